@@ -13,12 +13,15 @@
 package com.dynamo.bob.pipeline;
 
 import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
 import static org.junit.Assert.assertTrue;
 
 import java.io.ByteArrayInputStream;
 import java.io.ByteArrayOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.HashMap;
 import java.util.List;
 import java.util.Map;
@@ -29,7 +32,12 @@ import org.junit.Test;
 
 import com.dynamo.bob.CompileExceptionError;
 import com.dynamo.bob.util.MurmurHash;
+import com.dynamo.bob.util.RigUtil;
 import com.dynamo.rig.proto.Rig.AnimationSet;
+import com.dynamo.rig.proto.Rig.AnimationTrack;
+import com.dynamo.rig.proto.Rig.CompressedAnimationChannel;
+import com.dynamo.rig.proto.Rig.CompressedAnimationTracks;
+import com.dynamo.rig.proto.Rig.CompressedChannelType;
 import com.dynamo.rig.proto.Rig.RigAnimation;
 import com.google.protobuf.Message;
 
@@ -143,4 +151,91 @@ public class AnimationSetBuilderTest extends AbstractProtoBuilderTest {
         build("/test.animationset", src.toString());
     }
 
+    // Dequantizes one component of a compressed channel the same way the runtime sampler in rig.cpp does
+    private static float decompress(CompressedAnimationTracks tracks, CompressedAnimationChannel channel, int frame, int component) {
+        if (channel.getConstant()) {
+            return channel.getValues(component);
+        }
+        ByteBuffer frames = tracks.getFrames().asReadOnlyByteBuffer().order(ByteOrder.LITTLE_ENDIAN);
+        int index = frame * tracks.getFrameStride() + channel.getFrameOffset() + component;
+        short q = frames.getShort(index * 2);
+        if (channel.getType() == CompressedChannelType.COMPRESSED_CHANNEL_ROTATION) {
+            return q / 32767.0f;
+        }
+        int components = channel.getValuesCount() / 2;
+        return channel.getValues(component) + (q & 0xffff) * channel.getValues(components + component);
+    }
+
+    private static List<Float> getChannelSource(AnimationTrack track, CompressedChannelType type) {
+        switch (type) {
+        case COMPRESSED_CHANNEL_POSITION: return track.getPositionsList();
+        case COMPRESSED_CHANNEL_ROTATION: return track.getRotationsList();
+        default: return track.getScaleList();
+        }
+    }
+
+    private static void assertCompressedMatches(RigAnimation source, RigAnimation compressed) {
+        assertEquals(0, compressed.getTracksCount());
+        assertTrue(compressed.hasCompressedTracks());
+        CompressedAnimationTracks tracks = compressed.getCompressedTracks();
+        assertEquals(tracks.getFrameCount() * tracks.getFrameStride() * 2, tracks.getFrames().size());
+
+        Map<Integer, AnimationTrack> sourceTracks = new HashMap<Integer, AnimationTrack>();
+        for (AnimationTrack track : source.getTracksList()) {
+            sourceTracks.put(track.getBoneIndex(), track);
+        }
+        int channelCount = 0;
+        for (CompressedAnimationChannel channel : tracks.getChannelsList()) {
+            AnimationTrack track = sourceTracks.get(channel.getBoneIndex());
+            assertTrue(track != null);
+            List<Float> data = getChannelSource(track, channel.getType());
+            int components = channel.getType() == CompressedChannelType.COMPRESSED_CHANNEL_ROTATION ? 4 : 3;
+            for (int i = 0; i < data.size(); ++i) {
+                int frame = i / components;
+                int component = i % components;
+                // Half a quantization step, plus float rounding of the range
+                float tolerance = 0.0001f;
+                if (!channel.getConstant() && channel.getType() != CompressedChannelType.COMPRESSED_CHANNEL_ROTATION) {
+                    tolerance += channel.getValues(components + component);
+                }
+                assertEquals(data.get(i), decompress(tracks, channel, frame, component), tolerance);
+            }
+            ++channelCount;
+        }
+        int expectedChannels = 0;
+        for (AnimationTrack track : source.getTracksList()) {
+            expectedChannels += (track.getPositionsCount() > 0 ? 1 : 0) + (track.getRotationsCount() > 0 ? 1 : 0) + (track.getScaleCount() > 0 ? 1 : 0);
+        }
+        assertEquals(expectedChannels, channelCount);
+    }
+
+    @Test
+    public void testCompressAnimation() throws Exception {
+        addTestFile("testanim.dae", "testanim.dae");
+        StringBuilder src = new StringBuilder();
+        src.append("animations { animation : \"/testanim.dae\" }");
+        List<Message> outputs = build("/test.animationset", src.toString());
+
+        RigAnimation source = getAnim(getAnims((AnimationSet)outputs.get(0)), "testanim");
+        assertTrue(source.getTracksCount() > 0);
+
+        RigAnimation.Builder compressed = RigAnimation.newBuilder(source);
+        RigUtil.compressAnimation(compressed);
+        assertCompressedMatches(source, compressed.build());
+    }
+
+    @Test
+    public void testCompressedAnimationSet() throws Exception {
+        GetProject().getProjectProperties().putBooleanValue("model", "compress_animations", true);
+        addTestFile("testanim.dae", "testanim.dae");
+        StringBuilder src = new StringBuilder();
+        src.append("animations { animation : \"/testanim.dae\" }");
+        List<Message> outputs = build("/test.animationset", src.toString());
+
+        RigAnimation anim = getAnim(getAnims((AnimationSet)outputs.get(0)), "testanim");
+        assertEquals(0, anim.getTracksCount());
+        assertTrue(anim.hasCompressedTracks());
+        assertFalse(anim.getCompressedTracks().getChannelsList().isEmpty());
+    }
+
 }
@@ -67,6 +67,9 @@ public class TexcLibrary {
             }
 
             Native.register("texc_shared");
+
+            // Compress the mip maps of a texture on all cores, the output is the same as on a single thread
+            TEXC_SetWorkerCount(Math.max(0, Runtime.getRuntime().availableProcessors() - 1));
         } catch (Exception e) {
             System.out.println("FATAL: " + e.getMessage());
         }
@@ -141,6 +144,7 @@ public class TexcLibrary {
     public static native boolean TEXC_GenMipMaps(Pointer texture);
     public static native boolean TEXC_Flip(Pointer texture, int flipAxis);
     public static native boolean TEXC_Transcode(Pointer texture, int pixelFormat, int colorSpace, int compressionLevel, int compressionType, int dither);
+    public static native void TEXC_SetWorkerCount(int count);
 
 
     public static native Pointer TEXC_CompressWebPBuffer(int width, int height, int bitsPerPixel, Buffer data, int datasize, int pixelFormat, int compressionLevel, int compressionType);
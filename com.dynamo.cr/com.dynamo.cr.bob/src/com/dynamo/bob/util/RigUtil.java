@@ -12,6 +12,8 @@
 
 package com.dynamo.bob.util;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.ArrayList;
 import java.util.List;
 import java.util.Map;
@@ -25,7 +27,13 @@ import javax.vecmath.Vector3d;
 
 import com.dynamo.bob.textureset.TextureSetGenerator.UVTransform;
 import com.dynamo.bob.util.RigUtil.AnimationCurve.CurveIntepolation;
+import com.dynamo.rig.proto.Rig.AnimationSet;
+import com.dynamo.rig.proto.Rig.CompressedAnimationChannel;
+import com.dynamo.rig.proto.Rig.CompressedAnimationTracks;
+import com.dynamo.rig.proto.Rig.CompressedChannelType;
 import com.dynamo.rig.proto.Rig.MeshAnimationTrack;
+import com.dynamo.rig.proto.Rig.RigAnimation;
+import com.google.protobuf.ByteString;
 
 /**
  * Convenience class for loading spine json data.
@@ -768,4 +776,142 @@ public class RigUtil {
         // Create duplicate of last keyframe
         propertyBuilder.duplicateLast();
     }
+
+    private static class CompressedChannelSource {
+        public List<Float> data;
+        public CompressedAnimationChannel.Builder channel;
+        public int components;
+        public int frameCount;
+    }
+
+    private static boolean isConstantChannel(List<Float> data, int components) {
+        int count = data.size() / components;
+        for (int i = 1; i < count; ++i) {
+            for (int c = 0; c < components; ++c) {
+                if (Math.abs(data.get(i*components + c) - data.get(c)) > EPSILON) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    private static int addCompressedChannel(List<CompressedChannelSource> sources, int boneIndex, CompressedChannelType type, List<Float> data, int components, int frameOffset) {
+        if (data.isEmpty()) {
+            return frameOffset;
+        }
+        CompressedAnimationChannel.Builder channel = CompressedAnimationChannel.newBuilder();
+        channel.setBoneIndex(boneIndex).setType(type);
+        CompressedChannelSource source = new CompressedChannelSource();
+        source.data = data;
+        source.channel = channel;
+        source.components = components;
+        source.frameCount = data.size() / components;
+        sources.add(source);
+
+        if (isConstantChannel(data, components)) {
+            channel.setConstant(true);
+            for (int c = 0; c < components; ++c) {
+                channel.addValues(data.get(c));
+            }
+            return frameOffset;
+        }
+
+        if (type != CompressedChannelType.COMPRESSED_CHANNEL_ROTATION) {
+            // Quantization range: min followed by step per component
+            float[] min = new float[components];
+            float[] max = new float[components];
+            for (int c = 0; c < components; ++c) {
+                min[c] = Float.MAX_VALUE;
+                max[c] = -Float.MAX_VALUE;
+            }
+            for (int i = 0; i < data.size(); ++i) {
+                int c = i % components;
+                min[c] = Math.min(min[c], data.get(i));
+                max[c] = Math.max(max[c], data.get(i));
+            }
+            for (int c = 0; c < components; ++c) {
+                channel.addValues(min[c]);
+            }
+            for (int c = 0; c < components; ++c) {
+                channel.addValues((max[c] - min[c]) / 65535.0f);
+            }
+        }
+        channel.setFrameOffset(frameOffset);
+        return frameOffset + components;
+    }
+
+    private static short quantizeChannelValue(CompressedChannelSource source, int frame, int component) {
+        int sourceFrame = Math.min(frame, source.frameCount - 1);
+        float v = source.data.get(sourceFrame * source.components + component);
+        if (source.channel.getType() == CompressedChannelType.COMPRESSED_CHANNEL_ROTATION) {
+            long q = Math.round(v * 32767.0);
+            return (short)Math.max(-32767, Math.min(32767, q));
+        }
+        float min = source.channel.getValues(component);
+        float step = source.channel.getValues(source.components + component);
+        if (step == 0.0f) {
+            return 0;
+        }
+        long q = Math.round((v - min) / step);
+        return (short)Math.max(0, Math.min(65535, q));
+    }
+
+    /**
+     * Replaces the bone tracks of an animation with quantized frame data, interleaved
+     * frame by frame (see CompressedAnimationTracks in rig_ddf.proto). Channels that
+     * never change are stored once at full precision and left out of the frames.
+     */
+    public static void compressAnimation(RigAnimation.Builder animBuilder) {
+        if (animBuilder.getTracksCount() == 0) {
+            return;
+        }
+
+        List<CompressedChannelSource> sources = new ArrayList<CompressedChannelSource>();
+        int stride = 0;
+        int frameCount = 0;
+        for (com.dynamo.rig.proto.Rig.AnimationTrack track : animBuilder.getTracksList()) {
+            int boneIndex = track.getBoneIndex();
+            stride = addCompressedChannel(sources, boneIndex, CompressedChannelType.COMPRESSED_CHANNEL_POSITION, track.getPositionsList(), 3, stride);
+            stride = addCompressedChannel(sources, boneIndex, CompressedChannelType.COMPRESSED_CHANNEL_ROTATION, track.getRotationsList(), 4, stride);
+            stride = addCompressedChannel(sources, boneIndex, CompressedChannelType.COMPRESSED_CHANNEL_SCALE, track.getScaleList(), 3, stride);
+        }
+        for (CompressedChannelSource source : sources) {
+            frameCount = Math.max(frameCount, source.frameCount);
+        }
+
+        CompressedAnimationTracks.Builder compressed = CompressedAnimationTracks.newBuilder();
+        compressed.setFrameCount(stride > 0 ? frameCount : 0);
+        compressed.setFrameStride(stride);
+        if (stride > 0) {
+            ByteBuffer frames = ByteBuffer.allocate(frameCount * stride * 2).order(ByteOrder.LITTLE_ENDIAN);
+            for (int f = 0; f < frameCount; ++f) {
+                for (CompressedChannelSource source : sources) {
+                    if (source.channel.getConstant()) {
+                        continue;
+                    }
+                    for (int c = 0; c < source.components; ++c) {
+                        frames.putShort(quantizeChannelValue(source, f, c));
+                    }
+                }
+            }
+            compressed.setFrames(ByteString.copyFrom(frames.array()));
+        }
+        for (CompressedChannelSource source : sources) {
+            compressed.addChannels(source.channel);
+        }
+
+        animBuilder.clearTracks();
+        animBuilder.setCompressedTracks(compressed);
+    }
+
+    public static void compressAnimations(AnimationSet.Builder animSetBuilder) {
+        List<RigAnimation> animations = new ArrayList<RigAnimation>(animSetBuilder.getAnimationsList());
+        animSetBuilder.clearAnimations();
+        for (RigAnimation animation : animations) {
+            RigAnimation.Builder animBuilder = RigAnimation.newBuilder(animation);
+            compressAnimation(animBuilder);
+            animSetBuilder.addAnimations(animBuilder);
+        }
+    }
 }
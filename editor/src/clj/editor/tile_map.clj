@@ -170,7 +170,7 @@
     (condp = pass
       pass/transparent
       (let [{:keys [selected ^Matrix4d world-transform user-data]} (first renderables)
-            {:keys [node-id vbuf shader gpu-texture blend-mode]} user-data]
+            {:keys [node-id vbuf shader gpu-texture blend-mode vertex-space]} user-data]
         (when vbuf
           (let [render-args (merge render-args
                                    (math/derive-render-transforms
@@ -178,15 +178,19 @@
                                      (:view render-args)
                                      (:projection render-args)
                                      (:texture render-args)))
-                ;; In the runtime, vertices are in world space. In the editor we
-                ;; prefer to keep the vertices in local space in order to avoid
-                ;; unnecessary buffer updates. As a workaround, we trick the
-                ;; shader by supplying a world-view-projection matrix for the
-                ;; view-projection matrix. If this turns out to be a problem, we
-                ;; need to produce world-space buffers here in the render
-                ;; function, seeing as we don't have the final world-transform
-                ;; until the scene has been flattened.
-                render-args (assoc render-args :view-proj (:world-view-proj render-args))
+                ;; With :vertex-space-world materials the runtime supplies
+                ;; vertices in world space. In the editor we prefer to keep the
+                ;; vertices in local space in order to avoid unnecessary buffer
+                ;; updates. As a workaround, we trick the shader by supplying a
+                ;; world-view-projection matrix for the view-projection matrix.
+                ;; If this turns out to be a problem, we need to produce
+                ;; world-space buffers here in the render function, seeing as we
+                ;; don't have the final world-transform until the scene has been
+                ;; flattened. :vertex-space-local materials apply the world
+                ;; transform themselves, like in the runtime.
+                render-args (if (= :vertex-space-local vertex-space)
+                              render-args
+                              (assoc render-args :view-proj (:world-view-proj render-args)))
                 vertex-binding (vtx/use-with node-id vbuf shader)]
             (gl/with-gl-bindings gl render-args [gpu-texture shader vertex-binding]
               (gl/set-blend-mode gl blend-mode)
@@ -253,7 +257,7 @@
                                   [max-x max-y 0])}))))
 
 (g/defnk produce-layer-scene
-  [_node-id id cell-map texture-set-data z gpu-texture shader blend-mode visible]
+  [_node-id id cell-map texture-set-data z gpu-texture shader vertex-space blend-mode visible]
   (when visible
     (let [{:keys [aabb vbuf]} (gen-layer-render-data cell-map texture-set-data)
           transform (doto (Matrix4d.) (.set (Vector3d. 0.0 0.0 z)))
@@ -281,6 +285,7 @@
                                 :vbuf vbuf
                                 :gpu-texture gpu-texture
                                 :shader shader
+                                :vertex-space vertex-space
                                 :blend-mode blend-mode}
                     :passes [pass/transparent pass/selection]}})))
 
@@ -311,6 +316,7 @@
   (input texture-set-data g/Any)
   (input gpu-texture g/Any)
   (input shader ShaderLifecycle)
+  (input vertex-space g/Keyword)
   (input blend-mode g/Any)
 
   (property cell-map g/Any
@@ -336,6 +342,7 @@
    (g/connect layer-node :pb-msg                       parent :layer-msgs)
    (g/connect parent     :texture-set-data             layer-node :texture-set-data)
    (g/connect parent     :material-shader              layer-node :shader)
+   (g/connect parent     :material-vertex-space        layer-node :vertex-space)
    (g/connect parent     :gpu-texture                  layer-node :gpu-texture)
    (g/connect parent     :blend-mode                   layer-node :blend-mode)))
 
@@ -444,6 +451,7 @@
   (input material-resource resource/Resource)
   (input material-shader ShaderLifecycle)
   (input material-samplers g/Any)
+  (input material-vertex-space g/Keyword)
   (input default-tex-params g/Any)
 
   ;; tile source
@@ -469,7 +477,8 @@
                                             [:resource :material-resource]
                                             [:build-targets :dep-build-targets]
                                             [:shader :material-shader]
-                                            [:samplers :material-samplers])))
+                                            [:samplers :material-samplers]
+                                            [:vertex-space :material-vertex-space])))
             (dynamic error (g/fnk [_node-id material]
                                   (prop-resource-error :fatal _node-id :material material "Material")))
             (dynamic edit-type (g/constantly {:type resource/Resource :ext "material"})))
@@ -498,6 +507,7 @@
                                  default-tex-params)))
   (output gpu-texture g/Any (g/fnk [gpu-texture tex-params] (texture/set-params gpu-texture tex-params)))
   (output material-shader ShaderLifecycle (gu/passthrough material-shader))
+  (output material-vertex-space g/Keyword (gu/passthrough material-vertex-space))
   (output scene g/Any :cached produce-scene)
   (output node-outline outline/OutlineData :cached produce-node-outline)
   (output pb-msg g/Any :cached produce-pb-msg)
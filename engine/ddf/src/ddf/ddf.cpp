@@ -79,77 +79,6 @@ namespace dmDDF
         return GetDescriptorFromHash(dmHashString64(name));
     }
 
-    static Result CalculateRepeated(LoadContext* load_context, InputBuffer* ib, const Descriptor* desc)
-    {
-        assert(desc);
-
-        // Calculate number of entries in arrays, ie memory requirements for the entire message
-        uint32_t start = ib->Tell();
-        while (!ib->Eof())
-        {
-            uint32_t tag;
-            if (ib->ReadVarInt32(&tag))
-            {
-                uint32_t key = tag >> 3;
-                uint32_t type = tag & 0x7;
-
-                if (key == 0)
-                    return RESULT_WIRE_FORMAT_ERROR;
-
-                const FieldDescriptor* field = FindField(desc, key, 0);
-
-                if (field == 0)
-                {
-                    Result e = SkipField(ib, type);
-                    if (e != RESULT_OK)
-                        return e;
-                }
-                else
-                {
-                    if (field->m_Label == LABEL_REPEATED)
-                    {
-                        load_context->IncreaseArrayCount(start, field->m_Number);
-                    }
-
-                    if (field->m_Type != TYPE_MESSAGE)
-                    {
-                        Result e = SkipField(ib, type);
-                        if (e != RESULT_OK)
-                            return e;
-                    }
-                    else
-                    {
-                        assert(field->m_MessageDescriptor);
-                        uint32_t length;
-                        if (!ib->ReadVarInt32(&length))
-                            return RESULT_WIRE_FORMAT_ERROR;
-
-                        #if 1
-                        InputBuffer sub_ib;
-                        if (!ib->SubBuffer(length, &sub_ib))
-                        {
-                            return RESULT_WIRE_FORMAT_ERROR;
-                        }
-
-                        Result e = CalculateRepeated(load_context, &sub_ib, field->m_MessageDescriptor);
-                        #else
-                        InputBuffer sub_ib = ib;
-                        sub_ib->m_End = sub_ib->m_Current + length;
-                        Result e = CalculateRepeated(load_context, &sub_ib, field->m_MessageDescriptor);
-                        #endif
-                        if (e != RESULT_OK)
-                            return e;
-                    }
-                }
-            }
-            else
-            {
-                return RESULT_WIRE_FORMAT_ERROR;
-            }
-        }
-        return RESULT_OK;
-    }
-
     Result LoadMessage(const void* buffer, uint32_t buffer_size, const Descriptor* desc, void** out_message)
     {
         return LoadMessage(buffer, buffer_size, desc, out_message, 0, 0);
@@ -168,38 +97,22 @@ namespace dmDDF
         if (desc->m_MajorVersion != DDF_MAJOR_VERSION)
             return RESULT_VERSION_MISMATCH;
 
-        LoadContext load_context(0, 0, true, options);
-        Message dry_message = load_context.AllocMessage(desc);
-
-        InputBuffer input_buffer((const char*) buffer, buffer_size);
-
-        Result e = CalculateRepeated(&load_context, &input_buffer, desc);
-        if (e != RESULT_OK)
-        {
-            return e;
-        }
-
-        input_buffer.Seek(0);
-        e = DoLoadMessage(&load_context, &input_buffer, desc, &dry_message);
-
-        int message_buffer_size = load_context.GetMemoryUsage();
-        char* message_buffer = 0;
-        dmMemory::AlignedMalloc((void**)&message_buffer, 16, message_buffer_size);
-        assert(message_buffer);
-        load_context.SetMemoryBuffer(message_buffer, message_buffer_size, false);
+        // Single pass over the input. The decoded message is usually larger than its wire format,
+        // the context allocates more memory as needed.
+        LoadContext load_context(desc->m_Size + buffer_size * 2 + 256, options);
         Message message = load_context.AllocMessage(desc);
 
-        input_buffer.Seek(0);
-        e = DoLoadMessage(&load_context, &input_buffer, desc, &message);
+        InputBuffer input_buffer((const char*) buffer, buffer_size);
+        Result e = DoLoadMessage(&load_context, &input_buffer, desc, &message);
         if ( e == RESULT_OK )
         {
+            uint32_t message_buffer_size = 0;
+            *out_message = (void*) load_context.Finalize(desc, &message_buffer_size);
             if (size)
                 *size = message_buffer_size;
-            *out_message = (void*) message_buffer;
         }
         else
         {
-            dmMemory::AlignedFree((void*) message_buffer);
             *out_message = 0;
         }
         return e;
@@ -113,20 +113,70 @@ namespace dmDDF
         }
     }
 
+    // Count the elements of each repeated field in this message. Only the fields at this level are visited,
+    // sub messages are skipped over and counted when they are loaded.
+    static Result CountRepeated(InputBuffer input_buffer, const Descriptor* desc, uint32_t* counts)
+    {
+        while (!input_buffer.Eof())
+        {
+            uint32_t tag;
+            if (!input_buffer.ReadVarInt32(&tag))
+            {
+                return RESULT_WIRE_FORMAT_ERROR;
+            }
+
+            uint32_t key = tag >> 3;
+            uint32_t type = tag & 0x7;
+            if (key == 0)
+            {
+                return RESULT_WIRE_FORMAT_ERROR;
+            }
+
+            uint32_t field_index;
+            const FieldDescriptor* field = FindField(desc, key, &field_index);
+            if (field && field->m_Label == LABEL_REPEATED)
+            {
+                counts[field_index]++;
+            }
+
+            Result e = SkipField(&input_buffer, type);
+            if (e != RESULT_OK)
+            {
+                return e;
+            }
+        }
+        return RESULT_OK;
+    }
+
     Result DoLoadMessage(LoadContext* load_context, InputBuffer* input_buffer,
                          const Descriptor* desc, Message* message)
     {
         uint8_t read_fields[DDF_MAX_FIELDS];
         memset(read_fields, 0, sizeof(read_fields));
 
+        bool has_repeated = false;
         for (int i = 0; i < desc->m_FieldCount; ++i)
         {
-            const FieldDescriptor* f = &desc->m_Fields[i];
-            if (f->m_Label == LABEL_REPEATED)
+            has_repeated |= desc->m_Fields[i].m_Label == LABEL_REPEATED;
+        }
+
+        if (has_repeated)
+        {
+            uint32_t repeated_counts[DDF_MAX_FIELDS];
+            memset(repeated_counts, 0, sizeof(uint32_t) * desc->m_FieldCount);
+            Result e = CountRepeated(*input_buffer, desc, repeated_counts);
+            if (e != RESULT_OK)
             {
-                // TODO: Verify buffer_pos!!!! Correct to use Tell()?
-                uint32_t buffer_pos = input_buffer->Tell();
-                message->AllocateRepeatedBuffer(load_context, f, load_context->GetArrayCount(buffer_pos, f->m_Number));
+                return e;
+            }
+
+            for (int i = 0; i < desc->m_FieldCount; ++i)
+            {
+                const FieldDescriptor* f = &desc->m_Fields[i];
+                if (f->m_Label == LABEL_REPEATED)
+                {
+                    message->AllocateRepeatedBuffer(load_context, f, repeated_counts[i]);
+                }
             }
         }
 
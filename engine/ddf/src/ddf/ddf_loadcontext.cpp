@@ -11,41 +11,82 @@
 // specific language governing permissions and limitations under the License.
 
 #include <string.h>
+#include <assert.h>
 #include <dlib/align.h>
+#include <dlib/memory.h>
 #include "ddf_loadcontext.h"
 #include "ddf_util.h"
 
 namespace dmDDF
 {
-    LoadContext::LoadContext(char* buffer, int buffer_size, bool dry_run, uint32_t options)
+    LoadContext::LoadContext(uint32_t initial_capacity, uint32_t options)
     {
-        m_Start = buffer;
-        m_Current = buffer;
-        m_End = buffer + buffer_size;
-        m_DryRun = dry_run;
+        m_ChunkCount = 0;
+        m_Current = 0;
+        m_End = 0;
+        m_RelocationBuffer = 0;
         m_Options = options;
-        if (!dry_run)
+        NewChunk(initial_capacity);
+    }
+
+    LoadContext::~LoadContext()
+    {
+        for (uint32_t i = 0; i < m_ChunkCount; ++i)
         {
-            memset(buffer, 0, buffer_size);
+            dmMemory::AlignedFree(m_Chunks[i].m_Start);
         }
-        m_ArrayCount.SetCapacity(2048, 2048);
     }
 
-    Message LoadContext::AllocMessage(const Descriptor* desc)
+    void LoadContext::NewChunk(uint32_t min_capacity)
+    {
+        assert(m_ChunkCount < MAX_CHUNKS);
+
+        uint32_t offset = 0;
+        uint32_t capacity = DM_ALIGN(min_capacity, 16);
+        if (m_ChunkCount > 0)
+        {
+            // The previous chunk is full, its size is final
+            Chunk& prev = m_Chunks[m_ChunkCount-1];
+            prev.m_Used = (uint32_t) (m_Current - prev.m_Start);
+            offset = prev.m_Offset + DM_ALIGN(prev.m_Used, 16);
+            uint32_t grow_capacity = prev.m_Capacity * 2;
+            capacity = capacity > grow_capacity ? capacity : grow_capacity;
+        }
+
+        Chunk& chunk = m_Chunks[m_ChunkCount++];
+        dmMemory::AlignedMalloc((void**)&chunk.m_Start, 16, capacity);
+        assert(chunk.m_Start);
+        chunk.m_Capacity = capacity;
+        chunk.m_Used = 0;
+        chunk.m_Offset = offset;
+        m_Current = chunk.m_Start;
+        m_End = chunk.m_Start + capacity;
+    }
+
+    char* LoadContext::Alloc(uint32_t size, uint32_t alignment)
     {
-        m_Current = (char*) DM_ALIGN(m_Current, 16);
-        char* b = m_Current;
-        m_Current += desc->m_Size;
-        assert(m_DryRun || m_Current <= m_End);
+        char* b = (char*) DM_ALIGN(m_Current, (uintptr_t) alignment);
+        if (b + size > m_End)
+        {
+            NewChunk(size);
+            b = m_Current;
+        }
+        // Zero the allocation, including any alignment padding
+        memset(m_Current, 0, (b + size) - m_Current);
+        m_Current = b + size;
+        return b;
+    }
 
-        return Message(desc, b, desc->m_Size, m_DryRun);
+    Message LoadContext::AllocMessage(const Descriptor* desc)
+    {
+        char* b = Alloc(desc->m_Size, 16);
+        return Message(desc, b, desc->m_Size);
     }
 
     void* LoadContext::AllocRepeated(const FieldDescriptor* field_desc, int count)
     {
         Type type = (Type) field_desc->m_Type;
 
-        m_Current = (char*) DM_ALIGN(m_Current, 16);
         int element_size = 0;
         if ( field_desc->m_Type == TYPE_MESSAGE )
         {
@@ -60,78 +101,147 @@ namespace dmDDF
             element_size = ScalarTypeSize(type);
         }
 
-        char* b = m_Current;
-        m_Current += count * element_size;
-        assert(m_DryRun || m_Current <= m_End);
-        return (void*) b;
+        return (void*) Alloc(count * element_size, 16);
     }
 
     char* LoadContext::AllocString(int length)
     {
-        char* b = m_Current;
-        m_Current += length;
-        assert(m_DryRun || m_Current <= m_End);
-
-        return b;
+        return Alloc(length, 1);
     }
 
     char* LoadContext::AllocBytes(int length)
     {
-        m_Current = (char*) DM_ALIGN(m_Current, 16);
-        char* b = m_Current;
-        m_Current += length;
-        assert(m_DryRun || m_Current <= m_End);
-        return b;
+        return Alloc(length, 16);
     }
 
     uint32_t LoadContext::GetOffset(void* memory)
     {
-        return ((uintptr_t) memory) - ((uintptr_t) m_Start);
+        // The offset in the final message buffer, i.e. relative to the chunk start plus the chunk offset
+        const Chunk& chunk = m_Chunks[m_ChunkCount-1];
+        if ((char*) memory >= chunk.m_Start && (char*) memory <= m_End)
+        {
+            return chunk.m_Offset + (uint32_t) ((uintptr_t) memory - (uintptr_t) chunk.m_Start);
+        }
+        for (uint32_t i = 0; i < m_ChunkCount-1; ++i)
+        {
+            const Chunk& c = m_Chunks[i];
+            if ((char*) memory >= c.m_Start && (char*) memory <= c.m_Start + c.m_Used)
+            {
+                return c.m_Offset + (uint32_t) ((uintptr_t) memory - (uintptr_t) c.m_Start);
+            }
+        }
+        assert(false);
+        return 0;
     }
 
     void* LoadContext::GetPointer(uint32_t offset)
     {
-        return m_Start+offset;
+        for (uint32_t i = m_ChunkCount; i > 0; --i)
+        {
+            const Chunk& c = m_Chunks[i-1];
+            if (offset >= c.m_Offset)
+            {
+                return c.m_Start + (offset - c.m_Offset);
+            }
+        }
+        assert(false);
+        return 0;
     }
 
-    void LoadContext::SetMemoryBuffer(char* buffer, int buffer_size, bool dry_run)
+    char* LoadContext::Relocate(char* p)
     {
-        m_Start = buffer;
-        m_Current = buffer;
-        m_End = buffer + buffer_size;
-        m_DryRun = dry_run;
-        if (!dry_run)
+        for (uint32_t i = 0; i < m_ChunkCount; ++i)
         {
-            memset(buffer, 0, buffer_size);
+            const Chunk& c = m_Chunks[i];
+            if (p >= c.m_Start && p <= c.m_Start + c.m_Used)
+            {
+                return m_RelocationBuffer + c.m_Offset + (p - c.m_Start);
+            }
         }
+        return p;
     }
 
-    int LoadContext::GetMemoryUsage()
+    void LoadContext::RelocatePointers(const Descriptor* desc, char* message)
     {
-        return (int) (m_Current - m_Start);
+        bool offset_pointers = (m_Options & OPTION_OFFSET_POINTERS) != 0;
+        for (int i = 0; i < desc->m_FieldCount; ++i)
+        {
+            const FieldDescriptor* field = &desc->m_Fields[i];
+            char* fieldptr = message + field->m_Offset;
+            Type type = (Type) field->m_Type;
+
+            if (field->m_Label == LABEL_REPEATED)
+            {
+                RepeatedField* repeated_field = (RepeatedField*) fieldptr;
+                // With offset pointers, string arrays are stored as an offset once they have any elements
+                if (offset_pointers && type == TYPE_STRING && repeated_field->m_ArrayCount > 0)
+                {
+                    continue;
+                }
+
+                repeated_field->m_Array = (uintptr_t) Relocate((char*) repeated_field->m_Array);
+                if (type == TYPE_MESSAGE)
+                {
+                    char* element = (char*) repeated_field->m_Array;
+                    for (uint32_t j = 0; j < repeated_field->m_ArrayCount; ++j, element += field->m_MessageDescriptor->m_Size)
+                    {
+                        RelocatePointers(field->m_MessageDescriptor, element);
+                    }
+                }
+                else if (type == TYPE_STRING)
+                {
+                    char** strings = (char**) repeated_field->m_Array;
+                    for (uint32_t j = 0; j < repeated_field->m_ArrayCount; ++j)
+                    {
+                        strings[j] = Relocate(strings[j]);
+                    }
+                }
+            }
+            else if (type == TYPE_MESSAGE)
+            {
+                RelocatePointers(field->m_MessageDescriptor, fieldptr);
+            }
+            else if ((type == TYPE_STRING || type == TYPE_BYTES) && !offset_pointers)
+            {
+                // Bytes are stored as a RepeatedField, with the pointer first
+                char** p = (char**) fieldptr;
+                *p = Relocate(*p);
+            }
+        }
     }
 
-    void LoadContext::IncreaseArrayCount(uint32_t buffer_pos, uint32_t field_number)
+    char* LoadContext::Finalize(const Descriptor* desc, uint32_t* size)
     {
-        uint32_t key[] = {field_number, buffer_pos};
-        uint32_t hash = dmHashBufferNoReverse32((void*)key, sizeof(key));
-        if(m_ArrayCount.Full())
-            m_ArrayCount.SetCapacity(2048, m_ArrayCount.Capacity() + 1024);
-        uint32_t* value_p = m_ArrayCount.Get(hash);
-        if(value_p) {
-            (*value_p)++;
+        Chunk& last = m_Chunks[m_ChunkCount-1];
+        last.m_Used = (uint32_t) (m_Current - last.m_Start);
+        uint32_t total_size = last.m_Offset + last.m_Used;
+
+        // Keep the chunk as is when it's a tight fit
+        if (m_ChunkCount == 1 && last.m_Capacity - last.m_Used <= (last.m_Used / 8) + 256)
+        {
+            char* message = last.m_Start;
+            m_ChunkCount = 0;
+            *size = total_size;
+            return message;
         }
-        else {
-            m_ArrayCount.Put(hash, 1);
+
+        dmMemory::AlignedMalloc((void**)&m_RelocationBuffer, 16, total_size);
+        assert(m_RelocationBuffer);
+        for (uint32_t i = 0; i < m_ChunkCount; ++i)
+        {
+            const Chunk& c = m_Chunks[i];
+            memcpy(m_RelocationBuffer + c.m_Offset, c.m_Start, c.m_Used);
+            if (i + 1 < m_ChunkCount)
+            {
+                // Zero the padding up to the next chunk
+                memset(m_RelocationBuffer + c.m_Offset + c.m_Used, 0, m_Chunks[i+1].m_Offset - (c.m_Offset + c.m_Used));
+            }
         }
-    }
+        RelocatePointers(desc, m_RelocationBuffer);
 
-    uint32_t LoadContext::GetArrayCount(uint32_t buffer_pos, uint32_t field_number)
-    {
-        uint32_t key[] = {field_number, buffer_pos};
-        uint32_t hash = dmHashBufferNoReverse32((void*)key, sizeof(key));
-        uint32_t *value_p = m_ArrayCount.Get(hash);
-        return value_p == 0 ? 0 : *value_p;
+        char* message = m_RelocationBuffer;
+        m_RelocationBuffer = 0;
+        *size = total_size;
+        return message;
     }
 }
-
@@ -14,7 +14,6 @@
 #define DDF_LOADCONTEXT_H
 
 #include <stdint.h>
-#include <dlib/hashtable.h>
 #include "ddf.h"
 #include "ddf_message.h"
 
@@ -22,10 +21,17 @@ namespace dmDDF
 {
     class Message;
 
+    /**
+     * Allocator for a message being loaded. Memory is handed out from a list of chunks that are never moved
+     * while loading, so the message can be sized and filled in a single pass over the input. Finalize()
+     * gathers the chunks into one buffer and relocates all pointers if more than one chunk was used.
+     */
     class LoadContext
     {
     public:
-        LoadContext(char* buffer, int buffer_size, bool dry_run, uint32_t options);
+        LoadContext(uint32_t initial_capacity, uint32_t options);
+        ~LoadContext();
+
         Message     AllocMessage(const Descriptor* desc);
         void*       AllocRepeated(const FieldDescriptor* field_desc, int count);
         char*       AllocString(int length);
@@ -33,11 +39,14 @@ namespace dmDDF
         uint32_t    GetOffset(void* memory);
         void*       GetPointer(uint32_t offset);
 
-        void        SetMemoryBuffer(char* buffer, int buffer_size, bool dry_run);
-        int         GetMemoryUsage();
-
-        void        IncreaseArrayCount(uint32_t buffer_pos, uint32_t field_number);
-        uint32_t    GetArrayCount(uint32_t buffer_pos, uint32_t field_number);
+        /**
+         * Get the loaded message as a single buffer, allocated with dmMemory::AlignedMalloc.
+         * The ownership of the buffer is passed to the caller.
+         * @param desc descriptor of the root message
+         * @param size size of the returned buffer [out]
+         * @return message buffer
+         */
+        char*       Finalize(const Descriptor* desc, uint32_t* size);
 
         inline uint32_t GetOptions()
         {
@@ -45,13 +54,28 @@ namespace dmDDF
         }
 
     private:
-        dmHashTable32<uint32_t> m_ArrayCount;
+        static const uint32_t MAX_CHUNKS = 32;
+
+        struct Chunk
+        {
+            char*    m_Start;
+            uint32_t m_Capacity;
+            uint32_t m_Used;
+            /// Offset of the chunk in the final message buffer
+            uint32_t m_Offset;
+        };
+
+        char*       Alloc(uint32_t size, uint32_t alignment);
+        void        NewChunk(uint32_t min_capacity);
+        char*       Relocate(char* p);
+        void        RelocatePointers(const Descriptor* desc, char* message);
 
-        char* m_Start;
-        char* m_End;
-        char* m_Current;
-        bool  m_DryRun;
-        uint32_t m_Options;
+        Chunk       m_Chunks[MAX_CHUNKS];
+        uint32_t    m_ChunkCount;
+        char*       m_Current;
+        char*       m_End;
+        char*       m_RelocationBuffer;
+        uint32_t    m_Options;
     };
 }
 
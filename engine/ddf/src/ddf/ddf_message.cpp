@@ -18,12 +18,11 @@
 namespace dmDDF
 {
 
-    Message::Message(const Descriptor* message_descriptor, char* buffer, uint32_t buffer_size, bool dry_run)
+    Message::Message(const Descriptor* message_descriptor, char* buffer, uint32_t buffer_size)
     {
         m_MessageDescriptor = message_descriptor;
         m_Start = buffer;
         m_End = buffer + buffer_size;
-        m_DryRun = dry_run;
     }
 
     #define READSCALARFIELD_CASE(DDF_TYPE, CPP_TYPE, READ_METHOD) \
@@ -167,7 +166,7 @@ namespace dmDDF
             msg_buf = &m_Start[field->m_Offset];
             assert(msg_buf + field->m_MessageDescriptor->m_Size <= m_End);
         }
-        Message message(field->m_MessageDescriptor, (char*) msg_buf, field->m_MessageDescriptor->m_Size, m_DryRun);
+        Message message(field->m_MessageDescriptor, (char*) msg_buf, field->m_MessageDescriptor->m_Size);
         InputBuffer sub_buffer;
         if (!input_buffer->SubBuffer(length, &sub_buffer))
         {
@@ -194,7 +193,7 @@ namespace dmDDF
         assert(found);
 #endif
         char* msg_buf = &m_Start[field->m_Offset];
-        return Message(field->m_MessageDescriptor, (char*) msg_buf, field->m_MessageDescriptor->m_Size, m_DryRun);
+        return Message(field->m_MessageDescriptor, (char*) msg_buf, field->m_MessageDescriptor->m_Size);
     }
 
     Result Message::ReadField(LoadContext* load_context,
@@ -227,10 +226,7 @@ namespace dmDDF
         assert(field->m_MessageDescriptor == 0);
 
         assert(m_Start + field->m_Offset + buffer_size <= m_End);
-        if (!m_DryRun)
-        {
-            memcpy(m_Start + field->m_Offset, buffer, buffer_size);
-        }
+        memcpy(m_Start + field->m_Offset, buffer, buffer_size);
     }
 
     void* Message::AddScalar(const FieldDescriptor* field, const void* buffer, int buffer_size)
@@ -238,17 +234,13 @@ namespace dmDDF
         assert((Label) field->m_Label == LABEL_REPEATED);
         assert(field->m_MessageDescriptor == 0);
 
-        if (!m_DryRun)
-        {
-            RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
-            uintptr_t dest = repeated_field->m_Array + repeated_field->m_ArrayCount * buffer_size;
+        RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
+        uintptr_t dest = repeated_field->m_Array + repeated_field->m_ArrayCount * buffer_size;
 
-            memcpy((void*) dest, buffer, buffer_size);
-            repeated_field->m_ArrayCount++;
+        memcpy((void*) dest, buffer, buffer_size);
+        repeated_field->m_ArrayCount++;
 
-            return (void*) dest;
-        }
-        return 0;
+        return (void*) dest;
     }
 
     void* Message::AddMessage(const FieldDescriptor* field)
@@ -256,29 +248,22 @@ namespace dmDDF
         assert((Label) field->m_Label == LABEL_REPEATED);
         assert(field->m_MessageDescriptor);
 
-        if (!m_DryRun)
-        {
-            RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
-            uintptr_t dest = repeated_field->m_Array + repeated_field->m_ArrayCount * field->m_MessageDescriptor->m_Size;
+        RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
+        uintptr_t dest = repeated_field->m_Array + repeated_field->m_ArrayCount * field->m_MessageDescriptor->m_Size;
 
-            memset((void*) dest, 0, field->m_MessageDescriptor->m_Size);
-            repeated_field->m_ArrayCount++;
+        memset((void*) dest, 0, field->m_MessageDescriptor->m_Size);
+        repeated_field->m_ArrayCount++;
 
-            return (void*) dest;
-        }
-        return 0;
+        return (void*) dest;
     }
 
     void Message::SetRepeatedBuffer(const FieldDescriptor* field, void* buffer)
     {
         assert((Label) field->m_Label == LABEL_REPEATED);
 
-        if (!m_DryRun)
-        {
-            RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
-            repeated_field->m_Array = (uintptr_t) buffer;
-            repeated_field->m_ArrayCount = 0;
-        }
+        RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
+        repeated_field->m_Array = (uintptr_t) buffer;
+        repeated_field->m_ArrayCount = 0;
     }
 
     void Message::SetString(LoadContext* load_context, const FieldDescriptor* field, const char* buffer, int buffer_len)
@@ -288,20 +273,17 @@ namespace dmDDF
         // Always alloc
         char* str_buf = load_context->AllocString(buffer_len + 1);
 
-        if (!m_DryRun)
-        {
-            const char** string_field = (const char**) &m_Start[field->m_Offset];
-            memcpy(str_buf, buffer, buffer_len);
-            str_buf[buffer_len] = '\0';
+        const char** string_field = (const char**) &m_Start[field->m_Offset];
+        memcpy(str_buf, buffer, buffer_len);
+        str_buf[buffer_len] = '\0';
 
-            if (load_context->GetOptions() & OPTION_OFFSET_POINTERS)
-            {
-                *string_field = (char*)(uintptr_t) load_context->GetOffset(str_buf);
-            }
-            else
-            {
-                *string_field = str_buf;
-            }
+        if (load_context->GetOptions() & OPTION_OFFSET_POINTERS)
+        {
+            *string_field = (char*)(uintptr_t) load_context->GetOffset(str_buf);
+        }
+        else
+        {
+            *string_field = str_buf;
         }
     }
 
@@ -313,33 +295,30 @@ namespace dmDDF
         // Always alloc
         char* str_buf = load_context->AllocString(buffer_len + 1);
 
-        if (!m_DryRun)
+        RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
+        uintptr_t array = (uintptr_t)repeated_field->m_Array;
+        if (load_context->GetOptions() & OPTION_OFFSET_POINTERS )
         {
-            RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
-            uintptr_t array = (uintptr_t)repeated_field->m_Array;
-            if (load_context->GetOptions() & OPTION_OFFSET_POINTERS )
-            {
-                if (repeated_field->m_ArrayCount == 0) {
-                    repeated_field->m_Array = (uintptr_t) load_context->GetOffset((void*)repeated_field->m_Array);
-                }
-                array = (uintptr_t)load_context->GetPointer(repeated_field->m_Array);
+            if (repeated_field->m_ArrayCount == 0) {
+                repeated_field->m_Array = (uintptr_t) load_context->GetOffset((void*)repeated_field->m_Array);
             }
+            array = (uintptr_t)load_context->GetPointer(repeated_field->m_Array);
+        }
 
-            memcpy(str_buf, buffer, buffer_len);
-            str_buf[buffer_len] = '\0';
+        memcpy(str_buf, buffer, buffer_len);
+        str_buf[buffer_len] = '\0';
 
-            uintptr_t dest = array + repeated_field->m_ArrayCount * sizeof(const char*);
-            if (load_context->GetOptions() & OPTION_OFFSET_POINTERS)
-            {
-                const char* offset = (const char*)(uintptr_t) load_context->GetOffset(str_buf);
-                memcpy((void*) dest, &offset, sizeof(const char*));
-            }
-            else
-            {
-                memcpy((void*) dest, &str_buf, sizeof(const char*));
-            }
-            repeated_field->m_ArrayCount++;
+        uintptr_t dest = array + repeated_field->m_ArrayCount * sizeof(const char*);
+        if (load_context->GetOptions() & OPTION_OFFSET_POINTERS)
+        {
+            const char* offset = (const char*)(uintptr_t) load_context->GetOffset(str_buf);
+            memcpy((void*) dest, &offset, sizeof(const char*));
+        }
+        else
+        {
+            memcpy((void*) dest, &str_buf, sizeof(const char*));
         }
+        repeated_field->m_ArrayCount++;
     }
 
     void Message::SetBytes(LoadContext* load_context, const FieldDescriptor* field, const char* buffer, int buffer_len)
@@ -349,23 +328,20 @@ namespace dmDDF
         // Always alloc
         char* bytes_buf = load_context->AllocBytes(buffer_len);
 
-        if (!m_DryRun)
-        {
-            memcpy(bytes_buf, buffer, buffer_len);
+        memcpy(bytes_buf, buffer, buffer_len);
 
-            RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
-            assert(repeated_field->m_ArrayCount == 0);
+        RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
+        assert(repeated_field->m_ArrayCount == 0);
 
-            if (load_context->GetOptions() & OPTION_OFFSET_POINTERS)
-            {
-                repeated_field->m_Array = (uintptr_t) load_context->GetOffset(bytes_buf);
-            }
-            else
-            {
-                repeated_field->m_Array = (uintptr_t) bytes_buf;
-            }
-            repeated_field->m_ArrayCount = buffer_len;
+        if (load_context->GetOptions() & OPTION_OFFSET_POINTERS)
+        {
+            repeated_field->m_Array = (uintptr_t) load_context->GetOffset(bytes_buf);
+        }
+        else
+        {
+            repeated_field->m_Array = (uintptr_t) bytes_buf;
         }
+        repeated_field->m_ArrayCount = buffer_len;
     }
 
     void Message::AllocateRepeatedBuffer(LoadContext* load_context, const FieldDescriptor* field, int element_count)
@@ -25,7 +25,7 @@ namespace dmDDF
     class Message
     {
     public:
-        Message(const Descriptor* message_descriptor, char* buffer, uint32_t buffer_size, bool dry_run);
+        Message(const Descriptor* message_descriptor, char* buffer, uint32_t buffer_size);
 
         Result ReadField(LoadContext* load_context,
                          WireType wire_type,
@@ -67,7 +67,6 @@ namespace dmDDF
         const Descriptor*     m_MessageDescriptor;
         char*                 m_Start;
         char*                 m_End;
-        bool                  m_DryRun;
     };
 
 
@@ -28,6 +28,7 @@
 
 #include "../ddf/ddf.h"
 #include <dlib/memory.h>
+#include <dlib/time.h>
 
 /*
  * TODO:
@@ -748,6 +749,149 @@ TEST(PointerOffset, ResolvePointers)
     free(msg);
 }
 
+static void CreateScene(TestDDF::Scene* scene, uint32_t node_count)
+{
+    char buf[64];
+    scene->set_name("scene");
+    for (uint32_t i = 0; i < node_count; ++i)
+    {
+        TestDDF::SceneNode* node = scene->add_nodes();
+        snprintf(buf, sizeof(buf), "node%u", i);
+        node->set_id(buf);
+        if (i > 0)
+        {
+            snprintf(buf, sizeof(buf), "node%u", i / 2);
+            node->set_parent(buf);
+        }
+        snprintf(buf, sizeof(buf), "The quick brown fox %u", i);
+        node->set_text(buf);
+        node->mutable_position()->set_x((float) i);
+        node->mutable_position()->set_y((float) -i);
+        if (i % 2)
+        {
+            node->mutable_rotation()->set_z(0.5f);
+        }
+        for (uint32_t j = 0; j < i % 4; ++j)
+        {
+            snprintf(buf, sizeof(buf), "tag%u", j);
+            node->add_tags(buf);
+        }
+        for (uint32_t j = 0; j < i % 3; ++j)
+        {
+            TestDDF::Vector2Message* point = node->add_points();
+            point->set_x((float) j);
+            point->set_y((float) i);
+        }
+        node->set_flags(i);
+        node->set_data(buf, strlen(buf));
+    }
+    for (uint32_t i = 0; i < node_count / 100; ++i)
+    {
+        snprintf(buf, sizeof(buf), "/textures/texture%u.png", i);
+        scene->add_textures(buf);
+    }
+}
+
+static void VerifyScene(const TestDDF::Scene& src, const DUMMY::TestDDF::Scene* scene)
+{
+    ASSERT_STREQ(src.name().c_str(), scene->m_Name);
+    ASSERT_EQ((uint32_t) src.nodes_size(), scene->m_Nodes.m_Count);
+    for (int i = 0; i < src.nodes_size(); ++i)
+    {
+        const TestDDF::SceneNode& src_node = src.nodes(i);
+        const DUMMY::TestDDF::SceneNode& node = scene->m_Nodes[i];
+        ASSERT_STREQ(src_node.id().c_str(), node.m_Id);
+        ASSERT_STREQ(src_node.parent().c_str(), node.m_Parent);
+        ASSERT_STREQ(src_node.text().c_str(), node.m_Text);
+        ASSERT_EQ(src_node.position().x(), node.m_Position.m_X);
+        ASSERT_EQ(src_node.position().y(), node.m_Position.m_Y);
+        ASSERT_EQ(src_node.rotation().z(), node.m_Rotation.m_Z);
+        ASSERT_EQ(src_node.rotation().w(), node.m_Rotation.m_W);
+        ASSERT_EQ((uint32_t) src_node.tags_size(), node.m_Tags.m_Count);
+        for (int j = 0; j < src_node.tags_size(); ++j)
+        {
+            ASSERT_STREQ(src_node.tags(j).c_str(), node.m_Tags[j]);
+        }
+        ASSERT_EQ((uint32_t) src_node.points_size(), node.m_Points.m_Count);
+        for (int j = 0; j < src_node.points_size(); ++j)
+        {
+            ASSERT_EQ(src_node.points(j).x(), node.m_Points[j].m_X);
+            ASSERT_EQ(src_node.points(j).y(), node.m_Points[j].m_Y);
+        }
+        ASSERT_EQ(src_node.flags(), node.m_Flags);
+        ASSERT_EQ(src_node.data().size(), node.m_Data.m_Count);
+        ASSERT_EQ(0, memcmp(src_node.data().c_str(), node.m_Data.m_Data, node.m_Data.m_Count));
+    }
+    ASSERT_EQ((uint32_t) src.textures_size(), scene->m_Textures.m_Count);
+    for (int i = 0; i < src.textures_size(); ++i)
+    {
+        ASSERT_STREQ(src.textures(i).c_str(), scene->m_Textures[i]);
+    }
+}
+
+TEST(Scene, Load)
+{
+    // Large messages don't fit the initial allocation and are compacted after loading
+    const uint32_t node_counts[] = {0, 1, 10, 100, 5000};
+    for (uint32_t i = 0; i < sizeof(node_counts) / sizeof(node_counts[0]); ++i)
+    {
+        TestDDF::Scene src;
+        CreateScene(&src, node_counts[i]);
+        std::string msg_str = src.SerializeAsString();
+
+        DUMMY::TestDDF::Scene* scene;
+        uint32_t scene_size;
+        dmDDF::Result e = dmDDF::LoadMessage((void*) msg_str.c_str(), msg_str.size(), &DUMMY::TestDDF_Scene_DESCRIPTOR, (void**)&scene, 0, &scene_size);
+        ASSERT_EQ(dmDDF::RESULT_OK, e);
+        ASSERT_GT(scene_size, 0U);
+        VerifyScene(src, scene);
+        dmDDF::FreeMessage(scene);
+
+        e = dmDDF::LoadMessage((void*) msg_str.c_str(), msg_str.size(), &DUMMY::TestDDF_Scene_DESCRIPTOR, (void**)&scene, dmDDF::OPTION_OFFSET_POINTERS, &scene_size);
+        ASSERT_EQ(dmDDF::RESULT_OK, e);
+        // Strings are stored as offsets from the start of the message
+        const char* base = (const char*) scene;
+        ASSERT_STREQ(src.name().c_str(), base + (uintptr_t) scene->m_Name);
+        ASSERT_EQ((uint32_t) src.nodes_size(), scene->m_Nodes.m_Count);
+        for (int j = 0; j < src.nodes_size(); ++j)
+        {
+            const DUMMY::TestDDF::SceneNode& node = scene->m_Nodes[j];
+            ASSERT_STREQ(src.nodes(j).id().c_str(), base + (uintptr_t) node.m_Id);
+            ASSERT_STREQ(src.nodes(j).text().c_str(), base + (uintptr_t) node.m_Text);
+            ASSERT_EQ((uint32_t) src.nodes(j).points_size(), node.m_Points.m_Count);
+            ASSERT_EQ(src.nodes(j).position().x(), node.m_Position.m_X);
+        }
+        ASSERT_EQ((uint32_t) src.textures_size(), scene->m_Textures.m_Count);
+        for (int j = 0; j < src.textures_size(); ++j)
+        {
+            uintptr_t* texture_offsets = (uintptr_t*) (base + (uintptr_t) scene->m_Textures.m_Data);
+            ASSERT_STREQ(src.textures(j).c_str(), base + texture_offsets[j]);
+        }
+        dmDDF::FreeMessage(scene);
+    }
+}
+
+TEST(Scene, LoadBenchmark)
+{
+    const uint32_t node_count = 5000;
+    const uint32_t iterations = 50;
+    TestDDF::Scene src;
+    CreateScene(&src, node_count);
+    std::string msg_str = src.SerializeAsString();
+
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        DUMMY::TestDDF::Scene* scene;
+        dmDDF::Result e = dmDDF::LoadMessage<DUMMY::TestDDF::Scene>((void*) msg_str.c_str(), msg_str.size(), &scene);
+        ASSERT_EQ(dmDDF::RESULT_OK, e);
+        dmDDF::FreeMessage(scene);
+    }
+    uint64_t end = dmTime::GetTime();
+
+    printf("Bench elapsed: %f ms (%f ms per load of %u nodes, %u bytes)\n", (end - start) / 1000.0f, (end - start) / (1000.0f * iterations), node_count, (uint32_t) msg_str.size());
+}
+
 TEST(AlignmentTests, AlignStruct)
 {
     DM_STATIC_ASSERT(sizeof(DUMMY::TestDDF::TestMessageAlignment) % 16 == 0, Invalid_Struct_Size);
@@ -20,6 +20,8 @@
 #include <string.h>
 #include <assert.h>
 
+#include <dlib/spinlock.h>
+
 #if defined(_WIN32)
 #include <malloc.h>
 #endif
@@ -62,6 +64,8 @@ namespace dmBuffer
         Buffer** m_Buffers;
         uint32_t m_Capacity;
         uint32_t m_Version;
+        // Guards the slots, since buffers may be created on the resource loading thread
+        dmSpinlock::lock_t m_Spinlock;
     };
 
     static BufferContext* g_BufferContext = 0;
@@ -79,6 +83,7 @@ namespace dmBuffer
         uint32_t size = capacity * sizeof(Buffer*);
         g_BufferContext->m_Buffers = (Buffer**)malloc( size );
         g_BufferContext->m_Version = 0;
+        dmSpinlock::Init(&g_BufferContext->m_Spinlock);
 
         memset(g_BufferContext->m_Buffers, 0, size);
     }
@@ -123,6 +128,7 @@ namespace dmBuffer
         }
         uint32_t version = hbuffer >> 16;
         uint32_t index = hbuffer & 0xFFFF;
+        DM_SPINLOCK_SCOPED_LOCK(ctx->m_Spinlock);
         Buffer* b = ctx->m_Buffers[index];
         if (b == 0 || version != b->m_Version)
         {
@@ -147,13 +153,24 @@ namespace dmBuffer
     static void FreeBuffer(BufferContext* ctx, HBuffer hbuffer)
     {
         uint16_t version = hbuffer >> 16;
-        Buffer* b = ctx->m_Buffers[hbuffer & 0xffff];
-        if (version != b->m_Version)
+        Buffer* b;
+        {
+            DM_SPINLOCK_SCOPED_LOCK(ctx->m_Spinlock);
+            b = ctx->m_Buffers[hbuffer & 0xffff];
+            if (version != b->m_Version)
+            {
+                b = 0;
+            }
+            else
+            {
+                ctx->m_Buffers[hbuffer & 0xffff] = 0;
+            }
+        }
+        if (b == 0)
         {
             dmLogError("Stale buffer handle when freeing buffer");
             return;
         }
-        ctx->m_Buffers[hbuffer & 0xffff] = 0;
         dmMemory::AlignedFree(b);
     }
 
@@ -363,16 +380,6 @@ namespace dmBuffer
             return RESULT_BUFFER_SIZE_ERROR;
         }
 
-        uint32_t index = FindEmptySlot(ctx);
-        if( index == 0xFFFFFFFF )
-        {
-            GrowPool(ctx, 64);
-            index = FindEmptySlot(ctx);
-            if( index == 0xFFFFFFFF ) {
-                return RESULT_ALLOCATION_ERROR;
-            }
-        }
-
         // Allocate buffer to fit Buffer-struct, Stream-array and buffer data
         void* data_block = 0x0;
         dmMemory::Result r = dmMemory::AlignedMalloc((void**)&data_block, ADDR_ALIGNMENT, buffer_size);
@@ -390,6 +397,18 @@ namespace dmBuffer
 
         CreateStreamsInterleaved(buffer, streams_decl, offsets);
 
+        DM_SPINLOCK_SCOPED_LOCK(ctx->m_Spinlock);
+        uint32_t index = FindEmptySlot(ctx);
+        if( index == 0xFFFFFFFF )
+        {
+            GrowPool(ctx, 64);
+            index = FindEmptySlot(ctx);
+            if( index == 0xFFFFFFFF ) {
+                dmMemory::AlignedFree(data_block);
+                return RESULT_ALLOCATION_ERROR;
+            }
+        }
+
         *out_buffer = SetBuffer(ctx, index, buffer);
         return RESULT_OK;
     }
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "array.h"
+#include "hashtable.h"
 #include "log.h"
 #include "socket.h"
 #include "math.h"
@@ -39,6 +40,7 @@ namespace dmHttpServer
         Server()
         {
             m_ServerSocket = dmSocket::INVALID_SOCKET_HANDLE;
+            m_Poller = 0;
             m_Reconnect = 0;
         }
         dmSocket::Address   m_Address;
@@ -50,7 +52,12 @@ namespace dmHttpServer
         // Connection timeout in useconds. NOTE: In params it is specified in seconds.
         uint64_t            m_ConnectionTimeout;
         dmArray<Connection> m_Connections;
+        // Socket to index in m_Connections
+        dmHashTable32<uint32_t> m_ConnectionIndices;
         dmSocket::Socket    m_ServerSocket;
+        // The server socket and all connections are registered so that an update only touches the sockets with pending data
+        dmSocket::HPoller   m_Poller;
+        dmArray<dmSocket::PollResult> m_PollResults;
         // Receive and send buffer
         char                m_Buffer[BUFFER_SIZE];
 
@@ -105,6 +112,7 @@ namespace dmHttpServer
     {
         if (server->m_ServerSocket != dmSocket::INVALID_SOCKET_HANDLE)
         {
+            dmSocket::PollerRemove(server->m_Poller, server->m_ServerSocket);
             dmSocket::Delete(server->m_ServerSocket);
             server->m_ServerSocket = dmSocket::INVALID_SOCKET_HANDLE;
         }
@@ -139,7 +147,7 @@ namespace dmHttpServer
             return RESULT_SOCKET_ERROR;
         }
 
-        r = dmSocket::Listen(socket, 32);
+        r = dmSocket::Listen(socket, 128);
         if (r != dmSocket::RESULT_OK)
         {
             dmSocket::Delete(socket);
@@ -155,6 +163,18 @@ namespace dmHttpServer
             return RESULT_SOCKET_ERROR;
         }
 
+        // Non-blocking so that all pending connections can be accepted in one update
+        r = dmSocket::SetBlocking(socket, false);
+        if (r == dmSocket::RESULT_OK)
+        {
+            r = dmSocket::PollerAdd(server->m_Poller, socket, dmSocket::POLL_EVENT_READ);
+        }
+        if (r != dmSocket::RESULT_OK)
+        {
+            dmSocket::Delete(socket);
+            return RESULT_SOCKET_ERROR;
+        }
+
         server->m_Address = address;
         server->m_Port = actual_port;
         server->m_ServerSocket = socket;
@@ -170,8 +190,16 @@ namespace dmHttpServer
             return RESULT_ERROR_INVAL;
 
         Server* ret = new Server();
+        ret->m_Poller = dmSocket::NewPoller();
+        if (!ret->m_Poller)
+        {
+            delete ret;
+            return RESULT_SOCKET_ERROR;
+        }
+
         if (Connect(ret, port) != RESULT_OK)
         {
+            dmSocket::DeletePoller(ret->m_Poller);
             delete ret;
             return RESULT_SOCKET_ERROR;
         }
@@ -181,6 +209,9 @@ namespace dmHttpServer
         ret->m_Userdata = params->m_Userdata;
         ret->m_ConnectionTimeout = params->m_ConnectionTimeout * 1000000U;
         ret->m_Connections.SetCapacity(params->m_MaxConnections);
+        ret->m_ConnectionIndices.SetCapacity(dmMath::Max(1U, params->m_MaxConnections / 2U), params->m_MaxConnections);
+        ret->m_PollResults.SetCapacity(params->m_MaxConnections + 1);
+        ret->m_PollResults.SetSize(params->m_MaxConnections + 1);
 
         *server = ret;
         return RESULT_OK;
@@ -190,6 +221,7 @@ namespace dmHttpServer
     {
         // TODO: Shutdown connections
         dmSocket::Delete(server->m_ServerSocket);
+        dmSocket::DeletePoller(server->m_Poller);
         delete server;
     }
 
@@ -578,56 +610,77 @@ bail:
         }
     }
 
-    Result Update(HServer server)
+    static void RemoveConnection(Server* server, uint32_t index)
     {
-        if (server->m_Reconnect)
+        Connection* connection = &server->m_Connections[index];
+        dmSocket::PollerRemove(server->m_Poller, connection->m_Socket);
+        dmSocket::Shutdown(connection->m_Socket, dmSocket::SHUTDOWNTYPE_READWRITE);
+        dmSocket::Delete(connection->m_Socket);
+        server->m_ConnectionIndices.Erase(connection->m_Socket);
+
+        server->m_Connections.EraseSwap(index);
+        if (index < server->m_Connections.Size())
         {
-            dmLogWarning("Reconnecting http server (%d)", server->m_Port);
-            Connect(server, server->m_Port);
-            server->m_Reconnect = 0;
-        }
-        dmSocket::Selector selector;
-        dmSocket::SelectorZero(&selector);
-        dmSocket::SelectorSet(&selector, dmSocket::SELECTOR_KIND_READ, server->m_ServerSocket);
-
-        dmSocket::Result r = dmSocket::Select(&selector, 0);
-
-        if (r != dmSocket::RESULT_OK)
-        {
-            return RESULT_SOCKET_ERROR;
+            server->m_ConnectionIndices.Put(server->m_Connections[index].m_Socket, index);
         }
+    }
 
-        // Check for new connections
-        if (dmSocket::SelectorIsSet(&selector, dmSocket::SELECTOR_KIND_READ, server->m_ServerSocket))
+    static void AcceptConnections(Server* server)
+    {
+        for (;;)
         {
             dmSocket::Address address;
             dmSocket::Socket client_socket;
-            r = dmSocket::Accept(server->m_ServerSocket, &address, &client_socket);
-            if (r == dmSocket::RESULT_OK)
+            dmSocket::Result r = dmSocket::Accept(server->m_ServerSocket, &address, &client_socket);
+            if (r == dmSocket::RESULT_WOULDBLOCK || r == dmSocket::RESULT_TRY_AGAIN)
             {
-                if (server->m_Connections.Full())
-                {
-                    dmLogWarning("Out of client connections in http server (max: %d)", server->m_Connections.Capacity());
-                    dmSocket::Shutdown(client_socket, dmSocket::SHUTDOWNTYPE_READWRITE);
-                    dmSocket::Delete(client_socket);
-                }
-                else
-                {
-                    dmSocket::SetNoDelay(client_socket, true);
-                    Connection connection;
-                    memset(&connection, 0, sizeof(connection));
-                    connection.m_Socket = client_socket;
-                    connection.m_ConnectionTimeStart = dmTime::GetTime();
-                    server->m_Connections.Push(connection);
-                }
+                return;
             }
             else if (r == dmSocket::RESULT_CONNABORTED || r == dmSocket::RESULT_NOTCONN)
             {
                 server->m_Reconnect = 1;
+                return;
+            }
+            else if (r != dmSocket::RESULT_OK)
+            {
+                return;
+            }
+
+            if (server->m_Connections.Full())
+            {
+                dmLogWarning("Out of client connections in http server (max: %d)", server->m_Connections.Capacity());
+                dmSocket::Shutdown(client_socket, dmSocket::SHUTDOWNTYPE_READWRITE);
+                dmSocket::Delete(client_socket);
+                continue;
             }
+
+            // Accepted sockets inherit the non-blocking flag of the server socket on some platforms
+            dmSocket::SetBlocking(client_socket, true);
+            dmSocket::SetNoDelay(client_socket, true);
+            if (dmSocket::PollerAdd(server->m_Poller, client_socket, dmSocket::POLL_EVENT_READ) != dmSocket::RESULT_OK)
+            {
+                dmSocket::Shutdown(client_socket, dmSocket::SHUTDOWNTYPE_READWRITE);
+                dmSocket::Delete(client_socket);
+                continue;
+            }
+
+            Connection connection;
+            memset(&connection, 0, sizeof(connection));
+            connection.m_Socket = client_socket;
+            connection.m_ConnectionTimeStart = dmTime::GetTime();
+            server->m_ConnectionIndices.Put(client_socket, server->m_Connections.Size());
+            server->m_Connections.Push(connection);
         }
+    }
 
-        dmSocket::SelectorZero(&selector);
+    Result Update(HServer server)
+    {
+        if (server->m_Reconnect)
+        {
+            dmLogWarning("Reconnecting http server (%d)", server->m_Port);
+            Connect(server, server->m_Port);
+            server->m_Reconnect = 0;
+        }
 
         uint64_t current_time = dmTime::GetTime();
 
@@ -638,38 +691,38 @@ bail:
             uint64_t time_diff = current_time - connection->m_ConnectionTimeStart;
             if (time_diff > server->m_ConnectionTimeout)
             {
-                dmSocket::Shutdown(connection->m_Socket, dmSocket::SHUTDOWNTYPE_READWRITE);
-                dmSocket::Delete(connection->m_Socket);
-                server->m_Connections.EraseSwap(i);
+                RemoveConnection(server, i);
                 --i;
             }
         }
 
-        // Iterate over persistent connections, select phase
-        for (uint32_t i = 0; i < server->m_Connections.Size(); ++i)
-        {
-            Connection* connection = &server->m_Connections[i];
-            dmSocket::SelectorSet(&selector, dmSocket::SELECTOR_KIND_READ, connection->m_Socket);
-        }
-
-        r = dmSocket::Select(&selector, 0);
+        uint32_t result_count = 0;
+        dmSocket::Result r = dmSocket::Poll(server->m_Poller, 0, server->m_PollResults.Begin(), server->m_PollResults.Size(), &result_count);
         if (r != dmSocket::RESULT_OK)
+        {
             return RESULT_SOCKET_ERROR;
+        }
 
-        // Iterate over persistent connections, handle phase
-        for (uint32_t i = 0; i < server->m_Connections.Size(); ++i)
+        // Handle the new connections and the persistent connections with pending data
+        for (uint32_t i = 0; i < result_count; ++i)
         {
-            Connection* connection = &server->m_Connections[i];
-            if (dmSocket::SelectorIsSet(&selector, dmSocket::SELECTOR_KIND_READ, connection->m_Socket))
+            dmSocket::Socket socket = server->m_PollResults[i].m_Socket;
+            if (socket == server->m_ServerSocket)
             {
-                bool keep_connection =  HandleConnection(server, connection);
-                if (!keep_connection)
-                {
-                    dmSocket::Shutdown(connection->m_Socket, dmSocket::SHUTDOWNTYPE_READWRITE);
-                    dmSocket::Delete(connection->m_Socket);
-                    server->m_Connections.EraseSwap(i);
-                    --i;
-                }
+                AcceptConnections(server);
+                continue;
+            }
+
+            uint32_t* index = server->m_ConnectionIndices.Get(socket);
+            if (!index)
+            {
+                continue;
+            }
+
+            bool keep_connection = HandleConnection(server, &server->m_Connections[*index]);
+            if (!keep_connection)
+            {
+                RemoveConnection(server, *index);
             }
         }
         return RESULT_OK;
@@ -0,0 +1,191 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include "job_thread.h"
+
+#include <assert.h>
+#include "array.h"
+#include "atomic.h"
+#include "condition_variable.h"
+#include "dstrings.h"
+#include "mutex.h"
+#include "thread.h"
+
+namespace dmJobThread
+{
+    static const uint32_t THREAD_STACK_SIZE = 0x80000;
+
+    struct Batch
+    {
+        FProcess       m_Process;
+        void*          m_Context;
+        uint32_t       m_Count;
+        int32_atomic_t m_Next;
+        // Number of worker threads currently processing items from the batch, guarded by the mutex
+        uint32_t       m_Active;
+    };
+
+    struct JobContext
+    {
+        dmMutex::HMutex                         m_Mutex;
+        // Signaled when a batch is added or on shutdown
+        dmConditionVariable::HConditionVariable m_WorkCond;
+        // Signaled when a worker thread leaves a batch
+        dmConditionVariable::HConditionVariable m_DoneCond;
+        // Batches that may still have unclaimed items
+        dmArray<Batch*>                         m_Batches;
+        dmArray<dmThread::Thread>               m_Threads;
+        bool                                    m_Shutdown;
+    };
+
+    // Processes items until all are claimed
+    static void ProcessItems(Batch* batch)
+    {
+        const int32_t count = (int32_t) batch->m_Count;
+        for (;;)
+        {
+            int32_t index = dmAtomicIncrement32(&batch->m_Next);
+            if (index >= count)
+                break;
+            batch->m_Process(batch->m_Context, (uint32_t) index);
+        }
+    }
+
+    static void RemoveBatch(JobContext* context, Batch* batch)
+    {
+        for (uint32_t i = 0; i < context->m_Batches.Size(); ++i)
+        {
+            if (context->m_Batches[i] == batch)
+            {
+                context->m_Batches.EraseSwap(i);
+                return;
+            }
+        }
+    }
+
+    static void WorkerThread(void* arg)
+    {
+        JobContext* context = (JobContext*) arg;
+
+        dmMutex::Lock(context->m_Mutex);
+        for (;;)
+        {
+            while (!context->m_Shutdown && context->m_Batches.Empty())
+            {
+                dmConditionVariable::Wait(context->m_WorkCond, context->m_Mutex);
+            }
+            if (context->m_Shutdown)
+                break;
+
+            Batch* batch = context->m_Batches.Back();
+            batch->m_Active++;
+            dmMutex::Unlock(context->m_Mutex);
+
+            ProcessItems(batch);
+
+            dmMutex::Lock(context->m_Mutex);
+            // All items are claimed, no other thread needs to look at the batch
+            RemoveBatch(context, batch);
+            batch->m_Active--;
+            dmConditionVariable::Broadcast(context->m_DoneCond);
+        }
+        dmMutex::Unlock(context->m_Mutex);
+    }
+
+    HContext Create(uint32_t thread_count, const char* name)
+    {
+#if defined(__EMSCRIPTEN__)
+        thread_count = 0;
+#endif
+        JobContext* context = new JobContext;
+        context->m_Mutex    = dmMutex::New();
+        context->m_WorkCond = dmConditionVariable::New();
+        context->m_DoneCond = dmConditionVariable::New();
+        context->m_Shutdown = false;
+        context->m_Batches.SetCapacity(8);
+        context->m_Threads.SetCapacity(thread_count);
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            char thread_name[32];
+            dmSnPrintf(thread_name, sizeof(thread_name), "%s%u", name, i);
+            context->m_Threads.Push(dmThread::New(WorkerThread, THREAD_STACK_SIZE, context, thread_name));
+        }
+        return context;
+    }
+
+    void Destroy(HContext context)
+    {
+        if (!context)
+            return;
+
+        dmMutex::Lock(context->m_Mutex);
+        context->m_Shutdown = true;
+        dmConditionVariable::Broadcast(context->m_WorkCond);
+        dmMutex::Unlock(context->m_Mutex);
+
+        for (uint32_t i = 0; i < context->m_Threads.Size(); ++i)
+        {
+            dmThread::Join(context->m_Threads[i]);
+        }
+        assert(context->m_Batches.Empty());
+
+        dmConditionVariable::Delete(context->m_DoneCond);
+        dmConditionVariable::Delete(context->m_WorkCond);
+        dmMutex::Delete(context->m_Mutex);
+        delete context;
+    }
+
+    uint32_t GetWorkerCount(HContext context)
+    {
+        return context ? context->m_Threads.Size() : 0;
+    }
+
+    void ParallelFor(HContext context, FProcess process, void* process_context, uint32_t count)
+    {
+        if (context == 0 || context->m_Threads.Empty() || count <= 1)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                process(process_context, i);
+            }
+            return;
+        }
+
+        Batch batch;
+        batch.m_Process = process;
+        batch.m_Context = process_context;
+        batch.m_Count   = count;
+        batch.m_Next    = 0;
+        batch.m_Active  = 0;
+
+        dmMutex::Lock(context->m_Mutex);
+        if (context->m_Batches.Full())
+        {
+            context->m_Batches.OffsetCapacity(8);
+        }
+        context->m_Batches.Push(&batch);
+        dmConditionVariable::Broadcast(context->m_WorkCond);
+        dmMutex::Unlock(context->m_Mutex);
+
+        ProcessItems(&batch);
+
+        // The batch lives on this stack, wait for the worker threads to leave it
+        dmMutex::Lock(context->m_Mutex);
+        RemoveBatch(context, &batch);
+        while (batch.m_Active > 0)
+        {
+            dmConditionVariable::Wait(context->m_DoneCond, context->m_Mutex);
+        }
+        dmMutex::Unlock(context->m_Mutex);
+    }
+}
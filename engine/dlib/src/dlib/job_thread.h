@@ -0,0 +1,67 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#ifndef DM_JOB_THREAD_H
+#define DM_JOB_THREAD_H
+
+#include <stdint.h>
+
+/**
+ * Worker threads for splitting CPU heavy work into independent items.
+ * The calling thread takes part in the work and ParallelFor returns once
+ * all items have been processed, so the work is never deferred.
+ */
+namespace dmJobThread
+{
+    typedef struct JobContext* HContext;
+
+    /**
+     * Processes one item of a ParallelFor
+     * @param context User context
+     * @param index Item index
+     */
+    typedef void (*FProcess)(void* context, uint32_t index);
+
+    /**
+     * Create worker threads
+     * @param thread_count Number of worker threads. With zero threads all work is done on the calling thread.
+     * @param name Thread name
+     * @return Job thread context
+     */
+    HContext Create(uint32_t thread_count, const char* name);
+
+    /**
+     * Stop and join the worker threads
+     * @param context Job thread context
+     */
+    void Destroy(HContext context);
+
+    /**
+     * Get the number of worker threads
+     * @param context Job thread context, may be 0
+     * @return Number of worker threads
+     */
+    uint32_t GetWorkerCount(HContext context);
+
+    /**
+     * Call process for every index in [0, count) on the worker threads and the calling thread.
+     * Blocks until all items are processed. Several threads may call ParallelFor at the same time.
+     * @param context Job thread context. If 0 the items are processed on the calling thread.
+     * @param process Item function
+     * @param process_context User context passed to process
+     * @param count Number of items
+     */
+    void ParallelFor(HContext context, FProcess process, void* process_context, uint32_t count);
+}
+
+#endif // DM_JOB_THREAD_H
@@ -12,6 +12,7 @@
 
 #include "socket.h"
 #include "math.h"
+#include "time.h"
 #include "dstrings.h"
 #include "log.h"
 #include <assert.h>
@@ -21,6 +22,10 @@
 
 #if defined(__linux__)
 #include <linux/if.h>
+#include <sys/epoll.h>
+#define DM_SOCKET_EPOLL
+#elif defined(__MACH__) || defined(__EMSCRIPTEN__)
+#include <poll.h>
 #endif
 
 #if defined(__linux__) || defined(__MACH__) || defined(__EMSCRIPTEN__)
@@ -36,6 +41,7 @@
 #include <Winsock2.h>
 #endif
 
+#include "array.h"
 #include "log.h"
 #include "socket_private.h"
 
@@ -632,6 +638,190 @@ namespace dmSocket
         }
     }
 
+#if defined(DM_SOCKET_EPOLL)
+    struct Poller
+    {
+        int                         m_EpollFd;
+        dmArray<struct epoll_event> m_Events;
+    };
+
+    static uint32_t ToEpollEvents(uint32_t events)
+    {
+        return ((events & POLL_EVENT_READ) ? EPOLLIN : 0) | ((events & POLL_EVENT_WRITE) ? EPOLLOUT : 0);
+    }
+
+    HPoller NewPoller()
+    {
+        int fd = epoll_create1(EPOLL_CLOEXEC);
+        if (fd < 0)
+        {
+            dmLogError("Failed to create epoll instance: %s", ResultToString(NATIVETORESULT(DM_SOCKET_ERRNO)));
+            return 0;
+        }
+        Poller* poller = new Poller;
+        poller->m_EpollFd = fd;
+        return poller;
+    }
+
+    void DeletePoller(HPoller poller)
+    {
+        close(poller->m_EpollFd);
+        delete poller;
+    }
+
+    Result PollerAdd(HPoller poller, Socket socket, uint32_t events)
+    {
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = ToEpollEvents(events);
+        event.data.fd = socket;
+        if (epoll_ctl(poller->m_EpollFd, EPOLL_CTL_ADD, socket, &event) < 0)
+        {
+            return NATIVETORESULT(DM_SOCKET_ERRNO);
+        }
+        return RESULT_OK;
+    }
+
+    Result PollerRemove(HPoller poller, Socket socket)
+    {
+        // A non-null event is required by kernels before 2.6.9
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        if (epoll_ctl(poller->m_EpollFd, EPOLL_CTL_DEL, socket, &event) < 0)
+        {
+            return NATIVETORESULT(DM_SOCKET_ERRNO);
+        }
+        return RESULT_OK;
+    }
+
+    Result Poll(HPoller poller, int32_t timeout, PollResult* results, uint32_t max_results, uint32_t* result_count)
+    {
+        *result_count = 0;
+        if (max_results == 0)
+        {
+            return RESULT_INVAL;
+        }
+
+        if (poller->m_Events.Capacity() < max_results)
+        {
+            poller->m_Events.SetCapacity(max_results);
+        }
+        poller->m_Events.SetSize(max_results);
+
+        int timeout_ms = timeout < 0 ? -1 : (timeout + 999) / 1000;
+        int r = epoll_wait(poller->m_EpollFd, poller->m_Events.Begin(), (int) max_results, timeout_ms);
+        if (r < 0)
+        {
+            return NATIVETORESULT(DM_SOCKET_ERRNO);
+        }
+
+        for (int i = 0; i < r; ++i)
+        {
+            const struct epoll_event& event = poller->m_Events[i];
+            PollResult& result = results[i];
+            result.m_Socket = event.data.fd;
+            result.m_Events = ((event.events & (EPOLLIN | EPOLLHUP | EPOLLERR)) ? POLL_EVENT_READ : 0) |
+                              ((event.events & EPOLLOUT) ? POLL_EVENT_WRITE : 0);
+        }
+        *result_count = (uint32_t) r;
+        return (timeout > 0 && r == 0) ? RESULT_WOULDBLOCK : RESULT_OK;
+    }
+#else
+#if defined(_WIN32)
+    typedef WSAPOLLFD PollFd;
+    #define DM_SOCKET_POLL WSAPoll
+#else
+    typedef struct pollfd PollFd;
+    #define DM_SOCKET_POLL poll
+#endif
+
+    struct Poller
+    {
+        dmArray<PollFd> m_PollFds;
+    };
+
+    HPoller NewPoller()
+    {
+        return new Poller;
+    }
+
+    void DeletePoller(HPoller poller)
+    {
+        delete poller;
+    }
+
+    Result PollerAdd(HPoller poller, Socket socket, uint32_t events)
+    {
+        if (poller->m_PollFds.Full())
+        {
+            poller->m_PollFds.OffsetCapacity(dmMath::Max(16U, poller->m_PollFds.Capacity()));
+        }
+        PollFd fd;
+        memset(&fd, 0, sizeof(fd));
+        fd.fd = socket;
+        fd.events = ((events & POLL_EVENT_READ) ? POLLIN : 0) | ((events & POLL_EVENT_WRITE) ? POLLOUT : 0);
+        poller->m_PollFds.Push(fd);
+        return RESULT_OK;
+    }
+
+    Result PollerRemove(HPoller poller, Socket socket)
+    {
+        for (uint32_t i = 0; i < poller->m_PollFds.Size(); ++i)
+        {
+            if (poller->m_PollFds[i].fd == socket)
+            {
+                poller->m_PollFds.EraseSwap(i);
+                return RESULT_OK;
+            }
+        }
+        return RESULT_BADF;
+    }
+
+    Result Poll(HPoller poller, int32_t timeout, PollResult* results, uint32_t max_results, uint32_t* result_count)
+    {
+        *result_count = 0;
+        if (max_results == 0)
+        {
+            return RESULT_INVAL;
+        }
+
+        if (poller->m_PollFds.Empty())
+        {
+            // WSAPoll fails on an empty set, wait like the other platforms
+            if (timeout > 0)
+            {
+                dmTime::Sleep(timeout);
+            }
+            return timeout > 0 ? RESULT_WOULDBLOCK : RESULT_OK;
+        }
+
+        int timeout_ms = timeout < 0 ? -1 : (timeout + 999) / 1000;
+        int r = DM_SOCKET_POLL(poller->m_PollFds.Begin(), poller->m_PollFds.Size(), timeout_ms);
+        if (r < 0)
+        {
+            return NATIVETORESULT(DM_SOCKET_ERRNO);
+        }
+
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < poller->m_PollFds.Size() && count < max_results && count < (uint32_t) r; ++i)
+        {
+            const PollFd& fd = poller->m_PollFds[i];
+            if (fd.revents == 0)
+            {
+                continue;
+            }
+            PollResult& result = results[count++];
+            result.m_Socket = (Socket) fd.fd;
+            result.m_Events = ((fd.revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL)) ? POLL_EVENT_READ : 0) |
+                              ((fd.revents & POLLOUT) ? POLL_EVENT_WRITE : 0);
+        }
+        *result_count = count;
+        return (timeout > 0 && r == 0) ? RESULT_WOULDBLOCK : RESULT_OK;
+    }
+
+#undef DM_SOCKET_POLL
+#endif
+
     Result GetName(Socket socket, Address* address, uint16_t* port)
     {
         int result = -1;
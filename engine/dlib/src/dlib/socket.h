@@ -477,6 +477,71 @@ namespace dmSocket
      */
     Result Select(Selector* selector, int32_t timeout);
 
+    /**
+     * Poller events
+     */
+    enum PollEvent
+    {
+        POLL_EVENT_READ  = (1 << 0),
+        POLL_EVENT_WRITE = (1 << 1),
+    };
+
+    /**
+     * Poller handle. Unlike the Selector, sockets are added once and stay registered until removed,
+     * and the number of sockets is not limited by FD_SETSIZE. Uses epoll on Linux and Android and poll elsewhere.
+     */
+    typedef struct Poller* HPoller;
+
+    /**
+     * Socket with pending events, as returned by Poll()
+     */
+    struct PollResult
+    {
+        Socket   m_Socket;
+        /// Bitmask of PollEvent. Hang-ups and errors are reported as POLL_EVENT_READ
+        uint32_t m_Events;
+    };
+
+    /**
+     * Create a poller
+     * @return Poller handle, 0 on failure
+     */
+    HPoller NewPoller();
+
+    /**
+     * Delete a poller. The sockets are not closed.
+     * @param poller Poller
+     */
+    void DeletePoller(HPoller poller);
+
+    /**
+     * Add a socket to a poller
+     * @param poller Poller
+     * @param socket Socket
+     * @param events Bitmask of PollEvent to wait for
+     * @return RESULT_OK on success
+     */
+    Result PollerAdd(HPoller poller, Socket socket, uint32_t events);
+
+    /**
+     * Remove a socket from a poller. Must be called before the socket is deleted.
+     * @param poller Poller
+     * @param socket Socket
+     * @return RESULT_OK on success
+     */
+    Result PollerRemove(HPoller poller, Socket socket);
+
+    /**
+     * Wait for events on the sockets in a poller
+     * @param poller Poller
+     * @param timeout Timeout in microseconds. For blocking pass -1
+     * @param results Sockets with pending events
+     * @param max_results Size of the results array
+     * @param result_count Number of sockets written to results
+     * @return RESULT_OK on success, RESULT_WOULDBLOCK if the timeout expired
+     */
+    Result Poll(HPoller poller, int32_t timeout, PollResult* results, uint32_t max_results, uint32_t* result_count);
+
     /**
      * Get name, address and port for socket
      * @param socket Socket to get name for
@@ -108,6 +108,26 @@ namespace dmSocket
         return RESULT_OPNOTSUPP;
     }
 
+    HPoller NewPoller() {
+        return 0;
+    }
+
+    void DeletePoller(HPoller poller) {
+    }
+
+    Result PollerAdd(HPoller poller, Socket socket, uint32_t events) {
+        return RESULT_OPNOTSUPP;
+    }
+
+    Result PollerRemove(HPoller poller, Socket socket) {
+        return RESULT_OPNOTSUPP;
+    }
+
+    Result Poll(HPoller poller, int32_t timeout, PollResult* results, uint32_t max_results, uint32_t* result_count) {
+        *result_count = 0;
+        return RESULT_OPNOTSUPP;
+    }
+
     Result GetName(Socket socket, Address*address, uint16_t* port) {
         return RESULT_OPNOTSUPP;
     }
@@ -138,6 +138,7 @@ namespace dmBuffer
     /*# create Buffer
      *
      * Creates a new HBuffer with a number of different streams.
+     * Buffers may be created and destroyed from any thread.
      *
      * @name dmBuffer::Create
      * @param count [type:uint32_t] The number of "structs" the buffer should hold (e.g. vertex count)
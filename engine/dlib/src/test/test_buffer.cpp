@@ -16,6 +16,7 @@
 #include "../dlib/log.h"
 #include "../dlib/hash.h"
 #include "../dlib/buffer.h"
+#include "../dlib/thread.h"
 
 #define RIG_EPSILON 0.0001f
 
@@ -158,6 +159,53 @@ TEST_F(BufferTest, ValidAllocation)
     dmBuffer::Destroy(buffer);
 }
 
+struct CreateThreadContext
+{
+    dmBuffer::HBuffer m_Buffers[256];
+    bool              m_Failed;
+};
+
+static void CreateBuffersThread(void* arg)
+{
+    CreateThreadContext* ctx = (CreateThreadContext*)arg;
+    dmBuffer::StreamDeclaration streams_decl[] = {
+        {dmHashString64("position"), dmBuffer::VALUE_TYPE_FLOAT32, 3}
+    };
+    for (uint32_t i = 0; i < sizeof(ctx->m_Buffers) / sizeof(ctx->m_Buffers[0]); ++i)
+    {
+        if (dmBuffer::Create(16, streams_decl, 1, &ctx->m_Buffers[i]) != dmBuffer::RESULT_OK)
+            ctx->m_Failed = true;
+    }
+}
+
+// Buffers may be created on another thread (e.g. the resource loading thread) while the main thread uses its own
+TEST_F(BufferTest, CreateOnThread)
+{
+    dmBuffer::StreamDeclaration streams_decl[] = {
+        {dmHashString64("texcoord"), dmBuffer::VALUE_TYPE_UINT16, 2}
+    };
+
+    CreateThreadContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    // Creates more buffers than the initial capacity, so the slots grow while they are used here
+    dmThread::Thread thread = dmThread::New(CreateBuffersThread, 0x80000, &ctx, "create");
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        dmBuffer::HBuffer buffer = 0;
+        ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::Create(4, streams_decl, 1, &buffer));
+        ASSERT_TRUE(dmBuffer::IsBufferValid(buffer));
+        dmBuffer::Destroy(buffer);
+    }
+    dmThread::Join(thread);
+
+    ASSERT_FALSE(ctx.m_Failed);
+    for (uint32_t i = 0; i < sizeof(ctx.m_Buffers) / sizeof(ctx.m_Buffers[0]); ++i)
+    {
+        ASSERT_TRUE(dmBuffer::IsBufferValid(ctx.m_Buffers[i]));
+        dmBuffer::Destroy(ctx.m_Buffers[i]);
+    }
+}
+
 TEST_F(BufferTest, ValueTypes)
 {
     dmBuffer::HBuffer buffer = 0;
@@ -343,6 +343,111 @@ TEST_F(dmHttpServerTest, TestServerClient)
     dmThread::Join(thread);
 }
 
+struct LoadTestServer
+{
+    dmHttpServer::HServer m_Server;
+    volatile bool         m_Quit;
+    uint32_t              m_RequestCount;
+};
+
+static void LoadTestResponse(void* user_data, const dmHttpServer::Request* request)
+{
+    LoadTestServer* self = (LoadTestServer*) user_data;
+    ++self->m_RequestCount;
+    dmHttpServer::Send(request, "ok", 2);
+}
+
+static void LoadTestServerThread(void* user_data)
+{
+    LoadTestServer* self = (LoadTestServer*) user_data;
+    while (!self->m_Quit)
+    {
+        dmHttpServer::Update(self->m_Server);
+        dmTime::Sleep(100);
+    }
+}
+
+// Reads a chunked response until the terminating chunk
+static bool ReceiveLoadTestResponse(dmSocket::Socket socket)
+{
+    char buf[256];
+    int total = 0;
+    while (total < (int) sizeof(buf) - 1)
+    {
+        int received = 0;
+        dmSocket::Result r = dmSocket::Receive(socket, buf + total, sizeof(buf) - 1 - total, &received);
+        if (r == dmSocket::RESULT_TRY_AGAIN)
+            continue;
+        if (r != dmSocket::RESULT_OK || received == 0)
+            return false;
+        total += received;
+        buf[total] = '\0';
+        if (strstr(buf, "0\r\n\r\n"))
+            return strncmp(buf, "HTTP/1.1 200", 12) == 0;
+    }
+    return false;
+}
+
+// Many keep-alive connections that all send requests every round
+TEST(dmHttpServerLoadTest, KeepAliveConnections)
+{
+    const uint32_t connection_count = 256;
+    const uint32_t round_count = 20;
+
+    LoadTestServer server;
+    server.m_Quit = false;
+    server.m_RequestCount = 0;
+
+    dmHttpServer::NewParams params;
+    params.m_MaxConnections = connection_count;
+    params.m_Userdata = &server;
+    params.m_HttpResponse = LoadTestResponse;
+    ASSERT_EQ(dmHttpServer::RESULT_OK, dmHttpServer::New(&params, 0, &server.m_Server));
+
+    dmSocket::Address address;
+    uint16_t port;
+    dmHttpServer::GetName(server.m_Server, &address, &port);
+    ASSERT_EQ(dmSocket::RESULT_OK, dmSocket::GetHostByName(DM_LOOPBACK_ADDRESS_IPV4, &address));
+
+    dmThread::Thread thread = dmThread::New(LoadTestServerThread, 0x8000, &server, "load_test");
+
+    dmSocket::Socket sockets[connection_count];
+    for (uint32_t i = 0; i < connection_count; ++i)
+    {
+        ASSERT_EQ(dmSocket::RESULT_OK, dmSocket::New(address.m_family, dmSocket::TYPE_STREAM, dmSocket::PROTOCOL_TCP, &sockets[i]));
+        ASSERT_EQ(dmSocket::RESULT_OK, dmSocket::Connect(sockets[i], address, port));
+    }
+
+    const char* request = "GET /load HTTP/1.1\r\n\r\n";
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t round = 0; round < round_count; ++round)
+    {
+        for (uint32_t i = 0; i < connection_count; ++i)
+        {
+            int sent = 0;
+            ASSERT_EQ(dmSocket::RESULT_OK, dmSocket::Send(sockets[i], request, strlen(request), &sent));
+            ASSERT_EQ((int) strlen(request), sent);
+        }
+        for (uint32_t i = 0; i < connection_count; ++i)
+        {
+            ASSERT_TRUE(ReceiveLoadTestResponse(sockets[i]));
+        }
+    }
+    uint64_t end = dmTime::GetTime();
+
+    for (uint32_t i = 0; i < connection_count; ++i)
+    {
+        dmSocket::Delete(sockets[i]);
+    }
+    server.m_Quit = true;
+    dmThread::Join(thread);
+    dmHttpServer::Delete(server.m_Server);
+
+    ASSERT_EQ(connection_count * round_count, server.m_RequestCount);
+    printf("Bench elapsed: %f ms (%u connections, %f requests/s)\n", (end - start) / 1000.0f, connection_count,
+            (connection_count * round_count) / ((end - start) / 1000000.0f));
+}
+
 int main(int argc, char **argv)
 {
     dmSocket::Initialize();
@@ -0,0 +1,99 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#define JC_TEST_IMPLEMENTATION
+#include <jc_test/jc_test.h>
+#include "../dlib/atomic.h"
+#include "../dlib/job_thread.h"
+#include "../dlib/thread.h"
+
+struct ItemContext
+{
+    uint32_t*      m_Items;
+    int32_atomic_t m_Calls;
+};
+
+static void ProcessItem(void* context, uint32_t index)
+{
+    ItemContext* ctx = (ItemContext*) context;
+    ctx->m_Items[index] += index + 1;
+    dmAtomicIncrement32(&ctx->m_Calls);
+}
+
+// Returns true if every item was processed exactly once
+static bool RunParallelFor(dmJobThread::HContext job_thread, uint32_t count)
+{
+    ItemContext ctx;
+    ctx.m_Items = (uint32_t*) calloc(count, sizeof(uint32_t));
+    ctx.m_Calls = 0;
+    dmJobThread::ParallelFor(job_thread, ProcessItem, &ctx, count);
+    bool ok = ctx.m_Calls == (int32_t) count;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ok = ok && ctx.m_Items[i] == i + 1;
+    }
+    free(ctx.m_Items);
+    return ok;
+}
+
+TEST(dmJobThread, NoContext)
+{
+    ASSERT_EQ(0u, dmJobThread::GetWorkerCount(0));
+    ASSERT_TRUE(RunParallelFor(0, 0));
+    ASSERT_TRUE(RunParallelFor(0, 100));
+}
+
+TEST(dmJobThread, ParallelFor)
+{
+    dmJobThread::HContext job_thread = dmJobThread::Create(3, "test");
+    ASSERT_EQ(3u, dmJobThread::GetWorkerCount(job_thread));
+    const uint32_t counts[] = { 0, 1, 2, 3, 7, 1000, 100000 };
+    for (uint32_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i)
+    {
+        ASSERT_TRUE(RunParallelFor(job_thread, counts[i]));
+    }
+    dmJobThread::Destroy(job_thread);
+}
+
+static dmJobThread::HContext g_JobThread = 0;
+static int32_atomic_t g_Failures = 0;
+
+static void CallerThread(void*)
+{
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        if (!RunParallelFor(g_JobThread, 257))
+            dmAtomicIncrement32(&g_Failures);
+    }
+}
+
+TEST(dmJobThread, ConcurrentCallers)
+{
+    g_JobThread = dmJobThread::Create(2, "test");
+    dmThread::Thread t1 = dmThread::New(CallerThread, 0x80000, 0, "caller1");
+    dmThread::Thread t2 = dmThread::New(CallerThread, 0x80000, 0, "caller2");
+    CallerThread(0);
+    dmThread::Join(t1);
+    dmThread::Join(t2);
+    ASSERT_EQ(0, g_Failures);
+    dmJobThread::Destroy(g_JobThread);
+    g_JobThread = 0;
+}
+
+int main(int argc, char **argv)
+{
+    jc_test_init(&argc, argv);
+    return jc_test_run_all();
+}
@@ -1189,6 +1189,88 @@ TEST(Socket, Timeout)
     dmSocket::Delete(client_socket);
 }
 
+TEST(Socket, Poller_IPv4)
+{
+    dmSocket::HPoller poller = dmSocket::NewPoller();
+    ASSERT_NE((dmSocket::HPoller) 0, poller);
+
+    dmSocket::Socket server_socket;
+    dmSocket::Result r = dmSocket::New(dmSocket::DOMAIN_IPV4, dmSocket::TYPE_STREAM, dmSocket::PROTOCOL_TCP, &server_socket);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    dmSocket::Address bindaddress;
+    r = dmSocket::GetHostByName(DM_UNIVERSAL_BIND_ADDRESS_IPV4, &bindaddress, true, false);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    r = dmSocket::Bind(server_socket, bindaddress, 0);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    r = dmSocket::Listen(server_socket, 1000);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    uint16_t port;
+    dmSocket::Address address;
+    r = dmSocket::GetName(server_socket, &address, &port);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    r = dmSocket::GetHostByName(DM_LOOPBACK_ADDRESS_IPV4, &address, true, false);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    r = dmSocket::PollerAdd(poller, server_socket, dmSocket::POLL_EVENT_READ);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    // Nothing pending
+    dmSocket::PollResult results[4];
+    uint32_t result_count = 0;
+    r = dmSocket::Poll(poller, 1000, results, 4, &result_count);
+    ASSERT_EQ(dmSocket::RESULT_WOULDBLOCK, r);
+    ASSERT_EQ(0u, result_count);
+
+    dmSocket::Socket client_socket;
+    r = dmSocket::New(dmSocket::DOMAIN_IPV4, dmSocket::TYPE_STREAM, dmSocket::PROTOCOL_TCP, &client_socket);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    r = dmSocket::Connect(client_socket, address, port);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    // The pending connection makes the server socket readable
+    r = dmSocket::Poll(poller, -1, results, 4, &result_count);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+    ASSERT_EQ(1u, result_count);
+    ASSERT_EQ(server_socket, results[0].m_Socket);
+    ASSERT_EQ((uint32_t) dmSocket::POLL_EVENT_READ, results[0].m_Events);
+
+    dmSocket::Socket accepted_socket;
+    r = dmSocket::Accept(server_socket, &address, &accepted_socket);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    r = dmSocket::PollerAdd(poller, accepted_socket, dmSocket::POLL_EVENT_READ);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    int sent_bytes = 0;
+    r = dmSocket::Send(client_socket, "x", 1, &sent_bytes);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+
+    // Only the accepted socket has data
+    r = dmSocket::Poll(poller, -1, results, 4, &result_count);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+    ASSERT_EQ(1u, result_count);
+    ASSERT_EQ(accepted_socket, results[0].m_Socket);
+    ASSERT_EQ((uint32_t) dmSocket::POLL_EVENT_READ, results[0].m_Events);
+
+    // Removed sockets are not reported
+    r = dmSocket::PollerRemove(poller, accepted_socket);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+    r = dmSocket::Poll(poller, 0, results, 4, &result_count);
+    ASSERT_EQ(dmSocket::RESULT_OK, r);
+    ASSERT_EQ(0u, result_count);
+
+    dmSocket::DeletePoller(poller);
+    dmSocket::Delete(accepted_socket);
+    dmSocket::Delete(client_socket);
+    dmSocket::Delete(server_socket);
+}
+
 int main(int argc, char **argv)
 {
     dmSocket::Initialize();
@@ -233,8 +233,13 @@ namespace dmEngine
         m_PhysicsContext.m_Context3D = 0x0;
         m_PhysicsContext.m_Debug = false;
         m_PhysicsContext.m_3D = false;
+        m_PhysicsContext.m_UseFixedTimeStep = false;
+        m_PhysicsContext.m_Interpolate = false;
+        m_PhysicsContext.m_Broadphase = dmPhysics::BROADPHASE_TYPE_AXIS_SWEEP;
+        m_PhysicsContext.m_MaxBroadphaseProxies = 1024;
         m_GuiContext.m_GuiContext = 0x0;
         m_GuiContext.m_RenderContext = 0x0;
+        m_JobThread = 0x0;
         m_SpriteContext.m_RenderContext = 0x0;
         m_SpriteContext.m_MaxSpriteCount = 0;
         m_SpineModelContext.m_RenderContext = 0x0;
@@ -319,6 +324,8 @@ namespace dmEngine
             dmResource::DeleteFactory(engine->m_Factory);
         }
 
+        dmJobThread::Destroy(engine->m_JobThread);
+
         if (engine->m_GraphicsContext)
         {
             dmGraphics::CloseWindow(engine->m_GraphicsContext);
@@ -632,6 +639,8 @@ namespace dmEngine
         engine->m_RunWhileIconified = dmConfigFile::GetInt(engine->m_Config, "engine.run_while_iconified", 0);
 #endif
 
+        engine->m_JobThread = dmJobThread::Create(dmConfigFile::GetInt(engine->m_Config, "engine.worker_thread_count", 2), "worker");
+
         dmGameSystem::OnWindowCreated(physical_width, physical_height);
 
         bool setting_vsync = dmConfigFile::GetInt(engine->m_Config, "display.vsync", true);
@@ -677,12 +686,27 @@ namespace dmEngine
         }
 
         SetUpdateFrequency(engine, update_frequency);
+
+        const int32_t max_fixed_update_frequency = 1000;
+        int32_t fixed_update_frequency = dmConfigFile::GetInt(engine->m_Config, "engine.fixed_update_frequency", 60);
+        int32_t clamped_fixed_update_frequency = dmMath::Clamp(fixed_update_frequency, 0, max_fixed_update_frequency);
+        if (clamped_fixed_update_frequency != fixed_update_frequency)
+        {
+            dmLogWarning("Fixed update frequency must be in the range 0 - %d and has been clamped.", max_fixed_update_frequency);
+        }
+        if (clamped_fixed_update_frequency > 0)
+        {
+            engine->m_FixedUpdateAccumulator.m_TimeStep = 1.0f / (float) clamped_fixed_update_frequency;
+            engine->m_FixedUpdateAccumulator.m_MaxSteps = dmMath::Max(1, dmConfigFile::GetInt(engine->m_Config, "engine.max_fixed_update_steps", 5));
+        }
         SetSwapInterval(engine, swap_interval);
 
         const uint32_t max_resources = dmConfigFile::GetInt(engine->m_Config, dmResource::MAX_RESOURCES_KEY, 1024);
         dmResource::NewFactoryParams params;
         int32_t http_cache = dmConfigFile::GetInt(engine->m_Config, "resource.http_cache", 1);
         params.m_MaxResources = max_resources;
+        params.m_PreloaderMaxRequests = dmConfigFile::GetInt(engine->m_Config, "resource.preloader_max_requests", 4096);
+        params.m_PreloaderMaxPaths = dmConfigFile::GetInt(engine->m_Config, "resource.preloader_max_paths", 8192);
         params.m_Flags = 0;
         if (dLib::IsDebugMode())
         {
@@ -690,6 +714,10 @@ namespace dmEngine
             if (http_cache)
                 params.m_Flags |= RESOURCE_FACTORY_FLAGS_HTTP_CACHE;
         }
+        if (dmConfigFile::GetInt(engine->m_Config, "resource.archive_lookup_table", 0))
+        {
+            params.m_Flags |= RESOURCE_FACTORY_FLAGS_ARCHIVE_LOOKUP_TABLE;
+        }
 
 #if defined(DM_RELEASE)
         params.m_ArchiveIndex.m_Data = (const void*) BUILTINS_RELEASE_ARCI;
@@ -873,6 +901,14 @@ namespace dmEngine
         }
         physics_params.m_ContactImpulseLimit = dmConfigFile::GetFloat(engine->m_Config, "physics.contact_impulse_limit", 0.0f);
         physics_params.m_AllowDynamicTransforms = dmConfigFile::GetInt(engine->m_Config, "physics.allow_dynamic_transforms", 0) ? 1 : 0;
+        physics_params.m_VelocityIterations = dmConfigFile::GetInt(engine->m_Config, "physics.velocity_iterations", 10);
+        physics_params.m_PositionIterations = dmConfigFile::GetInt(engine->m_Config, "physics.position_iterations", 10);
+        int32_t solver_thread_count = dmConfigFile::GetInt(engine->m_Config, "physics.solver_thread_count", 0);
+        physics_params.m_SolverThreadCount = (uint32_t) dmMath::Clamp(solver_thread_count, 0, (int32_t) dmPhysics::MAX_SOLVER_THREAD_COUNT);
+        if ((uint32_t) solver_thread_count != physics_params.m_SolverThreadCount)
+        {
+            dmLogWarning("Physics solver thread count must be in the range 0 - %u and has been clamped.", dmPhysics::MAX_SOLVER_THREAD_COUNT);
+        }
         if (dmStrCaseCmp(physics_type, "3D") == 0)
         {
             engine->m_PhysicsContext.m_3D = true;
@@ -893,6 +929,35 @@ namespace dmEngine
         engine->m_PhysicsContext.m_MaxContactPointCount = dmConfigFile::GetInt(engine->m_Config, dmGameSystem::PHYSICS_MAX_CONTACTS_KEY, 128);
         // TODO: Should move inside the ifdef release? Is this usable without the debug callbacks?
         engine->m_PhysicsContext.m_Debug = (bool) dmConfigFile::GetInt(engine->m_Config, "physics.debug", 0);
+        const char* broadphase = dmConfigFile::GetString(engine->m_Config, "physics.broadphase", "axis_sweep");
+        if (strcmp(broadphase, "dbvt") == 0)
+        {
+            engine->m_PhysicsContext.m_Broadphase = dmPhysics::BROADPHASE_TYPE_DBVT;
+        }
+        else if (strcmp(broadphase, "axis_sweep") != 0)
+        {
+            dmLogWarning("Unsupported physics broadphase '%s', defaults to axis_sweep", broadphase);
+        }
+        int32_t max_broadphase_proxies = dmConfigFile::GetInt(engine->m_Config, "physics.max_broadphase_proxies", 1024);
+        engine->m_PhysicsContext.m_MaxBroadphaseProxies = (uint32_t) dmMath::Clamp(max_broadphase_proxies, 2, (int32_t) dmPhysics::MAX_BROADPHASE_PROXIES);
+        if ((uint32_t) max_broadphase_proxies != engine->m_PhysicsContext.m_MaxBroadphaseProxies)
+        {
+            dmLogWarning("Physics max broadphase proxies must be in the range 2 - %u and has been clamped.", dmPhysics::MAX_BROADPHASE_PROXIES);
+        }
+
+        if (dmConfigFile::GetInt(engine->m_Config, "physics.use_fixed_timestep", 0))
+        {
+            // Stepped by the fixed update, on the engine.fixed_update_frequency clock
+            if (engine->m_FixedUpdateAccumulator.m_TimeStep > 0.0f)
+            {
+                engine->m_PhysicsContext.m_UseFixedTimeStep = true;
+                engine->m_PhysicsContext.m_Interpolate = (bool) dmConfigFile::GetInt(engine->m_Config, "physics.interpolate", 1);
+            }
+            else
+            {
+                dmLogWarning("Fixed time step physics requires the fixed update, the physics will be stepped once per frame.");
+            }
+        }
 
 #if !defined(DM_RELEASE)
         dmPhysics::DebugCallbacks debug_callbacks;
@@ -937,6 +1002,10 @@ namespace dmEngine
 
         engine->m_CollectionProxyContext.m_Factory = engine->m_Factory;
         engine->m_CollectionProxyContext.m_MaxCollectionProxyCount = dmConfigFile::GetInt(engine->m_Config, dmGameSystem::COLLECTION_PROXY_MAX_COUNT_KEY, 8);
+        if (dmConfigFile::GetInt(engine->m_Config, dmGameSystem::COLLECTION_PROXY_PARALLEL_UPDATE_KEY, 0))
+        {
+            engine->m_CollectionProxyContext.m_JobThread = engine->m_JobThread;
+        }
 
         engine->m_FactoryContext.m_MaxFactoryCount = dmConfigFile::GetInt(engine->m_Config, dmGameSystem::FACTORY_MAX_COUNT_KEY, 128);
         engine->m_CollectionFactoryContext.m_MaxCollectionFactoryCount = dmConfigFile::GetInt(engine->m_Config, dmGameSystem::COLLECTION_FACTORY_MAX_COUNT_KEY, 128);
@@ -957,7 +1026,8 @@ namespace dmEngine
         fact_result = dmGameObject::RegisterResourceTypes(engine->m_Factory, engine->m_Register, engine->m_GOScriptContext, &engine->m_ModuleContext);
         if (fact_result != dmResource::RESULT_OK)
             goto bail;
-        fact_result = dmGameSystem::RegisterResourceTypes(engine->m_Factory, engine->m_RenderContext, &engine->m_GuiContext, engine->m_InputContext, &engine->m_PhysicsContext);
+        engine->m_TextureContext.m_JobThread = engine->m_JobThread;
+        fact_result = dmGameSystem::RegisterResourceTypes(engine->m_Factory, engine->m_RenderContext, &engine->m_GuiContext, engine->m_InputContext, &engine->m_PhysicsContext, &engine->m_TextureContext);
         if (fact_result != dmResource::RESULT_OK)
             goto bail;
 
@@ -1351,8 +1421,21 @@ bail:
                     }
 
 
+                    uint32_t fixed_step_count = dmGameObject::AccumulateFixedUpdate(&engine->m_FixedUpdateAccumulator, dt);
+                    if (fixed_step_count > 0)
+                    {
+                        DM_PROFILE(Engine, "FixedUpdate");
+                        dmGameObject::UpdateContext fixed_update_context;
+                        fixed_update_context.m_DT = engine->m_FixedUpdateAccumulator.m_TimeStep;
+                        for (uint32_t i = 0; i < fixed_step_count; ++i)
+                        {
+                            dmGameObject::FixedUpdate(engine->m_MainCollection, &fixed_update_context);
+                        }
+                    }
+
                     dmGameObject::UpdateContext update_context;
                     update_context.m_DT = dt;
+                    update_context.m_FixedUpdateFraction = dmGameObject::GetFixedUpdateFraction(&engine->m_FixedUpdateAccumulator);
                     dmGameObject::Update(engine->m_MainCollection, &update_context);
 
                     // Don't render while iconified
@@ -16,6 +16,7 @@
 #include <stdint.h>
 
 #include <dlib/configfile.h>
+#include <dlib/job_thread.h>
 #include <dlib/hashtable.h>
 #include <dlib/message.h>
 
@@ -131,6 +132,9 @@ namespace dmEngine
         dmScript::HContext                          m_GuiScriptContext;
         dmResource::HFactory                        m_Factory;
         dmGameSystem::GuiContext                    m_GuiContext;
+        dmGameSystem::TextureContext                m_TextureContext;
+        /// Worker threads for CPU heavy work, e.g. texture decoding
+        dmJobThread::HContext                       m_JobThread;
         dmMessage::HSocket                          m_SystemSocket;
         dmGameSystem::SpriteContext                 m_SpriteContext;
         dmGameSystem::CollectionProxyContext        m_CollectionProxyContext;
@@ -164,6 +168,7 @@ namespace dmEngine
         uint64_t                                    m_PreviousRenderTime;
         uint64_t                                    m_FlipTime;
         uint32_t                                    m_UpdateFrequency;
+        dmGameObject::FixedUpdateAccumulator        m_FixedUpdateAccumulator;   //!< Zero time step if the fixed update is disabled
         uint32_t                                    m_Width;
         uint32_t                                    m_Height;
         uint32_t                                    m_ClearColor;
@@ -335,6 +335,55 @@ TEST_F(EngineTest, ISSUE_4775)
     ASSERT_EQ(0, dmEngine::Launch(sizeof(argv)/sizeof(argv[0]), (char**)argv, 0, 0, 0));
 }
 
+// Stops the engine before the first frame, the config has been read by then
+static void PreRunSolverThreadCount(dmEngine::HEngine engine, void* ctx)
+{
+    *((uint32_t*) ctx) = dmPhysics::GetSolverThreadCount2D(engine->m_PhysicsContext.m_Context2D);
+    engine->m_Alive = false;
+}
+
+TEST_F(EngineTest, PhysicsSolverThreadCountConfig)
+{
+    // Out of range values are clamped when the config is read, a negative value must not wrap to a huge count
+    const char* configs[] = {
+        "--config=physics.solver_thread_count=-1",
+        "--config=physics.solver_thread_count=1000",
+        "--config=physics.solver_thread_count=2",
+    };
+    const uint32_t expected_counts[] = {0, dmPhysics::MAX_SOLVER_THREAD_COUNT, 2};
+    for (uint32_t i = 0; i < sizeof(configs) / sizeof(configs[0]); ++i)
+    {
+        uint32_t thread_count = ~0u;
+        const char* argv[] = {"test_engine", configs[i], "--config=dmengine.unload_builtins=0", CONTENT_ROOT "/game.projectc"};
+        ASSERT_EQ(0, dmEngine::Launch(sizeof(argv)/sizeof(argv[0]), (char**)argv, PreRunSolverThreadCount, 0, &thread_count));
+        ASSERT_EQ(expected_counts[i], thread_count);
+    }
+}
+
+static void PreRunMaxBroadphaseProxies(dmEngine::HEngine engine, void* ctx)
+{
+    *((uint32_t*) ctx) = engine->m_PhysicsContext.m_MaxBroadphaseProxies;
+    engine->m_Alive = false;
+}
+
+TEST_F(EngineTest, PhysicsMaxBroadphaseProxiesConfig)
+{
+    // Out of range values are clamped when the config is read, a negative value must not wrap to a huge count
+    const char* configs[] = {
+        "--config=physics.max_broadphase_proxies=-1",
+        "--config=physics.max_broadphase_proxies=1000000",
+        "--config=physics.max_broadphase_proxies=4096",
+    };
+    const uint32_t expected_counts[] = {2, dmPhysics::MAX_BROADPHASE_PROXIES, 4096};
+    for (uint32_t i = 0; i < sizeof(configs) / sizeof(configs[0]); ++i)
+    {
+        uint32_t max_proxies = 0;
+        const char* argv[] = {"test_engine", configs[i], "--config=dmengine.unload_builtins=0", CONTENT_ROOT "/game.projectc"};
+        ASSERT_EQ(0, dmEngine::Launch(sizeof(argv)/sizeof(argv[0]), (char**)argv, PreRunMaxBroadphaseProxies, 0, &max_proxies));
+        ASSERT_EQ(expected_counts[i], max_proxies);
+    }
+}
+
 int main(int argc, char **argv)
 {
     dmProfile::Initialize(256, 1024 * 16, 128);
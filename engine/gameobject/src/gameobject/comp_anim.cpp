@@ -18,6 +18,7 @@
 
 #include <script/script.h>
 
+#include "gameobject_private.h"
 #include "gameobject_script.h"
 #include "gameobject_props_lua.h"
 
@@ -33,27 +34,27 @@ namespace dmGameObject
 #define MAX_CAPACITY 65000u
 #define MIN_CAPACITY_GROWTH 2048u
 
+    /*
+     * Animations are stored as parallel arrays with the same indexing. m_Animations holds the
+     * target, callbacks and list links, while the data touched every frame is kept in separate
+     * float arrays (SoA) so that the evaluation passes below are tight loops over contiguous memory.
+     */
     struct Animation
     {
         HInstance           m_Instance;
         dmhash_t            m_ComponentId;
         dmhash_t            m_PropertyId;
-        Playback            m_Playback;
         dmEasing::Curve     m_Easing;
-        float*              m_Value;
-        float               m_From;
-        float               m_To;
-        float               m_Delay;
-        float               m_Cursor;
-        float               m_Duration;
-        float               m_InvDuration;
         AnimationStopped    m_AnimationStopped;
         void*               m_Userdata1;
         void*               m_Userdata2;
+        Playback            m_Playback;
         uint16_t            m_PreviousListener;
         uint16_t            m_NextListener;
         uint16_t            m_Index;
+        // Links in the list of animations of the instance, m_Prev of the list head is the tail
         uint16_t            m_Next;
+        uint16_t            m_Prev;
         uint16_t            m_Playing : 1;
         uint16_t            m_Finished : 1;
         uint16_t            m_Composite : 1;
@@ -64,6 +65,18 @@ namespace dmGameObject
     struct AnimWorld
     {
         dmArray<Animation>                  m_Animations;
+        // Per frame data, parallel to m_Animations
+        dmArray<float*>                     m_ValuePtrs;
+        dmArray<float>                      m_From;
+        dmArray<float>                      m_To;
+        dmArray<float>                      m_Delay;
+        dmArray<float>                      m_Cursor;
+        dmArray<float>                      m_Duration;
+        dmArray<float>                      m_InvDuration;
+        // Normalized time, eased and then evaluated in place during update
+        dmArray<float>                      m_T;
+        // Indices of the animations evaluated in the current update
+        dmArray<uint16_t>                   m_Evaluate;
         dmArray<uint16_t>                   m_AnimMap;
         dmIndexPool<uint16_t>               m_AnimMapIndexPool;
         dmHashTable<uintptr_t, uint16_t>    m_InstanceToIndex;
@@ -71,6 +84,99 @@ namespace dmGameObject
         uint32_t                            m_InUpdate : 1;
     };
 
+    static void SetAnimationCapacity(AnimWorld* world, uint32_t capacity)
+    {
+        world->m_Animations.SetCapacity(capacity);
+        world->m_ValuePtrs.SetCapacity(capacity);
+        world->m_From.SetCapacity(capacity);
+        world->m_To.SetCapacity(capacity);
+        world->m_Delay.SetCapacity(capacity);
+        world->m_Cursor.SetCapacity(capacity);
+        world->m_Duration.SetCapacity(capacity);
+        world->m_InvDuration.SetCapacity(capacity);
+        world->m_T.SetCapacity(capacity);
+        world->m_Evaluate.SetCapacity(capacity);
+    }
+
+    static void SetAnimationCount(AnimWorld* world, uint32_t count)
+    {
+        world->m_Animations.SetSize(count);
+        world->m_ValuePtrs.SetSize(count);
+        world->m_From.SetSize(count);
+        world->m_To.SetSize(count);
+        world->m_Delay.SetSize(count);
+        world->m_Cursor.SetSize(count);
+        world->m_Duration.SetSize(count);
+        world->m_InvDuration.SetSize(count);
+        world->m_T.SetSize(count);
+    }
+
+    // Removes the animation at anim_index by swapping in the last one
+    static void EraseAnimation(AnimWorld* world, uint32_t anim_index)
+    {
+        world->m_Animations.EraseSwap(anim_index);
+        world->m_ValuePtrs.EraseSwap(anim_index);
+        world->m_From.EraseSwap(anim_index);
+        world->m_To.EraseSwap(anim_index);
+        world->m_Delay.EraseSwap(anim_index);
+        world->m_Cursor.EraseSwap(anim_index);
+        world->m_Duration.EraseSwap(anim_index);
+        world->m_InvDuration.EraseSwap(anim_index);
+        world->m_T.EraseSwap(anim_index);
+        if (anim_index < world->m_Animations.Size())
+        {
+            // We swapped, update the map of the moved animation
+            world->m_AnimMap[world->m_Animations[anim_index].m_Index] = anim_index;
+        }
+    }
+
+    static void AddToInstanceList(AnimWorld* world, HInstance instance, uint16_t index)
+    {
+        Animation& anim = world->m_Animations[world->m_AnimMap[index]];
+        anim.m_Next = INVALID_INDEX;
+        uint16_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)instance);
+        if (head_ptr == 0x0)
+        {
+            world->m_InstanceToIndex.Put((uintptr_t)instance, index);
+            anim.m_Prev = index;
+        }
+        else
+        {
+            Animation& head = world->m_Animations[world->m_AnimMap[*head_ptr]];
+            uint16_t tail = head.m_Prev;
+            world->m_Animations[world->m_AnimMap[tail]].m_Next = index;
+            anim.m_Prev = tail;
+            head.m_Prev = index;
+        }
+    }
+
+    static void RemoveFromInstanceList(AnimWorld* world, Animation* anim)
+    {
+        uint16_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)anim->m_Instance);
+        uint16_t prev = anim->m_Prev;
+        uint16_t next = anim->m_Next;
+        if (*head_ptr == anim->m_Index)
+        {
+            // Remove instance when the list is empty
+            if (next == INVALID_INDEX)
+            {
+                world->m_InstanceToIndex.Erase((uintptr_t)anim->m_Instance);
+                return;
+            }
+            *head_ptr = next;
+            // The new head keeps track of the tail
+            world->m_Animations[world->m_AnimMap[next]].m_Prev = prev;
+        }
+        else
+        {
+            world->m_Animations[world->m_AnimMap[prev]].m_Next = next;
+            if (next != INVALID_INDEX)
+                world->m_Animations[world->m_AnimMap[next]].m_Prev = prev;
+            else
+                world->m_Animations[world->m_AnimMap[*head_ptr]].m_Prev = prev;
+        }
+    }
+
     CreateResult CompAnimNewWorld(const ComponentNewWorldParams& params)
     {
         if (params.m_World != 0x0)
@@ -78,7 +184,7 @@ namespace dmGameObject
             AnimWorld* world = new AnimWorld();
             *params.m_World = world;
             const uint32_t anim_count = 512;
-            world->m_Animations.SetCapacity(anim_count);
+            SetAnimationCapacity(world, anim_count);
             world->m_AnimMap.SetCapacity(MAX_CAPACITY);
             world->m_AnimMap.SetSize(MAX_CAPACITY);
             world->m_AnimMapIndexPool.SetCapacity(MAX_CAPACITY);
@@ -167,7 +273,10 @@ namespace dmGameObject
          * have an incorrect value when read by the newly started animation to
          * retrieve the from-value.
          *
-         * The second pass advances and evaluates the animations.
+         * The second pass advances and evaluates the animations. It is split into
+         * advancing the cursors, easing, interpolating and finally writing the values,
+         * where the interpolation runs over all animations in one branch free loop and
+         * the property writes are batched by target.
          *
          * The third pass prunes stopped animations and call callbacks.
          *
@@ -179,15 +288,15 @@ namespace dmGameObject
         uint32_t size = world->m_Animations.Size();
         uint32_t orig_size = size;
         DM_COUNTER("animc", size);
+        const float frame_dt = params.m_UpdateContext->m_DT;
         uint32_t i = 0;
         for (i = 0; i < size; ++i)
         {
             Animation& anim = world->m_Animations[i];
             if (!anim.m_Playing)
                 continue;
-            float dt = params.m_UpdateContext->m_DT;
             // Check delay
-            if (anim.m_Delay > dt)
+            if (world->m_Delay[i] > frame_dt)
             {
                 continue;
             }
@@ -197,13 +306,14 @@ namespace dmGameObject
                 // Update from-value
                 if (!anim.m_Composite)
                 {
-                    if (anim.m_Value != 0x0)
-                        anim.m_From = *anim.m_Value;
+                    float* value_ptr = world->m_ValuePtrs[i];
+                    if (value_ptr != 0x0)
+                        world->m_From[i] = *value_ptr;
                     else
                     {
                         PropertyDesc desc;
                         GetProperty(anim.m_Instance, anim.m_ComponentId, anim.m_PropertyId, desc);
-                        anim.m_From = (float)desc.m_Variant.m_Number;
+                        world->m_From[i] = (float)desc.m_Variant.m_Number;
                     }
                 }
                 // Cancel other currently playing animations
@@ -216,7 +326,7 @@ namespace dmGameObject
                         uint16_t anim_index = world->m_AnimMap[index];
                         Animation* a2 = &world->m_Animations[anim_index];
                         if (anim_index != i && !a2->m_FirstUpdate && a2->m_ComponentId == anim.m_ComponentId
-                                && a2->m_PropertyId == anim.m_PropertyId && a2->m_Delay <= 0.0f)
+                                && a2->m_PropertyId == anim.m_PropertyId && world->m_Delay[anim_index] <= 0.0f)
                         {
                             StopAnimation(a2, false);
                         }
@@ -225,58 +335,67 @@ namespace dmGameObject
                 }
             }
         }
-        i = 0;
+
+        // Advance cursors and compute the normalized time of the animations to evaluate
+        Animation* animations = world->m_Animations.Begin();
+        float* delays = world->m_Delay.Begin();
+        float* cursors = world->m_Cursor.Begin();
+        const float* durations = world->m_Duration.Begin();
+        const float* inv_durations = world->m_InvDuration.Begin();
+        float* ts = world->m_T.Begin();
+        world->m_Evaluate.SetSize(0);
         for (i = 0; i < size; ++i)
         {
-            Animation& anim = world->m_Animations[i];
+            Animation& anim = animations[i];
             // Ignore canceled or delayed animations
             if (!anim.m_Playing)
                 continue;
-            float dt = params.m_UpdateContext->m_DT;
-            if (anim.m_Delay > dt)
+            float dt = frame_dt;
+            if (delays[i] > dt)
             {
-                anim.m_Delay -= dt;
+                delays[i] -= dt;
                 continue;
             }
             // Take care of possible underflow
-            dt -= anim.m_Delay;
+            dt -= delays[i];
             // Reset delay
-            anim.m_Delay = 0.0f;
+            delays[i] = 0.0f;
             // Advance cursor
             if (anim.m_Playback != PLAYBACK_NONE)
             {
-                anim.m_Cursor += dt;
+                cursors[i] += dt;
             }
             // Adjust cursor
             bool completed = false;
+            const float duration = durations[i];
 
             switch (anim.m_Playback)
             {
             case PLAYBACK_ONCE_FORWARD:
             case PLAYBACK_ONCE_BACKWARD:
             case PLAYBACK_ONCE_PINGPONG:
-                if (anim.m_Cursor >= anim.m_Duration)
+                if (cursors[i] >= duration)
                 {
-                    anim.m_Cursor = anim.m_Duration;
+                    cursors[i] = duration;
                     completed = true;
                 }
                 break;
             case PLAYBACK_LOOP_FORWARD:
             case PLAYBACK_LOOP_BACKWARD:
-                if (anim.m_Duration > 0)
+                if (duration > 0)
                 {
-                    while (anim.m_Cursor >= anim.m_Duration)
+                    while (cursors[i] >= duration)
                     {
-                        anim.m_Cursor -= anim.m_Duration;
+                        cursors[i] -= duration;
                     }
                 }
                 break;
             case PLAYBACK_LOOP_PINGPONG:
-                if (anim.m_Duration > 0)
+                if (duration > 0)
                 {
-                    while (anim.m_Cursor >= anim.m_Duration)
+                    while (cursors[i] >= duration)
                     {
-                        anim.m_Cursor -= anim.m_Duration;
+                        cursors[i] -= duration;
                         anim.m_Backwards = ~anim.m_Backwards;
                     }
                 }
@@ -285,12 +404,11 @@ namespace dmGameObject
                 break;
             }
 
-            // Evaluate animation
             if (!anim.m_Composite)
             {
                 float t = 1.0f;
-                if (anim.m_Cursor < anim.m_Duration)
-                    t = dmMath::Clamp(anim.m_Cursor * anim.m_InvDuration, 0.0f, 1.0f);
+                if (cursors[i] < duration)
+                    t = dmMath::Clamp(cursors[i] * inv_durations[i], 0.0f, 1.0f);
                 if (anim.m_Backwards)
                     t = 1.0f - t;
                 if (anim.m_Playback == PLAYBACK_ONCE_PINGPONG || anim.m_Playback == PLAYBACK_LOOP_PINGPONG) {
@@ -299,22 +417,68 @@ namespace dmGameObject
                         t = 2.0f - t;
                     }
                 }
-                t = dmEasing::GetValue(anim.m_Easing, t);
-                float v = anim.m_From + (anim.m_To - anim.m_From) * t;
-                if (anim.m_Value != 0x0)
-                {
-                    *anim.m_Value = v;
-                }
-                else
-                {
-                    SetProperty(anim.m_Instance, anim.m_ComponentId, anim.m_PropertyId, PropertyVar(v));
-                }
+                ts[i] = t;
+                world->m_Evaluate.Push((uint16_t)i);
             }
             if (completed)
             {
                 StopAnimation(&anim, true);
             }
         }
+
+        const uint32_t evaluate_count = world->m_Evaluate.Size();
+        const uint16_t* evaluate = world->m_Evaluate.Begin();
+
+        // Ease
+        for (uint32_t e = 0; e < evaluate_count; ++e)
+        {
+            uint16_t index = evaluate[e];
+            const dmEasing::Curve& easing = animations[index].m_Easing;
+            ts[index] = dmEasing::GetValue(easing, ts[index]);
+        }
+
+        // Interpolate
+        const float* from = world->m_From.Begin();
+        const float* to = world->m_To.Begin();
+        for (uint32_t e = 0; e < evaluate_count; ++e)
+        {
+            uint16_t index = evaluate[e];
+            ts[index] = from[index] + (to[index] - from[index]) * ts[index];
+        }
+
+        // Write the values, resolving the target component once per run of animations on the same target
+        float* const* value_ptrs = world->m_ValuePtrs.Begin();
+        HInstance target_instance = 0x0;
+        dmhash_t target_component_id = 0;
+        uint16_t target_component_index = INVALID_INDEX;
+        for (uint32_t e = 0; e < evaluate_count; ++e)
+        {
+            uint16_t index = evaluate[e];
+            float* value_ptr = value_ptrs[index];
+            if (value_ptr != 0x0)
+            {
+                *value_ptr = ts[index];
+                continue;
+            }
+            Animation& anim = animations[index];
+            if (anim.m_ComponentId == 0)
+            {
+                SetProperty(anim.m_Instance, 0, anim.m_PropertyId, PropertyVar(ts[index]));
+                continue;
+            }
+            if (anim.m_Instance != target_instance || anim.m_ComponentId != target_component_id)
+            {
+                target_instance = anim.m_Instance;
+                target_component_id = anim.m_ComponentId;
+                if (GetComponentIndex(target_instance, target_component_id, &target_component_index) != RESULT_OK)
+                    target_component_index = INVALID_INDEX;
+            }
+            if (target_component_index != INVALID_INDEX)
+            {
+                SetComponentProperty(anim.m_Instance, target_component_index, anim.m_PropertyId, PropertyVar(ts[index]));
+            }
+        }
+
         i = 0;
         // Prune canceled animations and call callbacks
         while (i < size)
@@ -338,34 +502,11 @@ namespace dmGameObject
                         anim->m_Easing.release_callback(&anim->m_Easing);
                     }
                 }
-                uint16_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)anim->m_Instance);
-                uint16_t* index_ptr = head_ptr;
-                while (*index_ptr != INVALID_INDEX)
-                {
-                    if (*index_ptr == anim->m_Index)
-                    {
-                        *index_ptr = anim->m_Next;
-                        world->m_AnimMapIndexPool.Push(anim->m_Index);
-                        break;
-                    }
-                    else
-                    {
-                        index_ptr = &world->m_Animations[world->m_AnimMap[*index_ptr]].m_Next;
-                    }
-                }
-                // Remove instance when the list is empty
-                if (*head_ptr == INVALID_INDEX)
-                {
-                    world->m_InstanceToIndex.Erase((uintptr_t)anim->m_Instance);
-                }
-                // delete the instance from the list
-                anim = &world->m_Animations.EraseSwap(i);
+                RemoveFromInstanceList(world, anim);
+                world->m_AnimMapIndexPool.Push(anim->m_Index);
+                // delete the animation from the list
+                EraseAnimation(world, i);
                 --size;
-                if (size > i)
-                {
-                    // We swapped, anim points to the swapped animation, update its map
-                    world->m_AnimMap[anim->m_Index] = i;
-                }
             }
             else
             {
@@ -407,27 +548,12 @@ namespace dmGameObject
             dmLogError("Animation could not be stored since the buffer is full (%d).", MAX_CAPACITY);
             return false;
         }
-        uint16_t index = world->m_AnimMapIndexPool.Pop();
-        uint16_t* index_ptr = world->m_InstanceToIndex.Get((uintptr_t)instance);
-        if (index_ptr == 0x0)
+        if (world->m_InstanceToIndex.Get((uintptr_t)instance) == 0x0 && world->m_InstanceToIndex.Full())
         {
-            if (world->m_InstanceToIndex.Full())
-            {
-                dmLogError("Animation could not be stored since the instance buffer is full (%d).", world->m_InstanceToIndex.Size());
-                world->m_AnimMapIndexPool.Push(index);
-                return false;
-            }
-            world->m_InstanceToIndex.Put((uintptr_t)instance, index);
-        }
-        else
-        {
-            Animation* last_anim = &world->m_Animations[world->m_AnimMap[*index_ptr]];
-            while (last_anim->m_Next != INVALID_INDEX)
-            {
-                last_anim = &world->m_Animations[world->m_AnimMap[last_anim->m_Next]];
-            }
-            last_anim->m_Next = index;
+            dmLogError("Animation could not be stored since the instance buffer is full (%d).", world->m_InstanceToIndex.Size());
+            return false;
         }
+        uint16_t index = world->m_AnimMapIndexPool.Pop();
 
         if (world->m_Animations.Full())
         {
@@ -435,10 +561,10 @@ namespace dmGameObject
             uint32_t capacity = world->m_Animations.Capacity();
             uint32_t growth = dmMath::Min(MIN_CAPACITY_GROWTH, (MIN_CAPACITY_GROWTH + capacity / 2) / 2);
             capacity = dmMath::Min(capacity + growth, MAX_CAPACITY);
-            world->m_Animations.SetCapacity(capacity);
+            SetAnimationCapacity(world, capacity);
         }
         uint32_t anim_count = top + 1;
-        world->m_Animations.SetSize(anim_count);
+        SetAnimationCount(world, anim_count);
 
         Animation& animation = world->m_Animations[top];
         memset(&animation, 0, sizeof(Animation));
@@ -451,30 +577,31 @@ namespace dmGameObject
         animation.m_PropertyId = property_id;
         animation.m_Playback = playback;
         animation.m_Easing = easing;
-        animation.m_Value = value;
-        animation.m_From = from;
-        animation.m_To = to;
-        animation.m_Delay = dmMath::Max(delay, 0.0f);
-        animation.m_Duration = dmMath::Max(duration, 0.0f);
-        animation.m_InvDuration = 0.0f;
-        if (animation.m_Duration > 0.0f)
-            animation.m_InvDuration = 1.0f / animation.m_Duration;
         animation.m_AnimationStopped = animation_stopped;
         animation.m_Userdata1 = userdata1;
         animation.m_Userdata2 = userdata2;
         animation.m_PreviousListener = INVALID_INDEX;
         animation.m_NextListener = INVALID_INDEX;
-        animation.m_Next = INVALID_INDEX;
         animation.m_Playing = 1;
         animation.m_Composite = composite ? 1 : 0;
         if (animation.m_Playback == PLAYBACK_ONCE_BACKWARD || animation.m_Playback == PLAYBACK_LOOP_BACKWARD)
             animation.m_Backwards = 1;
         animation.m_FirstUpdate = 1;
 
-
+        float anim_duration = dmMath::Max(duration, 0.0f);
+        world->m_ValuePtrs[top] = value;
+        world->m_From[top] = from;
+        world->m_To[top] = to;
+        world->m_Delay[top] = dmMath::Max(delay, 0.0f);
+        world->m_Cursor[top] = 0.0f;
+        world->m_Duration[top] = anim_duration;
+        world->m_InvDuration[top] = anim_duration > 0.0f ? 1.0f / anim_duration : 0.0f;
+        world->m_T[top] = 0.0f;
+
+        AddToInstanceList(world, instance, index);
         if (0x0 != animation_stopped)
         {
-            index_ptr = world->m_ListenerInstanceToIndex.Get((uintptr_t)userdata1);
+            uint16_t* index_ptr = world->m_ListenerInstanceToIndex.Get((uintptr_t)userdata1);
             if (0x0 == index_ptr)
             {
                 if (world->m_ListenerInstanceToIndex.Full())
@@ -633,7 +760,6 @@ namespace dmGameObject
             uint16_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)instance);
             if (head_ptr != 0x0)
             {
-                uint32_t anim_count = world->m_Animations.Size();
                 uint16_t index = *head_ptr;
                 while (index != INVALID_INDEX)
                 {
@@ -652,15 +778,8 @@ namespace dmGameObject
                     }
                     world->m_AnimMapIndexPool.Push(index);
                     index = anim->m_Next;
-                    // delete the instance from the list
-                    anim_index = (uint16_t)(anim - world->m_Animations.Begin());
-                    anim = &world->m_Animations.EraseSwap(anim_index);
-                    --anim_count;
-                    if (anim_count > anim_index)
-                    {
-                        // We swapped, anim points to the swapped animation, update its map
-                        world->m_AnimMap[anim->m_Index] = anim_index;
-                    }
+                    // delete the animation from the list
+                    EraseAnimation(world, (uint32_t)(anim - world->m_Animations.Begin()));
                 }
                 world->m_InstanceToIndex.Erase((uintptr_t)instance);
             }
@@ -118,7 +118,7 @@ namespace dmGameObject
                 lua_rawgeti(L, LUA_REGISTRYINDEX, script_instance->m_InstanceReference);
                 ++arg_count;
             }
-            if (script_function == SCRIPT_FUNCTION_UPDATE)
+            if (script_function == SCRIPT_FUNCTION_UPDATE || script_function == SCRIPT_FUNCTION_FIXED_UPDATE)
             {
                 lua_pushnumber(L, params.m_UpdateContext->m_DT);
                 ++arg_count;
@@ -240,6 +240,37 @@ namespace dmGameObject
         return result;
     }
 
+    UpdateResult CompScriptFixedUpdate(const ComponentsUpdateParams& params, ComponentsUpdateResult& update_result)
+    {
+        lua_State* L = GetLuaState(params.m_Context);
+        int top = lua_gettop(L);
+        (void)top;
+        UpdateResult result = UPDATE_RESULT_OK;
+        RunScriptParams run_params;
+        run_params.m_UpdateContext = params.m_UpdateContext;
+        CompScriptWorld* script_world = (CompScriptWorld*)params.m_World;
+
+        bool ran_script = false;
+        uint32_t size = script_world->m_Instances.Size();
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            HScriptInstance script_instance = script_world->m_Instances[i];
+            if (script_instance->m_Update && script_instance->m_Script->m_FunctionReferences[SCRIPT_FUNCTION_FIXED_UPDATE] != LUA_NOREF) {
+                ScriptResult ret = RunScript(L, script_instance->m_Script, SCRIPT_FUNCTION_FIXED_UPDATE, script_instance, run_params);
+                if (ret == SCRIPT_RESULT_FAILED)
+                {
+                    result = UPDATE_RESULT_UNKNOWN_ERROR;
+                }
+                ran_script = true;
+            }
+        }
+
+        update_result.m_TransformsUpdated = ran_script;
+
+        assert(top == lua_gettop(L));
+        return result;
+    }
+
     UpdateResult CompScriptOnMessage(const ComponentOnMessageParams& params)
     {
         DM_PROFILE(Script, "RunScript");
@@ -35,6 +35,8 @@ namespace dmGameObject
 
     UpdateResult CompScriptUpdate(const ComponentsUpdateParams& params, ComponentsUpdateResult& result);
 
+    UpdateResult CompScriptFixedUpdate(const ComponentsUpdateParams& params, ComponentsUpdateResult& result);
+
     UpdateResult CompScriptOnMessage(const ComponentOnMessageParams& params);
 
     InputResult CompScriptOnInput(const ComponentOnInputParams& params);
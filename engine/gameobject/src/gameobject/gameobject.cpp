@@ -91,6 +91,16 @@ namespace dmGameObject
         memset(this, 0, sizeof(InputAction));
     }
 
+    UpdateContext::UpdateContext()
+    {
+        memset(this, 0, sizeof(UpdateContext));
+    }
+
+    FixedUpdateAccumulator::FixedUpdateAccumulator()
+    {
+        memset(this, 0, sizeof(FixedUpdateAccumulator));
+    }
+
     PropertyVar::PropertyVar()
     {
         m_Type = PROPERTY_TYPE_NUMBER;
@@ -190,12 +200,17 @@ namespace dmGameObject
         m_Instances.SetCapacity(max_instances);
         m_Instances.SetSize(max_instances);
         m_InstanceIndices.SetCapacity(max_instances);
+        m_InstanceGenerations.SetCapacity(max_instances);
+        m_InstanceGenerations.SetSize(max_instances);
+        memset(m_InstanceGenerations.Begin(), 0, max_instances * sizeof(uint16_t));
         m_WorldTransforms.SetCapacity(max_instances);
         m_WorldTransforms.SetSize(max_instances);
         m_IDToInstance.SetCapacity(dmMath::Max(1U, max_instances/3), max_instances);
         // TODO: Un-hard-code
         m_InputFocusStack.SetCapacity(16);
         m_NameHash = 0;
+        m_ProfilerName = 0;
+        m_ProfilerNameHash = 0;
         m_ComponentSocket = 0;
         m_FrameSocket = 0;
 
@@ -209,6 +224,7 @@ namespace dmGameObject
         m_ScaleAlongZ = 0;
         m_DirtyTransforms = 1;
         m_Initialized = 0;
+        m_UpdateFailed = 0;
 
         m_InstancesToDeleteHead = INVALID_INSTANCE_INDEX;
         m_InstancesToDeleteTail = INVALID_INSTANCE_INDEX;
@@ -396,6 +412,11 @@ namespace dmGameObject
         }
 
         collection->m_NameHash = dmHashString64(name);
+        collection->m_ProfilerName = DM_INTERNALIZE(name);
+        if (collection->m_ProfilerName != 0)
+        {
+            collection->m_ProfilerNameHash = dmProfile::GetNameHash(name, (uint32_t)strlen(name));
+        }
 
         HCollection hcollection = (HCollection)new CollectionHandle;
         Result result = AttachCollection(collection, name, factory, regist, hcollection);
@@ -676,6 +697,7 @@ namespace dmGameObject
         uint16_t instance_index = instance->m_Index;
         operator delete ((void*)instance);
         collection->m_Instances[instance_index] = 0x0;
+        ++collection->m_InstanceGenerations[instance_index];
         collection->m_InstanceIndices.Push(instance_index);
         assert(collection->m_IDToInstance.Size() <= collection->m_InstanceIndices.Size());
     }
@@ -1848,6 +1870,7 @@ namespace dmGameObject
             dmResource::Release(factory, prototype);
         collection->m_InstanceIndices.Push(instance->m_Index);
         collection->m_Instances[instance->m_Index] = 0;
+        ++collection->m_InstanceGenerations[instance->m_Index];
 
         // Erase from input stack
         bool found_instance = false;
@@ -2391,17 +2414,104 @@ namespace dmGameObject
         UpdateTransforms(hcollection->m_Collection);
     }
 
+    static const char* GetProfilerName(Collection* collection)
+    {
+        return collection->m_ProfilerName != 0 ? collection->m_ProfilerName : "<unnamed>";
+    }
+
+    static void BeginUpdate(Collection* collection)
+    {
+        // Add to update
+        DoAddToUpdate(collection);
+
+        collection->m_InUpdate = 1;
+    }
+
+    static void EndUpdate(Collection* collection)
+    {
+        collection->m_InUpdate = 0;
+        if (collection->m_DirtyTransforms) {
+            UpdateTransforms(collection);
+        }
+    }
+
+    // Runs the update function of a single component type. Touches only the collection and the component world,
+    // which allows different collections to run this concurrently for component types with m_ParallelUpdate set.
+    static bool UpdateComponentType(Collection* collection, uint16_t update_index, const UpdateContext* update_context)
+    {
+        ComponentType* component_type = &collection->m_Register->m_ComponentTypes[update_index];
+
+        DM_COUNTER_DYN(collection->m_Register->m_ComponentProfileCounterIndex[update_index], collection->m_ComponentInstanceCount[update_index]);
+
+        // Avoid to call UpdateTransforms for each/all component types.
+        if (component_type->m_ReadsTransforms && collection->m_DirtyTransforms) {
+            UpdateTransforms(collection);
+        }
+
+        if (component_type->m_UpdateFunction)
+        {
+            DM_PROFILE(GameObject, component_type->m_Name);
+            ComponentsUpdateParams params;
+            params.m_Collection = collection->m_HCollection;
+            params.m_UpdateContext = update_context;
+            params.m_World = collection->m_ComponentWorlds[update_index];
+            params.m_Context = component_type->m_Context;
+
+            ComponentsUpdateResult update_result;
+            update_result.m_TransformsUpdated = false;
+            UpdateResult res = component_type->m_UpdateFunction(params, update_result);
+
+            // Mark the collections transforms as dirty if this component has updated
+            // them in its update function.
+            collection->m_DirtyTransforms |= update_result.m_TransformsUpdated;
+
+            if (res != UPDATE_RESULT_OK)
+                return false;
+        }
+        return true;
+    }
+
     static bool Update(Collection* collection, const UpdateContext* update_context)
     {
         DM_PROFILE(GameObject, "Update");
+        DM_PROFILE_DYN(Collection, GetProfilerName(collection), collection->m_ProfilerNameHash);
         DM_COUNTER("Instances", collection->m_InstanceIndices.Size());
 
         assert(collection != 0x0);
 
-        // Add to update
-        DoAddToUpdate(collection);
+        BeginUpdate(collection);
 
-        collection->m_InUpdate = 1;
+        bool ret = true;
+
+        uint32_t component_types = collection->m_Register->m_ComponentTypeCount;
+        for (uint32_t i = 0; i < component_types; ++i)
+        {
+            uint16_t update_index = collection->m_Register->m_ComponentTypesOrder[i];
+
+            if (!UpdateComponentType(collection, update_index, update_context))
+                ret = false;
+
+            if (!DispatchMessages(collection, &collection->m_ComponentSocket, 1))
+                ret = false;
+        }
+
+        EndUpdate(collection);
+
+        return ret;
+    }
+
+    bool Update(HCollection hcollection, const UpdateContext* update_context)
+    {
+        return Update(hcollection->m_Collection, update_context);
+    }
+
+    static bool FixedUpdate(Collection* collection, const UpdateContext* update_context)
+    {
+        DM_PROFILE(GameObject, "FixedUpdate");
+
+        assert(collection != 0x0);
+
+        BeginUpdate(collection);
 
         bool ret = true;
 
@@ -2411,14 +2521,13 @@ namespace dmGameObject
             uint16_t update_index = collection->m_Register->m_ComponentTypesOrder[i];
             ComponentType* component_type = &collection->m_Register->m_ComponentTypes[update_index];
 
-            DM_COUNTER_DYN(collection->m_Register->m_ComponentProfileCounterIndex[update_index], collection->m_ComponentInstanceCount[update_index]);
+            if (!component_type->m_FixedUpdateFunction)
+                continue;
 
-            // Avoid to call UpdateTransforms for each/all component types.
             if (component_type->m_ReadsTransforms && collection->m_DirtyTransforms) {
                 UpdateTransforms(collection);
             }
 
-            if (component_type->m_UpdateFunction)
             {
                 DM_PROFILE(GameObject, component_type->m_Name);
                 ComponentsUpdateParams params;
@@ -2429,12 +2538,10 @@ namespace dmGameObject
 
                 ComponentsUpdateResult update_result;
                 update_result.m_TransformsUpdated = false;
-                UpdateResult res = component_type->m_UpdateFunction(params, update_result);
+                UpdateResult res = component_type->m_FixedUpdateFunction(params, update_result);
                 if (res != UPDATE_RESULT_OK)
                     ret = false;
 
-                // Mark the collections transforms as dirty if this component has updated
-                // them in its update function.
                 collection->m_DirtyTransforms |= update_result.m_TransformsUpdated;
             }
 
@@ -2442,17 +2549,127 @@ namespace dmGameObject
                 ret = false;
         }
 
-        collection->m_InUpdate = 0;
-        if (collection->m_DirtyTransforms) {
-            UpdateTransforms(collection);
-        }
+        EndUpdate(collection);
 
         return ret;
     }
 
-    bool Update(HCollection hcollection, const UpdateContext* update_context)
+    bool FixedUpdate(HCollection hcollection, const UpdateContext* update_context)
     {
-        return Update(hcollection->m_Collection, update_context);
+        return FixedUpdate(hcollection->m_Collection, update_context);
+    }
+
+    uint32_t AccumulateFixedUpdate(FixedUpdateAccumulator* accumulator, float dt)
+    {
+        if (accumulator->m_TimeStep <= 0.0f)
+            return 0;
+
+        // Epsilon to not miss a step due to rounding when the frame time is a multiple of the step
+        const float STEP_EPSILON = 0.0001f;
+        accumulator->m_Time += dt;
+        uint32_t step_count = (uint32_t) (accumulator->m_Time / accumulator->m_TimeStep + STEP_EPSILON);
+        if (step_count > accumulator->m_MaxSteps)
+        {
+            step_count = accumulator->m_MaxSteps;
+            accumulator->m_Time = 0.0f;
+        }
+        else
+        {
+            accumulator->m_Time = dmMath::Max(0.0f, accumulator->m_Time - step_count * accumulator->m_TimeStep);
+        }
+        return step_count;
+    }
+
+    float GetFixedUpdateFraction(const FixedUpdateAccumulator* accumulator)
+    {
+        if (accumulator->m_TimeStep <= 0.0f)
+            return 0.0f;
+        return dmMath::Min(accumulator->m_Time / accumulator->m_TimeStep, 1.0f);
+    }
+
+    struct ParallelUpdateContext
+    {
+        HCollection*            m_Collections;
+        const UpdateContext*    m_UpdateContexts;
+        uint16_t                m_UpdateIndex;
+    };
+
+    static void ParallelUpdateComponentType(void* context, uint32_t index)
+    {
+        ParallelUpdateContext* ctx = (ParallelUpdateContext*)context;
+        Collection* collection = ctx->m_Collections[index]->m_Collection;
+        DM_PROFILE_DYN(Collection, GetProfilerName(collection), collection->m_ProfilerNameHash);
+        if (!UpdateComponentType(collection, ctx->m_UpdateIndex, &ctx->m_UpdateContexts[index]))
+            collection->m_UpdateFailed = 1;
+    }
+
+    bool UpdateCollections(HCollection* collections, const UpdateContext* update_contexts, uint32_t collection_count, dmJobThread::HContext job_thread)
+    {
+        bool ret = true;
+        if (collection_count < 2 || dmJobThread::GetWorkerCount(job_thread) == 0)
+        {
+            for (uint32_t i = 0; i < collection_count; ++i)
+            {
+                if (!Update(collections[i]->m_Collection, &update_contexts[i]))
+                    ret = false;
+            }
+            return ret;
+        }
+
+        DM_PROFILE(GameObject, "UpdateCollections");
+
+        HRegister regist = collections[0]->m_Collection->m_Register;
+
+        for (uint32_t i = 0; i < collection_count; ++i)
+        {
+            Collection* collection = collections[i]->m_Collection;
+            assert(collection->m_Register == regist);
+            DM_COUNTER("Instances", collection->m_InstanceIndices.Size());
+            collection->m_UpdateFailed = 0;
+            BeginUpdate(collection);
+        }
+
+        ParallelUpdateContext ctx;
+        ctx.m_Collections = collections;
+        ctx.m_UpdateContexts = update_contexts;
+
+        uint32_t component_types = regist->m_ComponentTypeCount;
+        for (uint32_t i = 0; i < component_types; ++i)
+        {
+            uint16_t update_index = regist->m_ComponentTypesOrder[i];
+            ComponentType* component_type = &regist->m_ComponentTypes[update_index];
+
+            ctx.m_UpdateIndex = update_index;
+            if (component_type->m_ParallelUpdate)
+            {
+                // Join before the messages are dispatched, since those may run script code
+                dmJobThread::ParallelFor(job_thread, ParallelUpdateComponentType, &ctx, collection_count);
+            }
+            else
+            {
+                for (uint32_t c = 0; c < collection_count; ++c)
+                {
+                    ParallelUpdateComponentType(&ctx, c);
+                }
+            }
+
+            for (uint32_t c = 0; c < collection_count; ++c)
+            {
+                Collection* collection = collections[c]->m_Collection;
+                if (!DispatchMessages(collection, &collection->m_ComponentSocket, 1))
+                    ret = false;
+            }
+        }
+
+        for (uint32_t i = 0; i < collection_count; ++i)
+        {
+            Collection* collection = collections[i]->m_Collection;
+            EndUpdate(collection);
+            if (collection->m_UpdateFailed)
+                ret = false;
+        }
+
+        return ret;
     }
 
     bool Render(HCollection hcollection)
@@ -3007,6 +3224,77 @@ namespace dmGameObject
         instance->m_Transform.SetRotation(dmVMath::EulerToQuat(instance->m_EulerRotation));
     }
 
+    PropertyResult GetComponentProperty(HInstance instance, uint16_t component_index, dmhash_t property_id, PropertyDesc& out_value)
+    {
+        Prototype::Component* components = instance->m_Prototype->m_Components;
+        Prototype::Component& component = components[component_index];
+        ComponentType* type = component.m_Type;
+        if (type->m_GetPropertyFunction)
+        {
+            uintptr_t* user_data = 0;
+            if (type->m_InstanceHasUserData)
+            {
+                uint32_t next_component_instance_data = 0;
+                for (uint32_t i = 0; i < component_index; ++i)
+                {
+                    if (components[i].m_Type->m_InstanceHasUserData)
+                        ++next_component_instance_data;
+                }
+                user_data = &instance->m_ComponentInstanceUserData[next_component_instance_data];
+            }
+            ComponentGetPropertyParams p;
+            p.m_Context = type->m_Context;
+            p.m_World = instance->m_Collection->m_ComponentWorlds[component.m_TypeIndex];
+            p.m_Instance = instance;
+            p.m_PropertyId = property_id;
+            p.m_UserData = user_data;
+            PropertyDesc prop_desc;
+            PropertyResult result = type->m_GetPropertyFunction(p, prop_desc);
+            if (result == PROPERTY_RESULT_OK)
+            {
+                out_value = prop_desc;
+            }
+            return result;
+        }
+        else
+        {
+            return PROPERTY_RESULT_NOT_FOUND;
+        }
+    }
+
+    PropertyResult SetComponentProperty(HInstance instance, uint16_t component_index, dmhash_t property_id, const PropertyVar& value)
+    {
+        Prototype::Component* components = instance->m_Prototype->m_Components;
+        Prototype::Component& component = components[component_index];
+        ComponentType* type = component.m_Type;
+        if (type->m_SetPropertyFunction)
+        {
+            uintptr_t* user_data = 0;
+            if (type->m_InstanceHasUserData)
+            {
+                uint32_t next_component_instance_data = 0;
+                for (uint32_t i = 0; i < component_index; ++i)
+                {
+                    if (components[i].m_Type->m_InstanceHasUserData)
+                        ++next_component_instance_data;
+                }
+                user_data = &instance->m_ComponentInstanceUserData[next_component_instance_data];
+            }
+            ComponentSetPropertyParams p;
+            p.m_Context = type->m_Context;
+            p.m_World = instance->m_Collection->m_ComponentWorlds[component.m_TypeIndex];
+            p.m_Instance = instance;
+            p.m_PropertyId = property_id;
+            p.m_UserData = user_data;
+            p.m_Value = value;
+            return type->m_SetPropertyFunction(p);
+        }
+        else
+        {
+            return PROPERTY_RESULT_NOT_FOUND;
+        }
+    }
+
     PropertyResult GetProperty(HInstance instance, dmhash_t component_id, dmhash_t property_id, PropertyDesc& out_value)
     {
         if (instance == 0)
@@ -3145,40 +3433,7 @@ namespace dmGameObject
             uint16_t component_index;
             if (RESULT_OK == GetComponentIndex(instance, component_id, &component_index))
             {
-                Prototype::Component* components = instance->m_Prototype->m_Components;
-                Prototype::Component& component = components[component_index];
-                ComponentType* type = component.m_Type;
-                if (type->m_GetPropertyFunction)
-                {
-                    uintptr_t* user_data = 0;
-                    if (type->m_InstanceHasUserData)
-                    {
-                        uint32_t next_component_instance_data = 0;
-                        for (uint32_t i = 0; i < component_index; ++i)
-                        {
-                            if (components[i].m_Type->m_InstanceHasUserData)
-                                ++next_component_instance_data;
-                        }
-                        user_data = &instance->m_ComponentInstanceUserData[next_component_instance_data];
-                    }
-                    ComponentGetPropertyParams p;
-                    p.m_Context = type->m_Context;
-                    p.m_World = instance->m_Collection->m_ComponentWorlds[component.m_TypeIndex];
-                    p.m_Instance = instance;
-                    p.m_PropertyId = property_id;
-                    p.m_UserData = user_data;
-                    PropertyDesc prop_desc;
-                    PropertyResult result = type->m_GetPropertyFunction(p, prop_desc);
-                    if (result == PROPERTY_RESULT_OK)
-                    {
-                        out_value = prop_desc;
-                    }
-                    return result;
-                }
-                else
-                {
-                    return PROPERTY_RESULT_NOT_FOUND;
-                }
+                return GetComponentProperty(instance, component_index, property_id, out_value);
             }
             else
             {
@@ -3345,35 +3600,7 @@ namespace dmGameObject
             uint16_t component_index;
             if (RESULT_OK == GetComponentIndex(instance, component_id, &component_index))
             {
-                Prototype::Component* components = instance->m_Prototype->m_Components;
-                Prototype::Component& component = components[component_index];
-                ComponentType* type = component.m_Type;
-                if (type->m_SetPropertyFunction)
-                {
-                    uintptr_t* user_data = 0;
-                    if (type->m_InstanceHasUserData)
-                    {
-                        uint32_t next_component_instance_data = 0;
-                        for (uint32_t i = 0; i < component_index; ++i)
-                        {
-                            if (components[i].m_Type->m_InstanceHasUserData)
-                                ++next_component_instance_data;
-                        }
-                        user_data = &instance->m_ComponentInstanceUserData[next_component_instance_data];
-                    }
-                    ComponentSetPropertyParams p;
-                    p.m_Context = type->m_Context;
-                    p.m_World = instance->m_Collection->m_ComponentWorlds[component.m_TypeIndex];
-                    p.m_Instance = instance;
-                    p.m_PropertyId = property_id;
-                    p.m_UserData = user_data;
-                    p.m_Value = value;
-                    return type->m_SetPropertyFunction(p);
-                }
-                else
-                {
-                    return PROPERTY_RESULT_NOT_FOUND;
-                }
+                return SetComponentProperty(instance, component_index, property_id, value);
             }
             else
             {
@@ -3436,6 +3663,8 @@ namespace dmGameObject
         DestroyComponents(collection, instance);
         dmHashRelease64(&instance->m_CollectionPathHashState);
         collection->m_Instances[index] = new_instance;
+        // The components are recreated, invalidate any property handles to the old instance
+        ++collection->m_InstanceGenerations[index];
         collection->m_IDToInstance.Put(new_instance->m_Identifier, new_instance);
 
         dmArray<Instance*>& stack = collection->m_InputFocusStack;
@@ -19,6 +19,7 @@
 #include <dlib/easing.h>
 #include <dlib/hash.h>
 #include <dlib/hashtable.h>
+#include <dlib/job_thread.h>
 #include <dlib/message.h>
 #include <dlib/transform.h>
 
@@ -133,8 +134,28 @@ namespace dmGameObject
      */
     struct UpdateContext
     {
+        UpdateContext();
+
         /// Time step
         float m_DT;
+        /// Time accumulated towards the next fixed step, as a fraction [0, 1) of the fixed time step.
+        /// Used to interpolate between fixed steps in the regular update, zero if there is no fixed update.
+        float m_FixedUpdateFraction;
+    };
+
+    /**
+     * Frame time accumulator for FixedUpdate()
+     */
+    struct FixedUpdateAccumulator
+    {
+        FixedUpdateAccumulator();
+
+        /// Fixed time step, zero if the fixed update is disabled
+        float    m_TimeStep;
+        /// Time accumulated towards the next fixed step
+        float    m_Time;
+        /// Max number of fixed steps per frame
+        uint32_t m_MaxSteps;
     };
 
     extern const dmhash_t UNNAMED_IDENTIFIER;
@@ -482,6 +503,14 @@ namespace dmGameObject
      */
     typedef UpdateResult (*ComponentsUpdate)(const ComponentsUpdateParams& params, ComponentsUpdateResult& result);
 
+    /**
+     * Component fixed update function. Called zero or more times each frame with a constant time step,
+     * before the regular update. See FixedUpdate().
+     * @param params Input parameters
+     * @return UPDATE_RESULT_OK on success
+     */
+    typedef UpdateResult (*ComponentsFixedUpdate)(const ComponentsUpdateParams& params, ComponentsUpdateResult& result);
+
     /**
      * Parameters to ComponentsRender callback.
      */
@@ -674,6 +703,7 @@ namespace dmGameObject
         ComponentAddToUpdate    m_AddToUpdateFunction;
         ComponentGet            m_GetFunction;
         ComponentsUpdate        m_UpdateFunction;
+        ComponentsFixedUpdate   m_FixedUpdateFunction;
         ComponentsRender        m_RenderFunction;
         ComponentsPostUpdate    m_PostUpdateFunction;
         ComponentOnMessage      m_OnMessageFunction;
@@ -684,7 +714,9 @@ namespace dmGameObject
         ComponentSetProperty    m_SetPropertyFunction;
         uint32_t                m_InstanceHasUserData : 1;
         uint32_t                m_ReadsTransforms : 1;
-        uint32_t                m_Reserved : 30;
+        /// The update function only touches its own world and may be called for several collections at once
+        uint32_t                m_ParallelUpdate : 1;
+        uint32_t                m_Reserved : 29;
         uint16_t                m_UpdateOrderPrio;
     };
 
@@ -1041,6 +1073,46 @@ namespace dmGameObject
      */
     bool Update(HCollection collection, const UpdateContext* update_context);
 
+    /**
+     * Run one fixed time step for all components with a fixed update function. The component types
+     * are stepped in update order and messages are dispatched after each type, as in Update().
+     * The caller accumulates frame time and calls this once per elapsed step, with a constant dt.
+     * @param collection Game object collection to be updated
+     * @param update_context Update context, m_DT is the fixed time step
+     * @return True on success
+     */
+    bool FixedUpdate(HCollection collection, const UpdateContext* update_context);
+
+    /**
+     * Accumulate the frame time and return the number of fixed steps to run this frame.
+     * If more than m_MaxSteps steps have accumulated the excess time is dropped, rather than
+     * trying to catch up in the following frames.
+     * @param accumulator Fixed update accumulator
+     * @param dt Frame time
+     * @return Number of times to call FixedUpdate()
+     */
+    uint32_t AccumulateFixedUpdate(FixedUpdateAccumulator* accumulator, float dt);
+
+    /**
+     * Get the time accumulated towards the next fixed step, as passed in UpdateContext::m_FixedUpdateFraction
+     * @param accumulator Fixed update accumulator
+     * @return Fraction [0, 1) of the fixed time step, zero if the fixed update is disabled
+     */
+    float GetFixedUpdateFraction(const FixedUpdateAccumulator* accumulator);
+
+    /**
+     * Update several collections from the same register. The component types are updated in order,
+     * one type at a time for all collections. Update functions of types with m_ParallelUpdate set
+     * are run concurrently for the collections on the job thread, all other update functions and
+     * the message dispatching run on the calling thread. Returns when all collections are updated.
+     * @param collections Game object collections to be updated
+     * @param update_contexts Update context for each collection
+     * @param collection_count Number of collections
+     * @param job_thread Job thread context. If 0 the collections are updated one after the other.
+     * @return True on success
+     */
+    bool UpdateCollections(HCollection* collections, const UpdateContext* update_contexts, uint32_t collection_count, dmJobThread::HContext job_thread);
+
     /**
      * Render all components in all game objects.
      * @param collection Collection to be rendered
@@ -30,6 +30,7 @@ namespace dmGameObject
         script_component.m_FinalFunction = &CompScriptFinal;
         script_component.m_AddToUpdateFunction = &CompScriptAddToUpdate;
         script_component.m_UpdateFunction = &CompScriptUpdate;
+        script_component.m_FixedUpdateFunction = &CompScriptFixedUpdate;
         script_component.m_OnMessageFunction = &CompScriptOnMessage;
         script_component.m_OnInputFunction = &CompScriptOnInput;
         script_component.m_OnReloadFunction = &CompScriptOnReload;
@@ -250,6 +250,10 @@ namespace dmGameObject
         // Index pool for mapping Instance::m_Index to m_Instances
         dmIndexPool16            m_InstanceIndices;
 
+        // Generation counter per instance slot, bumped every time a slot is released
+        // Used to detect stale references to deleted instances (e.g. go.property_handle)
+        dmArray<uint16_t>        m_InstanceGenerations;
+
         // Resources referenced through property overrides inside the collection
         dmArray<void*>         m_PropertyResources;
 
@@ -271,6 +275,9 @@ namespace dmGameObject
 
         // Name-hash of the collection.
         dmhash_t                 m_NameHash;
+        // Internalized name and hash used for the per collection profiler scope
+        const char*              m_ProfilerName;
+        uint32_t                 m_ProfilerNameHash;
 
         // Socket for sending to instances, dispatched between every component update
         dmMessage::HSocket       m_ComponentSocket;
@@ -302,6 +309,8 @@ namespace dmGameObject
         uint32_t                 m_ScaleAlongZ : 1;
         uint32_t                 m_DirtyTransforms : 1;
         uint32_t                 m_Initialized : 1;
+        // Set if a component update failed in UpdateCollections, written by the job updating the collection
+        uint32_t                 m_UpdateFailed : 1;
     };
 
     struct CollectionHandle
@@ -328,6 +337,10 @@ namespace dmGameObject
 
     void* GetResource(HInstance instance);
 
+    // Get/set a property of the component at component_index, bypassing the component id lookup
+    PropertyResult GetComponentProperty(HInstance instance, uint16_t component_index, dmhash_t property_id, PropertyDesc& out_value);
+    PropertyResult SetComponentProperty(HInstance instance, uint16_t component_index, dmhash_t property_id, const PropertyVar& value);
+
     void AcquireInputFocus(Collection* collection, HInstance instance);
     void ReleaseInputFocus(Collection* collection, HInstance instance);
     UpdateResult DispatchInput(Collection* collection, InputAction* input_actions, uint32_t input_action_count);
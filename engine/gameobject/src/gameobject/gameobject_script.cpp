@@ -144,9 +144,11 @@ namespace dmGameObject
 
 #define SCRIPTINSTANCE "GOScriptInstance"
 #define SCRIPT "GOScript"
+#define PROPERTYHANDLE "GOPropertyHandle"
 
     static uint32_t SCRIPT_TYPE_HASH = 0;
     static uint32_t SCRIPTINSTANCE_TYPE_HASH = 0;
+    static uint32_t PROPERTYHANDLE_TYPE_HASH = 0;
 
     using namespace dmPropertiesDDF;
 
@@ -159,7 +161,8 @@ namespace dmGameObject
         "update",
         "on_message",
         "on_input",
-        "on_reload"
+        "on_reload",
+        "fixed_update"
     };
 
     HRegister g_Register = 0;
@@ -535,10 +538,155 @@ namespace dmGameObject
         }
     }
 
+    static const char* GetPropertyTypeName(PropertyType type)
+    {
+        switch (type)
+        {
+        case PROPERTY_TYPE_NUMBER:
+            return "number";
+        case PROPERTY_TYPE_HASH:
+            return "hash";
+        case PROPERTY_TYPE_URL:
+            return "msg.url";
+        case PROPERTY_TYPE_VECTOR3:
+            return "vmath.vector3";
+        case PROPERTY_TYPE_VECTOR4:
+            return "vmath.vector4";
+        case PROPERTY_TYPE_QUAT:
+            return "vmath.quat";
+        case PROPERTY_TYPE_BOOLEAN:
+            return "boolean";
+        default:
+            return "unknown";
+        }
+    }
+
+    // A pre-resolved (instance, component, property) triplet, created by go.property_handle
+    // The instance slot generation is stored to detect if the target has been deleted
+    struct PropertyHandle
+    {
+        Collection* m_Collection;
+        Instance*   m_Instance;
+        dmhash_t    m_Path;
+        dmhash_t    m_Fragment;
+        dmhash_t    m_PropertyId;
+        uint16_t    m_InstanceIndex;
+        uint16_t    m_Generation;
+        uint16_t    m_ComponentIndex;
+    };
+
+    static PropertyHandle* ToPropertyHandle(lua_State* L, int index)
+    {
+        return (PropertyHandle*)dmScript::ToUserType(L, index, PROPERTYHANDLE_TYPE_HASH);
+    }
+
+    static Instance* CheckPropertyHandleInstance(lua_State* L, ScriptInstance* i, PropertyHandle* handle, const char* function_name)
+    {
+        Collection* collection = i->m_Instance->m_Collection;
+        if (handle->m_Collection != collection)
+        {
+            luaL_error(L, "%s can only access property handles created within the same collection.", function_name);
+            return 0; // Actually never reached
+        }
+        Instance* instance = collection->m_Instances[handle->m_InstanceIndex];
+        if (instance == 0 || instance != handle->m_Instance || collection->m_InstanceGenerations[handle->m_InstanceIndex] != handle->m_Generation)
+        {
+            luaL_error(L, "the property handle to '%s' is no longer valid, the instance has been deleted.", dmHashReverseSafe64(handle->m_Path));
+            return 0; // Actually never reached
+        }
+        return instance;
+    }
+
+    static PropertyResult GetHandleProperty(Instance* instance, PropertyHandle* handle, PropertyDesc& out_value)
+    {
+        if (handle->m_Fragment == 0)
+            return GetProperty(instance, 0, handle->m_PropertyId, out_value);
+        return GetComponentProperty(instance, handle->m_ComponentIndex, handle->m_PropertyId, out_value);
+    }
+
+    static PropertyResult SetHandleProperty(Instance* instance, PropertyHandle* handle, const PropertyVar& value)
+    {
+        if (handle->m_Fragment == 0)
+            return SetProperty(instance, 0, handle->m_PropertyId, value);
+        return SetComponentProperty(instance, handle->m_ComponentIndex, handle->m_PropertyId, value);
+    }
+
+    static int PropertyHandle_tostring(lua_State* L)
+    {
+        PropertyHandle* handle = (PropertyHandle*)lua_touserdata(L, 1);
+        if (handle->m_Fragment)
+            lua_pushfstring(L, "%s: [%s#%s].%s", PROPERTYHANDLE, dmHashReverseSafe64(handle->m_Path), dmHashReverseSafe64(handle->m_Fragment), dmHashReverseSafe64(handle->m_PropertyId));
+        else
+            lua_pushfstring(L, "%s: [%s].%s", PROPERTYHANDLE, dmHashReverseSafe64(handle->m_Path), dmHashReverseSafe64(handle->m_PropertyId));
+        return 1;
+    }
+
+    static const luaL_reg PropertyHandle_methods[] =
+    {
+        {0,0}
+    };
+
+    static const luaL_reg PropertyHandle_meta[] =
+    {
+        {"__tostring", PropertyHandle_tostring},
+        {0, 0}
+    };
+
+    static int Script_GetFromHandle(lua_State* L, ScriptInstance* i, PropertyHandle* handle)
+    {
+        Instance* target_instance = CheckPropertyHandleInstance(L, i, handle, "go.get");
+        dmGameObject::PropertyDesc property_desc;
+        dmGameObject::PropertyResult result = GetHandleProperty(target_instance, handle, property_desc);
+        switch (result)
+        {
+        case dmGameObject::PROPERTY_RESULT_OK:
+            dmGameObject::LuaPushVar(L, property_desc.m_Variant);
+            return 1;
+        case dmGameObject::PROPERTY_RESULT_NOT_FOUND:
+            return luaL_error(L, "'%s' does not have any property called '%s'", dmHashReverseSafe64(handle->m_Path), dmHashReverseSafe64(handle->m_PropertyId));
+        default:
+            // Should never happen, programmer error
+            return luaL_error(L, "go.get failed with error code %d", result);
+        }
+    }
+
+    static int Script_SetFromHandle(lua_State* L, ScriptInstance* i, PropertyHandle* handle)
+    {
+        Instance* target_instance = CheckPropertyHandleInstance(L, i, handle, "go.set");
+        dmGameObject::PropertyVar property_var;
+        dmGameObject::PropertyResult result = dmGameObject::LuaToVar(L, 2, property_var);
+        if (result == PROPERTY_RESULT_OK)
+        {
+            result = SetHandleProperty(target_instance, handle, property_var);
+        }
+        switch (result)
+        {
+        case dmGameObject::PROPERTY_RESULT_OK:
+            return 0;
+        case PROPERTY_RESULT_NOT_FOUND:
+            return luaL_error(L, "'%s' does not have any property called '%s'", dmHashReverseSafe64(handle->m_Path), dmHashReverseSafe64(handle->m_PropertyId));
+        case PROPERTY_RESULT_UNSUPPORTED_TYPE:
+        case PROPERTY_RESULT_TYPE_MISMATCH:
+            {
+                dmGameObject::PropertyDesc property_desc;
+                GetHandleProperty(target_instance, handle, property_desc);
+                return luaL_error(L, "the property '%s' of '%s' must be a %s", dmHashReverseSafe64(handle->m_PropertyId), dmHashReverseSafe64(handle->m_Path), GetPropertyTypeName(property_desc.m_Variant.m_Type));
+            }
+        case dmGameObject::PROPERTY_RESULT_UNSUPPORTED_VALUE:
+            return luaL_error(L, "go.set failed because the value is unsupported");
+        case dmGameObject::PROPERTY_RESULT_UNSUPPORTED_OPERATION:
+            return luaL_error(L, "could not perform unsupported operation on '%s'", dmHashReverseSafe64(handle->m_PropertyId));
+        default:
+            // Should never happen, programmer error
+            return luaL_error(L, "go.set failed with error code %d", result);
+        }
+    }
+
     /*# gets a named property of the specified game object or component
      *
      * @name go.get
-     * @param url [type:string|hash|url] url of the game object or component having the property
+     * @param url [type:string|hash|url|handle] url of the game object or component having the property,
+     * or a handle created by [ref:go.property_handle], in which case the property argument is omitted
      * @param property [type:string|hash] id of the property to retrieve
      * @return value [type:any] the value of the specified property
      * @examples
@@ -558,6 +706,11 @@ namespace dmGameObject
     int Script_Get(lua_State* L)
     {
         ScriptInstance* i = ScriptInstance_Check(L);
+        PropertyHandle* handle = ToPropertyHandle(L, 1);
+        if (handle)
+        {
+            return Script_GetFromHandle(L, i, handle);
+        }
         Instance* instance = i->m_Instance;
         dmMessage::URL sender;
         dmScript::GetURL(L, &sender);
@@ -607,33 +760,11 @@ namespace dmGameObject
         }
     }
 
-    static const char* GetPropertyTypeName(PropertyType type)
-    {
-        switch (type)
-        {
-        case PROPERTY_TYPE_NUMBER:
-            return "number";
-        case PROPERTY_TYPE_HASH:
-            return "hash";
-        case PROPERTY_TYPE_URL:
-            return "msg.url";
-        case PROPERTY_TYPE_VECTOR3:
-            return "vmath.vector3";
-        case PROPERTY_TYPE_VECTOR4:
-            return "vmath.vector4";
-        case PROPERTY_TYPE_QUAT:
-            return "vmath.quat";
-        case PROPERTY_TYPE_BOOLEAN:
-            return "boolean";
-        default:
-            return "unknown";
-        }
-    }
-
     /*# sets a named property of the specified game object or component
      *
      * @name go.set
-     * @param url [type:string|hash|url] url of the game object or component having the property
+     * @param url [type:string|hash|url|handle] url of the game object or component having the property,
+     * or a handle created by [ref:go.property_handle], in which case the property argument is omitted
      * @param property [type:string|hash] id of the property to set
      * @param value [type:any] the value to set
      * @examples
@@ -653,6 +784,11 @@ namespace dmGameObject
     int Script_Set(lua_State* L)
     {
         ScriptInstance* i = ScriptInstance_Check(L);
+        PropertyHandle* handle = ToPropertyHandle(L, 1);
+        if (handle)
+        {
+            return Script_SetFromHandle(L, i, handle);
+        }
         Instance* instance = i->m_Instance;
         dmMessage::URL sender;
         dmScript::GetURL(L, &sender);
@@ -718,6 +854,70 @@ namespace dmGameObject
         }
     }
 
+    /*# creates a handle to a named property of the specified game object or component
+     * Resolves the url, the component and the property id once and returns a handle that can be
+     * passed to [ref:go.get] and [ref:go.set] in place of the url and property arguments.
+     * Use this when accessing the same property every frame to avoid resolving the url each call.
+     * The handle becomes invalid when the game object is deleted, using it after that raises an error.
+     *
+     * @name go.property_handle
+     * @param url [type:string|hash|url] url of the game object or component having the property
+     * @param property [type:string|hash] id of the property
+     * @return handle [type:handle] handle to the property
+     * @examples
+     *
+     * ```lua
+     * function init(self)
+     *     self.speed = go.property_handle("#player", "speed")
+     * end
+     *
+     * function update(self, dt)
+     *     go.set(self.speed, go.get(self.speed) + dt)
+     * end
+     * ```
+     */
+    int Script_PropertyHandle(lua_State* L)
+    {
+        ScriptInstance* i = ScriptInstance_Check(L);
+        Collection* collection = i->m_Instance->m_Collection;
+        dmMessage::URL sender;
+        dmScript::GetURL(L, &sender);
+        dmMessage::URL target;
+        dmScript::ResolveURL(L, 1, &target, &sender);
+        if (target.m_Socket != dmGameObject::GetMessageSocket(collection->m_HCollection))
+        {
+            return luaL_error(L, "go.property_handle can only access instances within the same collection.");
+        }
+        dmhash_t property_id = 0;
+        if (lua_isstring(L, 2))
+        {
+            property_id = dmHashString64(lua_tostring(L, 2));
+        }
+        else
+        {
+            property_id = dmScript::CheckHash(L, 2);
+        }
+        dmGameObject::HInstance target_instance = dmGameObject::GetInstanceFromIdentifier(collection, target.m_Path);
+        if (target_instance == 0)
+            return luaL_error(L, "Could not find any instance with id '%s'.", dmHashReverseSafe64(target.m_Path));
+        uint16_t component_index = 0;
+        if (target.m_Fragment && dmGameObject::GetComponentIndex(target_instance, target.m_Fragment, &component_index) != dmGameObject::RESULT_OK)
+            return luaL_error(L, "could not find component '%s' when resolving '%s'", dmHashReverseSafe64(target.m_Fragment), lua_tostring(L, 1));
+
+        PropertyHandle* handle = (PropertyHandle*)lua_newuserdata(L, sizeof(PropertyHandle));
+        handle->m_Collection = collection;
+        handle->m_Instance = target_instance;
+        handle->m_Path = target.m_Path;
+        handle->m_Fragment = target.m_Fragment;
+        handle->m_PropertyId = property_id;
+        handle->m_InstanceIndex = target_instance->m_Index;
+        handle->m_Generation = collection->m_InstanceGenerations[target_instance->m_Index];
+        handle->m_ComponentIndex = component_index;
+        luaL_getmetatable(L, PROPERTYHANDLE);
+        lua_setmetatable(L, -2);
+        return 1;
+    }
+
     /*# gets the position of a game object instance
      * The position is relative the parent (if any). Use [ref:go.get_world_position] to retrieve the global world position.
      *
@@ -1867,6 +2067,7 @@ namespace dmGameObject
     {
         {"get",                     Script_Get},
         {"set",                     Script_Set},
+        {"property_handle",         Script_PropertyHandle},
         {"get_position",            Script_GetPosition},
         {"get_rotation",            Script_GetRotation},
         {"get_scale",               Script_GetScale},
@@ -1904,6 +2105,8 @@ namespace dmGameObject
 
         SCRIPTINSTANCE_TYPE_HASH = dmScript::RegisterUserType(L, SCRIPTINSTANCE, ScriptInstance_methods, ScriptInstance_meta);
 
+        PROPERTYHANDLE_TYPE_HASH = dmScript::RegisterUserType(L, PROPERTYHANDLE, PropertyHandle_methods, PropertyHandle_meta);
+
         luaL_register(L, "go", GO_methods);
 
 #define SETPLAYBACK(name) \
@@ -2434,6 +2637,32 @@ const char* TYPE_NAMES[PROPERTY_TYPE_COUNT] = {
      * ```
      */
 
+    /*# called to update a script component at a fixed rate
+     *
+     * This is a callback-function, which is called by the engine at a fixed rate, independent of the frame rate.
+     * It is called zero or more times each frame, before `update`, so that the total simulated time follows the real time.
+     * The rate is set with `engine.fixed_update_frequency` in game.project. Use it for simulation code that must
+     * produce the same result regardless of the display refresh rate, e.g. for lockstep multiplayer.
+     *
+     * @name fixed_update
+     * @param self [type:object] reference to the script state to be used for storing data
+     * @param dt [type:number] the fixed time-step, 1 / `engine.fixed_update_frequency`
+     * @examples
+     *
+     * This example demonstrates how to integrate a velocity at a fixed rate:
+     *
+     * ```lua
+     * function init(self)
+     *     self.my_velocity = vmath.vector3(1, 0, 0)
+     * end
+     *
+     * function fixed_update(self, dt)
+     *     -- the same number of steps are taken on a 30 Hz and a 144 Hz display
+     *     go.set_position(go.get_position() + dt * self.my_velocity)
+     * end
+     * ```
+     */
+
     /*# called when a message has been sent to the script component
      *
      * This is a callback-function, which is called by the engine whenever a message has been sent to the script component.
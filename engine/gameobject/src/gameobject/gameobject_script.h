@@ -48,6 +48,7 @@ namespace dmGameObject
         SCRIPT_FUNCTION_ONMESSAGE,
         SCRIPT_FUNCTION_ONINPUT,
         SCRIPT_FUNCTION_ONRELOAD,
+        SCRIPT_FUNCTION_FIXED_UPDATE,
         MAX_SCRIPT_FUNCTION_COUNT
     };
 
@@ -467,6 +467,42 @@ TEST_F(AnimTest, LoadTest)
     }
 }
 
+TEST_F(AnimTest, Benchmark)
+{
+    // Many concurrent tweens with mixed easings and playback modes, half of them going through SetProperty (euler)
+    const uint32_t count = 8192;
+    const uint32_t frames = 60;
+    dmGameObject::HCollection collection = dmGameObject::NewCollection("benchmark", m_Factory, m_Register, count);
+    m_UpdateContext.m_DT = 1.0f / 60.0f;
+    const dmGameObject::Playback playbacks[] = {dmGameObject::PLAYBACK_LOOP_FORWARD, dmGameObject::PLAYBACK_LOOP_BACKWARD, dmGameObject::PLAYBACK_LOOP_PINGPONG};
+    dmhash_t ids[] = {hash("position"), hash("euler")};
+
+    dmGameObject::HInstance* gos = new dmGameObject::HInstance[count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        gos[i] = dmGameObject::New(collection, "/dummy.goc");
+        ASSERT_NE((void*) 0, (void*) gos[i]);
+        dmGameObject::PropertyVar var(Vector3(10.0f, 5.0f, 1.0f));
+        dmEasing::Curve curve((dmEasing::Type)(i % dmEasing::TYPE_FLOAT_VECTOR));
+        dmGameObject::PropertyResult result = Animate(collection, gos[i], 0, ids[i % 2], playbacks[i % 3], var, curve, 1.0f + (i % 7) * 0.1f, 0.0f, 0x0, 0x0, 0x0);
+        ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, result);
+    }
+
+    uint64_t time = dmTime::GetTime();
+    for (uint32_t i = 0; i < frames; ++i)
+    {
+        dmGameObject::Update(collection, &m_UpdateContext);
+    }
+    uint64_t delta = dmTime::GetTime() - time;
+    printf("Bench elapsed: %d animations, %d frames in %.3f ms (%.3f ms/frame)\n", count * 4, frames, delta * 0.001, delta * 0.001 / frames);
+
+    ASSERT_NE(0.0f, X(gos[0]));
+
+    dmGameObject::DeleteCollection(collection);
+    dmGameObject::PostUpdate(m_Register);
+    delete [] gos;
+}
+
 TEST_F(AnimTest, LinkedList)
 {
     m_UpdateContext.m_DT = 0.25f;
@@ -17,7 +17,10 @@
 
 #include <dlib/hash.h>
 #include <dlib/log.h>
+#include <dlib/dstrings.h>
 #include <dlib/time.h>
+#include <dlib/atomic.h>
+#include <dlib/job_thread.h>
 
 #include "../gameobject.h"
 #include "../gameobject_private.h"
@@ -521,6 +524,131 @@ TEST_F(CollectionTest, CreateCallback)
     dmGameObject::PostUpdate(m_Register);
 }
 
+struct ParallelUpdateWorld
+{
+    uint32_t m_UpdateCount;
+    float    m_DT;
+    int32_t  m_ParallelUpdateCount;
+};
+
+static int32_atomic_t g_ParallelUpdateCount = 0;
+
+static dmGameObject::CreateResult ParallelUpdateNewWorld(const dmGameObject::ComponentNewWorldParams& params)
+{
+    ParallelUpdateWorld* world = new ParallelUpdateWorld;
+    memset(world, 0, sizeof(*world));
+    *params.m_World = world;
+    return dmGameObject::CREATE_RESULT_OK;
+}
+
+static dmGameObject::CreateResult ParallelUpdateDeleteWorld(const dmGameObject::ComponentDeleteWorldParams& params)
+{
+    delete (ParallelUpdateWorld*)params.m_World;
+    return dmGameObject::CREATE_RESULT_OK;
+}
+
+static dmGameObject::CreateResult ParallelUpdateAddToUpdate(const dmGameObject::ComponentAddToUpdateParams& params)
+{
+    return dmGameObject::CREATE_RESULT_OK;
+}
+
+static dmGameObject::UpdateResult ParallelUpdateUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
+{
+    ParallelUpdateWorld* world = (ParallelUpdateWorld*)params.m_World;
+    world->m_UpdateCount++;
+    world->m_DT = params.m_UpdateContext->m_DT;
+    dmAtomicIncrement32(&g_ParallelUpdateCount);
+    return dmGameObject::UPDATE_RESULT_OK;
+}
+
+static dmGameObject::UpdateResult SerialUpdateUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
+{
+    // All collections must have run the parallel type (lower prio) before any of them runs this one
+    ParallelUpdateWorld* world = (ParallelUpdateWorld*)params.m_World;
+    world->m_UpdateCount++;
+    world->m_DT = params.m_UpdateContext->m_DT;
+    world->m_ParallelUpdateCount = dmAtomicAdd32(&g_ParallelUpdateCount, 0);
+    return dmGameObject::UPDATE_RESULT_OK;
+}
+
+static void RegisterUpdateType(dmResource::HFactory factory, dmGameObject::HRegister regist, const char* name, uint16_t prio, dmGameObject::ComponentsUpdate update, bool parallel)
+{
+    dmResource::Result e = dmResource::RegisterType(factory, name, 0, 0, NullResourceCreate, 0, NullResourceDestroy, 0);
+    ASSERT_EQ(dmResource::RESULT_OK, e);
+    dmResource::ResourceType resource_type;
+    e = dmResource::GetTypeFromExtension(factory, name, &resource_type);
+    ASSERT_EQ(dmResource::RESULT_OK, e);
+    dmGameObject::ComponentType type;
+    type.m_Name = name;
+    type.m_ResourceType = resource_type;
+    type.m_NewWorldFunction = ParallelUpdateNewWorld;
+    type.m_DeleteWorldFunction = ParallelUpdateDeleteWorld;
+    type.m_AddToUpdateFunction = ParallelUpdateAddToUpdate;
+    type.m_UpdateFunction = update;
+    type.m_ParallelUpdate = parallel;
+    ASSERT_EQ(dmGameObject::RESULT_OK, dmGameObject::RegisterComponentType(regist, type));
+    dmGameObject::SetUpdateOrderPrio(regist, resource_type, prio);
+}
+
+TEST_F(CollectionTest, UpdateCollections)
+{
+    RegisterUpdateType(m_Factory, m_Register, "parallelc", 3, ParallelUpdateUpdate, true);
+    RegisterUpdateType(m_Factory, m_Register, "serialc", 4, SerialUpdateUpdate, false);
+    dmGameObject::SortComponentTypes(m_Register);
+
+    dmResource::ResourceType resource_type;
+    uint32_t parallel_index, serial_index;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::GetTypeFromExtension(m_Factory, "parallelc", &resource_type));
+    ASSERT_NE((void*) 0, dmGameObject::FindComponentType(m_Register, resource_type, &parallel_index));
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::GetTypeFromExtension(m_Factory, "serialc", &resource_type));
+    ASSERT_NE((void*) 0, dmGameObject::FindComponentType(m_Register, resource_type, &serial_index));
+
+    const uint32_t collection_count = 4;
+    dmGameObject::HCollection collections[collection_count];
+    dmGameObject::UpdateContext update_contexts[collection_count];
+    for (uint32_t i = 0; i < collection_count; ++i)
+    {
+        char name[32];
+        dmSnPrintf(name, sizeof(name), "parallel%d", i);
+        collections[i] = dmGameObject::NewCollection(name, m_Factory, m_Register, 16);
+        ASSERT_NE((void*) 0, collections[i]);
+        update_contexts[i].m_DT = (i + 1) * 0.01f;
+    }
+
+    dmJobThread::HContext job_threads[] = { 0, dmJobThread::Create(2, "test_worker") };
+    for (uint32_t t = 0; t < 2; ++t)
+    {
+        g_ParallelUpdateCount = 0;
+        const uint32_t frame_count = 3;
+        for (uint32_t frame = 0; frame < frame_count; ++frame)
+        {
+            ASSERT_TRUE(dmGameObject::UpdateCollections(collections, update_contexts, collection_count, job_threads[t]));
+
+            for (uint32_t i = 0; i < collection_count; ++i)
+            {
+                ParallelUpdateWorld* parallel_world = (ParallelUpdateWorld*)dmGameObject::GetWorld(collections[i], parallel_index);
+                ParallelUpdateWorld* serial_world = (ParallelUpdateWorld*)dmGameObject::GetWorld(collections[i], serial_index);
+                ASSERT_EQ(t * frame_count + frame + 1, parallel_world->m_UpdateCount);
+                ASSERT_EQ(t * frame_count + frame + 1, serial_world->m_UpdateCount);
+                ASSERT_EQ(update_contexts[i].m_DT, parallel_world->m_DT);
+                ASSERT_EQ(update_contexts[i].m_DT, serial_world->m_DT);
+                if (job_threads[t] != 0)
+                {
+                    // The serial type runs after the parallel type has been joined for all collections
+                    ASSERT_EQ((int32_t)(collection_count * (frame + 1)), serial_world->m_ParallelUpdateCount);
+                }
+            }
+        }
+    }
+    dmJobThread::Destroy(job_threads[1]);
+
+    for (uint32_t i = 0; i < collection_count; ++i)
+    {
+        dmGameObject::DeleteCollection(collections[i]);
+    }
+    dmGameObject::PostUpdate(m_Register);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -519,6 +519,23 @@ TEST_F(PropsTest, PropsGetSetScript)
     dmResource::Release(m_Factory, collection);
 }
 
+TEST_F(PropsTest, PropsHandle)
+{
+    dmGameObject::HCollection collection;
+    dmResource::Result res = dmResource::Get(m_Factory, "/props_handle.collectionc", (void**)&collection);
+    ASSERT_EQ(dmResource::RESULT_OK, res);
+    ASSERT_TRUE(dmGameObject::Init(collection));
+    dmGameObject::UpdateContext context;
+    context.m_DT = 1 / 60.0f;
+    // Deletes the target instance
+    ASSERT_TRUE(dmGameObject::Update(collection, &context));
+    ASSERT_TRUE(dmGameObject::PostUpdate(collection));
+    // Verifies that the handles have been invalidated
+    ASSERT_TRUE(dmGameObject::Update(collection, &context));
+    ASSERT_TRUE(dmGameObject::PostUpdate(collection));
+    dmResource::Release(m_Factory, collection);
+}
+
 #define ASSERT_SPAWN_FAILS(path)\
     dmGameObject::HInstance i = Spawn(m_Factory, m_Collection, path, dmHashString64("id"), (uint8_t*)0x0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));\
     ASSERT_EQ(0, i);
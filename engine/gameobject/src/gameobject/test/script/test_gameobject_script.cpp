@@ -543,6 +543,85 @@ TEST_F(ScriptTest, TestInstanceContext)
     dmGameObject::PostUpdate(m_Collection);
 }
 
+TEST_F(ScriptTest, TestFixedUpdate)
+{
+    dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/fixed_update.goc");
+    ASSERT_NE((void*) 0, (void*) go);
+
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+
+    dmGameObject::UpdateContext fixed_update_context;
+    fixed_update_context.m_DT = 1.0f / 30.0f;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(dmGameObject::FixedUpdate(m_Collection, &fixed_update_context));
+        ASSERT_TRUE(dmGameObject::FixedUpdate(m_Collection, &fixed_update_context));
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    }
+
+    // The world transform is updated at the end of the fixed step
+    ASSERT_TRUE(dmGameObject::FixedUpdate(m_Collection, &fixed_update_context));
+    ASSERT_EQ(7.0f, dmGameObject::GetWorldPosition(go).getX());
+
+    // Scripts without fixed_update are skipped
+    dmGameObject::HInstance null_go = dmGameObject::New(m_Collection, "/null.goc");
+    ASSERT_NE((void*) 0, (void*) null_go);
+    ASSERT_TRUE(dmGameObject::FixedUpdate(m_Collection, &fixed_update_context));
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+    dmGameObject::Delete(m_Collection, go, false);
+    dmGameObject::Delete(m_Collection, null_go, false);
+    dmGameObject::PostUpdate(m_Collection);
+}
+
+TEST_F(ScriptTest, TestFixedUpdateAccumulator)
+{
+    dmGameObject::FixedUpdateAccumulator accumulator;
+    ASSERT_EQ(0u, dmGameObject::AccumulateFixedUpdate(&accumulator, 1.0f / 60.0f));
+    ASSERT_EQ(0.0f, dmGameObject::GetFixedUpdateFraction(&accumulator));
+
+    accumulator.m_TimeStep = 1.0f / 60.0f;
+    accumulator.m_MaxSteps = 5;
+
+    // Frame time equal to the step
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(1u, dmGameObject::AccumulateFixedUpdate(&accumulator, 1.0f / 60.0f));
+        ASSERT_NEAR(0.0f, dmGameObject::GetFixedUpdateFraction(&accumulator), 0.001f);
+    }
+
+    // Frames shorter than the step
+    ASSERT_EQ(0u, dmGameObject::AccumulateFixedUpdate(&accumulator, 1.0f / 240.0f));
+    ASSERT_NEAR(0.25f, dmGameObject::GetFixedUpdateFraction(&accumulator), 0.001f);
+    ASSERT_EQ(0u, dmGameObject::AccumulateFixedUpdate(&accumulator, 1.0f / 240.0f));
+    ASSERT_NEAR(0.5f, dmGameObject::GetFixedUpdateFraction(&accumulator), 0.001f);
+    ASSERT_EQ(1u, dmGameObject::AccumulateFixedUpdate(&accumulator, 1.0f / 120.0f));
+    ASSERT_NEAR(0.0f, dmGameObject::GetFixedUpdateFraction(&accumulator), 0.001f);
+
+    // Frames longer than the step
+    ASSERT_EQ(2u, dmGameObject::AccumulateFixedUpdate(&accumulator, 2.5f / 60.0f));
+    ASSERT_NEAR(0.5f, dmGameObject::GetFixedUpdateFraction(&accumulator), 0.001f);
+    ASSERT_EQ(3u, dmGameObject::AccumulateFixedUpdate(&accumulator, 2.5f / 60.0f));
+    ASSERT_NEAR(0.0f, dmGameObject::GetFixedUpdateFraction(&accumulator), 0.001f);
+}
+
+TEST_F(ScriptTest, TestFixedUpdateMaxSteps)
+{
+    dmGameObject::FixedUpdateAccumulator accumulator;
+    accumulator.m_TimeStep = 1.0f / 60.0f;
+    accumulator.m_MaxSteps = 3;
+
+    ASSERT_EQ(3u, dmGameObject::AccumulateFixedUpdate(&accumulator, 3.0f / 60.0f));
+    ASSERT_NEAR(0.0f, dmGameObject::GetFixedUpdateFraction(&accumulator), 0.001f);
+
+    // The time of the steps over the max is dropped, not run in the next frame
+    ASSERT_EQ(3u, dmGameObject::AccumulateFixedUpdate(&accumulator, 10.5f / 60.0f));
+    ASSERT_EQ(0.0f, dmGameObject::GetFixedUpdateFraction(&accumulator));
+    ASSERT_EQ(1u, dmGameObject::AccumulateFixedUpdate(&accumulator, 1.0f / 60.0f));
+    ASSERT_EQ(0u, dmGameObject::AccumulateFixedUpdate(&accumulator, 0.5f / 60.0f));
+    ASSERT_NEAR(0.5f, dmGameObject::GetFixedUpdateFraction(&accumulator), 0.001f);
+}
+
 int main(int argc, char **argv)
 {
     dmDDF::RegisterAllTypes();
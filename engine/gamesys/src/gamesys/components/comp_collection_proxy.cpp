@@ -20,6 +20,7 @@
 #include <dlib/log.h>
 #include <dlib/hash.h>
 #include <dlib/index_pool.h>
+#include <dlib/math.h>
 
 #include <gameobject/gameobject.h>
 #include <gameobject/gameobject_ddf.h>
@@ -44,6 +45,7 @@ namespace dmGameSystem
     using namespace Vectormath::Aos;
 
     const char* COLLECTION_PROXY_MAX_COUNT_KEY = "collection_proxy.max_count";
+    const char* COLLECTION_PROXY_PARALLEL_UPDATE_KEY = "collection_proxy.parallel_update";
 
     struct CollectionProxyComponent
     {
@@ -54,6 +56,9 @@ namespace dmGameSystem
         dmGameSystemDDF::TimeStepMode   m_TimeStepMode;
         float                           m_TimeStepFactor;
         float                           m_AccumulatedTime;
+        float                           m_FixedAccumulatedTime;
+        // m_FixedAccumulatedTime as a fraction of the fixed time step, to interpolate between the discrete fixed steps
+        float                           m_FixedAccumulatedFraction;
         uint32_t                        m_ComponentIndex : 16;
         uint32_t                        m_Initialized : 1;
         uint32_t                        m_Enabled : 1;
@@ -69,6 +74,9 @@ namespace dmGameSystem
     {
         dmArray<CollectionProxyComponent>   m_Components;
         dmIndexPool32                       m_IndexPool;
+        // Collections to update this frame, only used with parallel update
+        dmArray<dmGameObject::HCollection>  m_UpdateCollections;
+        dmArray<dmGameObject::UpdateContext> m_UpdateContexts;
     };
 
     static dmGameObject::UpdateResult DoLoad(dmResource::HFactory factory, CollectionProxyComponent *proxy)
@@ -133,6 +141,11 @@ namespace dmGameSystem
         proxy_world->m_Components.SetSize(component_count);
         memset(&proxy_world->m_Components[0], 0, sizeof(CollectionProxyComponent) * component_count);
         proxy_world->m_IndexPool.SetCapacity(component_count);
+        if (context->m_JobThread != 0)
+        {
+            proxy_world->m_UpdateCollections.SetCapacity(component_count);
+            proxy_world->m_UpdateContexts.SetCapacity(component_count);
+        }
         *params.m_World = proxy_world;
         return dmGameObject::CREATE_RESULT_OK;
     }
@@ -218,7 +231,10 @@ namespace dmGameSystem
     dmGameObject::UpdateResult CompCollectionProxyUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
     {
         CollectionProxyWorld* proxy_world = (CollectionProxyWorld*)params.m_World;
+        CollectionProxyContext* proxy_context = (CollectionProxyContext*)params.m_Context;
         dmGameObject::UpdateResult result = dmGameObject::UPDATE_RESULT_OK;
+        proxy_world->m_UpdateCollections.SetSize(0);
+        proxy_world->m_UpdateContexts.SetSize(0);
         for (uint32_t i = 0; i < proxy_world->m_Components.Size(); ++i)
         {
             CollectionProxyComponent* proxy = &proxy_world->m_Components[i];
@@ -254,10 +270,13 @@ namespace dmGameSystem
                     dmGameObject::UpdateContext uc;
 
                     float warped_dt = params.m_UpdateContext->m_DT * proxy->m_TimeStepFactor;
+                    float fixed_update_fraction = params.m_UpdateContext->m_FixedUpdateFraction;
                     switch (proxy->m_TimeStepMode)
                     {
                     case dmGameSystemDDF::TIME_STEP_MODE_CONTINUOUS:
                         uc.m_DT = warped_dt;
+                        // The fixed steps are scaled along with the frame time
+                        uc.m_FixedUpdateFraction = fixed_update_fraction;
                         proxy->m_AccumulatedTime = 0.0f;
                         break;
                     case dmGameSystemDDF::TIME_STEP_MODE_DISCRETE:
@@ -271,13 +290,23 @@ namespace dmGameSystem
                         {
                             uc.m_DT = 0.0f;
                         }
+                        // Time accumulated towards the next discrete fixed step, including the part of the parent step
+                        uc.m_FixedUpdateFraction = dmMath::Min(proxy->m_FixedAccumulatedFraction + fixed_update_fraction * proxy->m_TimeStepFactor, 1.0f);
                         break;
                     default:
                         break;
                     }
 
-                    if (!dmGameObject::Update(proxy->m_Collection, &uc))
+                    if (proxy_context->m_JobThread != 0)
+                    {
+                        // Updated together with the other loaded collections below
+                        proxy_world->m_UpdateCollections.Push(proxy->m_Collection);
+                        proxy_world->m_UpdateContexts.Push(uc);
+                    }
+                    else if (!dmGameObject::Update(proxy->m_Collection, &uc))
+                    {
                         result = dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+                    }
                 }
                 else
                 {
@@ -301,6 +330,60 @@ namespace dmGameSystem
                 }
             }
         }
+        if (!proxy_world->m_UpdateCollections.Empty())
+        {
+            if (!dmGameObject::UpdateCollections(proxy_world->m_UpdateCollections.Begin(), proxy_world->m_UpdateContexts.Begin(),
+                                                 proxy_world->m_UpdateCollections.Size(), proxy_context->m_JobThread))
+                result = dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+        }
+        return result;
+    }
+
+    dmGameObject::UpdateResult CompCollectionProxyFixedUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
+    {
+        CollectionProxyWorld* proxy_world = (CollectionProxyWorld*)params.m_World;
+        dmGameObject::UpdateResult result = dmGameObject::UPDATE_RESULT_OK;
+        for (uint32_t i = 0; i < proxy_world->m_Components.Size(); ++i)
+        {
+            CollectionProxyComponent* proxy = &proxy_world->m_Components[i];
+            if (!proxy->m_AddedToUpdate || proxy->m_Collection == 0)
+            {
+                continue;
+            }
+            if (!proxy->m_Enabled)
+            {
+                proxy->m_FixedAccumulatedTime = 0.0f;
+                proxy->m_FixedAccumulatedFraction = 0.0f;
+                continue;
+            }
+
+            // Same time step warping as the regular update, with a separate accumulator for the fixed steps
+            float fixed_dt = params.m_UpdateContext->m_DT;
+            float warped_dt = fixed_dt * proxy->m_TimeStepFactor;
+            dmGameObject::UpdateContext uc;
+            switch (proxy->m_TimeStepMode)
+            {
+            case dmGameSystemDDF::TIME_STEP_MODE_DISCRETE:
+                proxy->m_FixedAccumulatedTime += warped_dt;
+                if (proxy->m_FixedAccumulatedTime < fixed_dt)
+                {
+                    proxy->m_FixedAccumulatedFraction = proxy->m_FixedAccumulatedTime / fixed_dt;
+                    continue;
+                }
+                uc.m_DT = fixed_dt;
+                proxy->m_FixedAccumulatedTime -= fixed_dt;
+                proxy->m_FixedAccumulatedFraction = proxy->m_FixedAccumulatedTime / fixed_dt;
+                break;
+            default:
+                uc.m_DT = warped_dt;
+                proxy->m_FixedAccumulatedTime = 0.0f;
+                proxy->m_FixedAccumulatedFraction = 0.0f;
+                break;
+            }
+
+            if (!dmGameObject::FixedUpdate(proxy->m_Collection, &uc))
+                result = dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+        }
         return result;
     }
 
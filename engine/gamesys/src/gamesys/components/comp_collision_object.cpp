@@ -17,9 +17,12 @@
 #include <dlib/hash.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
+#include <dlib/profile.h>
 
 #include <physics/physics.h>
 
+#include <script/script.h>
+
 #include <gameobject/gameobject.h>
 #include <gameobject/gameobject_ddf.h>
 
@@ -104,6 +107,33 @@ namespace dmGameSystem
         uint8_t m_FlippedY : 1;
     };
 
+    enum CollisionEventType
+    {
+        COLLISION_EVENT_TYPE_COLLISION      = 0,
+        COLLISION_EVENT_TYPE_CONTACT_POINT  = 1,
+        COLLISION_EVENT_TYPE_TRIGGER_ENTER  = 2,
+        COLLISION_EVENT_TYPE_TRIGGER_EXIT   = 3,
+    };
+
+    /// Collision, contact point or trigger event buffered for the world event listener.
+    /// The contact point fields are only valid for COLLISION_EVENT_TYPE_CONTACT_POINT.
+    struct CollisionEvent
+    {
+        dmhash_t    m_IdA;
+        dmhash_t    m_IdB;
+        uint64_t    m_GroupA;
+        uint64_t    m_GroupB;
+        Point3      m_PositionA;
+        Point3      m_PositionB;
+        Vector3     m_Normal;
+        Vector3     m_RelativeVelocity;
+        float       m_Distance;
+        float       m_AppliedImpulse;
+        float       m_MassA;
+        float       m_MassB;
+        uint8_t     m_Type;
+    };
+
     struct CollisionWorld
     {
         uint64_t m_Groups[16];
@@ -116,6 +146,11 @@ namespace dmGameSystem
         uint8_t m_ComponentIndex;
         uint8_t m_3D : 1;
         dmArray<CollisionComponent*> m_Components;
+        // When set, events are collected in m_Events and delivered once per physics step instead of being posted as messages.
+        // There is one listener per collection, owned by the script instance that set it.
+        dmScript::LuaCallbackInfo* m_EventListener;
+        dmGameObject::HInstance m_EventListenerOwner;
+        dmArray<CollisionEvent> m_Events;
     };
 
     // Forward declarations
@@ -162,6 +197,8 @@ namespace dmGameSystem
         dmPhysics::NewWorldParams world_params;
         world_params.m_GetWorldTransformCallback = GetWorldTransform;
         world_params.m_SetWorldTransformCallback = SetWorldTransform;
+        world_params.m_Broadphase = physics_context->m_Broadphase;
+        world_params.m_MaxBroadphaseProxies = physics_context->m_MaxBroadphaseProxies;
 
         dmPhysics::HWorld2D world2D;
         dmPhysics::HWorld3D world3D;
@@ -213,6 +250,8 @@ namespace dmGameSystem
             dmPhysics::DeleteWorld3D(physics_context->m_Context3D, world->m_World3D);
         else
             dmPhysics::DeleteWorld2D(physics_context->m_Context2D, world->m_World2D);
+        if (world->m_EventListener)
+            dmScript::DestroyCallback(world->m_EventListener);
         delete world;
         return dmGameObject::CREATE_RESULT_OK;
     }
@@ -536,10 +575,31 @@ namespace dmGameSystem
         }
     }
 
+    static CollisionEvent& PushCollisionEvent(CollisionWorld* world, CollisionEventType type, CollisionComponent* component_a, uint16_t group_a, CollisionComponent* component_b, uint16_t group_b)
+    {
+        dmArray<CollisionEvent>& events = world->m_Events;
+        if (events.Full())
+            events.OffsetCapacity(dmMath::Max(64U, events.Capacity()));
+        events.SetSize(events.Size() + 1);
+        CollisionEvent& event = events.Back();
+        event.m_Type = (uint8_t) type;
+        event.m_IdA = dmGameObject::GetIdentifier(component_a->m_Instance);
+        event.m_IdB = dmGameObject::GetIdentifier(component_b->m_Instance);
+        event.m_GroupA = GetLSBGroupHash(world, group_a);
+        event.m_GroupB = GetLSBGroupHash(world, group_b);
+        return event;
+    }
+
     bool CollisionCallback(void* user_data_a, uint16_t group_a, void* user_data_b, uint16_t group_b, void* user_data)
     {
         CollisionUserData* cud = (CollisionUserData*)user_data;
-        if (cud->m_Count < cud->m_Context->m_MaxCollisionCount)
+        if (cud->m_World->m_EventListener)
+        {
+            cud->m_Count += 1;
+            PushCollisionEvent(cud->m_World, COLLISION_EVENT_TYPE_COLLISION, (CollisionComponent*)user_data_a, group_a, (CollisionComponent*)user_data_b, group_b);
+            return true;
+        }
+        else if (cud->m_Count < cud->m_Context->m_MaxCollisionCount)
         {
             cud->m_Count += 1;
 
@@ -582,7 +642,23 @@ namespace dmGameSystem
     bool ContactPointCallback(const dmPhysics::ContactPoint& contact_point, void* user_data)
     {
         CollisionUserData* cud = (CollisionUserData*)user_data;
-        if (cud->m_Count < cud->m_Context->m_MaxContactPointCount)
+        if (cud->m_World->m_EventListener)
+        {
+            cud->m_Count += 1;
+            CollisionEvent& event = PushCollisionEvent(cud->m_World, COLLISION_EVENT_TYPE_CONTACT_POINT,
+                                                       (CollisionComponent*)contact_point.m_UserDataA, contact_point.m_GroupA,
+                                                       (CollisionComponent*)contact_point.m_UserDataB, contact_point.m_GroupB);
+            event.m_PositionA = contact_point.m_PositionA;
+            event.m_PositionB = contact_point.m_PositionB;
+            event.m_Normal = contact_point.m_Normal;
+            event.m_RelativeVelocity = contact_point.m_RelativeVelocity;
+            event.m_Distance = contact_point.m_Distance;
+            event.m_AppliedImpulse = contact_point.m_AppliedImpulse;
+            event.m_MassA = dmMath::Select(-contact_point.m_MassA, 0.0f, contact_point.m_MassA);
+            event.m_MassB = dmMath::Select(-contact_point.m_MassB, 0.0f, contact_point.m_MassB);
+            return true;
+        }
+        else if (cud->m_Count < cud->m_Context->m_MaxContactPointCount)
         {
             cud->m_Count += 1;
 
@@ -646,6 +722,12 @@ namespace dmGameSystem
     void TriggerEnteredCallback(const dmPhysics::TriggerEnter& trigger_enter, void* user_data)
     {
         CollisionWorld* world = (CollisionWorld*)user_data;
+        if (world->m_EventListener)
+        {
+            PushCollisionEvent(world, COLLISION_EVENT_TYPE_TRIGGER_ENTER, (CollisionComponent*)trigger_enter.m_UserDataA, trigger_enter.m_GroupA,
+                                                                          (CollisionComponent*)trigger_enter.m_UserDataB, trigger_enter.m_GroupB);
+            return;
+        }
         CollisionComponent* component_a = (CollisionComponent*)trigger_enter.m_UserDataA;
         CollisionComponent* component_b = (CollisionComponent*)trigger_enter.m_UserDataB;
         dmGameObject::HInstance instance_a = component_a->m_Instance;
@@ -677,6 +759,12 @@ namespace dmGameSystem
     void TriggerExitedCallback(const dmPhysics::TriggerExit& trigger_exit, void* user_data)
     {
         CollisionWorld* world = (CollisionWorld*)user_data;
+        if (world->m_EventListener)
+        {
+            PushCollisionEvent(world, COLLISION_EVENT_TYPE_TRIGGER_EXIT, (CollisionComponent*)trigger_exit.m_UserDataA, trigger_exit.m_GroupA,
+                                                                         (CollisionComponent*)trigger_exit.m_UserDataB, trigger_exit.m_GroupB);
+            return;
+        }
         CollisionComponent* component_a = (CollisionComponent*)trigger_exit.m_UserDataA;
         CollisionComponent* component_b = (CollisionComponent*)trigger_exit.m_UserDataB;
         dmGameObject::HInstance instance_a = component_a->m_Instance;
@@ -870,45 +958,101 @@ namespace dmGameSystem
         return dispatch_context.m_Success;
     }
 
-    dmGameObject::UpdateResult CompCollisionObjectUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
+    static void PushCollisionEvents(lua_State* L, void* user_context)
     {
-        if (params.m_World == 0x0)
-            return dmGameObject::UPDATE_RESULT_OK;
-        PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
-
-        dmGameObject::UpdateResult result = dmGameObject::UPDATE_RESULT_OK;
-        CollisionWorld* world = (CollisionWorld*)params.m_World;
-
-        if (!CompCollisionObjectDispatchPhysicsMessages(physics_context, world, params.m_Collection))
-            result = dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+        CollisionWorld* world = (CollisionWorld*)user_context;
+        static const dmhash_t event_types[] = {
+            dmPhysicsDDF::CollisionResponse::m_DDFDescriptor->m_NameHash,
+            dmPhysicsDDF::ContactPointResponse::m_DDFDescriptor->m_NameHash,
+            dmPhysicsDDF::TriggerResponse::m_DDFDescriptor->m_NameHash,
+            dmPhysicsDDF::TriggerResponse::m_DDFDescriptor->m_NameHash,
+        };
 
-        // Hot-reload is not available in release, so lets not iterate collision components in that case.
-        if (dLib::IsDebugMode())
+        uint32_t count = world->m_Events.Size();
+        lua_createtable(L, count, 0);
+        for (uint32_t i = 0; i < count; ++i)
         {
-            uint32_t num_components = world->m_Components.Size();
-            for (uint32_t i = 0; i < num_components; ++i)
+            const CollisionEvent& event = world->m_Events[i];
+            lua_createtable(L, 0, 14);
+            dmScript::PushHash(L, event_types[event.m_Type]);
+            lua_setfield(L, -2, "type");
+            dmScript::PushHash(L, event.m_IdA);
+            lua_setfield(L, -2, "id_a");
+            dmScript::PushHash(L, event.m_GroupA);
+            lua_setfield(L, -2, "group_a");
+            dmScript::PushHash(L, event.m_IdB);
+            lua_setfield(L, -2, "id_b");
+            dmScript::PushHash(L, event.m_GroupB);
+            lua_setfield(L, -2, "group_b");
+            if (event.m_Type == COLLISION_EVENT_TYPE_CONTACT_POINT)
             {
-                CollisionComponent* c = world->m_Components[i];
-                TileGridResource* tile_grid_res = c->m_Resource->m_TileGridResource;
-                if (tile_grid_res != 0x0 && tile_grid_res->m_Dirty)
-                {
-                    CollisionObjectResource* resource = c->m_Resource;
-                    dmPhysicsDDF::CollisionObjectDesc* ddf = resource->m_DDF;
-                    dmPhysics::CollisionObjectData data;
-                    SetCollisionObjectData(world, c, c->m_Resource, ddf, true, data);
-                    c->m_Mask = data.m_Mask;
+                dmScript::PushVector3(L, Vector3(event.m_PositionA));
+                lua_setfield(L, -2, "position_a");
+                dmScript::PushVector3(L, Vector3(event.m_PositionB));
+                lua_setfield(L, -2, "position_b");
+                dmScript::PushVector3(L, event.m_Normal);
+                lua_setfield(L, -2, "normal");
+                dmScript::PushVector3(L, event.m_RelativeVelocity);
+                lua_setfield(L, -2, "relative_velocity");
+                lua_pushnumber(L, event.m_Distance);
+                lua_setfield(L, -2, "distance");
+                lua_pushnumber(L, event.m_AppliedImpulse);
+                lua_setfield(L, -2, "applied_impulse");
+                lua_pushnumber(L, event.m_MassA);
+                lua_setfield(L, -2, "mass_a");
+                lua_pushnumber(L, event.m_MassB);
+                lua_setfield(L, -2, "mass_b");
+            }
+            else if (event.m_Type != COLLISION_EVENT_TYPE_COLLISION)
+            {
+                lua_pushboolean(L, event.m_Type == COLLISION_EVENT_TYPE_TRIGGER_ENTER);
+                lua_setfield(L, -2, "enter");
+            }
+            lua_rawseti(L, -2, i + 1);
+        }
+    }
 
-                    dmPhysics::DeleteCollisionObject2D(world->m_World2D, c->m_Object2D);
-                    dmArray<dmPhysics::HCollisionShape2D>& shapes = resource->m_TileGridResource->m_GridShapes;
-                    c->m_Object2D = dmPhysics::NewCollisionObject2D(world->m_World2D, data, &shapes.Front(), shapes.Size());
+    static void DispatchCollisionEvents(CollisionWorld* world)
+    {
+        DM_PROFILE(Physics, "DispatchEvents");
+        uint32_t count = world->m_Events.Size();
+        DM_COUNTER("PhysicsEvents", count);
+        if (count == 0)
+            return;
 
-                    SetupEmptyTileGrid(world, c);
-                    SetupTileGrid(world, c);
-                    tile_grid_res->m_Dirty = 0;
-                }
-            }
+        if (!dmScript::IsCallbackValid(world->m_EventListener))
+        {
+            // The listening script instance has been deleted, go back to posting messages
+            dmScript::DestroyCallback(world->m_EventListener);
+            world->m_EventListener = 0x0;
+            world->m_EventListenerOwner = 0x0;
         }
+        else if (!dmScript::InvokeCallback(world->m_EventListener, PushCollisionEvents, world))
+        {
+            dmLogError("Could not run physics event listener because the instance has been deleted.");
+        }
+        world->m_Events.SetSize(0);
+    }
+
+    bool SetCollisionEventListener(void* _world, dmGameObject::HInstance owner, dmScript::LuaCallbackInfo* listener)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        if (world->m_EventListener)
+        {
+            // A listener of a deleted instance is invalid and may be replaced by anyone
+            if (world->m_EventListenerOwner != owner && dmScript::IsCallbackValid(world->m_EventListener))
+                return false;
+            dmScript::DestroyCallback(world->m_EventListener);
+        }
+        world->m_EventListener = listener;
+        world->m_EventListenerOwner = listener ? owner : 0x0;
+        world->m_Events.SetSize(0);
+        return true;
+    }
 
+    /// Step the simulation and dispatch the resulting events
+    static void StepWorld(PhysicsContext* physics_context, CollisionWorld* world, float dt, bool fixed)
+    {
         CollisionUserData collision_user_data;
         collision_user_data.m_World = world;
         collision_user_data.m_Context = physics_context;
@@ -919,7 +1063,7 @@ namespace dmGameSystem
         contact_user_data.m_Count = 0;
 
         dmPhysics::StepWorldContext step_world_context;
-        step_world_context.m_DT = params.m_UpdateContext->m_DT;
+        step_world_context.m_DT = dt;
         step_world_context.m_CollisionCallback = CollisionCallback;
         step_world_context.m_CollisionUserData = &collision_user_data;
         step_world_context.m_ContactPointCallback = ContactPointCallback;
@@ -930,10 +1074,14 @@ namespace dmGameSystem
         step_world_context.m_TriggerExitedUserData = world;
         step_world_context.m_RayCastCallback = RayCastCallback;
         step_world_context.m_RayCastUserData = world;
+        if (fixed)
+        {
+            // One step per fixed update, keeping the previous transforms to interpolate from in the regular update
+            step_world_context.m_FixedTimeStep = 1;
+            step_world_context.m_SkipDebugDraw = 1;
+        }
 
-        world->m_LastDT = params.m_UpdateContext->m_DT;
-
-        g_NumPhysicsTransformsUpdated = 0;
+        world->m_LastDT = dt;
 
         if (physics_context->m_3D)
         {
@@ -944,36 +1092,129 @@ namespace dmGameSystem
             dmPhysics::StepWorld2D(world->m_World2D, step_world_context);
         }
 
-        update_result.m_TransformsUpdated = g_NumPhysicsTransformsUpdated > 0;
-
-        if (collision_user_data.m_Count >= physics_context->m_MaxCollisionCount)
+        if (world->m_EventListener)
         {
-            if (!g_CollisionOverflowWarning)
-            {
-                dmLogWarning("Maximum number of collisions (%d) reached, messages have been lost. Tweak \"%s\" in the config file.", physics_context->m_MaxCollisionCount, PHYSICS_MAX_COLLISIONS_KEY);
-                g_CollisionOverflowWarning = true;
-            }
+            // Buffered events are never dropped
+            DispatchCollisionEvents(world);
         }
         else
         {
-            g_CollisionOverflowWarning = false;
-        }
-        if (contact_user_data.m_Count >= physics_context->m_MaxContactPointCount)
-        {
-            if (!g_ContactOverflowWarning)
+            if (collision_user_data.m_Count >= physics_context->m_MaxCollisionCount)
             {
-                dmLogWarning("Maximum number of contacts (%d) reached, messages have been lost. Tweak \"%s\" in the config file.", physics_context->m_MaxContactPointCount, PHYSICS_MAX_CONTACTS_KEY);
-                g_ContactOverflowWarning = true;
+                if (!g_CollisionOverflowWarning)
+                {
+                    dmLogWarning("Maximum number of collisions (%d) reached, messages have been lost. Tweak \"%s\" in the config file.", physics_context->m_MaxCollisionCount, PHYSICS_MAX_COLLISIONS_KEY);
+                    g_CollisionOverflowWarning = true;
+                }
+            }
+            else
+            {
+                g_CollisionOverflowWarning = false;
+            }
+            if (contact_user_data.m_Count >= physics_context->m_MaxContactPointCount)
+            {
+                if (!g_ContactOverflowWarning)
+                {
+                    dmLogWarning("Maximum number of contacts (%d) reached, messages have been lost. Tweak \"%s\" in the config file.", physics_context->m_MaxContactPointCount, PHYSICS_MAX_CONTACTS_KEY);
+                    g_ContactOverflowWarning = true;
+                }
+            }
+            else
+            {
+                g_ContactOverflowWarning = false;
             }
         }
-        else
+    }
+
+    dmGameObject::UpdateResult CompCollisionObjectUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
+    {
+        if (params.m_World == 0x0)
+            return dmGameObject::UPDATE_RESULT_OK;
+        PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
+
+        dmGameObject::UpdateResult result = dmGameObject::UPDATE_RESULT_OK;
+        CollisionWorld* world = (CollisionWorld*)params.m_World;
+
+        if (!CompCollisionObjectDispatchPhysicsMessages(physics_context, world, params.m_Collection))
+            result = dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+
+        // Hot-reload is not available in release, so lets not iterate collision components in that case.
+        if (dLib::IsDebugMode())
         {
-            g_ContactOverflowWarning = false;
+            uint32_t num_components = world->m_Components.Size();
+            for (uint32_t i = 0; i < num_components; ++i)
+            {
+                CollisionComponent* c = world->m_Components[i];
+                TileGridResource* tile_grid_res = c->m_Resource->m_TileGridResource;
+                if (tile_grid_res != 0x0 && tile_grid_res->m_Dirty)
+                {
+                    CollisionObjectResource* resource = c->m_Resource;
+                    dmPhysicsDDF::CollisionObjectDesc* ddf = resource->m_DDF;
+                    dmPhysics::CollisionObjectData data;
+                    SetCollisionObjectData(world, c, c->m_Resource, ddf, true, data);
+                    c->m_Mask = data.m_Mask;
+
+                    dmPhysics::DeleteCollisionObject2D(world->m_World2D, c->m_Object2D);
+                    dmArray<dmPhysics::HCollisionShape2D>& shapes = resource->m_TileGridResource->m_GridShapes;
+                    c->m_Object2D = dmPhysics::NewCollisionObject2D(world->m_World2D, data, &shapes.Front(), shapes.Size());
+
+                    SetupEmptyTileGrid(world, c);
+                    SetupTileGrid(world, c);
+                    tile_grid_res->m_Dirty = 0;
+                }
+            }
         }
+
         if (physics_context->m_3D)
             dmPhysics::SetDrawDebug3D(world->m_World3D, physics_context->m_Debug);
         else
             dmPhysics::SetDrawDebug2D(world->m_World2D, physics_context->m_Debug);
+
+        g_NumPhysicsTransformsUpdated = 0;
+
+        if (physics_context->m_UseFixedTimeStep)
+        {
+            // Stepped in the fixed update, only move the objects between the steps here
+            if (physics_context->m_Interpolate)
+            {
+                float alpha = params.m_UpdateContext->m_FixedUpdateFraction;
+                if (physics_context->m_3D)
+                    dmPhysics::InterpolateTransforms3D(world->m_World3D, alpha);
+                else
+                    dmPhysics::InterpolateTransforms2D(world->m_World2D, alpha);
+            }
+            if (physics_context->m_3D)
+                dmPhysics::DrawDebug3D(world->m_World3D);
+            else
+                dmPhysics::DrawDebug2D(world->m_World2D);
+        }
+        else
+        {
+            StepWorld(physics_context, world, params.m_UpdateContext->m_DT, false);
+        }
+
+        update_result.m_TransformsUpdated = g_NumPhysicsTransformsUpdated > 0;
+        return result;
+    }
+
+    dmGameObject::UpdateResult CompCollisionObjectFixedUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
+    {
+        if (params.m_World == 0x0)
+            return dmGameObject::UPDATE_RESULT_OK;
+        PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
+        if (!physics_context->m_UseFixedTimeStep)
+            return dmGameObject::UPDATE_RESULT_OK;
+
+        dmGameObject::UpdateResult result = dmGameObject::UPDATE_RESULT_OK;
+        CollisionWorld* world = (CollisionWorld*)params.m_World;
+
+        // Messages posted by the fixed_update of scripts apply to this step
+        if (!CompCollisionObjectDispatchPhysicsMessages(physics_context, world, params.m_Collection))
+            result = dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+
+        g_NumPhysicsTransformsUpdated = 0;
+        StepWorld(physics_context, world, params.m_UpdateContext->m_DT, true);
+        update_result.m_TransformsUpdated = g_NumPhysicsTransformsUpdated > 0;
         return result;
     }
 
@@ -1221,6 +1462,45 @@ namespace dmGameSystem
         }
     }
 
+    void RayCastBatch(void* _world, const dmPhysics::RayCastRequest* requests, uint32_t count, dmPhysics::RayCastResponse* responses)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        if (world->m_3D)
+        {
+            dmPhysics::RayCastBatch3D(world->m_World3D, requests, count, responses);
+        }
+        else
+        {
+            dmPhysics::RayCastBatch2D(world->m_World2D, requests, count, responses);
+        }
+    }
+
+    void QueryOverlap(void* _world, const dmPhysics::OverlapRequest& request, dmArray<dmPhysics::OverlapResponse>& results)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        if (world->m_3D)
+        {
+            dmPhysics::QueryOverlap3D(world->m_World3D, request, results);
+        }
+        else
+        {
+            dmPhysics::QueryOverlap2D(world->m_World2D, request, results);
+        }
+    }
+
+    void ShapeCast(void* _world, const dmPhysics::ShapeCastRequest& request, dmPhysics::RayCastResponse& response)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        if (world->m_3D)
+        {
+            dmPhysics::ShapeCast3D(world->m_World3D, request, response);
+        }
+        else
+        {
+            dmPhysics::ShapeCast2D(world->m_World2D, request, response);
+        }
+    }
+
     // Find a JointEntry in the linked list of a collision component based on the joint id.
     static JointEntry* FindJointEntry(CollisionWorld* world, CollisionComponent* component, dmhash_t id)
     {
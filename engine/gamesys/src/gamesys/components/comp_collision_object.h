@@ -20,6 +20,11 @@
 
 template <typename T> class dmArray;
 
+namespace dmScript
+{
+    struct LuaCallbackInfo;
+}
+
 namespace dmGameSystem
 {
     dmGameObject::CreateResult CompCollisionObjectNewWorld(const dmGameObject::ComponentNewWorldParams& params);
@@ -36,6 +41,8 @@ namespace dmGameSystem
 
     dmGameObject::UpdateResult CompCollisionObjectUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result);
 
+    dmGameObject::UpdateResult CompCollisionObjectFixedUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result);
+
     dmGameObject::UpdateResult CompCollisionObjectPostUpdate(const dmGameObject::ComponentsPostUpdateParams& params);
 
     dmGameObject::UpdateResult CompCollisionObjectOnMessage(const dmGameObject::ComponentOnMessageParams& params);
@@ -50,6 +57,11 @@ namespace dmGameSystem
 
     // For script_physics.cpp
     void RayCast(void* world, const dmPhysics::RayCastRequest& request, dmArray<dmPhysics::RayCastResponse>& results);
+    void RayCastBatch(void* world, const dmPhysics::RayCastRequest* requests, uint32_t count, dmPhysics::RayCastResponse* responses);
+    void QueryOverlap(void* world, const dmPhysics::OverlapRequest& request, dmArray<dmPhysics::OverlapResponse>& results);
+    void ShapeCast(void* world, const dmPhysics::ShapeCastRequest& request, dmPhysics::RayCastResponse& response);
+    // Returns false if the listener of the world is held by another script instance
+    bool SetCollisionEventListener(void* world, dmGameObject::HInstance owner, dmScript::LuaCallbackInfo* listener);
     uint64_t GetLSBGroupHash(void* world, uint16_t mask);
     dmhash_t CompCollisionObjectGetIdentifier(void* component);
 
@@ -38,22 +38,34 @@
 namespace dmGameSystem
 {
     const uint32_t TILEGRID_REGION_SIZE = 32;
+    // Region vertex ranges are reserved in whole rows of tiles, so that adding a few
+    // tiles to a region seldom requires the regions of the layer to be laid out again
+    const uint32_t TILEGRID_REGION_VERTEX_ALIGNMENT = 6 * TILEGRID_REGION_SIZE;
 
     using namespace Vectormath::Aos;
 
-    // A "region" spans all layers (in Z) for a bounding box [(x1,y1), (x2,y2)]
-    // where the the box spans TILEGRID_REGION_SIZE tiles in each direction
+    // A "region" spans a bounding box [(x1,y1), (x2,y2)] of one layer
+    // where the the box spans TILEGRID_REGION_SIZE tiles in each direction.
+    // The vertices of a region are kept in a range of the vertex buffer of its layer,
+    // and are only regenerated when a tile in the region changes
     struct TileGridRegion
     {
-        uint8_t m_Dirty:1;
-        uint8_t m_Occupied:1;
-        uint8_t :6;
+        uint32_t m_VertexStart;
+        uint32_t m_VertexCapacity;  // The part of the range not used by tiles is filled with degenerate triangles
+        uint16_t m_TileCount;       // Number of non empty cells
+        uint8_t  m_Dirty:1;
+        uint8_t  :7;
     };
 
     struct TileGridLayer
     {
-        uint8_t m_IsVisible:1;
-        uint8_t :7;
+        dmGraphics::HVertexBuffer   m_VertexBuffer;
+        uint32_t                    m_VertexCount;  // Sum of the vertex capacity of all regions in the layer
+        uint32_t                    m_TileCount;    // Number of non empty cells
+        uint8_t                     m_IsVisible:1;
+        uint8_t                     m_Dirty:1;      // One or more regions need to be regenerated
+        uint8_t                     m_Relayout:1;   // A region outgrew its vertex range
+        uint8_t                     :5;
     };
 
     struct TileGridComponent
@@ -66,34 +78,39 @@ namespace dmGameSystem
         };
 
         TileGridComponent()
-        : m_Instance(0)
+        : m_World(Matrix4::identity())
+        , m_VertexWorld(Matrix4::identity())
+        , m_Instance(0)
         , m_Material(0)
         , m_TextureSet(0)
         , m_Resource(0)
         , m_Cells(0)
         , m_CellFlags(0)
+        , m_CachedTextureSet(0)
         {
         }
 
         Vectormath::Aos::Vector3    m_Translation;
         Vectormath::Aos::Quat       m_Rotation;
         Vectormath::Aos::Matrix4    m_World;
+        Vectormath::Aos::Matrix4    m_VertexWorld; // The transform baked into the vertices, for materials in world vertex space
         dmGameObject::HInstance     m_Instance;
         uint16_t*                   m_Cells;
         Flags*                      m_CellFlags;
-        dmArray<TileGridRegion>     m_Regions;
+        dmArray<TileGridRegion>     m_Regions; // layer major, i.e. [layer][region]
         dmArray<TileGridLayer>      m_Layers;
         uint32_t                    m_MixedHash;
         CompRenderConstants         m_RenderConstants;
         dmRender::HMaterial         m_Material;
         TextureSetResource*         m_TextureSet;
         TileGridResource*           m_Resource;
+        dmGameSystemDDF::TextureSet* m_CachedTextureSet; // The texture set the vertices were created with
         uint16_t                    m_RegionsX; // number of regions in the x dimension
         uint16_t                    m_RegionsY; // number of regions in the y dimension
-        uint16_t                    m_Occupied; // Number of occupied regions (regions with visible tiles)
         uint8_t                     m_Enabled : 1;
         uint8_t                     m_AddedToUpdate : 1;
-        uint8_t                     : 6;
+        uint8_t                     m_LocalVertexSpace : 1; // The vertices are in local space, and the world transform is applied by the material
+        uint8_t                     : 5;
     };
 
     struct TileGridVertex
@@ -113,13 +130,13 @@ namespace dmGameSystem
         dmArray<dmRender::RenderObject> m_RenderObjects;
         dmGraphics::HVertexDeclaration  m_VertexDeclaration;
 
-        dmGraphics::HVertexBuffer       m_VertexBuffer;
+        // Scratch memory used when (re)building the vertices of a single region
         TileGridVertex*                 m_VertexBufferData;
-        TileGridVertex*                 m_VertexBufferDataEnd;
-        TileGridVertex*                 m_VertexBufferWritePtr;
 
         uint32_t                        m_MaxTilemapCount;
         uint32_t                        m_MaxTileCount;
+        uint32_t                        m_TileCount;            // Number of tiles rendered this frame
+        uint32_t                        m_UploadedVertexCount;  // Number of vertices uploaded this frame
     };
 
     static void TileGridWorldAllocate(TileGridWorld* world)
@@ -135,10 +152,8 @@ namespace dmGameSystem
                 {"texcoord0", 1, 2, dmGraphics::TYPE_FLOAT, false},
         };
         world->m_VertexDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, ve, sizeof(ve) / sizeof(ve[0]));
-        world->m_VertexBuffer = dmGraphics::NewVertexBuffer(dmRender::GetGraphicsContext(world->m_RenderContext), 0, 0x0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
-        uint32_t vcount = 6 * world->m_MaxTileCount;
+        uint32_t vcount = 6 * TILEGRID_REGION_SIZE * TILEGRID_REGION_SIZE;
         world->m_VertexBufferData = (TileGridVertex*) malloc(sizeof(TileGridVertex) * vcount);
-        world->m_VertexBufferDataEnd = world->m_VertexBufferData + vcount;
     }
 
     dmGameObject::CreateResult CompTileGridNewWorld(const dmGameObject::ComponentNewWorldParams& params)
@@ -164,7 +179,6 @@ namespace dmGameSystem
         if (world->m_VertexDeclaration)
         {
             dmGraphics::DeleteVertexDeclaration(world->m_VertexDeclaration);
-            dmGraphics::DeleteVertexBuffer(world->m_VertexBuffer);
             free(world->m_VertexBufferData);
         }
         delete world;
@@ -213,26 +227,71 @@ namespace dmGameSystem
         layer->m_IsVisible = visible;
     }
 
-    static void SetRegionDirty(TileGridComponent* component, int32_t cell_x, int32_t cell_y)
+    static inline TileGridRegion* GetRegion(TileGridComponent* component, uint32_t layer, uint32_t region_x, uint32_t region_y)
     {
-        uint32_t region_x = cell_x / TILEGRID_REGION_SIZE;
-        uint32_t region_y = cell_y / TILEGRID_REGION_SIZE;
-        uint32_t region_index = region_y * component->m_RegionsX + region_x;
-        TileGridRegion* region = &component->m_Regions[region_index];
-        region->m_Dirty = 1;
+        uint32_t region_count = component->m_RegionsX * component->m_RegionsY;
+        return &component->m_Regions[layer * region_count + region_y * component->m_RegionsX + region_x];
+    }
+
+    // Marks all regions for regeneration, e.g. when the tile source changed
+    static void SetLayersDirty(TileGridComponent* component)
+    {
+        uint32_t n = component->m_Regions.Size();
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            component->m_Regions[i].m_Dirty = 1;
+        }
+        n = component->m_Layers.Size();
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            component->m_Layers[i].m_Dirty = 1;
+        }
+    }
+
+    static void DeleteLayerBuffers(TileGridComponent* component)
+    {
+        uint32_t n = component->m_Layers.Size();
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            TileGridLayer* layer = &component->m_Layers[i];
+            if (layer->m_VertexBuffer)
+            {
+                dmGraphics::DeleteVertexBuffer(layer->m_VertexBuffer);
+                layer->m_VertexBuffer = 0;
+            }
+        }
     }
 
     void SetTileGridTile(TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t tile, bool flip_h, bool flip_v)
     {
         TileGridResource* resource = component->m_Resource;
         uint32_t cell_index = CalculateCellIndex(layer, cell_x, cell_y, resource->m_ColumnCount, resource->m_RowCount);
+        bool was_empty = component->m_Cells[cell_index] == 0xffff;
         component->m_Cells[cell_index] = tile;
+        bool is_empty = component->m_Cells[cell_index] == 0xffff;
 
         TileGridComponent::Flags* flags = &component->m_CellFlags[cell_index];
         flags->m_FlipHorizontal = flip_h;
         flags->m_FlipVertical = flip_v;
 
-        SetRegionDirty(component, cell_x, cell_y);
+        TileGridLayer* grid_layer = &component->m_Layers[layer];
+        TileGridRegion* region = GetRegion(component, layer, cell_x / TILEGRID_REGION_SIZE, cell_y / TILEGRID_REGION_SIZE);
+        if (was_empty && !is_empty)
+        {
+            ++region->m_TileCount;
+            ++grid_layer->m_TileCount;
+        }
+        else if (!was_empty && is_empty)
+        {
+            --region->m_TileCount;
+            --grid_layer->m_TileCount;
+        }
+        region->m_Dirty = 1;
+        grid_layer->m_Dirty = 1;
+        if (region->m_TileCount * 6 > region->m_VertexCapacity)
+        {
+            grid_layer->m_Relayout = 1;
+        }
     }
 
     uint16_t GetTileCount(const TileGridComponent* component) {
@@ -259,71 +318,11 @@ namespace dmGameSystem
         // Round up to closest multiple
         component->m_RegionsX = ((resource->m_ColumnCount + TILEGRID_REGION_SIZE - 1) / TILEGRID_REGION_SIZE);
         component->m_RegionsY = ((resource->m_RowCount + TILEGRID_REGION_SIZE - 1) / TILEGRID_REGION_SIZE);
-        uint32_t region_count = component->m_RegionsX * component->m_RegionsY;
+        uint32_t region_count = component->m_RegionsX * component->m_RegionsY * resource->m_TileGrid->m_Layers.m_Count;
 
         component->m_Regions.SetCapacity(region_count);
         component->m_Regions.SetSize(region_count);
-        memset(&component->m_Regions[0], 0xFF, region_count * sizeof(TileGridRegion)); // mark them all dirty
-    }
-
-    static uint32_t UpdateRegion(TileGridComponent* component, uint32_t region_x, uint32_t region_y)
-    {
-        uint32_t index = region_y * component->m_RegionsX + region_x;
-        TileGridRegion* region = &component->m_Regions[index];
-        if (!region->m_Dirty) {
-            return region->m_Occupied;
-        }
-        region->m_Dirty = 0;
-
-        TileGridResource* resource = component->m_Resource;
-        dmGameSystemDDF::TileGrid* tile_grid_ddf = resource->m_TileGrid;
-
-        uint32_t n_layers = tile_grid_ddf->m_Layers.m_Count;
-
-        uint32_t column_count = resource->m_ColumnCount;
-        uint32_t row_count = resource->m_RowCount;
-        int32_t min_x = resource->m_MinCellX + region_x * TILEGRID_REGION_SIZE;
-        int32_t min_y = resource->m_MinCellY + region_y * TILEGRID_REGION_SIZE;
-        int32_t max_x = dmMath::Min(min_x + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellX + (int32_t)column_count);
-        int32_t max_y = dmMath::Min(min_y + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellY + (int32_t)row_count);
-
-        region->m_Occupied = 0;
-
-        uint32_t visible_tiles = 0;
-        for (uint32_t j = 0; j < n_layers; ++j)
-        {
-            TileGridLayer* layer = &component->m_Layers[j];
-            if (!layer->m_IsVisible)
-                continue;
-
-            for (int32_t y = min_y; y < max_y; ++y)
-            {
-                for (int32_t x = min_x; x < max_x; ++x)
-                {
-                    uint32_t cell = CalculateCellIndex(j, x - resource->m_MinCellX, y - resource->m_MinCellY, column_count, row_count);
-                    uint16_t tile = component->m_Cells[cell];
-                    if (tile != 0xffff)
-                    {
-                        ++visible_tiles;
-                        region->m_Occupied = 1;
-                        return region->m_Occupied;
-                    }
-                }
-            }
-        }
-
-        return region->m_Occupied;
-    }
-
-    static uint32_t UpdateRegions(TileGridComponent* component)
-    {
-        uint32_t occupied = 0;
-        for (uint32_t region_y = 0; region_y < component->m_RegionsY; ++region_y) {
-            for (uint32_t region_x = 0; region_x < component->m_RegionsX; ++region_x) {
-                occupied += UpdateRegion(component, region_x, region_y);
-            }
-        }
-        return occupied;
+        memset(component->m_Regions.Begin(), 0, region_count * sizeof(TileGridRegion));
     }
 
     static uint32_t CreateTileGrid(TileGridComponent* component)
@@ -349,20 +348,34 @@ namespace dmGameSystem
         uint32_t column_count = resource->m_ColumnCount;
         uint32_t row_count = resource->m_RowCount;
 
+        DeleteLayerBuffers(component);
         component->m_Layers.SetCapacity(n_layers);
         component->m_Layers.SetSize(n_layers);
+        memset(component->m_Layers.Begin(), 0, n_layers * sizeof(TileGridLayer));
+
+        CreateRegions(component, resource);
 
         for (uint32_t i = 0; i < n_layers; ++i)
         {
             dmGameSystemDDF::TileLayer* layer_ddf = &tile_grid_ddf->m_Layers[i];
 
-            component->m_Layers[i].m_IsVisible = layer_ddf->m_IsVisible;
+            TileGridLayer* layer = &component->m_Layers[i];
+            layer->m_IsVisible = layer_ddf->m_IsVisible;
+            layer->m_Dirty = 1;
+            layer->m_Relayout = 1;
 
             uint32_t n_cells = layer_ddf->m_Cell.m_Count;
             for (uint32_t j = 0; j < n_cells; ++j)
             {
                 dmGameSystemDDF::TileCell* cell = &layer_ddf->m_Cell[j];
-                uint32_t cell_index = CalculateCellIndex(i, cell->m_X - min_x, cell->m_Y - min_y, column_count, row_count);
+                int32_t cell_x = cell->m_X - min_x;
+                int32_t cell_y = cell->m_Y - min_y;
+                uint32_t cell_index = CalculateCellIndex(i, cell_x, cell_y, column_count, row_count);
+                if (component->m_Cells[cell_index] == 0xffff)
+                {
+                    ++GetRegion(component, i, cell_x / TILEGRID_REGION_SIZE, cell_y / TILEGRID_REGION_SIZE)->m_TileCount;
+                    ++layer->m_TileCount;
+                }
                 component->m_Cells[cell_index] = (uint16_t)cell->m_Tile;
 
                 TileGridComponent::Flags* flags = &component->m_CellFlags[cell_index];
@@ -371,8 +384,6 @@ namespace dmGameSystem
             }
         }
 
-        CreateRegions(component, resource);
-        component->m_Occupied = UpdateRegions(component);
         return n_layers;
     }
 
@@ -406,16 +417,6 @@ namespace dmGameSystem
         world->m_Components.Push(component);
         *params.m_UserData = (uintptr_t) component;
 
-        uint32_t num_layers = 0;
-        uint32_t n = world->m_Components.Size();
-        for (uint32_t i = 0; i < n; ++i)
-        {
-            TileGridComponent* component = world->m_Components[i];
-            dmGameSystemDDF::TileGrid* tile_grid_ddf = component->m_Resource->m_TileGrid;
-            num_layers += tile_grid_ddf->m_Layers.m_Count;
-        }
-        world->m_RenderObjects.SetCapacity(num_layers);
-
         ReHash(component);
         return dmGameObject::CREATE_RESULT_OK;
     }
@@ -435,6 +436,7 @@ namespace dmGameSystem
                     dmResource::Release(dmGameObject::GetFactory(params.m_Instance), tile_grid->m_TextureSet);
                 }
 
+                DeleteLayerBuffers(tile_grid);
                 delete [] tile_grid->m_Cells;
                 delete [] tile_grid->m_CellFlags;
                 world->m_Components.EraseSwap(i);
@@ -473,11 +475,6 @@ namespace dmGameSystem
                 continue;
             }
 
-            component->m_Occupied = UpdateRegions(component);
-            if (!component->m_Occupied) {
-                continue;
-            }
-
             Matrix4 local(component->m_Rotation, component->m_Translation);
             const Matrix4& go_world = dmGameObject::GetWorldMatrix(component->m_Instance);
             if (dmGameObject::ScaleAlongZ(component->m_Instance))
@@ -492,20 +489,18 @@ namespace dmGameSystem
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
-    static inline uint64_t EncodeRegionInfo(uint32_t tile_grid, uint32_t layer, uint32_t region_x, uint32_t region_y)
+    static inline uint64_t EncodeLayerInfo(uint32_t tile_grid, uint32_t layer)
     {
-        return (uint64_t)( (tile_grid & 0xFFFF) | ((layer & 0xFFFF) << 16) | ((uint64_t)region_x << 32) | ((uint64_t)region_y << 48) );
+        return (uint64_t)tile_grid | ((uint64_t)layer << 32);
     }
 
-    static inline void DecodeGridAndLayer(uint64_t ptr, uint32_t& tile_grid, uint32_t& layer, uint32_t& region_x, uint32_t& region_y)
+    static inline void DecodeGridAndLayer(uint64_t ptr, uint32_t& tile_grid, uint32_t& layer)
     {
-        tile_grid = ptr & 0xFFFF;
-        layer = (ptr >> 16) & 0xFFFF;
-        region_x = (ptr >> 32) & 0xFFFF;
-        region_y = (ptr >> 48) & 0xFFFF;
+        tile_grid = (uint32_t)(ptr & 0xFFFFFFFF);
+        layer = (uint32_t)(ptr >> 32);
     }
 
-    TileGridVertex* CreateVertexData(TileGridWorld* world, TileGridVertex* where, TextureSetResource* texture_set, dmRender::RenderListEntry* buf, uint32_t* begin, uint32_t* end)
+    static TileGridVertex* CreateRegionVertexData(const TileGridComponent* component, TextureSetResource* texture_set, const Matrix4& w, uint32_t layer, uint32_t region_x, uint32_t region_y, TileGridVertex* where)
     {
         DM_PROFILE(TileGrid, "CreateVertexData");
         static int tex_coord_order[] = {
@@ -521,150 +516,227 @@ namespace dmGameSystem
         uint32_t tile_width = texture_set_ddf->m_TileWidth;
         uint32_t tile_height = texture_set_ddf->m_TileHeight;
 
-        for (uint32_t* i = begin; i != end; ++i)
-        {
-            uint32_t index, layer, region_x, region_y;
-            DecodeGridAndLayer(buf[*i].m_UserData, index, layer, region_x, region_y);
-
-            const TileGridComponent* component = world->m_Components[index];
-            const TileGridResource* resource = component->m_Resource;
-            dmGameSystemDDF::TileGrid* tile_grid_ddf = resource->m_TileGrid;
-            dmGameSystemDDF::TileLayer* layer_ddf = &tile_grid_ddf->m_Layers[layer];
+        const TileGridResource* resource = component->m_Resource;
+        dmGameSystemDDF::TileGrid* tile_grid_ddf = resource->m_TileGrid;
+        dmGameSystemDDF::TileLayer* layer_ddf = &tile_grid_ddf->m_Layers[layer];
 
-            const Matrix4& w = component->m_World;
-            const float z = layer_ddf->m_Z;
+        const float z = layer_ddf->m_Z;
 
-            uint32_t column_count = resource->m_ColumnCount;
-            uint32_t row_count = resource->m_RowCount;
+        uint32_t column_count = resource->m_ColumnCount;
+        uint32_t row_count = resource->m_RowCount;
 
-            int32_t min_x = resource->m_MinCellX + region_x * TILEGRID_REGION_SIZE;
-            int32_t min_y = resource->m_MinCellY + region_y * TILEGRID_REGION_SIZE;
-            int32_t max_x = dmMath::Min(min_x + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellX + (int32_t)column_count);
-            int32_t max_y = dmMath::Min(min_y + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellY + (int32_t)row_count);
+        int32_t min_x = resource->m_MinCellX + region_x * TILEGRID_REGION_SIZE;
+        int32_t min_y = resource->m_MinCellY + region_y * TILEGRID_REGION_SIZE;
+        int32_t max_x = dmMath::Min(min_x + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellX + (int32_t)column_count);
+        int32_t max_y = dmMath::Min(min_y + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellY + (int32_t)row_count);
 
-            for (int32_t y = min_y; y < max_y; ++y)
+        for (int32_t y = min_y; y < max_y; ++y)
+        {
+            for (int32_t x = min_x; x < max_x; ++x)
             {
-                for (int32_t x = min_x; x < max_x; ++x)
+                uint32_t cell = CalculateCellIndex(layer, x - resource->m_MinCellX, y - resource->m_MinCellY, column_count, row_count);
+                uint16_t tile = component->m_Cells[cell];
+                if (tile == 0xffff)
                 {
-                    uint32_t cell = CalculateCellIndex(layer, x - resource->m_MinCellX, y - resource->m_MinCellY, column_count, row_count);
-                    uint16_t tile = component->m_Cells[cell];
-                    if (tile == 0xffff)
-                    {
-                        continue;
-                    }
+                    continue;
+                }
 
-                    if( where >= world->m_VertexBufferDataEnd )
-                    {
-                        dmLogError("Out of tiles to render (%zu). You can change this with the game.project setting tilemap.max_tile_count", (size_t)((world->m_VertexBufferDataEnd - world->m_VertexBufferData) / 6));
-                        return world->m_VertexBufferDataEnd;
+                float p[4];
+                CalculateCellBounds(x, y, 1, 1, p);
+                const float* puv = &tex_coords[tile * 8];
+                uint32_t flip_flag = 0;
+
+                TileGridComponent::Flags flags = component->m_CellFlags[cell];
+                if (flags.m_FlipHorizontal)
+                {
+                    flip_flag = 1;
+                }
+                if (flags.m_FlipVertical)
+                {
+                    flip_flag |= 2;
+                }
+                const int* tex_lookup = &tex_coord_order[flip_flag * 6];
+
+                #define SET_VERTEX(_I, _X, _Y, _Z, _U, _V) \
+                    { \
+                        const Vector4 v = w * Point3(_X * tile_width, _Y * tile_height, _Z); \
+                        where[_I].x = v.getX(); \
+                        where[_I].y = v.getY(); \
+                        where[_I].z = v.getZ(); \
+                        where[_I].u = _U; \
+                        where[_I].v = _V; \
                     }
 
-                    float p[4];
-                    CalculateCellBounds(x, y, 1, 1, p);
-                    const float* puv = &tex_coords[tile * 8];
-                    uint32_t flip_flag = 0;
+                SET_VERTEX(0, p[0], p[1], z, puv[tex_lookup[0] * 2], puv[tex_lookup[0] * 2 + 1]);
+                SET_VERTEX(1, p[0], p[3], z, puv[tex_lookup[1] * 2], puv[tex_lookup[1] * 2 + 1]);
+                SET_VERTEX(2, p[2], p[3], z, puv[tex_lookup[2] * 2], puv[tex_lookup[2] * 2 + 1]);
+                SET_VERTEX(3, p[2], p[3], z, puv[tex_lookup[3] * 2], puv[tex_lookup[3] * 2 + 1]);
+                SET_VERTEX(4, p[2], p[1], z, puv[tex_lookup[4] * 2], puv[tex_lookup[4] * 2 + 1]);
+                SET_VERTEX(5, p[0], p[1], z, puv[tex_lookup[5] * 2], puv[tex_lookup[5] * 2 + 1]);
 
-                    TileGridComponent::Flags flags = component->m_CellFlags[cell];
-                    if (flags.m_FlipHorizontal)
-                    {
-                        flip_flag = 1;
-                    }
-                    if (flags.m_FlipVertical)
-                    {
-                        flip_flag |= 2;
-                    }
-                    const int* tex_lookup = &tex_coord_order[flip_flag * 6];
-
-                    #define SET_VERTEX(_I, _X, _Y, _Z, _U, _V) \
-                        { \
-                            const Vector4 v = w * Point3(_X * tile_width, _Y * tile_height, _Z); \
-                            where[_I].x = v.getX(); \
-                            where[_I].y = v.getY(); \
-                            where[_I].z = v.getZ(); \
-                            where[_I].u = _U; \
-                            where[_I].v = _V; \
-                        }
-
-                    SET_VERTEX(0, p[0], p[1], z, puv[tex_lookup[0] * 2], puv[tex_lookup[0] * 2 + 1]);
-                    SET_VERTEX(1, p[0], p[3], z, puv[tex_lookup[1] * 2], puv[tex_lookup[1] * 2 + 1]);
-                    SET_VERTEX(2, p[2], p[3], z, puv[tex_lookup[2] * 2], puv[tex_lookup[2] * 2 + 1]);
-                    SET_VERTEX(3, p[2], p[3], z, puv[tex_lookup[3] * 2], puv[tex_lookup[3] * 2 + 1]);
-                    SET_VERTEX(4, p[2], p[1], z, puv[tex_lookup[4] * 2], puv[tex_lookup[4] * 2 + 1]);
-                    SET_VERTEX(5, p[0], p[1], z, puv[tex_lookup[5] * 2], puv[tex_lookup[5] * 2 + 1]);
-
-                    where += 6;
-
-                    #undef SET_VERTEX
-                }
+                where += 6;
+
+                #undef SET_VERTEX
             }
         }
         return where;
     }
 
-    static void RenderBatch(TileGridWorld* world, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
+    // Lays out the vertex ranges of all regions in the layer back to back and reallocates the layer vertex buffer
+    static void CreateLayerRanges(TileGridWorld* world, TileGridComponent* component, TileGridLayer* layer, uint32_t layer_index)
     {
-        DM_PROFILE(TileGrid, "RenderBatch");
+        uint32_t region_count = component->m_RegionsX * component->m_RegionsY;
+        TileGridRegion* regions = &component->m_Regions[layer_index * region_count];
+        uint32_t vertex_count = 0;
+        for (uint32_t i = 0; i < region_count; ++i)
+        {
+            TileGridRegion* region = &regions[i];
+            uint32_t capacity = region->m_TileCount * 6;
+            capacity = ((capacity + TILEGRID_REGION_VERTEX_ALIGNMENT - 1) / TILEGRID_REGION_VERTEX_ALIGNMENT) * TILEGRID_REGION_VERTEX_ALIGNMENT;
+            region->m_VertexStart = vertex_count;
+            region->m_VertexCapacity = capacity;
+            region->m_Dirty = 1;
+            vertex_count += capacity;
+        }
 
-        uint32_t index, layer, region_x, region_y;
-        DecodeGridAndLayer(buf[*begin].m_UserData, index, layer, region_x, region_y);
-        const TileGridComponent* first = world->m_Components[index];
-        assert(first->m_Enabled);
+        uint32_t buffer_size = sizeof(TileGridVertex) * vertex_count;
+        if (layer->m_VertexBuffer == 0)
+        {
+            dmGraphics::HContext graphics_context = dmRender::GetGraphicsContext(world->m_RenderContext);
+            layer->m_VertexBuffer = dmGraphics::NewVertexBuffer(graphics_context, buffer_size, 0x0, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+        }
+        else
+        {
+            dmGraphics::SetVertexBufferData(layer->m_VertexBuffer, buffer_size, 0x0, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+        }
+        layer->m_VertexCount = vertex_count;
+        layer->m_Relayout = 0;
+    }
 
-        TileGridResource* resource = first->m_Resource;
-        TextureSetResource* texture_set = GetTextureSet(first);
+    // Regenerates the vertices of the dirty regions in the layer and uploads them to their ranges of the layer vertex buffer
+    static void UpdateLayer(TileGridWorld* world, TileGridComponent* component, uint32_t layer_index)
+    {
+        TileGridLayer* layer = &component->m_Layers[layer_index];
+        if (!layer->m_Dirty)
+        {
+            return;
+        }
+        DM_PROFILE(TileGrid, "UpdateLayer");
 
-        dmRender::RenderObject& ro = *world->m_RenderObjects.End();
-        world->m_RenderObjects.SetSize(world->m_RenderObjects.Size()+1);
+        if (layer->m_Relayout)
+        {
+            CreateLayerRanges(world, component, layer, layer_index);
+        }
 
-        // Fill in vertex buffer
-        TileGridVertex* vb_begin = world->m_VertexBufferWritePtr;
-        world->m_VertexBufferWritePtr = CreateVertexData(world, vb_begin, texture_set, buf, begin, end);
+        TextureSetResource* texture_set = GetTextureSet(component);
+        const Matrix4 w = component->m_LocalVertexSpace ? Matrix4::identity() : component->m_VertexWorld;
+        for (uint32_t region_y = 0; region_y < component->m_RegionsY; ++region_y)
+        {
+            for (uint32_t region_x = 0; region_x < component->m_RegionsX; ++region_x)
+            {
+                TileGridRegion* region = GetRegion(component, layer_index, region_x, region_y);
+                if (!region->m_Dirty)
+                {
+                    continue;
+                }
+                region->m_Dirty = 0;
+                if (region->m_VertexCapacity == 0)
+                {
+                    continue;
+                }
 
-        ro.Init();
-        ro.m_VertexDeclaration = world->m_VertexDeclaration;
-        ro.m_VertexBuffer = world->m_VertexBuffer;
-        ro.m_PrimitiveType = dmGraphics::PRIMITIVE_TRIANGLES;
-        ro.m_VertexStart = vb_begin - world->m_VertexBufferData;
-        ro.m_VertexCount = (world->m_VertexBufferWritePtr - vb_begin);
-        ro.m_Material = GetMaterial(first);
-        ro.m_Textures[0] = texture_set->m_Texture;
+                TileGridVertex* vb_begin = world->m_VertexBufferData;
+                TileGridVertex* vb_end = CreateRegionVertexData(component, texture_set, w, layer_index, region_x, region_y, vb_begin);
+                uint32_t vertex_count = vb_end - vb_begin;
+                assert(vertex_count <= region->m_VertexCapacity);
+                memset(vb_end, 0, sizeof(TileGridVertex) * (region->m_VertexCapacity - vertex_count));
 
-        const dmRender::Constant* constants = first->m_RenderConstants.m_RenderConstants;
-        uint32_t size = first->m_RenderConstants.m_ConstantCount;
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            const dmRender::Constant& c = constants[i];
-            dmRender::EnableRenderObjectConstant(&ro, c.m_NameHash, c.m_Value);
+                dmGraphics::SetVertexBufferSubData(layer->m_VertexBuffer, sizeof(TileGridVertex) * region->m_VertexStart, sizeof(TileGridVertex) * region->m_VertexCapacity, vb_begin);
+                world->m_UploadedVertexCount += region->m_VertexCapacity;
+            }
         }
+        layer->m_Dirty = 0;
+    }
 
-        dmGameSystemDDF::TileGrid::BlendMode blend_mode = resource->m_TileGrid->m_BlendMode;
-        switch (blend_mode)
+    static void RenderBatch(TileGridWorld* world, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
+    {
+        DM_PROFILE(TileGrid, "RenderBatch");
+
+        for (uint32_t* i = begin; i != end; ++i)
         {
-            case dmGameSystemDDF::TileGrid::BLEND_MODE_ALPHA:
-                ro.m_SourceBlendFactor = dmGraphics::BLEND_FACTOR_ONE;
-                ro.m_DestinationBlendFactor = dmGraphics::BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-            break;
+            uint32_t index, layer_index;
+            DecodeGridAndLayer(buf[*i].m_UserData, index, layer_index);
+            TileGridComponent* component = world->m_Components[index];
+            assert(component->m_Enabled);
+
+            TileGridLayer* layer = &component->m_Layers[layer_index];
+            // Skip the layer, but keep rendering the rest of the batch, smaller layers may still fit
+            if (world->m_TileCount + layer->m_TileCount > world->m_MaxTileCount)
+            {
+                dmLogError("Out of tiles to render (%u). You can change this with the game.project setting tilemap.max_tile_count", world->m_MaxTileCount);
+                continue;
+            }
+            world->m_TileCount += layer->m_TileCount;
 
-            case dmGameSystemDDF::TileGrid::BLEND_MODE_ADD:
-            case dmGameSystemDDF::TileGrid::BLEND_MODE_ADD_ALPHA:
-                ro.m_SourceBlendFactor = dmGraphics::BLEND_FACTOR_ONE;
-                ro.m_DestinationBlendFactor = dmGraphics::BLEND_FACTOR_ONE;
-            break;
+            UpdateLayer(world, component, layer_index);
 
-            case dmGameSystemDDF::TileGrid::BLEND_MODE_MULT:
-                ro.m_SourceBlendFactor = dmGraphics::BLEND_FACTOR_DST_COLOR;
-                ro.m_DestinationBlendFactor = dmGraphics::BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-            break;
+            TileGridResource* resource = component->m_Resource;
+            TextureSetResource* texture_set = GetTextureSet(component);
+
+            dmRender::RenderObject& ro = *world->m_RenderObjects.End();
+            world->m_RenderObjects.SetSize(world->m_RenderObjects.Size()+1);
+
+            // All regions of the layer are drawn at once, the unused parts of their ranges are degenerate triangles
+            ro.Init();
+            ro.m_VertexDeclaration = world->m_VertexDeclaration;
+            ro.m_VertexBuffer = layer->m_VertexBuffer;
+            ro.m_PrimitiveType = dmGraphics::PRIMITIVE_TRIANGLES;
+            ro.m_VertexStart = 0;
+            ro.m_VertexCount = layer->m_VertexCount;
+            ro.m_Material = GetMaterial(component);
+            ro.m_Textures[0] = texture_set->m_Texture;
+            if (component->m_LocalVertexSpace)
+            {
+                ro.m_WorldTransform = component->m_World;
+            }
 
-            default:
-                dmLogError("Unknown blend mode: %d\n", blend_mode);
-                assert(0);
-            break;
-        }
+            const dmRender::Constant* constants = component->m_RenderConstants.m_RenderConstants;
+            uint32_t size = component->m_RenderConstants.m_ConstantCount;
+            for (uint32_t j = 0; j < size; ++j)
+            {
+                const dmRender::Constant& c = constants[j];
+                dmRender::EnableRenderObjectConstant(&ro, c.m_NameHash, c.m_Value);
+            }
+
+            dmGameSystemDDF::TileGrid::BlendMode blend_mode = resource->m_TileGrid->m_BlendMode;
+            switch (blend_mode)
+            {
+                case dmGameSystemDDF::TileGrid::BLEND_MODE_ALPHA:
+                    ro.m_SourceBlendFactor = dmGraphics::BLEND_FACTOR_ONE;
+                    ro.m_DestinationBlendFactor = dmGraphics::BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+                break;
+
+                case dmGameSystemDDF::TileGrid::BLEND_MODE_ADD:
+                case dmGameSystemDDF::TileGrid::BLEND_MODE_ADD_ALPHA:
+                    ro.m_SourceBlendFactor = dmGraphics::BLEND_FACTOR_ONE;
+                    ro.m_DestinationBlendFactor = dmGraphics::BLEND_FACTOR_ONE;
+                break;
+
+                case dmGameSystemDDF::TileGrid::BLEND_MODE_MULT:
+                    ro.m_SourceBlendFactor = dmGraphics::BLEND_FACTOR_DST_COLOR;
+                    ro.m_DestinationBlendFactor = dmGraphics::BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+                break;
+
+                default:
+                    dmLogError("Unknown blend mode: %d\n", blend_mode);
+                    assert(0);
+                break;
+            }
 
-        ro.m_SetBlendFactors = 1;
+            ro.m_SetBlendFactors = 1;
 
-        dmRender::AddToRender(render_context, &ro);
+            dmRender::AddToRender(render_context, &ro);
+        }
     }
 
     static void RenderListDispatch(dmRender::RenderListDispatchParams const &params)
@@ -674,16 +746,14 @@ namespace dmGameSystem
         switch (params.m_Operation)
         {
         case dmRender::RENDER_LIST_OPERATION_BEGIN:
-            world->m_VertexBufferWritePtr = world->m_VertexBufferData;
+            world->m_TileCount = 0;
+            world->m_UploadedVertexCount = 0;
             world->m_RenderObjects.SetSize(0);
             break;
 
         case dmRender::RENDER_LIST_OPERATION_END:
-            dmGraphics::SetVertexBufferData(world->m_VertexBuffer, 0, 0, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
-            dmGraphics::SetVertexBufferData(world->m_VertexBuffer, sizeof(TileGridVertex) * (world->m_VertexBufferWritePtr - world->m_VertexBufferData),
-                                            world->m_VertexBufferData, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
-            DM_COUNTER("TileGridVertexBuffer", (world->m_VertexBufferWritePtr - world->m_VertexBufferData) * sizeof(TileGridVertex));
-            DM_COUNTER("TileGridTileCount", (world->m_VertexBufferWritePtr - world->m_VertexBufferData));
+            DM_COUNTER("TileGridVertexBuffer", world->m_UploadedVertexCount * sizeof(TileGridVertex));
+            DM_COUNTER("TileGridTileCount", world->m_TileCount);
             break;
 
         case dmRender::RENDER_LIST_OPERATION_BATCH:
@@ -692,24 +762,25 @@ namespace dmGameSystem
         }
     }
 
-    // Estimates the number of render entries needed
-    static uint32_t CalcNumVisibleRegions(TileGridComponent** components, uint32_t num_components)
+    static inline bool IsLayerRendered(const TileGridLayer* layer)
+    {
+        return layer->m_IsVisible && layer->m_TileCount > 0;
+    }
+
+    // Calculates the number of render entries needed, one per layer
+    static uint32_t CalcNumVisibleLayers(TileGridComponent** components, uint32_t num_components)
     {
         uint32_t num_render_entries = 0;
         for (uint32_t i = 0; i < num_components; ++i)
         {
             const TileGridComponent* component = components[i];
-            if (!component->m_Enabled || !component->m_AddedToUpdate || !component->m_Occupied) {
+            if (!component->m_Enabled || !component->m_AddedToUpdate) {
                 continue;
             }
             uint32_t n_layers = component->m_Layers.Size();
             for (uint32_t l = 0; l < n_layers; ++l)
             {
-                const TileGridLayer* layer = &component->m_Layers[l];
-                if (!layer->m_IsVisible)
-                    continue;
-
-                num_render_entries += component->m_RegionsY * component->m_RegionsX;
+                num_render_entries += IsLayerRendered(&component->m_Layers[l]) ? 1 : 0;
             }
         }
         return num_render_entries;
@@ -727,7 +798,16 @@ namespace dmGameSystem
             return dmGameObject::UPDATE_RESULT_OK;
         }
 
-        uint32_t num_render_entries = CalcNumVisibleRegions(&components[0], n);
+        uint32_t num_render_entries = CalcNumVisibleLayers(&components[0], n);
+        if (num_render_entries == 0)
+        {
+            return dmGameObject::UPDATE_RESULT_OK;
+        }
+        if (world->m_RenderObjects.Capacity() < num_render_entries)
+        {
+            world->m_RenderObjects.SetCapacity(num_render_entries);
+        }
+
         dmRender::HRenderContext render_context = context->m_RenderContext;
         dmRender::RenderListEntry* render_list = dmRender::RenderListAlloc(render_context, num_render_entries);
         dmRender::HRenderListDispatch dispatch = dmRender::RenderListMakeDispatch(render_context, &RenderListDispatch, world);
@@ -736,7 +816,7 @@ namespace dmGameSystem
         for (uint32_t i = 0; i < n; ++i)
         {
             TileGridComponent* component = components[i];
-            if (!component->m_Enabled || !component->m_AddedToUpdate || !component->m_Occupied) {
+            if (!component->m_Enabled || !component->m_AddedToUpdate) {
                 continue;
             }
 
@@ -748,38 +828,47 @@ namespace dmGameSystem
             TileGridResource* resource = component->m_Resource;
             dmGameSystemDDF::TextureSet* texture_set_ddf = GetTextureSet(component)->m_TextureSet;
             dmGameSystemDDF::TileGrid* tile_grid_ddf = resource->m_TileGrid;
+            dmRender::HMaterial material = GetMaterial(component);
 
-            uint32_t tile_width = texture_set_ddf->m_TileWidth;
-            uint32_t tile_height = texture_set_ddf->m_TileHeight;
+            // The tile source was changed or reloaded
+            if (component->m_CachedTextureSet != texture_set_ddf)
+            {
+                component->m_CachedTextureSet = texture_set_ddf;
+                SetLayersDirty(component);
+            }
+
+            // Materials in local vertex space get the world transform through the render object,
+            // materials in world vertex space need it baked into the vertices
+            bool local_vertex_space = dmRender::GetMaterialVertexSpace(material) == dmRenderDDF::MaterialDesc::VERTEX_SPACE_LOCAL;
+            if (local_vertex_space != (bool)component->m_LocalVertexSpace)
+            {
+                component->m_LocalVertexSpace = local_vertex_space;
+                SetLayersDirty(component);
+            }
+            if (!local_vertex_space && memcmp(&component->m_VertexWorld, &component->m_World, sizeof(Matrix4)) != 0)
+            {
+                component->m_VertexWorld = component->m_World;
+                SetLayersDirty(component);
+            }
 
             uint32_t n_layers = tile_grid_ddf->m_Layers.m_Count;
             for (uint32_t l = 0; l < n_layers; ++l)
             {
                 TileGridLayer* layer = &component->m_Layers[l];
-                if (!layer->m_IsVisible)
+                if (!IsLayerRendered(layer))
                     continue;
 
                 dmGameSystemDDF::TileLayer* layer_ddf = &tile_grid_ddf->m_Layers[l];
-                for (uint32_t y = 0, region_index = 0; y < component->m_RegionsY; ++y) {
-                    for (uint32_t x = 0; x < component->m_RegionsX; ++x, ++region_index) {
-
-                        TileGridRegion* region = &component->m_Regions[region_index];
-                        if (!region->m_Occupied) {
-                            continue;
-                        }
-
-                        Vector4 trans = component->m_World * Point3(x * tile_width, y * tile_height, layer_ddf->m_Z);
-
-                        write_ptr->m_WorldPosition = Point3(trans.getXYZ());
-                        write_ptr->m_UserData = EncodeRegionInfo(i, l, x, y);
-                        write_ptr->m_TagMask = dmRender::GetMaterialTagMask(GetMaterial(component));
-                        write_ptr->m_BatchKey = component->m_MixedHash;
-                        write_ptr->m_Dispatch = dispatch;
-                        write_ptr->m_MinorOrder = 0;
-                        write_ptr->m_MajorOrder = dmRender::RENDER_ORDER_WORLD;
-                        ++write_ptr;
-                    }
-                }
+                Vector4 trans = component->m_World * Point3(0.0f, 0.0f, layer_ddf->m_Z);
+
+                write_ptr->m_WorldPosition = Point3(trans.getXYZ());
+                write_ptr->m_UserData = EncodeLayerInfo(i, l);
+                write_ptr->m_TagMask = dmRender::GetMaterialTagMask(material);
+                write_ptr->m_BatchKey = component->m_MixedHash;
+                write_ptr->m_Dispatch = dispatch;
+                write_ptr->m_MinorOrder = 0;
+                write_ptr->m_MajorOrder = dmRender::RENDER_ORDER_WORLD;
+                ++write_ptr;
             }
         }
 
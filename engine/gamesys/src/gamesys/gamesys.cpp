@@ -89,7 +89,13 @@ namespace dmGameSystem
         m_Worlds.SetCapacity(128);
     }
 
-    dmResource::Result RegisterResourceTypes(dmResource::HFactory factory, dmRender::HRenderContext render_context, GuiContext* gui_context, dmInput::HContext input_context, PhysicsContext* physics_context)
+    TextureContext::TextureContext()
+    : m_GraphicsContext(0)
+    , m_JobThread(0)
+    {
+    }
+
+    dmResource::Result RegisterResourceTypes(dmResource::HFactory factory, dmRender::HRenderContext render_context, GuiContext* gui_context, dmInput::HContext input_context, PhysicsContext* physics_context, TextureContext* texture_context)
     {
         dmResource::Result e;
 
@@ -104,13 +110,14 @@ namespace dmGameSystem
     }\
 
         dmGraphics::HContext graphics_context = dmRender::GetGraphicsContext(render_context);
+        texture_context->m_GraphicsContext = graphics_context;
 
         REGISTER_RESOURCE_TYPE("collectionproxyc", 0, 0, ResCollectionProxyCreate, 0, ResCollectionProxyDestroy, ResCollectionProxyRecreate);
         REGISTER_RESOURCE_TYPE("collisionobjectc", physics_context, 0, ResCollisionObjectCreate, 0, ResCollisionObjectDestroy, ResCollisionObjectRecreate);
         REGISTER_RESOURCE_TYPE("convexshapec", physics_context, 0, ResConvexShapeCreate, 0, ResConvexShapeDestroy, ResConvexShapeRecreate);
         REGISTER_RESOURCE_TYPE("emitterc", 0, 0, ResEmitterCreate, 0,ResEmitterDestroy, ResEmitterRecreate);
         REGISTER_RESOURCE_TYPE("particlefxc", 0, ResParticleFXPreload, ResParticleFXCreate, 0, ResParticleFXDestroy, ResParticleFXRecreate);
-        REGISTER_RESOURCE_TYPE("texturec", graphics_context, ResTexturePreload, ResTextureCreate, ResTexturePostCreate, ResTextureDestroy, ResTextureRecreate);
+        REGISTER_RESOURCE_TYPE("texturec", texture_context, ResTexturePreload, ResTextureCreate, ResTexturePostCreate, ResTextureDestroy, ResTextureRecreate);
         REGISTER_RESOURCE_TYPE("vpc", graphics_context, ResVertexProgramPreload, ResVertexProgramCreate, 0, ResVertexProgramDestroy, ResVertexProgramRecreate);
         REGISTER_RESOURCE_TYPE("fpc", graphics_context, ResFragmentProgramPreload, ResFragmentProgramCreate, 0, ResFragmentProgramDestroy, ResFragmentProgramRecreate);
         REGISTER_RESOURCE_TYPE("fontc", render_context, ResFontMapPreload, ResFontMapCreate, 0, ResFontMapDestroy, ResFontMapRecreate);
@@ -144,6 +151,14 @@ namespace dmGameSystem
 
 #undef REGISTER_RESOURCE_TYPE
 
+        // These types only parse or convert their data when created, which can be done on the load thread.
+        // Buffers build their streams from the DDF data, which is the expensive part of loading a mesh.
+        const char* threaded_create_types[] = { "bufferc", "camerac", "gamepadsc", "lightc", "skeletonc" };
+        for (uint32_t i = 0; i < sizeof(threaded_create_types) / sizeof(threaded_create_types[0]); ++i)
+        {
+            dmResource::SetTypeFlags(factory, threaded_create_types[i], RESOURCE_TYPE_FLAGS_THREADED_CREATE);
+        }
+
         return e;
     }
 
@@ -171,8 +186,8 @@ namespace dmGameSystem
 
 #define REGISTER_COMPONENT_TYPE(extension, prio, context, new_world_func, delete_world_func, \
                                 create_func, destroy_func, init_func, final_func, add_to_update_func, get_func, \
-                                update_func, render_func, post_update_func, on_message_func, on_input_func, \
-                                on_reload_func, get_property_func, set_property_func, set_reads_transforms)\
+                                update_func, fixed_update_func, render_func, post_update_func, on_message_func, on_input_func, \
+                                on_reload_func, get_property_func, set_property_func, set_reads_transforms, set_parallel_update)\
     factory_result = dmResource::GetTypeFromExtension(factory, extension, &type);\
     if (factory_result != dmResource::RESULT_OK)\
     {\
@@ -193,6 +208,7 @@ namespace dmGameSystem
     component_type.m_GetFunction = get_func;\
     component_type.m_RenderFunction = render_func;\
     component_type.m_UpdateFunction = update_func;\
+    component_type.m_FixedUpdateFunction = fixed_update_func;\
     component_type.m_PostUpdateFunction = post_update_func;\
     component_type.m_OnMessageFunction = on_message_func;\
     component_type.m_OnInputFunction = on_input_func;\
@@ -200,6 +216,7 @@ namespace dmGameSystem
     component_type.m_GetPropertyFunction = get_property_func;\
     component_type.m_SetPropertyFunction = set_property_func;\
     component_type.m_ReadsTransforms = set_reads_transforms;\
+    component_type.m_ParallelUpdate = set_parallel_update;\
     component_type.m_InstanceHasUserData = (uint32_t)true;\
     component_type.m_UpdateOrderPrio = prio;\
     go_result = dmGameObject::RegisterComponentType(regist, component_type);\
@@ -214,8 +231,8 @@ namespace dmGameSystem
         REGISTER_COMPONENT_TYPE("collectionproxyc", 100, collection_proxy_context,
                 &CompCollectionProxyNewWorld, &CompCollectionProxyDeleteWorld,
                 &CompCollectionProxyCreate, &CompCollectionProxyDestroy, 0, &CompCollectionProxyFinal, &CompCollectionProxyAddToUpdate, 0,
-                &CompCollectionProxyUpdate, &CompCollectionProxyRender, &CompCollectionProxyPostUpdate, &CompCollectionProxyOnMessage, &CompCollectionProxyOnInput, 0, 0, 0,
-                0);
+                &CompCollectionProxyUpdate, &CompCollectionProxyFixedUpdate, &CompCollectionProxyRender, &CompCollectionProxyPostUpdate, &CompCollectionProxyOnMessage, &CompCollectionProxyOnInput, 0, 0, 0,
+                0, 0);
 
         // See gameobject_comp.cpp for these two component types:
         // Priority 200 is reserved for scriptc (read+write transforms)
@@ -224,92 +241,92 @@ namespace dmGameSystem
         REGISTER_COMPONENT_TYPE("guic", 300, gui_context,
                 CompGuiNewWorld, CompGuiDeleteWorld,
                 CompGuiCreate, CompGuiDestroy, CompGuiInit, CompGuiFinal, CompGuiAddToUpdate, 0,
-                CompGuiUpdate, CompGuiRender, 0, CompGuiOnMessage, CompGuiOnInput, CompGuiOnReload, CompGuiGetProperty, CompGuiSetProperty,
-                0);
+                CompGuiUpdate, 0, CompGuiRender, 0, CompGuiOnMessage, CompGuiOnInput, CompGuiOnReload, CompGuiGetProperty, CompGuiSetProperty,
+                0, 0);
 
         REGISTER_COMPONENT_TYPE("collisionobjectc", 400, physics_context,
                 &CompCollisionObjectNewWorld, &CompCollisionObjectDeleteWorld,
                 &CompCollisionObjectCreate, &CompCollisionObjectDestroy, 0, &CompCollisionObjectFinal, &CompCollisionObjectAddToUpdate, 0,
-                &CompCollisionObjectUpdate, 0, &CompCollisionObjectPostUpdate, &CompCollisionObjectOnMessage, 0, &CompCollisionObjectOnReload, CompCollisionObjectGetProperty, CompCollisionObjectSetProperty,
-                1);
+                &CompCollisionObjectUpdate, &CompCollisionObjectFixedUpdate, 0, &CompCollisionObjectPostUpdate, &CompCollisionObjectOnMessage, 0, &CompCollisionObjectOnReload, CompCollisionObjectGetProperty, CompCollisionObjectSetProperty,
+                1, 0);
 
         REGISTER_COMPONENT_TYPE("camerac", 500, render_context,
                 &CompCameraNewWorld, &CompCameraDeleteWorld,
                 &CompCameraCreate, &CompCameraDestroy, 0, 0, &CompCameraAddToUpdate, 0,
-                &CompCameraUpdate, 0, 0, &CompCameraOnMessage, 0, &CompCameraOnReload, 0, 0,
-                1);
+                &CompCameraUpdate, 0, 0, 0, &CompCameraOnMessage, 0, &CompCameraOnReload, 0, 0,
+                1, 0);
 
         REGISTER_COMPONENT_TYPE("soundc", 600, sound_context,
                 CompSoundNewWorld, CompSoundDeleteWorld,
                 CompSoundCreate, CompSoundDestroy, 0, 0, CompSoundAddToUpdate, 0,
-                CompSoundUpdate, 0, 0, CompSoundOnMessage, 0, 0, CompSoundGetProperty, CompSoundSetProperty,
-                0);
+                CompSoundUpdate, 0, 0, 0, CompSoundOnMessage, 0, 0, CompSoundGetProperty, CompSoundSetProperty,
+                0, 0);
 
         REGISTER_COMPONENT_TYPE("modelc", 700, model_context,
                 CompModelNewWorld, CompModelDeleteWorld,
                 CompModelCreate, CompModelDestroy, 0, 0, CompModelAddToUpdate, 0,
-                CompModelUpdate, CompModelRender, 0, CompModelOnMessage, 0, 0, CompModelGetProperty, CompModelSetProperty,
-                0);
+                CompModelUpdate, 0, CompModelRender, 0, CompModelOnMessage, 0, 0, CompModelGetProperty, CompModelSetProperty,
+                0, 1);
 
         REGISTER_COMPONENT_TYPE("meshc", 725, mesh_context,
                 CompMeshNewWorld, CompMeshDeleteWorld,
                 CompMeshCreate, CompMeshDestroy, 0, 0, CompMeshAddToUpdate, 0,
-                CompMeshUpdate, CompMeshRender, 0, CompMeshOnMessage, 0, 0, CompMeshGetProperty, CompMeshSetProperty,
-                0);
+                CompMeshUpdate, 0, CompMeshRender, 0, CompMeshOnMessage, 0, 0, CompMeshGetProperty, CompMeshSetProperty,
+                0, 1);
 
         REGISTER_COMPONENT_TYPE("emitterc", 750, 0x0,
                 &CompEmitterNewWorld, &CompEmitterDeleteWorld,
                 &CompEmitterCreate, &CompEmitterDestroy, 0, 0, 0, 0,
-                0, 0, 0, CompEmitterOnMessage, 0, 0, 0, 0,
-                0);
+                0, 0, 0, 0, CompEmitterOnMessage, 0, 0, 0, 0,
+                0, 0);
 
         REGISTER_COMPONENT_TYPE("particlefxc", 800, particlefx_context,
                 &CompParticleFXNewWorld, &CompParticleFXDeleteWorld,
                 &CompParticleFXCreate, &CompParticleFXDestroy, 0, 0, &CompParticleFXAddToUpdate, 0,
-                &CompParticleFXUpdate, &CompParticleFXRender, 0, &CompParticleFXOnMessage, 0, &CompParticleFXOnReload, 0, 0,
-                1);
+                &CompParticleFXUpdate, 0, &CompParticleFXRender, 0, &CompParticleFXOnMessage, 0, &CompParticleFXOnReload, 0, 0,
+                1, 0);
 
         REGISTER_COMPONENT_TYPE("factoryc", 900, factory_context,
                 CompFactoryNewWorld, CompFactoryDeleteWorld,
                 CompFactoryCreate, CompFactoryDestroy, 0, 0, CompFactoryAddToUpdate, 0,
-                CompFactoryUpdate, 0, 0, CompFactoryOnMessage, 0, 0, 0, 0,
-                0);
+                CompFactoryUpdate, 0, 0, 0, CompFactoryOnMessage, 0, 0, 0, 0,
+                0, 0);
 
         REGISTER_COMPONENT_TYPE("collectionfactoryc", 950, collectionfactory_context,
                 CompCollectionFactoryNewWorld, CompCollectionFactoryDeleteWorld,
                 CompCollectionFactoryCreate, CompCollectionFactoryDestroy, 0, 0, CompCollectionFactoryAddToUpdate, 0,
-                CompCollectionFactoryUpdate, 0, 0, 0, 0, 0, 0, 0,
-                0);
+                CompCollectionFactoryUpdate, 0, 0, 0, 0, 0, 0, 0, 0,
+                0, 0);
 
         REGISTER_COMPONENT_TYPE("lightc", 1000, render_context,
                 CompLightNewWorld, CompLightDeleteWorld,
                 CompLightCreate, CompLightDestroy, 0, 0, CompLightAddToUpdate, 0,
-                CompLightUpdate, 0, 0, CompLightOnMessage, 0, 0, 0, 0,
-                1);
+                CompLightUpdate, 0, 0, 0, CompLightOnMessage, 0, 0, 0, 0,
+                1, 0);
 
         REGISTER_COMPONENT_TYPE("spritec", 1100, sprite_context,
                 CompSpriteNewWorld, CompSpriteDeleteWorld,
                 CompSpriteCreate, CompSpriteDestroy, 0, 0, CompSpriteAddToUpdate, 0,
-                CompSpriteUpdate, CompSpriteRender, 0, CompSpriteOnMessage, 0, CompSpriteOnReload, CompSpriteGetProperty, CompSpriteSetProperty,
-                1);
+                CompSpriteUpdate, 0, CompSpriteRender, 0, CompSpriteOnMessage, 0, CompSpriteOnReload, CompSpriteGetProperty, CompSpriteSetProperty,
+                1, 1);
 
         REGISTER_COMPONENT_TYPE(TILE_MAP_EXT, 1200, tilemap_context,
                 CompTileGridNewWorld, CompTileGridDeleteWorld,
                 CompTileGridCreate, CompTileGridDestroy, 0, 0, CompTileGridAddToUpdate, 0,
-                CompTileGridUpdate, CompTileGridRender, 0, CompTileGridOnMessage, 0, CompTileGridOnReload, CompTileGridGetProperty, CompTileGridSetProperty,
-                1);
+                CompTileGridUpdate, 0, CompTileGridRender, 0, CompTileGridOnMessage, 0, CompTileGridOnReload, CompTileGridGetProperty, CompTileGridSetProperty,
+                1, 1);
 
         REGISTER_COMPONENT_TYPE(SPINE_MODEL_EXT, 1300, spine_model_context,
                 CompSpineModelNewWorld, CompSpineModelDeleteWorld,
                 CompSpineModelCreate, CompSpineModelDestroy, 0, 0, CompSpineModelAddToUpdate, 0,
-                CompSpineModelUpdate, CompSpineModelRender, 0, CompSpineModelOnMessage, 0, CompSpineModelOnReload, CompSpineModelGetProperty, CompSpineModelSetProperty,
-                0);
+                CompSpineModelUpdate, 0, CompSpineModelRender, 0, CompSpineModelOnMessage, 0, CompSpineModelOnReload, CompSpineModelGetProperty, CompSpineModelSetProperty,
+                0, 0);
 
         REGISTER_COMPONENT_TYPE("labelc", 1400, label_context,
                 CompLabelNewWorld, CompLabelDeleteWorld,
                 CompLabelCreate, CompLabelDestroy, 0, 0, CompLabelAddToUpdate, CompLabelGetComponent,
-                CompLabelUpdate, CompLabelRender, 0, CompLabelOnMessage, 0, CompLabelOnReload, CompLabelGetProperty, CompLabelSetProperty,
-                1);
+                CompLabelUpdate, 0, CompLabelRender, 0, CompLabelOnMessage, 0, CompLabelOnReload, CompLabelGetProperty, CompLabelSetProperty,
+                1, 0);
 
         #undef REGISTER_COMPONENT_TYPE
 
@@ -14,6 +14,7 @@
 #define DM_GAMESYS_H
 
 #include <dlib/configfile.h>
+#include <dlib/job_thread.h>
 
 #include <script/script.h>
 
@@ -36,6 +37,7 @@ namespace dmGameSystem
     extern const char* PHYSICS_MAX_CONTACTS_KEY;
     /// Config key to use for tweaking maximum number of collection proxies
     extern const char* COLLECTION_PROXY_MAX_COUNT_KEY;
+    extern const char* COLLECTION_PROXY_PARALLEL_UPDATE_KEY;
     /// Config key to use for tweaking maximum number of factories
     extern const char* FACTORY_MAX_COUNT_KEY;
     /// Config key to use for tweaking maximum number of collection factories
@@ -72,8 +74,14 @@ namespace dmGameSystem
         };
         uint32_t m_MaxCollisionCount;
         uint32_t m_MaxContactPointCount;
+        dmPhysics::BroadphaseType m_Broadphase;
+        uint32_t m_MaxBroadphaseProxies;
         bool m_Debug;
         bool m_3D;
+        /// Step the simulation once per fixed update step rather than once per frame
+        bool m_UseFixedTimeStep;
+        /// Interpolate the transforms between the fixed steps in the regular update
+        bool m_Interpolate;
     };
 
     struct ParticleFXContext
@@ -111,6 +119,15 @@ namespace dmGameSystem
         uint32_t                    m_MaxSpineCount;
     };
 
+    struct TextureContext
+    {
+        TextureContext();
+
+        dmGraphics::HContext        m_GraphicsContext;
+        /// Worker threads used to decode mip levels in parallel, may be 0
+        dmJobThread::HContext       m_JobThread;
+    };
+
     struct SpriteContext
     {
         SpriteContext()
@@ -181,6 +198,8 @@ namespace dmGameSystem
             memset(this, 0, sizeof(*this));
         }
         dmResource::HFactory m_Factory;
+        /// Updates the loaded collections of a proxy world concurrently if set
+        dmJobThread::HContext m_JobThread;
         uint32_t m_MaxCollectionProxyCount;
     };
 
@@ -211,7 +230,8 @@ namespace dmGameSystem
         dmRender::HRenderContext render_context,
         GuiContext* gui_context,
         dmInput::HContext input_context,
-        PhysicsContext* physics_context);
+        PhysicsContext* physics_context,
+        TextureContext* texture_context);
 
     dmGameObject::Result RegisterComponentTypes(dmResource::HFactory factory,
                                                   dmGameObject::HRegister regist,
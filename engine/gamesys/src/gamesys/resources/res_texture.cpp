@@ -12,21 +12,38 @@
 
 #include "res_texture.h"
 
+#include <dlib/atomic.h>
+#include <dlib/dstrings.h>
 #include <dlib/log.h>
+#include <dlib/math.h>
+#include <dlib/profile.h>
 #include <dlib/webp.h>
 #include <dlib/time.h>
 #include <graphics/graphics.h>
 
+#include "../gamesys.h"
+
 namespace dmGameSystem
 {
     static const uint32_t m_MaxMipCount = 32;
     struct ImageDesc
     {
         dmGraphics::TextureImage* m_DDFImage;
+        // Points into m_DecompressedBuffer, or 0 if the mip level is not compressed
         uint8_t* m_DecompressedData[m_MaxMipCount];
+        // One allocation for all decompressed mip levels
+        uint8_t* m_DecompressedBuffer;
         bool m_UseBlankTexture;
     };
 
+    // State shared by the mip levels when decoding in parallel
+    struct DecodeMipMapsJob
+    {
+        dmGraphics::TextureImage::Image* m_Image;
+        ImageDesc*                       m_ImageDesc;
+        int32_atomic_t                   m_Failed;
+    };
+
     static dmWebP::TextureEncodeFormat TextureFormatFormatToEncodeFormat(dmGraphics::TextureImage::TextureFormat format)
     {
         switch (format)
@@ -119,24 +136,14 @@ namespace dmGameSystem
         dmGraphics::SetTextureAsync(texture, params);
     }
 
-    bool WebPDecodeTexture(uint32_t mipmap, uint32_t width, int32_t height, dmGraphics::TextureImage::Image* image, uint8_t*& decompressed_data, uint32_t& decompressed_data_size)
+    // Decodes a mip level into decompressed_data, which must hold m_MipMapSize[mipmap] bytes
+    bool WebPDecodeTexture(uint32_t mipmap, uint32_t width, int32_t height, dmGraphics::TextureImage::Image* image, uint8_t* decompressed_data)
     {
-        uint32_t compressed_data_size = image->m_MipMapSizeCompressed[mipmap];
-        if(!compressed_data_size)
-        {
-            decompressed_data = 0;
-            decompressed_data_size = 0;
-            return true;
-        }
+        DM_PROFILE(Resource, "WebPDecodeTexture");
 
+        uint32_t compressed_data_size = image->m_MipMapSizeCompressed[mipmap];
         uint8_t* compressed_data = &image->m_Data[image->m_MipMapOffset[mipmap]];
-        decompressed_data_size = image->m_MipMapSize[mipmap];
-        decompressed_data = new uint8_t[decompressed_data_size];
-        if(!decompressed_data)
-        {
-            dmLogError("Not enough memory to decode WebP encoded image (%u bytes). Using blank texture.", decompressed_data_size);
-            return false;
-        }
+        uint32_t decompressed_data_size = image->m_MipMapSize[mipmap];
 
         dmWebP::Result webp_res;
         uint32_t stride = decompressed_data_size/height;
@@ -168,7 +175,6 @@ namespace dmGameSystem
         if(webp_res != dmWebP::RESULT_OK)
         {
             dmLogError("Failed to decode WebP encoded image, code(%d). Using blank texture.", (int32_t) webp_res);
-            delete[] decompressed_data;
             return false;
         }
 
@@ -308,7 +314,39 @@ namespace dmGameSystem
         return result;
     }
 
-    ImageDesc* CreateImage(dmGraphics::HContext context, dmGraphics::TextureImage* texture_image)
+    static void DecodeMipMap(void* context, uint32_t mipmap)
+    {
+        DecodeMipMapsJob* job = (DecodeMipMapsJob*) context;
+        uint8_t* decompressed_data = job->m_ImageDesc->m_DecompressedData[mipmap];
+        if (!decompressed_data || job->m_Failed)
+        {
+            return;
+        }
+        dmGraphics::TextureImage::Image* image = job->m_Image;
+        uint32_t width = dmMath::Max(image->m_Width >> mipmap, 1u);
+        uint32_t height = dmMath::Max(image->m_Height >> mipmap, 1u);
+        if (!WebPDecodeTexture(mipmap, width, height, image, decompressed_data))
+        {
+            dmAtomicIncrement32(&job->m_Failed);
+        }
+    }
+
+    // Profiler sample name for decoding a texture, e.g. "TextureDecode@/main/logo.texturec"
+    static const char* GetDecodeProfilerName(const char* filename, uint32_t* out_profiler_hash)
+    {
+        const char* profiler_name = 0;
+        if (dmProfile::g_IsInitialized)
+        {
+            char buffer[128];
+            dmSnPrintf(buffer, sizeof(buffer), "TextureDecode@%s", filename);
+            uint32_t length = (uint32_t) strlen(buffer);
+            *out_profiler_hash = dmProfile::GetNameHash(buffer, length);
+            profiler_name = dmProfile::Internalize(buffer, length, *out_profiler_hash);
+        }
+        return profiler_name;
+    }
+
+    ImageDesc* CreateImage(TextureContext* context, const char* filename, dmGraphics::TextureImage* texture_image)
     {
         ImageDesc* image_desc = new ImageDesc;
         memset(image_desc, 0x0, sizeof(ImageDesc));
@@ -316,7 +354,7 @@ namespace dmGameSystem
         for(uint32_t i = 0; i < texture_image->m_Alternatives.m_Count; ++i)
         {
             dmGraphics::TextureImage::Image* image = &texture_image->m_Alternatives[i];
-            if (!dmGraphics::IsTextureFormatSupported(context, TextureImageToTextureFormat(image)))
+            if (!dmGraphics::IsTextureFormatSupported(context->m_GraphicsContext, TextureImageToTextureFormat(image)))
             {
                 continue;
             }
@@ -325,26 +363,43 @@ namespace dmGameSystem
                 case dmGraphics::TextureImage::COMPRESSION_TYPE_WEBP:
                 case dmGraphics::TextureImage::COMPRESSION_TYPE_WEBP_LOSSY:
                 {
-                    uint32_t w = image->m_Width;
-                    uint32_t h = image->m_Height;
-                    for (int i = 0; i < (int) image->m_MipMapOffset.m_Count; ++i)
+                    uint32_t profiler_hash = 0;
+                    const char* profiler_name = GetDecodeProfilerName(filename, &profiler_hash);
+                    DM_PROFILE_DYN(Resource, profiler_name, profiler_hash);
+
+                    // Place all the decompressed mip levels in a single allocation
+                    uint32_t mipmap_count = image->m_MipMapOffset.m_Count;
+                    uint32_t decompressed_size = 0;
+                    for (uint32_t mipmap = 0; mipmap < mipmap_count; ++mipmap)
                     {
-                        uint8_t* decompressed_data;
-                        uint32_t decompressed_data_size;
-                        if(WebPDecodeTexture(i, w, h, image, decompressed_data, decompressed_data_size))
+                        if (image->m_MipMapSizeCompressed[mipmap])
                         {
-                            image_desc->m_DecompressedData[i] = decompressed_data;
+                            decompressed_size += image->m_MipMapSize[mipmap];
                         }
-                        else
+                    }
+                    if (decompressed_size == 0)
+                    {
+                        break;
+                    }
+
+                    image_desc->m_DecompressedBuffer = new uint8_t[decompressed_size];
+                    uint32_t offset = 0;
+                    for (uint32_t mipmap = 0; mipmap < mipmap_count; ++mipmap)
+                    {
+                        if (image->m_MipMapSizeCompressed[mipmap])
                         {
-                            image_desc->m_UseBlankTexture = true;
-                            break;
+                            image_desc->m_DecompressedData[mipmap] = image_desc->m_DecompressedBuffer + offset;
+                            offset += image->m_MipMapSize[mipmap];
                         }
-                        w >>= 1;
-                        h >>= 1;
-                        if (w == 0) w = 1;
-                        if (h == 0) h = 1;
                     }
+
+                    // The mip levels are independent and decoded on the worker threads together with this thread
+                    DecodeMipMapsJob job;
+                    job.m_Image     = image;
+                    job.m_ImageDesc = image_desc;
+                    job.m_Failed    = 0;
+                    dmJobThread::ParallelFor(context->m_JobThread, DecodeMipMap, &job, mipmap_count);
+                    image_desc->m_UseBlankTexture = job.m_Failed != 0;
                 }
                 break;
 
@@ -358,11 +413,7 @@ namespace dmGameSystem
 
     void DestroyImage(ImageDesc* image_desc)
     {
-        for (uint32_t i = 0; i < m_MaxMipCount; ++i)
-        {
-            if(image_desc->m_DecompressedData[i])
-                delete[] image_desc->m_DecompressedData[i];
-        }
+        delete[] image_desc->m_DecompressedBuffer;
         delete image_desc;
     }
 
@@ -375,7 +426,7 @@ namespace dmGameSystem
             return dmResource::RESULT_FORMAT_ERROR;
         }
 
-        ImageDesc* image_desc = CreateImage((dmGraphics::HContext) params.m_Context, texture_image);
+        ImageDesc* image_desc = CreateImage((TextureContext*) params.m_Context, params.m_Filename, texture_image);
         *params.m_PreloadData = image_desc;
         return dmResource::RESULT_OK;
     }
@@ -398,7 +449,7 @@ namespace dmGameSystem
 
     dmResource::Result ResTextureCreate(const dmResource::ResourceCreateParams& params)
     {
-        dmGraphics::HContext graphics_context = (dmGraphics::HContext) params.m_Context;
+        dmGraphics::HContext graphics_context = ((TextureContext*) params.m_Context)->m_GraphicsContext;
         dmGraphics::HTexture texture;
         dmResource::Result r = AcquireResources(params.m_Resource, graphics_context, (ImageDesc*) params.m_PreloadData, 0, &texture);
         if (r == dmResource::RESULT_OK)
@@ -425,12 +476,13 @@ namespace dmGameSystem
                 return dmResource::RESULT_FORMAT_ERROR;
             }
         }
-        dmGraphics::HContext graphics_context = (dmGraphics::HContext) params.m_Context;
+        TextureContext* texture_context = (TextureContext*) params.m_Context;
+        dmGraphics::HContext graphics_context = texture_context->m_GraphicsContext;
         dmGraphics::HTexture texture = (dmGraphics::HTexture) params.m_Resource->m_Resource;
 
         // Create the image from the DDF data.
         // Note that the image desc for performance reasons keeps references to the DDF image, meaning they're invalid after the DDF message has been free'd!
-        ImageDesc* image_desc = CreateImage((dmGraphics::HContext) params.m_Context, texture_image);
+        ImageDesc* image_desc = CreateImage(texture_context, params.m_Filename, texture_image);
 
         // Set up the new texture (version), wait for it to finish before issuing new requests
         SynchronizeTexture(texture, true);
@@ -465,6 +465,357 @@ namespace dmGameSystem
         return 1;
     }
 
+    // Get the collision world of the calling script instance
+    static void* CheckCollisionWorld(lua_State* L, const char* function_name)
+    {
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender)) {
+            luaL_error(L, "could not find a requesting instance for %s", function_name);
+            return 0x0;
+        }
+
+        dmScript::GetGlobal(L, PHYSICS_CONTEXT_HASH);
+        PhysicsScriptContext* context = (PhysicsScriptContext*)lua_touserdata(L, -1);
+        lua_pop(L, 1);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+        return dmGameObject::GetWorld(collection, context->m_ComponentIndex);
+    }
+
+    static uint16_t CheckGroupMask(lua_State* L, int index, void* world)
+    {
+        uint32_t mask = 0;
+        luaL_checktype(L, index, LUA_TTABLE);
+        lua_pushnil(L);
+        while (lua_next(L, index) != 0)
+        {
+            mask |= CompCollisionGetGroupBitIndex(world, dmScript::CheckHash(L, -1));
+            lua_pop(L, 1);
+        }
+        return (uint16_t)mask;
+    }
+
+    /*# performs several ray casts at once
+     *
+     * Performs a batch of synchronous ray casts, which is considerably cheaper than calling
+     * `physics.raycast` for each ray when many rays are cast each frame, e.g. for line of sight checks.
+     * Only the closest hit of each ray is reported. Trigger objects do not intersect with ray casts.
+     * In 2D the rays are spread across the physics solver threads when `physics.solver_thread_count` is set.
+     *
+     * @name physics.raycast_batch
+     * @param from [type:table] a lua table with the world positions of the start of each ray
+     * @param to [type:table] a lua table with the world positions of the end of each ray
+     * @param groups [type:table] a lua table containing the hashed groups for which to test collisions against
+     * @return result [type:table] a list with one entry per ray, `false` for a miss. See `ray_cast_response` for details on the returned values.
+     * @examples
+     *
+     * How to check line of sight from several enemies to the player:
+     *
+     * ```lua
+     * function update(self, dt)
+     *     local player = go.get_position("player")
+     *     local from = {}
+     *     local to = {}
+     *     for i,enemy in ipairs(self.enemies) do
+     *         from[i] = go.get_position(enemy)
+     *         to[i] = player
+     *     end
+     *     local results = physics.raycast_batch(from, to, {hash("world")})
+     *     for i,result in ipairs(results) do
+     *         self.can_see_player[i] = not result
+     *     end
+     * end
+     * ```
+     */
+    static int Physics_RayCastBatch(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+
+        void* world = CheckCollisionWorld(L, "physics.raycast_batch");
+
+        luaL_checktype(L, 1, LUA_TTABLE);
+        luaL_checktype(L, 2, LUA_TTABLE);
+        uint32_t count = lua_objlen(L, 1);
+        if (count != lua_objlen(L, 2))
+        {
+            return DM_LUA_ERROR("the from and to tables must have the same length");
+        }
+        uint16_t mask = CheckGroupMask(L, 3, world);
+
+        dmArray<dmPhysics::RayCastRequest> requests;
+        requests.SetCapacity(count);
+        requests.SetSize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            lua_rawgeti(L, 1, i+1);
+            requests[i].m_From = Vectormath::Aos::Point3(*dmScript::CheckVector3(L, -1));
+            lua_pop(L, 1);
+            lua_rawgeti(L, 2, i+1);
+            requests[i].m_To = Vectormath::Aos::Point3(*dmScript::CheckVector3(L, -1));
+            lua_pop(L, 1);
+            requests[i].m_Mask = mask;
+        }
+
+        dmArray<dmPhysics::RayCastResponse> responses;
+        responses.SetCapacity(count);
+        responses.SetSize(count);
+        dmGameSystem::RayCastBatch(world, requests.Begin(), count, responses.Begin());
+
+        lua_createtable(L, count, 0);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (responses[i].m_Hit)
+            {
+                lua_newtable(L);
+                PushRayCastResponse(L, world, responses[i]);
+            }
+            else
+            {
+                lua_pushboolean(L, 0);
+            }
+            lua_rawseti(L, -2, i+1);
+        }
+        return 1;
+    }
+
+    static int OverlapInternal(lua_State* L, const char* function_name, const dmPhysics::QueryShape& shape)
+    {
+        void* world = CheckCollisionWorld(L, function_name);
+
+        dmPhysics::OverlapRequest request;
+        request.m_Shape = shape;
+        request.m_Position = Vectormath::Aos::Point3(*dmScript::CheckVector3(L, 1));
+        request.m_Mask = CheckGroupMask(L, 3, world);
+
+        dmArray<dmPhysics::OverlapResponse> results;
+        results.SetCapacity(32);
+        dmGameSystem::QueryOverlap(world, request, results);
+
+        if (results.Empty())
+        {
+            lua_pushnil(L);
+            return 1;
+        }
+
+        lua_createtable(L, results.Size(), 0);
+        for (uint32_t i = 0; i < results.Size(); ++i)
+        {
+            lua_newtable(L);
+            dmScript::PushHash(L, dmGameSystem::GetLSBGroupHash(world, results[i].m_CollisionObjectGroup));
+            lua_setfield(L, -2, "group");
+            dmScript::PushHash(L, dmGameSystem::CompCollisionObjectGetIdentifier(results[i].m_CollisionObjectUserData));
+            lua_setfield(L, -2, "id");
+            lua_rawseti(L, -2, i+1);
+        }
+        return 1;
+    }
+
+    /*# finds the collision objects overlapping a sphere
+     *
+     * Collision objects of types kinematic, dynamic and static are tested against. Trigger objects
+     * are never reported. In 2D the sphere is a circle in the xy-plane.
+     *
+     * @name physics.overlap_sphere
+     * @param position [type:vector3] the world position of the center of the sphere
+     * @param radius [type:number] the radius of the sphere
+     * @param groups [type:table] a lua table containing the hashed groups for which to test collisions against
+     * @return result [type:table] a list of tables with the `id` and `group` of each overlapping object. If nothing overlaps it returns nil.
+     * @examples
+     *
+     * ```lua
+     * local result = physics.overlap_sphere(go.get_position(), 100, {hash("enemy")})
+     * if result then
+     *     for _,hit in ipairs(result) do
+     *         msg.post(hit.id, "explosion")
+     *     end
+     * end
+     * ```
+     */
+    static int Physics_OverlapSphere(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+        dmPhysics::QueryShape shape;
+        shape.m_Type = dmPhysics::QueryShape::TYPE_SPHERE;
+        shape.m_Radius = (float) luaL_checknumber(L, 2);
+        return OverlapInternal(L, "physics.overlap_sphere", shape);
+    }
+
+    /*# finds the collision objects overlapping an axis aligned box
+     *
+     * Collision objects of types kinematic, dynamic and static are tested against. Trigger objects
+     * are never reported. In 2D the z component of the box is ignored.
+     *
+     * @name physics.overlap_box
+     * @param position [type:vector3] the world position of the center of the box
+     * @param half_extents [type:vector3] half the size of the box
+     * @param groups [type:table] a lua table containing the hashed groups for which to test collisions against
+     * @return result [type:table] a list of tables with the `id` and `group` of each overlapping object. If nothing overlaps it returns nil.
+     */
+    static int Physics_OverlapBox(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+        dmPhysics::QueryShape shape;
+        shape.m_Type = dmPhysics::QueryShape::TYPE_BOX;
+        shape.m_HalfExtents = *dmScript::CheckVector3(L, 2);
+        return OverlapInternal(L, "physics.overlap_box", shape);
+    }
+
+    static int ShapeCastInternal(lua_State* L, const char* function_name, const dmPhysics::QueryShape& shape)
+    {
+        void* world = CheckCollisionWorld(L, function_name);
+
+        dmPhysics::ShapeCastRequest request;
+        request.m_Shape = shape;
+        request.m_From = Vectormath::Aos::Point3(*dmScript::CheckVector3(L, 1));
+        request.m_To = Vectormath::Aos::Point3(*dmScript::CheckVector3(L, 2));
+        request.m_Mask = CheckGroupMask(L, 4, world);
+
+        dmPhysics::RayCastResponse response;
+        dmGameSystem::ShapeCast(world, request, response);
+
+        if (!response.m_Hit)
+        {
+            lua_pushnil(L);
+            return 1;
+        }
+
+        lua_newtable(L);
+        PushRayCastResponse(L, world, response);
+        return 1;
+    }
+
+    /*# sweeps a sphere through the physics world
+     *
+     * Moves a sphere from `from` to `to` and reports the first collision object it touches.
+     * Trigger objects are never hit. In 2D the sphere is a circle in the xy-plane.
+     *
+     * @name physics.sphere_cast
+     * @param from [type:vector3] the world position of the center of the sphere at the start of the sweep
+     * @param to [type:vector3] the world position of the center of the sphere at the end of the sweep
+     * @param radius [type:number] the radius of the sphere
+     * @param groups [type:table] a lua table containing the hashed groups for which to test collisions against
+     * @return result [type:table] the first hit, where `fraction` is how far along the sweep the sphere touches and `position` the contact point. If missed it returns nil. See `ray_cast_response` for details on the returned values.
+     * @examples
+     *
+     * How to check if a character fits through a corridor:
+     *
+     * ```lua
+     * local result = physics.sphere_cast(from, to, 16, {hash("world")})
+     * if result == nil then
+     *     -- the way is clear
+     * end
+     * ```
+     */
+    static int Physics_SphereCast(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+        dmPhysics::QueryShape shape;
+        shape.m_Type = dmPhysics::QueryShape::TYPE_SPHERE;
+        shape.m_Radius = (float) luaL_checknumber(L, 3);
+        return ShapeCastInternal(L, "physics.sphere_cast", shape);
+    }
+
+    /*# sweeps an axis aligned box through the physics world
+     *
+     * Moves a box from `from` to `to` and reports the first collision object it touches.
+     * Trigger objects are never hit. In 2D the z component of the box is ignored.
+     *
+     * @name physics.box_cast
+     * @param from [type:vector3] the world position of the center of the box at the start of the sweep
+     * @param to [type:vector3] the world position of the center of the box at the end of the sweep
+     * @param half_extents [type:vector3] half the size of the box
+     * @param groups [type:table] a lua table containing the hashed groups for which to test collisions against
+     * @return result [type:table] the first hit, where `fraction` is how far along the sweep the box touches and `position` the contact point. If missed it returns nil. See `ray_cast_response` for details on the returned values.
+     */
+    static int Physics_BoxCast(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+        dmPhysics::QueryShape shape;
+        shape.m_Type = dmPhysics::QueryShape::TYPE_BOX;
+        shape.m_HalfExtents = *dmScript::CheckVector3(L, 3);
+        return ShapeCastInternal(L, "physics.box_cast", shape);
+    }
+
+    /*# sets a listener receiving all physics events of the collection
+     *
+     * When a listener is set, the collision, contact point and trigger events of the physics world
+     * of the calling script's collection are collected during the physics step and delivered
+     * in a single call after each step, instead of being posted as `collision_response`,
+     * `contact_point_response` and `trigger_response` messages to each involved game object.
+     * The physics world is stepped once per frame, or once per fixed update when
+     * `physics.use_fixed_timestep` is enabled, in which case the listener may be called
+     * several times in a frame, or not at all.
+     * The number of buffered events is not limited by `physics.max_collisions` or `physics.max_contacts`.
+     *
+     * There is a single listener per collection and it receives the events of all objects in the
+     * collection. While it is set, no physics messages are posted to any game object of the collection.
+     * The listener is owned by the script instance that set it, and only that instance can replace it or
+     * pass `nil` to remove it and go back to messages. Calling this function from another script instance
+     * raises an error. The listener is removed automatically when the owning instance is deleted.
+     *
+     * Each event is a table with the fields:
+     *
+     * `type`
+     * : [type:hash] `hash("collision_response")`, `hash("contact_point_response")` or `hash("trigger_response")`
+     *
+     * `id_a`, `id_b`
+     * : [type:hash] ids of the two game objects
+     *
+     * `group_a`, `group_b`
+     * : [type:hash] collision groups of the two objects
+     *
+     * Contact point events also contain `position_a`, `position_b`, `normal` (pointing from `a` to `b`),
+     * `relative_velocity`, `distance`, `applied_impulse`, `mass_a` and `mass_b`.
+     * Trigger events contain `enter`, [type:boolean] `true` when the objects started to overlap.
+     *
+     * @name physics.set_event_listener
+     * @param callback [type:function(self, events)|nil] the function receiving the list of events of the physics step
+     * @examples
+     *
+     * ```lua
+     * local function on_physics_events(self, events)
+     *     for _,event in ipairs(events) do
+     *         if event.type == hash("trigger_response") and event.enter then
+     *             msg.post(event.id_a, "pickup", { other = event.id_b })
+     *         end
+     *     end
+     * end
+     *
+     * function init(self)
+     *     physics.set_event_listener(on_physics_events)
+     * end
+     * ```
+     */
+    static int Physics_SetEventListener(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+
+        void* world = CheckCollisionWorld(L, "physics.set_event_listener");
+
+        dmScript::LuaCallbackInfo* listener = 0x0;
+        if (!lua_isnil(L, 1))
+        {
+            // The listener outlives the calling coroutine, so it is created on the main thread
+            lua_State* main_thread = dmScript::GetMainThread(L);
+            lua_pushvalue(L, 1);
+            lua_xmove(L, main_thread, 1);
+            listener = dmScript::CreateCallback(main_thread, -1);
+            lua_pop(main_thread, 1);
+            if (listener == 0x0)
+            {
+                return DM_LUA_ERROR("physics.set_event_listener failed to create callback");
+            }
+        }
+        if (!dmGameSystem::SetCollisionEventListener(world, CheckGoInstance(L), listener))
+        {
+            if (listener)
+                dmScript::DestroyCallback(listener);
+            return DM_LUA_ERROR("physics.set_event_listener failed, the listener of the collection is owned by another script instance");
+        }
+        return 0;
+    }
+
     // Matches JointResult in physics.h
     static const char* PhysicsResultString[] = {
         "result ok",
@@ -1062,6 +1413,12 @@ namespace dmGameSystem
         {"ray_cast",        Physics_RayCastAsync}, // Deprecated
         {"raycast_async",   Physics_RayCastAsync},
         {"raycast",         Physics_RayCast},
+        {"raycast_batch",   Physics_RayCastBatch},
+        {"overlap_sphere",  Physics_OverlapSphere},
+        {"overlap_box",     Physics_OverlapBox},
+        {"sphere_cast",     Physics_SphereCast},
+        {"box_cast",        Physics_BoxCast},
+        {"set_event_listener", Physics_SetEventListener},
 
         {"create_joint",    Physics_CreateJoint},
         {"destroy_joint",   Physics_DestroyJoint},
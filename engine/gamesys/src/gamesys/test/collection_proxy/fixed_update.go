@@ -0,0 +1,8 @@
+components {
+  id: "proxy"
+  component: "/collection_proxy/fixed_update.collectionproxy"
+}
+components {
+  id: "script"
+  component: "/collection_proxy/fixed_update.script"
+}
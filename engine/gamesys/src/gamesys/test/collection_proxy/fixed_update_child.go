@@ -0,0 +1,4 @@
+components {
+  id: "script"
+  component: "/collection_proxy/fixed_update_child.script"
+}
@@ -0,0 +1,12 @@
+components {
+  id: "proxy_a"
+  component: "/collection_proxy/parallel_update_a.collectionproxy"
+}
+components {
+  id: "proxy_b"
+  component: "/collection_proxy/parallel_update_b.collectionproxy"
+}
+components {
+  id: "script"
+  component: "/collection_proxy/parallel_update.script"
+}
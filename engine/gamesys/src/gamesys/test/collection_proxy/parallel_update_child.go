@@ -0,0 +1,8 @@
+components {
+  id: "script"
+  component: "/collection_proxy/parallel_update_child.script"
+}
+components {
+  id: "sprite"
+  component: "/sprite/valid.sprite"
+}
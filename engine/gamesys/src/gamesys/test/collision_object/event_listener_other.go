@@ -0,0 +1,4 @@
+components {
+  id: "script"
+  component: "/collision_object/event_listener_other.script"
+}
@@ -0,0 +1,8 @@
+components {
+  id: "collisionobject"
+  component: "/collision_object/joint_test_sphere_kinematic.collisionobject"
+}
+components {
+  id: "script"
+  component: "/collision_object/event_listener_test.script"
+}
@@ -15,6 +15,7 @@
 #include "../../../../graphics/src/graphics_private.h"
 #include "../../../../resource/src/resource_private.h"
 
+#include "gamesys/resources/res_buffer.h"
 #include "gamesys/resources/res_textureset.h"
 
 #include <stdio.h>
@@ -126,6 +127,48 @@ TEST_P(ResourceTest, TestPreload)
     dmResource::Release(m_Factory, resource);
 }
 
+// Buffers are created on the load thread when preloaded, see RESOURCE_TYPE_FLAGS_THREADED_CREATE
+TEST_F(ResourceTest, TestPreloadBuffer)
+{
+    const char* resource_name = "/mesh/triangle.bufferc";
+    dmResource::HPreloader pr = dmResource::NewPreloader(m_Factory, resource_name);
+    dmResource::Result r;
+
+    uint64_t stop_time = dmTime::GetTime() + 30*10e6;
+    while (dmTime::GetTime() < stop_time)
+    {
+        r = dmResource::UpdatePreloader(pr, 0, 0, 16*1000);
+        if (r != dmResource::RESULT_PENDING)
+            break;
+        dmTime::Sleep(16*1000);
+    }
+    ASSERT_EQ(dmResource::RESULT_OK, r);
+
+    dmGameSystem::BufferResource* resource = 0;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(m_Factory, resource_name, (void**) &resource));
+    ASSERT_TRUE(dmBuffer::IsBufferValid(resource->m_Buffer));
+
+    float* positions = 0;
+    uint32_t count = 0;
+    uint32_t components = 0;
+    uint32_t stride = 0;
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetStream(resource->m_Buffer, dmHashString64("position"), (void**) &positions, &count, &components, &stride));
+    ASSERT_EQ(3u, count);
+    ASSERT_EQ(3u, components);
+
+    const float expected[] = { 0.0f, 0.0f, 0.0f,  1.0f, 0.0f, 0.0f,  1.0f, 1.0f, 0.0f };
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        for (uint32_t c = 0; c < components; ++c)
+        {
+            ASSERT_EQ(expected[i * 3 + c], positions[i * stride + c]);
+        }
+    }
+
+    dmResource::DeletePreloader(pr);
+    dmResource::Release(m_Factory, resource);
+}
+
 TEST_F(ResourceTest, TestReloadTextureSet)
 {
     const char* texture_set_path_a   = "/textureset/valid_a.texturesetc";
@@ -154,6 +197,39 @@ TEST_F(ResourceTest, TestReloadTextureSet)
     dmResource::Release(m_Factory, (void**) resource);
 }
 
+static float LoadTextureBenchmark(dmResource::HFactory factory, const char* path, uint32_t load_count)
+{
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < load_count; ++i)
+    {
+        void* resource = 0;
+        if (dmResource::RESULT_OK != dmResource::Get(factory, path, &resource))
+        {
+            return -1.0f;
+        }
+        dmResource::Release(factory, resource);
+    }
+    return (dmTime::GetTime() - start) / (1000.0f * load_count);
+}
+
+// The texture is 1024x1024 RGBA with a full mip chain, WebP lossless compressed
+TEST_F(ResourceTest, TextureDecodeBenchmark)
+{
+    const char* path = "/texture/webp_1024.texturec";
+    const uint32_t load_count = 20;
+
+    float serial_time = LoadTextureBenchmark(m_Factory, path, load_count);
+    ASSERT_LT(0.0f, serial_time);
+
+    m_TextureContext.m_JobThread = dmJobThread::Create(4, "texture_bench");
+    float parallel_time = LoadTextureBenchmark(m_Factory, path, load_count);
+    dmJobThread::Destroy(m_TextureContext.m_JobThread);
+    m_TextureContext.m_JobThread = 0;
+    ASSERT_LT(0.0f, parallel_time);
+
+    printf("Bench elapsed: serial %f ms, parallel %f ms per load\n", serial_time, parallel_time);
+}
+
 TEST_P(ResourceFailTest, Test)
 {
     const ResourceFailParams& p = GetParam();
@@ -393,6 +469,133 @@ TEST_F(ComponentTest, ConsumeInputInCollectionProxy)
     #undef ASSERT_INPUT_OBJECT_EQUALS
 }
 
+// Test that all collections loaded through proxies are updated with collection_proxy.parallel_update enabled
+TEST_F(ComponentTest, CollectionProxyParallelUpdate)
+{
+    /* Setup:
+    ** go_parallel
+    ** - [script] parallel_update.script
+    ** - collection_proxy a and b
+    ** -- go
+    ** ---- [script] parallel_update_child.script
+    ** ---- sprite
+    */
+
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+    lua_pushinteger(L, 0);
+    lua_setglobal(L, "parallel_update_count");
+
+    dmJobThread::HContext job_thread = dmJobThread::Create(2, "test_worker");
+    m_CollectionProxyContext.m_JobThread = job_thread;
+
+    // The proxy world reserves space for the parallel update when it is created
+    dmGameObject::HCollection collection = dmGameObject::NewCollection("parallel_update", m_Factory, m_Register, 1024);
+
+    dmGameObject::HInstance go = Spawn(m_Factory, collection, "/collection_proxy/parallel_update.goc", dmHashString64("/go_parallel"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    // Load and enable both proxies
+    int count = 0;
+    for (uint32_t i = 0; i < 10 && count == 0; ++i)
+    {
+        ASSERT_TRUE(dmGameObject::Update(collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(collection));
+
+        lua_getglobal(L, "parallel_update_count");
+        count = lua_tointeger(L, -1);
+        lua_pop(L, 1);
+    }
+    ASSERT_LT(0, count);
+
+    // Both collections are updated every frame
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(dmGameObject::Update(collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(collection));
+
+        lua_getglobal(L, "parallel_update_count");
+        int new_count = lua_tointeger(L, -1);
+        lua_pop(L, 1);
+        ASSERT_EQ(count + 2, new_count);
+        count = new_count;
+    }
+
+    dmGameObject::DeleteCollection(collection);
+    dmGameObject::PostUpdate(m_Register);
+
+    m_CollectionProxyContext.m_JobThread = 0;
+    dmJobThread::Destroy(job_thread);
+}
+
+// Spawn the fixed update proxy and run frames until its collection has been stepped once
+static void LoadFixedUpdateProxy(lua_State* L, dmResource::HFactory factory, dmGameObject::HCollection collection, const dmGameObject::UpdateContext* update_context, const dmGameObject::UpdateContext* fixed_update_context, int time_step_mode)
+{
+    lua_pushinteger(L, time_step_mode);
+    lua_setglobal(L, "fixed_update_mode");
+    lua_pushinteger(L, 0);
+    lua_setglobal(L, "fixed_update_count");
+
+    dmGameObject::HInstance go = Spawn(factory, collection, "/collection_proxy/fixed_update.goc", dmHashString64("/go_fixed_update"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    int count = 0;
+    for (uint32_t i = 0; i < 10 && count == 0; ++i)
+    {
+        ASSERT_TRUE(dmGameObject::FixedUpdate(collection, fixed_update_context));
+        ASSERT_TRUE(dmGameObject::Update(collection, update_context));
+        ASSERT_TRUE(dmGameObject::PostUpdate(collection));
+
+        lua_getglobal(L, "fixed_update_count");
+        count = lua_tointeger(L, -1);
+        lua_pop(L, 1);
+    }
+    ASSERT_LT(0, count);
+}
+
+// Test that the fixed steps of a collection proxy are scaled by the time step factor
+TEST_F(ComponentTest, CollectionProxyFixedUpdateTimeStepFactor)
+{
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+    dmGameObject::UpdateContext fixed_update_context;
+    fixed_update_context.m_DT = 1.0f / 60.0f;
+    LoadFixedUpdateProxy(L, m_Factory, m_Collection, &m_UpdateContext, &fixed_update_context, dmGameSystemDDF::TIME_STEP_MODE_CONTINUOUS);
+
+    // Stepped along with the parent collection, with half the time step
+    for (int i = 1; i <= 4; ++i)
+    {
+        ASSERT_TRUE(dmGameObject::FixedUpdate(m_Collection, &fixed_update_context));
+
+        lua_getglobal(L, "fixed_update_count");
+        ASSERT_EQ(1 + i, lua_tointeger(L, -1));
+        lua_pop(L, 1);
+        lua_getglobal(L, "fixed_update_dt");
+        ASSERT_NEAR(0.5f / 60.0f, lua_tonumber(L, -1), 0.000001f);
+        lua_pop(L, 1);
+    }
+}
+
+// Test that a collection proxy in discrete mode takes whole fixed steps, less often
+TEST_F(ComponentTest, CollectionProxyFixedUpdateDiscrete)
+{
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+    dmGameObject::UpdateContext fixed_update_context;
+    fixed_update_context.m_DT = 1.0f / 60.0f;
+    LoadFixedUpdateProxy(L, m_Factory, m_Collection, &m_UpdateContext, &fixed_update_context, dmGameSystemDDF::TIME_STEP_MODE_DISCRETE);
+
+    // Stepped every other parent step, with the full time step
+    for (int i = 1; i <= 4; ++i)
+    {
+        ASSERT_TRUE(dmGameObject::FixedUpdate(m_Collection, &fixed_update_context));
+
+        lua_getglobal(L, "fixed_update_count");
+        ASSERT_EQ(1 + i / 2, lua_tointeger(L, -1));
+        lua_pop(L, 1);
+        lua_getglobal(L, "fixed_update_dt");
+        ASSERT_NEAR(1.0f / 60.0f, lua_tonumber(L, -1), 0.000001f);
+        lua_pop(L, 1);
+    }
+}
+
 TEST_P(ComponentFailTest, Test)
 {
     const char* go_name = GetParam();
@@ -402,7 +605,7 @@ TEST_P(ComponentFailTest, Test)
 }
 
 static void DeleteInstance(dmGameObject::HCollection collection, dmGameObject::HInstance instance) {
-    dmGameObject::UpdateContext ctx = {0.0f};
+    dmGameObject::UpdateContext ctx;
     dmGameObject::Update(collection, &ctx);
     dmGameObject::Delete(collection, instance, false);
     dmGameObject::PostUpdate(collection);
@@ -1167,6 +1370,101 @@ TEST_P(DrawCountTest, DrawCount)
     ASSERT_TRUE(dmGameObject::Final(m_Collection));
 }
 
+/* TileGrid */
+TEST_F(ComponentTest, TileGridRegionUpload)
+{
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+
+    // One layer with two regions holding two tiles each, see region_upload.script for what happens each frame
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/tile/region_upload.goc", dmHashString64("/go"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    const uint32_t frame_count = 5;
+    uint64_t uploaded[frame_count];
+    for (uint32_t i = 0; i < frame_count; ++i)
+    {
+        uint64_t upload_size = dmGraphics::GetVertexBufferUploadSize();
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+
+        dmRender::RenderListBegin(m_RenderContext);
+        dmGameObject::Render(m_Collection);
+        dmRender::RenderListEnd(m_RenderContext);
+        dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0);
+
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+        uploaded[i] = dmGraphics::GetVertexBufferUploadSize() - upload_size;
+
+        // Both regions are drawn with a single draw call
+        ASSERT_EQ(1u, dmGraphics::GetDrawCount());
+        dmGraphics::Flip(m_GraphicsContext);
+    }
+
+    // The first frame uploads both regions
+    ASSERT_LT(0u, uploaded[0]);
+    // Nothing changed
+    ASSERT_EQ(0u, uploaded[1]);
+    // set_tile only re-uploads the region containing the tile
+    ASSERT_EQ(uploaded[0], 2 * uploaded[2]);
+    // The material is in local vertex space, so moving the tilemap does not touch the vertices
+    ASSERT_EQ(0u, uploaded[3]);
+    ASSERT_EQ(0u, uploaded[4]);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
+TEST_F(ComponentTest, TileGridLargeMapBenchmark)
+{
+    // The map has 1024x1024 tiles, which needs a collection with a larger tile budget than the default test setup
+    m_TilemapContext.m_MaxTileCount = 1024 * 1024;
+    dmGameObject::HCollection collection = dmGameObject::NewCollection("tilegrid_bench", m_Factory, m_Register, 16);
+    ASSERT_NE((void*)0, collection);
+    ASSERT_TRUE(dmGameObject::Init(collection));
+
+    // The script fills the whole map in init
+    dmGameObject::HInstance go = Spawn(m_Factory, collection, "/tile/large_tilegrid.goc", dmHashString64("/go"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    const uint32_t frame_count = 100;
+    uint64_t first_frame_time = 0;
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < frame_count + 1; ++i)
+    {
+        uint64_t frame_start = dmTime::GetTime();
+        uint64_t upload_size = dmGraphics::GetVertexBufferUploadSize();
+        ASSERT_TRUE(dmGameObject::Update(collection, &m_UpdateContext));
+
+        dmRender::RenderListBegin(m_RenderContext);
+        dmGameObject::Render(collection);
+        dmRender::RenderListEnd(m_RenderContext);
+        dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0);
+
+        ASSERT_TRUE(dmGameObject::PostUpdate(collection));
+
+        // The whole layer is drawn with a single draw call
+        ASSERT_EQ(1u, dmGraphics::GetDrawCount());
+        dmGraphics::Flip(m_GraphicsContext);
+
+        // The first frame builds the vertex buffers of all regions, the following frames reuse them
+        if (i == 0)
+        {
+            first_frame_time = dmTime::GetTime() - frame_start;
+            start = dmTime::GetTime();
+        }
+        else
+        {
+            ASSERT_EQ(0u, dmGraphics::GetVertexBufferUploadSize() - upload_size);
+        }
+    }
+    uint64_t end = dmTime::GetTime();
+
+    printf("Bench first frame: %f ms\n", first_frame_time / 1000.0f);
+    printf("Bench elapsed: %f ms (%f ms per frame)\n", (end - start) / 1000.0f, (end - start) / (1000.0f * frame_count));
+
+    ASSERT_TRUE(dmGameObject::Final(collection));
+    dmGameObject::DeleteCollection(collection);
+    dmGameObject::PostUpdate(m_Register);
+}
+
 /* Physics joints */
 TEST_F(ComponentTest, JointTest)
 {
@@ -1216,6 +1514,61 @@ TEST_F(ComponentTest, JointTest)
 
 }
 
+/* Physics event listener */
+TEST_F(ComponentTest, EventListenerTest)
+{
+    /* Setup:
+    ** event_listener_test
+    ** - [collisionobject] collision_object/joint_test_sphere_kinematic.collisionobject
+    ** - [script] collision_object/event_listener_test.script
+    ** joint_test_b
+    ** - [collisionobject] collision_object/joint_test_sphere.collisionobject
+    ** event_listener_other
+    ** - [script] collision_object/event_listener_other.script
+    */
+
+    dmHashEnableReverseHash(true);
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory = m_Factory;
+    scriptlibcontext.m_Register = m_Register;
+    scriptlibcontext.m_LuaState = L;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    lua_pushboolean(L, 0);
+    lua_setglobal(L, "tests_done");
+    lua_pushboolean(L, 0);
+    lua_setglobal(L, "other_listener_rejected");
+
+    dmGameObject::HInstance go_b = Spawn(m_Factory, m_Collection, "/collision_object/joint_test_b.goc", dmHashString64("/joint_test_b"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go_b);
+
+    dmGameObject::HInstance go_a = Spawn(m_Factory, m_Collection, "/collision_object/event_listener_test.goc", dmHashString64("/event_listener_test"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go_a);
+
+    // Another script instance in the same collection can't take over or remove the listener
+    dmGameObject::HInstance go_other = Spawn(m_Factory, m_Collection, "/collision_object/event_listener_other.goc", dmHashString64("/event_listener_other"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go_other);
+
+    bool tests_done = false;
+    while (!tests_done)
+    {
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+
+        lua_getglobal(L, "tests_done");
+        tests_done = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+    }
+
+    lua_getglobal(L, "other_listener_rejected");
+    ASSERT_TRUE(lua_toboolean(L, -1));
+    lua_pop(L, 1);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
 /* Camera */
 
 const char* valid_camera_resources[] = {"/camera/valid.camerac"};
@@ -1710,7 +2063,6 @@ const char* invalid_vertexspace_resources[] =
     "/sprite/invalid_vertexspace.spritec",
     "/model/invalid_vertexspace.modelc",
     "/spine/invalid_vertexspace.spinemodelc",
-    "/tile/invalid_vertexspace.tilegridc",
     "/particlefx/invalid_vertexspace.particlefxc",
     "/gui/invalid_vertexspace.guic",
     "/label/invalid_vertexspace.labelc",
@@ -49,6 +49,7 @@ protected:
     dmGraphics::HContext m_GraphicsContext;
     dmRender::HRenderContext m_RenderContext;
     dmGameSystem::PhysicsContext m_PhysicsContext;
+    dmGameSystem::TextureContext m_TextureContext;
     dmGameSystem::ParticleFXContext m_ParticleFXContext;
     dmGameSystem::GuiContext m_GuiContext;
     dmHID::HContext m_HidContext;
@@ -322,7 +323,7 @@ void GamesysTest<T>::SetUp()
 
     m_SoundContext.m_MaxComponentCount = 32;
 
-    dmResource::Result r = dmGameSystem::RegisterResourceTypes(m_Factory, m_RenderContext, &m_GuiContext, m_InputContext, &m_PhysicsContext);
+    dmResource::Result r = dmGameSystem::RegisterResourceTypes(m_Factory, m_RenderContext, &m_GuiContext, m_InputContext, &m_PhysicsContext, &m_TextureContext);
     assert(dmResource::RESULT_OK == r);
 
     dmResource::Get(m_Factory, "/input/valid.gamepadsc", (void**)&m_GamepadMapsDDF);
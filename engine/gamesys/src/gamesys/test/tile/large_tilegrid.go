@@ -0,0 +1,8 @@
+components {
+  id: "tilegrid"
+  component: "/tile/large.tilegrid"
+}
+components {
+  id: "script"
+  component: "/tile/large_tilegrid.script"
+}
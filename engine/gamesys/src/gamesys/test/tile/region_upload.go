@@ -0,0 +1,8 @@
+components {
+  id: "tilegrid"
+  component: "/tile/region_upload.tilegrid"
+}
+components {
+  id: "script"
+  component: "/tile/region_upload.script"
+}
@@ -0,0 +1 @@
+/root/repo/engine/glfw/include/GL/glfw.h
\ No newline at end of file
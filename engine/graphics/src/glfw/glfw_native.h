@@ -0,0 +1 @@
+/root/repo/engine/glfw/include/GL/glfw_native.h
\ No newline at end of file
@@ -19,6 +19,7 @@
 namespace dmGraphics
 {
     uint64_t GetDrawCount();
+    uint64_t GetVertexBufferUploadSize();
     void SetForceFragmentReloadFail(bool should_fail);
     void SetForceVertexReloadFail(bool should_fail);
     uint32_t GetTextureFormatBPP(TextureFormat format);
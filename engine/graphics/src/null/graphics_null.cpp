@@ -28,6 +28,7 @@
 using namespace Vectormath::Aos;
 
 uint64_t g_DrawCount = 0;
+uint64_t g_VertexBufferUploadSize = 0;
 uint64_t g_Flipped = 0;
 
 // Used only for tests
@@ -339,7 +340,10 @@ namespace dmGraphics
         vb->m_Copy = 0x0;
         vb->m_Size = size;
         if (size > 0 && data != 0x0)
+        {
             memcpy(vb->m_Buffer, data, size);
+            g_VertexBufferUploadSize += size;
+        }
         return (uintptr_t)vb;
     }
 
@@ -361,14 +365,20 @@ namespace dmGraphics
         vb->m_Buffer = new char[size];
         vb->m_Size = size;
         if (data != 0x0)
+        {
             memcpy(vb->m_Buffer, data, size);
+            g_VertexBufferUploadSize += size;
+        }
     }
 
     static void NullSetVertexBufferSubData(HVertexBuffer buffer, uint32_t offset, uint32_t size, const void* data)
     {
         VertexBuffer* vb = (VertexBuffer*)buffer;
         if (offset + size <= vb->m_Size && data != 0x0)
+        {
             memcpy(&(vb->m_Buffer)[offset], data, size);
+            g_VertexBufferUploadSize += size;
+        }
     }
 
     static void* NullMapVertexBuffer(HVertexBuffer buffer, BufferAccess access)
@@ -650,6 +660,12 @@ namespace dmGraphics
         return g_DrawCount;
     }
 
+    // For tests, the total number of bytes uploaded to vertex buffers
+    uint64_t GetVertexBufferUploadSize()
+    {
+        return g_VertexBufferUploadSize;
+    }
+
     struct VertexProgram
     {
         char* m_Data;
@@ -17,6 +17,7 @@
 
 #include <ddf/ddf.h>
 
+#include <dlib/array.h>
 #include <dlib/log.h>
 #include <dlib/time.h>
 #include <dlib/sys.h>
@@ -121,6 +122,17 @@ namespace dmLiveUpdate
     }
 
     bool VerifyResource(dmResource::Manifest* manifest, const char* expected, uint32_t expectedLength, const dmResourceArchive::LiveUpdateResource* resource)
+    {
+        if (manifest == 0x0)
+        {
+            return false;
+        }
+        uint32_t digestLength = dmResource::HashLength(manifest->m_DDFData->m_Header.m_ResourceHashAlgorithm);
+        uint8_t* digest = (uint8_t*) alloca(digestLength * sizeof(uint8_t));
+        return VerifyResource(manifest, expected, expectedLength, resource, digest);
+    }
+
+    bool VerifyResource(dmResource::Manifest* manifest, const char* expected, uint32_t expectedLength, const dmResourceArchive::LiveUpdateResource* resource, uint8_t* out_digest)
     {
         if (manifest == 0x0 || resource->m_Data == 0x0)
         {
@@ -130,7 +142,7 @@ namespace dmLiveUpdate
         bool result = true;
         dmLiveUpdateDDF::HashAlgorithm algorithm = manifest->m_DDFData->m_Header.m_ResourceHashAlgorithm;
         uint32_t digestLength = dmResource::HashLength(algorithm);
-        uint8_t* digest = (uint8_t*) alloca(digestLength * sizeof(uint8_t));
+        uint8_t* digest = out_digest;
 
         CreateResourceHash(algorithm, (const char*)resource->m_Data, resource->m_Count, digest);
 
@@ -243,24 +255,62 @@ namespace dmLiveUpdate
         return res == true ? RESULT_OK : RESULT_INVALID_RESOURCE;
     }
 
-    Result NewArchiveIndexWithResource(dmResource::Manifest* manifest, const char* expected_digest, const uint32_t expected_digest_length, const dmResourceArchive::LiveUpdateResource* resource, dmResourceArchive::HArchiveIndex& out_new_index)
+    Result NewArchiveIndexWithResources(dmResource::Manifest* manifest, const AsyncResourceRequest* requests, uint32_t request_count, Result* out_results, dmResourceArchive::HArchiveIndex& out_new_index)
     {
         out_new_index = 0x0;
-        if(!VerifyResource(manifest, expected_digest, expected_digest_length, resource))
+        if (manifest == 0x0)
         {
-            dmLogError("Verification failure for Liveupdate archive for resource: %s", expected_digest);
+            for (uint32_t i = 0; i < request_count; ++i)
+            {
+                out_results[i] = RESULT_INVALID_RESOURCE;
+            }
             return RESULT_INVALID_RESOURCE;
         }
 
         dmLiveUpdateDDF::HashAlgorithm algorithm = manifest->m_DDFData->m_Header.m_ResourceHashAlgorithm;
         uint32_t digestLength = dmResource::HashLength(algorithm);
-        uint8_t* digest = (uint8_t*) alloca(digestLength);
 
-        CreateResourceHash(algorithm, (const char*)resource->m_Data, resource->m_Count, digest);
+        dmArray<uint8_t> digests;
+        dmArray<dmResourceArchive::LiveUpdateResource> resources;
+        dmArray<uint32_t> request_indices;
+        digests.SetCapacity(request_count * digestLength);
+        resources.SetCapacity(request_count);
+        request_indices.SetCapacity(request_count);
+
+        // Verify and hash every resource up front, the digest is reused as the archive index key
+        for (uint32_t i = 0; i < request_count; ++i)
+        {
+            const AsyncResourceRequest& request = requests[i];
+            uint8_t* digest = digests.End();
+            if (!VerifyResource(manifest, request.m_ExpectedResourceDigest, request.m_ExpectedResourceDigestLength, &request.m_Resource, digest))
+            {
+                dmLogError("Verification failure for Liveupdate archive for resource: %s", request.m_ExpectedResourceDigest);
+                out_results[i] = RESULT_INVALID_RESOURCE;
+                continue;
+            }
+            digests.SetSize(digests.Size() + digestLength);
+
+            out_results[i] = RESULT_OK;
+            resources.Push(request.m_Resource);
+            request_indices.Push(i);
+        }
+
+        if (resources.Empty())
+        {
+            return RESULT_INVALID_RESOURCE;
+        }
 
         char proj_id[dmResource::MANIFEST_PROJ_ID_LEN];
         dmResource::BytesToHexString(manifest->m_DDFData->m_Header.m_ProjectIdentifier.m_Data.m_Data, dmResource::HashLength(dmLiveUpdateDDF::HASH_SHA1), proj_id, dmResource::MANIFEST_PROJ_ID_LEN);
-        dmResource::Result res = dmResource::NewArchiveIndexWithResource(manifest, digest, digestLength, resource, proj_id, out_new_index);
+
+        dmArray<dmResourceArchive::Result> archive_results;
+        archive_results.SetCapacity(resources.Size());
+        archive_results.SetSize(resources.Size());
+        dmResource::Result res = dmResource::NewArchiveIndexWithResources(manifest, digests.Begin(), digestLength, resources.Begin(), resources.Size(), proj_id, out_new_index, archive_results.Begin());
+        for (uint32_t i = 0; i < resources.Size(); ++i)
+        {
+            out_results[request_indices[i]] = (archive_results[i] == dmResourceArchive::RESULT_OK) ? RESULT_OK : RESULT_INVALID_RESOURCE;
+        }
 
         return (res == dmResource::RESULT_OK) ? RESULT_OK : RESULT_INVALID_RESOURCE;
     }
@@ -39,33 +39,86 @@ namespace dmLiveUpdate
     /// job input and output queues
     static dmArray<AsyncResourceRequest> m_JobQueue;
     static dmArray<AsyncResourceRequest> m_ThreadJobQueue;
-    static AsyncResourceRequest m_TreadJob;
-    static ResourceRequestCallbackData m_JobCompleteData;
+    static dmArray<AsyncResourceRequest> m_ThreadJobBatch;
+    static dmArray<AsyncResourceRequest> m_ValidRequests;
+    static dmArray<uint32_t> m_ValidRequestIndices;
+    static dmArray<Result> m_ValidRequestResults;
+    static ResourceRequestBatchCallbackData m_JobCompleteData;
 
-    void ProcessRequest(AsyncResourceRequest &request)
+    template <typename T> static void EnsureCapacity(dmArray<T>& a, uint32_t capacity)
     {
-        m_JobCompleteData.m_CallbackData = request.m_CallbackData;
-        m_JobCompleteData.m_Callback = request.m_Callback;
-        Result res = dmLiveUpdate::RESULT_OK;
-        if (request.m_Resource.m_Header != 0x0)
+        if (a.Capacity() < capacity)
         {
-            res = dmLiveUpdate::NewArchiveIndexWithResource(request.m_Manifest, request.m_ExpectedResourceDigest, request.m_ExpectedResourceDigestLength, &request.m_Resource, m_JobCompleteData.m_NewArchiveIndex);
-            m_JobCompleteData.m_ArchiveIndexContainer = request.m_Manifest->m_ArchiveIndex;
+            a.SetCapacity(capacity + m_JobQueueSizeIncrement);
         }
-        else
+    }
+
+    // Move the most recently queued requests that share the same manifest into the batch.
+    // All requests of a batch are stored into the archive with a single archive index update
+    static void PopRequestBatch(dmArray<AsyncResourceRequest>& queue, dmArray<AsyncResourceRequest>& batch)
+    {
+        dmResource::Manifest* manifest = queue.Back().m_Manifest;
+        uint32_t first = queue.Size() - 1;
+        while (first > 0 && queue[first - 1].m_Manifest == manifest)
+        {
+            --first;
+        }
+        uint32_t count = queue.Size() - first;
+        batch.SetSize(0);
+        EnsureCapacity(batch, count);
+        batch.PushArray(&queue[first], count);
+        queue.SetSize(first);
+    }
+
+    void ProcessRequests(const AsyncResourceRequest* requests, uint32_t request_count)
+    {
+        EnsureCapacity(m_JobCompleteData.m_Requests, request_count);
+        EnsureCapacity(m_ValidRequests, request_count);
+        EnsureCapacity(m_ValidRequestIndices, request_count);
+        EnsureCapacity(m_ValidRequestResults, request_count);
+        m_JobCompleteData.m_Requests.SetSize(request_count);
+        m_ValidRequests.SetSize(0);
+        m_ValidRequestIndices.SetSize(0);
+
+        for (uint32_t i = 0; i < request_count; ++i)
         {
-            res = dmLiveUpdate::RESULT_INVALID_HEADER;
+            const AsyncResourceRequest& request = requests[i];
+            ResourceRequestCallbackData& data = m_JobCompleteData.m_Requests[i];
+            data.m_CallbackData = request.m_CallbackData;
+            data.m_Callback = request.m_Callback;
+            data.m_CallbackData.m_Status = false;
+            if (request.m_Resource.m_Header != 0x0)
+            {
+                m_ValidRequests.Push(request);
+                m_ValidRequestIndices.Push(i);
+            }
+        }
+
+        m_JobCompleteData.m_ArchiveIndexContainer = requests[0].m_Manifest->m_ArchiveIndex;
+        m_JobCompleteData.m_NewArchiveIndex = 0x0;
+        if (!m_ValidRequests.Empty())
+        {
+            m_ValidRequestResults.SetSize(m_ValidRequests.Size());
+            dmLiveUpdate::NewArchiveIndexWithResources(requests[0].m_Manifest, m_ValidRequests.Begin(), m_ValidRequests.Size(), m_ValidRequestResults.Begin(), m_JobCompleteData.m_NewArchiveIndex);
+            for (uint32_t i = 0; i < m_ValidRequests.Size(); ++i)
+            {
+                m_JobCompleteData.m_Requests[m_ValidRequestIndices[i]].m_CallbackData.m_Status = m_ValidRequestResults[i] == dmLiveUpdate::RESULT_OK;
+            }
         }
-        m_JobCompleteData.m_CallbackData.m_Status = res == dmLiveUpdate::RESULT_OK ? true : false;
     }
 
     void ProcessRequestComplete()
     {
-        if(m_JobCompleteData.m_CallbackData.m_Status)
+        if(m_JobCompleteData.m_NewArchiveIndex != 0x0)
         {
             dmLiveUpdate::SetNewArchiveIndex(m_JobCompleteData.m_ArchiveIndexContainer, m_JobCompleteData.m_NewArchiveIndex, true);
         }
-        m_JobCompleteData.m_Callback(&m_JobCompleteData.m_CallbackData);
+        for (uint32_t i = 0; i < m_JobCompleteData.m_Requests.Size(); ++i)
+        {
+            ResourceRequestCallbackData& data = m_JobCompleteData.m_Requests[i];
+            data.m_Callback(&data.m_CallbackData);
+        }
+        m_JobCompleteData.m_Requests.SetSize(0);
     }
 
 
@@ -73,7 +126,6 @@ namespace dmLiveUpdate
     static void AsyncThread(void* args)
     {
         // Liveupdate async thread batch processing requested liveupdate tasks
-        AsyncResourceRequest request;
         while (m_Active)
         {
             // Lock and sleep until signaled there is requests queued up
@@ -83,10 +135,9 @@ namespace dmLiveUpdate
                     dmConditionVariable::Wait(m_ConsumerThreadCondition, m_ConsumerThreadMutex);
                 if((m_ThreadJobComplete) || (!m_Active))
                     continue;
-                request = m_ThreadJobQueue.Back();
-                m_ThreadJobQueue.Pop();
+                PopRequestBatch(m_ThreadJobQueue, m_ThreadJobBatch);
             }
-            ProcessRequest(request);
+            ProcessRequests(m_ThreadJobBatch.Begin(), m_ThreadJobBatch.Size());
             m_ThreadJobComplete = true;
         }
     }
@@ -172,8 +223,8 @@ namespace dmLiveUpdate
     {
         if(!m_JobQueue.Empty())
         {
-            ProcessRequest(m_JobQueue.Back());
-            m_JobQueue.Pop();
+            PopRequestBatch(m_JobQueue, m_ThreadJobBatch);
+            ProcessRequests(m_ThreadJobBatch.Begin(), m_ThreadJobBatch.Size());
             ProcessRequestComplete();
         }
     }
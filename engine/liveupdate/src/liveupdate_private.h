@@ -17,6 +17,7 @@
 
 #include <resource/liveupdate_ddf.h>
 #include <resource/resource_archive.h>
+#include <dlib/array.h>
 #include <dlib/hash.h>
 
 extern "C"
@@ -41,6 +42,12 @@ namespace dmLiveUpdate
     {
         StoreResourceCallbackData m_CallbackData;
         void (*m_Callback)(StoreResourceCallbackData*);
+    };
+
+    /// Result of a processed batch of requests sharing the same archive index container
+    struct ResourceRequestBatchCallbackData
+    {
+        dmArray<ResourceRequestCallbackData> m_Requests;
         dmResourceArchive::HArchiveIndexContainer m_ArchiveIndexContainer;
         dmResourceArchive::HArchiveIndex m_NewArchiveIndex;
     };
@@ -55,9 +62,14 @@ namespace dmLiveUpdate
     uint32_t MissingResources(dmResource::Manifest* manifest, const dmhash_t urlHash, uint8_t* entries[], uint32_t entries_size);
 
     void CreateResourceHash(dmLiveUpdateDDF::HashAlgorithm algorithm, const char* buf, size_t buflen, uint8_t* digest);
+
+    // Same as VerifyResource, but also returns the digest of the resource data (HashLength(algorithm) bytes)
+    bool VerifyResource(dmResource::Manifest* manifest, const char* expected, uint32_t expectedLength, const dmResourceArchive::LiveUpdateResource* resource, uint8_t* out_digest);
     void CreateManifestHash(dmLiveUpdateDDF::HashAlgorithm algorithm, const uint8_t* buf, size_t buflen, uint8_t* digest);
 
-    Result NewArchiveIndexWithResource(dmResource::Manifest* manifest, const char* expected_digest, const uint32_t expected_digest_length, const dmResourceArchive::LiveUpdateResource* resource, dmResourceArchive::HArchiveIndex& out_new_index);
+    /// Verifies and stores all resources of the requests (all belonging to the same manifest) with a single archive index update.
+    /// The per request result is written to out_results, out_new_index is only set if at least one resource was stored
+    Result NewArchiveIndexWithResources(dmResource::Manifest* manifest, const AsyncResourceRequest* requests, uint32_t request_count, Result* out_results, dmResourceArchive::HArchiveIndex& out_new_index);
     void SetNewArchiveIndex(dmResourceArchive::HArchiveIndexContainer archive_container, dmResourceArchive::HArchiveIndex new_index, bool mem_mapped);
 
     void AsyncInitialize(const dmResource::HFactory factory);
@@ -21,6 +21,9 @@
 
 
 static volatile bool g_TestAsyncCallbackComplete = false;
+static volatile uint32_t g_TestAsyncCallbackCount = 0;
+static uint32_t g_TestAsyncBatchCount = 0;
+static uint32_t g_TestAsyncBatchRequestCount = 0;
 static dmResource::HFactory g_ResourceFactory = 0x0;
 
 class LiveUpdate : public jc_test_base_class
@@ -46,13 +49,20 @@ public:
 
 namespace dmLiveUpdate
 {
-    dmLiveUpdate::Result NewArchiveIndexWithResource(dmResource::Manifest* manifest, const char* expected_digest, const uint32_t expected_digest_length, const dmResourceArchive::LiveUpdateResource* resource, dmResourceArchive::HArchiveIndex& out_new_index)
+    dmLiveUpdate::Result NewArchiveIndexWithResources(dmResource::Manifest* manifest, const AsyncResourceRequest* requests, uint32_t request_count, dmLiveUpdate::Result* out_results, dmResourceArchive::HArchiveIndex& out_new_index)
     {
+        ++g_TestAsyncBatchCount;
+        g_TestAsyncBatchRequestCount += request_count;
         out_new_index = (dmResourceArchive::HArchiveIndex) 0x5678;
         assert(manifest->m_ArchiveIndex == (dmResourceArchive::HArchiveIndexContainer) 0x1234);
-        assert(strcmp("DUMMY2", expected_digest)==0);
-        assert(expected_digest_length == 6);
-        assert(*((uint32_t*)resource->m_Data) == 0xdeadbeef);
+        for (uint32_t i = 0; i < request_count; ++i)
+        {
+            assert(requests[i].m_Manifest == manifest);
+            assert(strcmp("DUMMY2", requests[i].m_ExpectedResourceDigest)==0);
+            assert(requests[i].m_ExpectedResourceDigestLength == 6);
+            assert(*((uint32_t*)requests[i].m_Resource.m_Data) == 0xdeadbeef);
+            out_results[i] = dmLiveUpdate::RESULT_OK;
+        }
         return dmLiveUpdate::RESULT_OK;
     }
 
@@ -120,6 +130,59 @@ TEST_F(LiveUpdate, TestAsync)
     dmLiveUpdate::AsyncFinalize();
 }
 
+static void Callback_StoreResourceBatch(dmLiveUpdate::StoreResourceCallbackData* callback_data)
+{
+    ++g_TestAsyncCallbackCount;
+    ASSERT_EQ(4, callback_data->m_Self);
+    ASSERT_TRUE(callback_data->m_Status);
+}
+
+TEST_F(LiveUpdate, TestAsyncBatch)
+{
+    dmLiveUpdate::AsyncInitialize(g_ResourceFactory);
+
+    uint8_t buf[sizeof(dmResourceArchive::LiveUpdateResourceHeader)+sizeof(uint32_t)];
+    const size_t buf_len = sizeof(buf);
+    *((uint32_t*)&buf[sizeof(dmResourceArchive::LiveUpdateResourceHeader)]) = 0xdeadbeef;
+    dmResourceArchive::LiveUpdateResource resource((const uint8_t*) buf, buf_len);
+
+    dmLiveUpdate::StoreResourceCallbackData cb;
+    cb.m_Callback = 1;
+    cb.m_ResourceRef = 2;
+    cb.m_HexDigestRef = 3;
+    cb.m_Self = 4;
+    cb.m_HexDigest = "DUMMY1";;
+
+    dmResource::Manifest manifest;
+    manifest.m_ArchiveIndex = (dmResourceArchive::HArchiveIndexContainer) 0x1234;
+
+    dmLiveUpdate::AsyncResourceRequest request;
+    request.m_Manifest = &manifest;
+    request.m_ExpectedResourceDigestLength = 6;
+    request.m_ExpectedResourceDigest = "DUMMY2";
+    request.m_Resource.Set(resource);
+    request.m_CallbackData = cb;
+    request.m_Callback = Callback_StoreResourceBatch;
+
+    // Requests queued within the same frame are stored with a single archive index update
+    const uint32_t request_count = 100;
+    g_TestAsyncCallbackCount = 0;
+    g_TestAsyncBatchCount = 0;
+    g_TestAsyncBatchRequestCount = 0;
+    for (uint32_t i = 0; i < request_count; ++i)
+    {
+        ASSERT_TRUE(dmLiveUpdate::AddAsyncResourceRequest(request));
+    }
+    while(g_TestAsyncCallbackCount < request_count)
+        dmLiveUpdate::AsyncUpdate();
+
+    ASSERT_EQ(request_count, g_TestAsyncCallbackCount);
+    ASSERT_EQ(request_count, g_TestAsyncBatchRequestCount);
+    ASSERT_EQ(1u, g_TestAsyncBatchCount);
+
+    dmLiveUpdate::AsyncFinalize();
+}
+
 TEST_F(LiveUpdate, TestAsyncInvalidResource)
 {
     dmLiveUpdate::AsyncInitialize(g_ResourceFactory);
@@ -17,6 +17,8 @@ b2GridShape::b2GridShape(const b2HullSet* hullSet,
     : m_hullSet(hullSet),
       m_cellWidth(cellWidth), m_cellHeight(cellHeight),
       m_rowCount(rowCount), m_columnCount(columnCount),
+      m_chunkRowCount((rowCount + B2GRIDSHAPE_CHUNK_SIZE - 1) / B2GRIDSHAPE_CHUNK_SIZE),
+      m_chunkColumnCount((columnCount + B2GRIDSHAPE_CHUNK_SIZE - 1) / B2GRIDSHAPE_CHUNK_SIZE),
       m_enabled(1)
 {
     uint32 cellCount = m_rowCount * m_columnCount;
@@ -74,6 +76,20 @@ bool b2GridShape::RayCast(b2RayCastOutput* output, const b2RayCastInput& input,
     return polyShape.RayCast(output, input, transform, childIndex);
 }
 
+static void ComputeRectAABB(b2AABB* aabb, const b2Transform& transform, const b2Vec2& offset, float32 x0, float32 y0, float32 x1, float32 y1)
+{
+    b2Vec2 v00 = b2Mul(transform, b2Vec2(x0, y0) + offset);
+    b2Vec2 v10 = b2Mul(transform, b2Vec2(x1, y0) + offset);
+    b2Vec2 v01 = b2Mul(transform, b2Vec2(x0, y1) + offset);
+    b2Vec2 v11 = b2Mul(transform, b2Vec2(x1, y1) + offset);
+
+    b2Vec2 lower(b2Min(b2Min(v00.x, v01.x), b2Min(v10.x, v11.x)), b2Min(b2Min(v00.y, v01.y), b2Min(v10.y, v11.y)));
+    b2Vec2 upper(b2Max(b2Max(v00.x, v01.x), b2Max(v10.x, v11.x)), b2Max(b2Max(v00.y, v01.y), b2Max(v10.y, v11.y)));
+
+    aabb->lowerBound = lower;
+    aabb->upperBound = upper;
+}
+
 void b2GridShape::ComputeAABB(b2AABB* aabb, const b2Transform& transform, int32 childIndex) const
 {
     const b2GridShape::Cell& cell = m_cells[childIndex];
@@ -95,16 +111,89 @@ void b2GridShape::ComputeAABB(b2AABB* aabb, const b2Transform& transform, int32
     float32 y0 = m_cellHeight * row - m_radius;
     float32 y1 = m_cellHeight * (row + 1) + m_radius;
 
-    b2Vec2 v00 = b2Mul(transform, b2Vec2(x0, y0) + offset);
-    b2Vec2 v10 = b2Mul(transform, b2Vec2(x1, y0) + offset);
-    b2Vec2 v01 = b2Mul(transform, b2Vec2(x0, y1) + offset);
-    b2Vec2 v11 = b2Mul(transform, b2Vec2(x1, y1) + offset);
+    ComputeRectAABB(aabb, transform, offset, x0, y0, x1, y1);
+}
 
-    b2Vec2 lower(b2Min(b2Min(v00.x, v01.x), b2Min(v10.x, v11.x)), b2Min(b2Min(v00.y, v01.y), b2Min(v10.y, v11.y)));
-    b2Vec2 upper(b2Max(b2Max(v00.x, v01.x), b2Max(v10.x, v11.x)), b2Max(b2Max(v00.y, v01.y), b2Max(v10.y, v11.y)));
+int32 b2GridShape::GetProxyCount() const
+{
+    return m_chunkRowCount * m_chunkColumnCount;
+}
 
-    aabb->lowerBound = lower;
-    aabb->upperBound = upper;
+void b2GridShape::ComputeProxyAABB(b2AABB* aabb, const b2Transform& transform, int32 proxyIndex) const
+{
+    uint32 chunkRow = proxyIndex / m_chunkColumnCount;
+    uint32 chunkCol = proxyIndex - m_chunkColumnCount * chunkRow;
+    uint32 row0 = chunkRow * B2GRIDSHAPE_CHUNK_SIZE;
+    uint32 col0 = chunkCol * B2GRIDSHAPE_CHUNK_SIZE;
+    uint32 row1 = b2Min(row0 + B2GRIDSHAPE_CHUNK_SIZE, m_rowCount);
+    uint32 col1 = b2Min(col0 + B2GRIDSHAPE_CHUNK_SIZE, m_columnCount);
+
+    // The whole chunk is covered as long as any cell is set, so that editing cells seldom moves the proxy
+    bool empty = true;
+    for (uint32 row = row0; row < row1 && empty; ++row)
+    {
+        for (uint32 col = col0; col < col1; ++col)
+        {
+            if (m_cells[row * m_columnCount + col].m_Index != B2GRIDSHAPE_EMPTY_CELL)
+            {
+                empty = false;
+                break;
+            }
+        }
+    }
+    if (empty)
+    {
+        aabb->lowerBound = b2Vec2(FLT_MAX, FLT_MAX);
+        aabb->upperBound = b2Vec2(-FLT_MAX, -FLT_MAX);
+        return;
+    }
+
+    b2Vec2 halfDims(m_cellWidth * m_columnCount * 0.5f, m_cellHeight * m_rowCount * 0.5f);
+    b2Vec2 offset = m_position - halfDims;
+
+    float32 x0 = m_cellWidth * col0 - m_radius;
+    float32 x1 = m_cellWidth * col1 + m_radius;
+    float32 y0 = m_cellHeight * row0 - m_radius;
+    float32 y1 = m_cellHeight * row1 + m_radius;
+
+    ComputeRectAABB(aabb, transform, offset, x0, y0, x1, y1);
+}
+
+uint32 b2GridShape::GetChunkIndex(uint32 index) const
+{
+    uint32 row = index / m_columnCount;
+    uint32 col = index - m_columnCount * row;
+    return (row / B2GRIDSHAPE_CHUNK_SIZE) * m_chunkColumnCount + col / B2GRIDSHAPE_CHUNK_SIZE;
+}
+
+uint32 b2GridShape::GetChunkCells(uint32 chunkIndex, const b2AABB& aabb, const b2Transform& xf, uint32* cells) const
+{
+    uint32 chunkRow = chunkIndex / m_chunkColumnCount;
+    uint32 chunkCol = chunkIndex - m_chunkColumnCount * chunkRow;
+    uint32 row0 = chunkRow * B2GRIDSHAPE_CHUNK_SIZE;
+    uint32 col0 = chunkCol * B2GRIDSHAPE_CHUNK_SIZE;
+    uint32 row1 = b2Min(row0 + B2GRIDSHAPE_CHUNK_SIZE, m_rowCount);
+    uint32 col1 = b2Min(col0 + B2GRIDSHAPE_CHUNK_SIZE, m_columnCount);
+
+    uint32 count = 0;
+    for (uint32 row = row0; row < row1; ++row)
+    {
+        for (uint32 col = col0; col < col1; ++col)
+        {
+            uint32 index = row * m_columnCount + col;
+            if (m_cells[index].m_Index == B2GRIDSHAPE_EMPTY_CELL)
+            {
+                continue;
+            }
+            b2AABB cellAABB;
+            ComputeAABB(&cellAABB, xf, index);
+            if (b2TestOverlap(cellAABB, aabb))
+            {
+                cells[count++] = index;
+            }
+        }
+    }
+    return count;
 }
 
 void b2GridShape::ComputeMass(b2MassData* massData, float32 density) const
@@ -395,5 +484,6 @@ void b2GridShape::SetCellHull(b2Body* body, uint32 row, uint32 column, uint32 hu
             cell->m_Index = B2GRIDSHAPE_EMPTY_CELL;
     }
 
-    body->SynchronizeSingle(this, index);
+    // Defold mod: Refresh the proxy of the chunk containing the cell
+    body->SynchronizeSingle(this, GetChunkIndex(index));
 }
@@ -51,6 +51,10 @@ private:
  */
 const uint32 B2GRIDSHAPE_EMPTY_CELL = 0xffffffff;
 
+// Defold mod: Cells are grouped in square chunks of this size, each chunk has a single broad-phase proxy
+const uint32 B2GRIDSHAPE_CHUNK_SIZE = 8;
+const uint32 B2GRIDSHAPE_CHUNK_CELL_COUNT = B2GRIDSHAPE_CHUNK_SIZE * B2GRIDSHAPE_CHUNK_SIZE;
+
 class b2GridShape : public b2Shape
 {
 public:
@@ -95,6 +99,15 @@ public:
 
     virtual void ComputeMass(b2MassData* massData, float32 density) const;
 
+    virtual int32 GetProxyCount() const;
+
+    virtual void ComputeProxyAABB(b2AABB* aabb, const b2Transform& xf, int32 proxyIndex) const;
+
+    uint32 GetChunkIndex(uint32 index) const;
+
+    /// Get the non-empty cells of a chunk overlapping aabb, cells must hold B2GRIDSHAPE_CHUNK_CELL_COUNT entries
+    uint32 GetChunkCells(uint32 chunkIndex, const b2AABB& aabb, const b2Transform& xf, uint32* cells) const;
+
     void GetPolygonShapeForCell(uint32 index, b2PolygonShape& polyShape) const;
     uint32 GetEdgeShapesForCell(uint32 index, b2EdgeShape* edgeShapes, uint32 edgeShapeCount, uint32 edgeMask) const;
 
@@ -112,6 +125,8 @@ public:
     float32  m_cellHeight;
     uint32   m_rowCount;
     uint32   m_columnCount;
+    uint32   m_chunkRowCount;
+    uint32   m_chunkColumnCount;
     uint8    m_enabled:1;
     uint8    m_flags:7;
 
@@ -90,6 +90,13 @@ public:
 	/// @param density the density in kilograms per meter squared.
 	virtual void ComputeMass(b2MassData* massData, float32 density) const = 0;
 
+	// Defold modifications
+	/// Get the number of broad-phase proxies, a proxy may cover several child primitives.
+	virtual int32 GetProxyCount() const { return GetChildCount(); }
+
+	/// Compute the axis aligned bounding box of a broad-phase proxy.
+	virtual void ComputeProxyAABB(b2AABB* aabb, const b2Transform& xf, int32 proxyIndex) const { ComputeAABB(aabb, xf, proxyIndex); }
+
 	Type m_type;
 	float32 m_radius;
 
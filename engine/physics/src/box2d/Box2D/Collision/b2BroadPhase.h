@@ -63,6 +63,17 @@ public:
 	/// Get the fat AABB for a proxy.
 	const b2AABB& GetFatAABB(int32 proxyId) const;
 
+	/// Defold mod: Replace the fat AABB of a proxy. No move is buffered, see TouchProxy.
+	void SetFatAABB(int32 proxyId, const b2AABB& fatAABB);
+
+	/// Defold mod: The proxies that have moved since the last call to UpdatePairs.
+	/// Destroyed proxies are e_nullProxy.
+	int32 GetMoveCount() const { return m_moveCount; }
+	const int32* GetMoveBuffer() const { return m_moveBuffer; }
+
+	/// Defold mod: Forget the moved proxies without updating the pairs.
+	void ClearMoveBuffer() { m_moveCount = 0; }
+
 	/// Get user data from a proxy. Returns NULL if the id is invalid.
 	void* GetUserData(int32 proxyId) const;
 
@@ -157,6 +168,11 @@ inline const b2AABB& b2BroadPhase::GetFatAABB(int32 proxyId) const
 	return m_tree.GetFatAABB(proxyId);
 }
 
+inline void b2BroadPhase::SetFatAABB(int32 proxyId, const b2AABB& fatAABB)
+{
+	m_tree.SetFatAABB(proxyId, fatAABB);
+}
+
 inline int32 b2BroadPhase::GetProxyCount() const
 {
 	return m_proxyCount;
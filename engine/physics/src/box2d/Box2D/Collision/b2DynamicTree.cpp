@@ -130,6 +130,25 @@ void b2DynamicTree::DestroyProxy(int32 proxyId)
 	FreeNode(proxyId);
 }
 
+// Defold mod
+void b2DynamicTree::SetFatAABB(int32 proxyId, const b2AABB& fatAABB)
+{
+	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+
+	b2Assert(m_nodes[proxyId].IsLeaf());
+
+	const b2AABB& aabb = m_nodes[proxyId].aabb;
+	if (aabb.lowerBound.x == fatAABB.lowerBound.x && aabb.lowerBound.y == fatAABB.lowerBound.y &&
+		aabb.upperBound.x == fatAABB.upperBound.x && aabb.upperBound.y == fatAABB.upperBound.y)
+	{
+		return;
+	}
+
+	RemoveLeaf(proxyId);
+	m_nodes[proxyId].aabb = fatAABB;
+	InsertLeaf(proxyId);
+}
+
 bool b2DynamicTree::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
 {
 	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
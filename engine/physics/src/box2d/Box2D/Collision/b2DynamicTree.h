@@ -79,6 +79,9 @@ public:
 	/// @return true if the proxy was re-inserted.
 	bool MoveProxy(int32 proxyId, const b2AABB& aabb1, const b2Vec2& displacement);
 
+	/// Defold mod: Replace the fat AABB of a proxy, re-inserting it in the tree if it changed.
+	void SetFatAABB(int32 proxyId, const b2AABB& fatAABB);
+
 	/// Get proxy user data.
 	/// @return the proxy user data or 0 if the id is invalid.
 	void* GetUserData(int32 proxyId) const;
@@ -144,6 +144,7 @@ protected:
 	friend class b2ContactSolver;
 	friend class b2Body;
 	friend class b2Fixture;
+	friend class b2Island;
 
 	// Flags stored in m_flags
 	enum
@@ -209,6 +210,10 @@ protected:
 
 	float32 m_friction;
 	float32 m_restitution;
+
+	// Defold mod: Island indices of the bodies, see b2Island::StoreContactIndices
+	int32 m_islandIndexA;
+	int32 m_islandIndexB;
 };
 
 inline b2Manifold* b2Contact::GetManifold()
@@ -242,6 +242,19 @@ float32 b2DistanceJoint::GetReactionTorque(float32 inv_dt) const
 	return 0.0f;
 }
 
+// Defold mod
+int32 b2DistanceJoint::SaveImpulses(float32* impulses) const
+{
+	impulses[0] = m_impulse;
+	return 1;
+}
+
+// Defold mod
+void b2DistanceJoint::RestoreImpulses(const float32* impulses)
+{
+	m_impulse = impulses[0];
+}
+
 void b2DistanceJoint::Dump()
 {
 	int32 indexA = m_bodyA->m_islandIndex;
@@ -79,6 +79,10 @@ public:
 	/// Unit is N*m. This is always zero for a distance joint.
 	float32 GetReactionTorque(float32 inv_dt) const;
 
+	// Defold mod: See b2Joint::SaveImpulses
+	int32 SaveImpulses(float32* impulses) const;
+	void RestoreImpulses(const float32* impulses);
+
 	/// The local anchor point relative to bodyA's origin.
 	const b2Vec2& GetLocalAnchorA() const { return m_localAnchorA; }
 
@@ -212,6 +212,23 @@ float32 b2FrictionJoint::GetReactionTorque(float32 inv_dt) const
 	return inv_dt * m_angularImpulse;
 }
 
+// Defold mod
+int32 b2FrictionJoint::SaveImpulses(float32* impulses) const
+{
+	impulses[0] = m_linearImpulse.x;
+	impulses[1] = m_linearImpulse.y;
+	impulses[2] = m_angularImpulse;
+	return 3;
+}
+
+// Defold mod
+void b2FrictionJoint::RestoreImpulses(const float32* impulses)
+{
+	m_linearImpulse.x = impulses[0];
+	m_linearImpulse.y = impulses[1];
+	m_angularImpulse = impulses[2];
+}
+
 void b2FrictionJoint::SetMaxForce(float32 force)
 {
 	b2Assert(b2IsValid(force) && force >= 0.0f);
@@ -61,6 +61,10 @@ public:
 	b2Vec2 GetReactionForce(float32 inv_dt) const;
 	float32 GetReactionTorque(float32 inv_dt) const;
 
+	// Defold mod: See b2Joint::SaveImpulses
+	int32 SaveImpulses(float32* impulses) const;
+	void RestoreImpulses(const float32* impulses);
+
 	/// The local anchor point relative to bodyA's origin.
 	const b2Vec2& GetLocalAnchorA() const { return m_localAnchorA; }
 
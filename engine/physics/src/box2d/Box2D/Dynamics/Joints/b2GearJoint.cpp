@@ -393,6 +393,19 @@ float32 b2GearJoint::GetReactionTorque(float32 inv_dt) const
 	return inv_dt * L;
 }
 
+// Defold mod
+int32 b2GearJoint::SaveImpulses(float32* impulses) const
+{
+	impulses[0] = m_impulse;
+	return 1;
+}
+
+// Defold mod
+void b2GearJoint::RestoreImpulses(const float32* impulses)
+{
+	m_impulse = impulses[0];
+}
+
 void b2GearJoint::SetRatio(float32 ratio)
 {
 	b2Assert(b2IsValid(ratio));
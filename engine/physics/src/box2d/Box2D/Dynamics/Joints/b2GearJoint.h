@@ -62,6 +62,10 @@ public:
 	b2Vec2 GetReactionForce(float32 inv_dt) const;
 	float32 GetReactionTorque(float32 inv_dt) const;
 
+	// Defold mod: See b2Joint::SaveImpulses
+	int32 SaveImpulses(float32* impulses) const;
+	void RestoreImpulses(const float32* impulses);
+
 	/// Get the first joint.
 	b2Joint* GetJoint1() { return m_joint1; }
 
@@ -97,6 +97,9 @@ struct b2JointDef
 	bool collideConnected;
 };
 
+/// Defold mod: Maximum number of impulses saved by b2Joint::SaveImpulses
+const int32 b2_maxJointImpulses = 4;
+
 /// The base joint class. Joints are used to constraint two bodies together in
 /// various fashions. Some joints also feature limits and motors.
 class b2Joint
@@ -145,6 +148,13 @@ public:
 	/// Dump this joint to the log file.
 	virtual void Dump() { b2Log("// Dump is not supported for this joint type.\n"); }
 
+	/// Defold mod: Copy the accumulated (warm starting) impulses of this joint to an array of
+	/// at least b2_maxJointImpulses floats. Returns the number of floats written.
+	virtual int32 SaveImpulses(float32* impulses) const { B2_NOT_USED(impulses); return 0; }
+
+	/// Defold mod: Restore impulses written by SaveImpulses.
+	virtual void RestoreImpulses(const float32* impulses) { B2_NOT_USED(impulses); }
+
 protected:
 	friend class b2World;
 	friend class b2Body;
@@ -215,3 +215,18 @@ float32 b2MouseJoint::GetReactionTorque(float32 inv_dt) const
 {
 	return inv_dt * 0.0f;
 }
+
+// Defold mod
+int32 b2MouseJoint::SaveImpulses(float32* impulses) const
+{
+	impulses[0] = m_impulse.x;
+	impulses[1] = m_impulse.y;
+	return 2;
+}
+
+// Defold mod
+void b2MouseJoint::RestoreImpulses(const float32* impulses)
+{
+	m_impulse.x = impulses[0];
+	m_impulse.y = impulses[1];
+}
@@ -73,6 +73,10 @@ public:
 	/// Implements b2Joint.
 	float32 GetReactionTorque(float32 inv_dt) const;
 
+	// Defold mod: See b2Joint::SaveImpulses
+	int32 SaveImpulses(float32* impulses) const;
+	void RestoreImpulses(const float32* impulses);
+
 	/// Use this to update the target point.
 	void SetTarget(const b2Vec2& target);
 	const b2Vec2& GetTarget() const;
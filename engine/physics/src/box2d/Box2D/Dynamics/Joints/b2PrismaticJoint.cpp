@@ -512,6 +512,25 @@ float32 b2PrismaticJoint::GetReactionTorque(float32 inv_dt) const
 	return inv_dt * m_impulse.y;
 }
 
+// Defold mod
+int32 b2PrismaticJoint::SaveImpulses(float32* impulses) const
+{
+	impulses[0] = m_impulse.x;
+	impulses[1] = m_impulse.y;
+	impulses[2] = m_impulse.z;
+	impulses[3] = m_motorImpulse;
+	return 4;
+}
+
+// Defold mod
+void b2PrismaticJoint::RestoreImpulses(const float32* impulses)
+{
+	m_impulse.x = impulses[0];
+	m_impulse.y = impulses[1];
+	m_impulse.z = impulses[2];
+	m_motorImpulse = impulses[3];
+}
+
 float32 b2PrismaticJoint::GetJointTranslation() const
 {
 	b2Vec2 pA = m_bodyA->GetWorldPoint(m_localAnchorA);
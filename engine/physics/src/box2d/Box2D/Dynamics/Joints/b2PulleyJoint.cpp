@@ -281,6 +281,19 @@ float32 b2PulleyJoint::GetReactionTorque(float32 inv_dt) const
 	return 0.0f;
 }
 
+// Defold mod
+int32 b2PulleyJoint::SaveImpulses(float32* impulses) const
+{
+	impulses[0] = m_impulse;
+	return 1;
+}
+
+// Defold mod
+void b2PulleyJoint::RestoreImpulses(const float32* impulses)
+{
+	m_impulse = impulses[0];
+}
+
 b2Vec2 b2PulleyJoint::GetGroundAnchorA() const
 {
 	return m_groundAnchorA;
@@ -397,6 +397,25 @@ float32 b2RevoluteJoint::GetReactionTorque(float32 inv_dt) const
 	return inv_dt * m_impulse.z;
 }
 
+// Defold mod
+int32 b2RevoluteJoint::SaveImpulses(float32* impulses) const
+{
+	impulses[0] = m_impulse.x;
+	impulses[1] = m_impulse.y;
+	impulses[2] = m_impulse.z;
+	impulses[3] = m_motorImpulse;
+	return 4;
+}
+
+// Defold mod
+void b2RevoluteJoint::RestoreImpulses(const float32* impulses)
+{
+	m_impulse.x = impulses[0];
+	m_impulse.y = impulses[1];
+	m_impulse.z = impulses[2];
+	m_motorImpulse = impulses[3];
+}
+
 float32 b2RevoluteJoint::GetJointAngle() const
 {
 	b2Body* bA = m_bodyA;
@@ -147,6 +147,10 @@ public:
 	/// Unit is N*m.
 	float32 GetReactionTorque(float32 inv_dt) const;
 
+	// Defold mod: See b2Joint::SaveImpulses
+	int32 SaveImpulses(float32* impulses) const;
+	void RestoreImpulses(const float32* impulses);
+
 	/// Get the current motor torque given the inverse time step.
 	/// Unit is N*m.
 	float32 GetMotorTorque(float32 inv_dt) const;
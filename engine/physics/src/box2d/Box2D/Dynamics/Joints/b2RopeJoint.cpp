@@ -215,6 +215,19 @@ float32 b2RopeJoint::GetReactionTorque(float32 inv_dt) const
 	return 0.0f;
 }
 
+// Defold mod
+int32 b2RopeJoint::SaveImpulses(float32* impulses) const
+{
+	impulses[0] = m_impulse;
+	return 1;
+}
+
+// Defold mod
+void b2RopeJoint::RestoreImpulses(const float32* impulses)
+{
+	m_impulse = impulses[0];
+}
+
 float32 b2RopeJoint::GetMaxLength() const
 {
 	return m_maxLength;
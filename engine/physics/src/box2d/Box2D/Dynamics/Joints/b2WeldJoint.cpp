@@ -312,6 +312,23 @@ float32 b2WeldJoint::GetReactionTorque(float32 inv_dt) const
 	return inv_dt * m_impulse.z;
 }
 
+// Defold mod
+int32 b2WeldJoint::SaveImpulses(float32* impulses) const
+{
+	impulses[0] = m_impulse.x;
+	impulses[1] = m_impulse.y;
+	impulses[2] = m_impulse.z;
+	return 3;
+}
+
+// Defold mod
+void b2WeldJoint::RestoreImpulses(const float32* impulses)
+{
+	m_impulse.x = impulses[0];
+	m_impulse.y = impulses[1];
+	m_impulse.z = impulses[2];
+}
+
 void b2WeldJoint::Dump()
 {
 	int32 indexA = m_bodyA->m_islandIndex;
@@ -346,6 +346,23 @@ float32 b2WheelJoint::GetReactionTorque(float32 inv_dt) const
 	return inv_dt * m_motorImpulse;
 }
 
+// Defold mod
+int32 b2WheelJoint::SaveImpulses(float32* impulses) const
+{
+	impulses[0] = m_impulse;
+	impulses[1] = m_motorImpulse;
+	impulses[2] = m_springImpulse;
+	return 3;
+}
+
+// Defold mod
+void b2WheelJoint::RestoreImpulses(const float32* impulses)
+{
+	m_impulse = impulses[0];
+	m_motorImpulse = impulses[1];
+	m_springImpulse = impulses[2];
+}
+
 float32 b2WheelJoint::GetJointTranslation() const
 {
 	b2Body* bA = m_bodyA;
@@ -66,6 +66,13 @@ b2Body::b2Body(const b2BodyDef* bd, b2World* world)
 	m_sweep.a = bd->angle;
 	m_sweep.alpha0 = 0.0f;
 
+	// Defold mod
+	StorePreviousTransform();
+	m_prevAwake = NULL;
+	m_nextAwake = NULL;
+	m_prevKinematic = NULL;
+	m_nextKinematic = NULL;
+
 	m_jointList = NULL;
 	m_contactList = NULL;
 	m_prev = NULL;
@@ -123,8 +130,20 @@ void b2Body::SetType(b2BodyType type)
 		return;
 	}
 
+	// Defold mod
+	if (m_type == b2_kinematicBody)
+	{
+		m_world->RemoveKinematicBody(this);
+	}
+
 	m_type = type;
 
+	// Defold mod
+	if (m_type == b2_kinematicBody)
+	{
+		m_world->AddKinematicBody(this);
+	}
+
 	ResetMassData();
 
 	if (m_type == b2_staticBody)
@@ -138,6 +157,12 @@ void b2Body::SetType(b2BodyType type)
 
 	SetAwake(true);
 
+	// Defold mod: The body might already have been awake
+	if ((m_flags & (e_awakeListFlag | e_activeFlag)) == e_activeFlag)
+	{
+		LinkAwake();
+	}
+
 	m_force.SetZero();
 	m_torque = 0.0f;
 
@@ -440,6 +465,9 @@ void b2Body::SetTransform(const b2Vec2& position, float32 angle)
 	m_sweep.c0 = m_sweep.c;
 	m_sweep.a0 = angle;
 
+	// Defold mod: Don't interpolate from the old transform
+	StorePreviousTransform();
+
 	b2BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
 	for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
 	{
@@ -486,6 +514,19 @@ void b2Body::SynchronizeSingle(b2Shape* shape, int32 index)
     }
 }
 
+void b2Body::LinkAwake()
+{
+	b2Assert((m_flags & e_awakeListFlag) == 0);
+	m_prevAwake = NULL;
+	m_nextAwake = m_world->m_awakeBodyList;
+	if (m_world->m_awakeBodyList)
+	{
+		m_world->m_awakeBodyList->m_prevAwake = this;
+	}
+	m_world->m_awakeBodyList = this;
+	m_flags |= e_awakeListFlag;
+}
+
 void b2Body::SetActive(bool flag)
 {
 	b2Assert(m_world->IsLocked() == false);
@@ -507,6 +548,12 @@ void b2Body::SetActive(bool flag)
 		}
 
 		// Contacts are created the next time step.
+
+		// Defold mod
+		if ((m_flags & (e_awakeFlag | e_awakeListFlag)) == e_awakeFlag)
+		{
+			LinkAwake();
+		}
 	}
 	else
 	{
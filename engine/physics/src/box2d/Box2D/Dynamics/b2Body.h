@@ -387,6 +387,21 @@ public:
     /// Get the total force
     const b2Vec2& GetForce() const;
 
+    /// Store the current origin and angle as the previous state, used to interpolate between steps
+    void StorePreviousTransform();
+
+    /// Get the origin stored by StorePreviousTransform
+    const b2Vec2& GetPreviousPosition() const;
+
+    /// Get the angle stored by StorePreviousTransform
+    float32 GetPreviousAngle() const;
+
+    /// Get the next body in the world awake list, see b2World::GetAwakeBodyList
+    b2Body* GetNextAwake();
+
+    /// Get the next body in the world kinematic list, see b2World::GetKinematicBodyList
+    b2Body* GetNextKinematic();
+
 private:
 
 	friend class b2World;
@@ -417,7 +432,8 @@ private:
 		e_bulletFlag		= 0x0008,
 		e_fixedRotationFlag	= 0x0010,
 		e_activeFlag		= 0x0020,
-		e_toiFlag			= 0x0040
+		e_toiFlag			= 0x0040,
+		e_awakeListFlag		= 0x0080 // Defold mod: the body is in the world awake list
 	};
 
 	b2Body(const b2BodyDef* bd, b2World* world);
@@ -427,6 +443,8 @@ private:
     // Defold mod
     void SynchronizeSingle(b2Shape* shape, int32 index);
     void SynchronizeTransform();
+    // Defold mod: Add the body to the world awake list
+    void LinkAwake();
 
 	// This is used to prevent connected bodies from colliding.
 	// It may lie, depending on the collideConnected flag.
@@ -471,6 +489,18 @@ private:
 	float32 m_sleepTime;
 
 	void* m_userData;
+
+    // Defold mod: Origin and angle before the last step, see StorePreviousTransform
+    b2Vec2 m_prevPosition;
+    float32 m_prevAngle;
+
+    // Defold mod: Links in the world awake list
+    b2Body* m_prevAwake;
+    b2Body* m_nextAwake;
+
+    // Defold mod: Links in the world kinematic list
+    b2Body* m_prevKinematic;
+    b2Body* m_nextKinematic;
 };
 
 inline b2BodyType b2Body::GetType() const
@@ -645,6 +675,12 @@ inline void b2Body::SetAwake(bool flag)
 		{
 			m_flags |= e_awakeFlag;
 			m_sleepTime = 0.0f;
+
+			// Defold mod
+			if ((m_flags & (e_awakeListFlag | e_activeFlag)) == e_activeFlag)
+			{
+				LinkAwake();
+			}
 		}
 	}
 	else
@@ -863,4 +899,30 @@ inline const b2Vec2& b2Body::GetForce() const
     return m_force;
 }
 
+inline void b2Body::StorePreviousTransform()
+{
+    m_prevPosition = m_xf.p;
+    m_prevAngle = m_sweep.a;
+}
+
+inline const b2Vec2& b2Body::GetPreviousPosition() const
+{
+    return m_prevPosition;
+}
+
+inline float32 b2Body::GetPreviousAngle() const
+{
+    return m_prevAngle;
+}
+
+inline b2Body* b2Body::GetNextAwake()
+{
+    return m_nextAwake;
+}
+
+inline b2Body* b2Body::GetNextKinematic()
+{
+    return m_nextKinematic;
+}
+
 #endif
@@ -21,6 +21,7 @@
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
 #include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <Box2D/Collision/Shapes/b2GridShape.h>
 
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
@@ -150,9 +151,20 @@ void b2ContactManager::Collide()
 			continue;
 		}
 
-		int32 proxyIdA = fixtureA->m_proxies[indexA].proxyId;
-		int32 proxyIdB = fixtureB->m_proxies[indexB].proxyId;
-		bool overlap = m_broadPhase.TestOverlap(proxyIdA, proxyIdB);
+		bool overlap;
+		// Defold modification. Grid proxies cover a chunk of cells, test the cell itself against the other proxy
+		if (fixtureA->GetType() == b2Shape::e_grid)
+		{
+			b2AABB cellAABB;
+			fixtureA->GetShape()->ComputeAABB(&cellAABB, bodyA->GetTransform(), indexA);
+			overlap = b2TestOverlap(cellAABB, m_broadPhase.GetFatAABB(fixtureB->m_proxies[indexB].proxyId));
+		}
+		else
+		{
+			int32 proxyIdA = fixtureA->m_proxies[indexA].proxyId;
+			int32 proxyIdB = fixtureB->m_proxies[indexB].proxyId;
+			overlap = m_broadPhase.TestOverlap(proxyIdA, proxyIdB);
+		}
 
 		// Here we destroy contacts that cease to overlap in the broad-phase.
 		if (overlap == false)
@@ -192,12 +204,36 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 	b2FixtureProxy* proxyA = (b2FixtureProxy*)proxyUserDataA;
 	b2FixtureProxy* proxyB = (b2FixtureProxy*)proxyUserDataB;
 
-	b2Fixture* fixtureA = proxyA->fixture;
-	b2Fixture* fixtureB = proxyB->fixture;
+	// Defold modifications. A grid proxy covers a chunk of cells, add a contact for each
+	// cell overlapping the other proxy. There are no grid vs grid contacts.
+	bool gridA = proxyA->fixture->GetType() == b2Shape::e_grid;
+	bool gridB = proxyB->fixture->GetType() == b2Shape::e_grid;
+	if (gridA && gridB)
+	{
+		return;
+	}
+	if (gridA || gridB)
+	{
+		if (gridB)
+		{
+			b2Swap(proxyA, proxyB);
+		}
+		b2Fixture* gridFixture = proxyA->fixture;
+		const b2GridShape* grid = (const b2GridShape*)gridFixture->GetShape();
+		uint32 cells[B2GRIDSHAPE_CHUNK_CELL_COUNT];
+		uint32 cellCount = grid->GetChunkCells(proxyA->childIndex, m_broadPhase.GetFatAABB(proxyB->proxyId), gridFixture->GetBody()->GetTransform(), cells);
+		for (uint32 i = 0; i < cellCount; ++i)
+		{
+			AddChildPair(gridFixture, cells[i], proxyB->fixture, proxyB->childIndex);
+		}
+		return;
+	}
 
-	int32 indexA = proxyA->childIndex;
-	int32 indexB = proxyB->childIndex;
+	AddChildPair(proxyA->fixture, proxyA->childIndex, proxyB->fixture, proxyB->childIndex);
+}
 
+void b2ContactManager::AddChildPair(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB)
+{
 	b2Body* bodyA = fixtureA->GetBody();
 	b2Body* bodyB = fixtureB->GetBody();
 
@@ -249,20 +285,30 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 		return;
 	}
 
+	b2Contact* c = CreateContact(fixtureA, indexA, fixtureB, indexB);
+	if (c == NULL)
+	{
+		return;
+	}
+
+	// Wake up the bodies
+	c->GetFixtureA()->GetBody()->SetAwake(true);
+	c->GetFixtureB()->GetBody()->SetAwake(true);
+}
+
+// Defold modifications
+b2Contact* b2ContactManager::CreateContact(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB)
+{
 	// Call the factory.
 	b2Contact* c = b2Contact::Create(fixtureA, indexA, fixtureB, indexB, m_allocator);
 	if (c == NULL)
 	{
-		return;
+		return NULL;
 	}
 
 	// Contact creation may swap fixtures.
-	fixtureA = c->GetFixtureA();
-	fixtureB = c->GetFixtureB();
-	indexA = c->GetChildIndexA();
-	indexB = c->GetChildIndexB();
-	bodyA = fixtureA->GetBody();
-	bodyB = fixtureB->GetBody();
+	b2Body* bodyA = c->GetFixtureA()->GetBody();
+	b2Body* bodyB = c->GetFixtureB()->GetBody();
 
 	// Insert into the world.
 	c->m_prev = NULL;
@@ -299,9 +345,6 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 	}
 	bodyB->m_contactList = &c->m_nodeB;
 
-	// Wake up the bodies
-	bodyA->SetAwake(true);
-	bodyB->SetAwake(true);
-
 	++m_contactCount;
+	return c;
 }
@@ -22,6 +22,7 @@
 #include <Box2D/Collision/b2BroadPhase.h>
 
 class b2Contact;
+class b2Fixture;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
@@ -42,6 +43,13 @@ public:
 	void Destroy(b2Contact* c);
 
 	void Collide();
+
+	// Defold modifications
+	// Add a contact between two child shapes
+	void AddChildPair(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB);
+	// Create a contact and link it first in the contact lists, without waking the bodies or
+	// checking if the fixtures should collide. Returns NULL if the shapes cannot collide.
+	b2Contact* CreateContact(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB);
             
 	b2BroadPhase m_broadPhase;
 	b2Contact* m_contactList;
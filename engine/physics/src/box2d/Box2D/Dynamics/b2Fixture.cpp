@@ -58,19 +58,24 @@ void b2Fixture::Create(b2BlockAllocator* allocator, b2Body* body, const b2Fixtur
     m_shape = (b2Shape*)def->shape;
 
 	// Reserve proxy space
+	// Defold modification. A proxy may cover several child shapes
 	int32 childCount = m_shape->GetChildCount();
-	m_proxies = (b2FixtureProxy*)allocator->Allocate(childCount * sizeof(b2FixtureProxy));
+	int32 proxyCount = m_shape->GetProxyCount();
+	m_proxies = (b2FixtureProxy*)allocator->Allocate(proxyCount * sizeof(b2FixtureProxy));
     // Defold modification. Allocate filters per child-shape
 	if (m_shape->m_filterPerChild)
 	{
 	    m_filters = (b2Filter*)allocator->Allocate(childCount * sizeof(b2Filter));
 	}
-	for (int32 i = 0; i < childCount; ++i)
+	for (int32 i = 0; i < proxyCount; ++i)
 	{
 		m_proxies[i].fixture = NULL;
 		m_proxies[i].proxyId = b2BroadPhase::e_nullProxy;
-	    // Defold modification. Set filter per child shape
-	    if (m_shape->m_filterPerChild)
+	}
+	// Defold modification. Set filter per child shape
+	if (m_shape->m_filterPerChild)
+	{
+	    for (int32 i = 0; i < childCount; ++i)
 	    {
 	        m_filters[i] = def->filter;
 	    }
@@ -87,7 +92,7 @@ void b2Fixture::Destroy(b2BlockAllocator* allocator)
 
 	// Free the proxy array.
 	int32 childCount = m_shape->GetChildCount();
-	allocator->Free(m_proxies, childCount * sizeof(b2FixtureProxy));
+	allocator->Free(m_proxies, m_shape->GetProxyCount() * sizeof(b2FixtureProxy));
 	m_proxies = NULL;
 	if (m_shape->m_filterPerChild)
 	{
@@ -143,12 +148,12 @@ void b2Fixture::CreateProxies(b2BroadPhase* broadPhase, const b2Transform& xf)
 	b2Assert(m_proxyCount == 0);
 
 	// Create proxies in the broad-phase.
-	m_proxyCount = m_shape->GetChildCount();
+	m_proxyCount = m_shape->GetProxyCount();
 
 	for (int32 i = 0; i < m_proxyCount; ++i)
 	{
 		b2FixtureProxy* proxy = m_proxies + i;
-		m_shape->ComputeAABB(&proxy->aabb, xf, i);
+		m_shape->ComputeProxyAABB(&proxy->aabb, xf, i);
 		proxy->proxyId = broadPhase->CreateProxy(proxy->aabb, proxy);
 		proxy->fixture = this;
 		proxy->childIndex = i;
@@ -181,8 +186,8 @@ void b2Fixture::Synchronize(b2BroadPhase* broadPhase, const b2Transform& transfo
 
 		// Compute an AABB that covers the swept shape (may miss some rotation effect).
 		b2AABB aabb1, aabb2;
-		m_shape->ComputeAABB(&aabb1, transform1, proxy->childIndex);
-		m_shape->ComputeAABB(&aabb2, transform2, proxy->childIndex);
+		m_shape->ComputeProxyAABB(&aabb1, transform1, proxy->childIndex);
+		m_shape->ComputeProxyAABB(&aabb2, transform2, proxy->childIndex);
 
 		proxy->aabb.Combine(aabb1, aabb2);
 
@@ -199,14 +204,19 @@ void b2Fixture::SynchronizeSingle(b2BroadPhase* broadPhase, int32 index, const b
     b2FixtureProxy* proxy = m_proxies + index;
 
     b2AABB aabb1, aabb2;
-    m_shape->ComputeAABB(&aabb1, transform1, proxy->childIndex);
-    m_shape->ComputeAABB(&aabb2, transform2, proxy->childIndex);
+    m_shape->ComputeProxyAABB(&aabb1, transform1, proxy->childIndex);
+    m_shape->ComputeProxyAABB(&aabb2, transform2, proxy->childIndex);
 
     proxy->aabb.Combine(aabb1, aabb2);
 
     b2Vec2 displacement = transform2.p - transform1.p;
 
     broadPhase->MoveProxy(proxy->proxyId, proxy->aabb, displacement);
+    // Defold modification. A grid proxy covers a chunk of cells and needs new pairs even when its AABB is unchanged
+    if (GetType() == b2Shape::e_grid)
+    {
+        broadPhase->TouchProxy(proxy->proxyId);
+    }
 }
 
 void b2Fixture::SetFilterData(const b2Filter& filter, int32 index)
@@ -71,6 +71,10 @@ public:
 
 	void Report(const b2ContactVelocityConstraint* constraints);
 
+	// Defold mod: Copy the island indices of the contact bodies to the contacts. Static bodies
+	// are shared between islands, so this must be done before the next island is built.
+	void StoreContactIndices();
+
 	b2StackAllocator* m_allocator;
 	b2ContactListener* m_listener;
 
@@ -42,6 +42,12 @@ b2World::b2World(const b2Vec2& gravity)
 
 	m_bodyList = NULL;
 	m_jointList = NULL;
+	m_awakeBodyList = NULL;
+	m_kinematicBodyList = NULL;
+
+	m_parallelFor = NULL;
+	m_taskAllocators = NULL;
+	m_taskCount = 1;
 
 	m_bodyCount = 0;
 	m_jointCount = 0;
@@ -83,6 +89,8 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	SetParallelFor(NULL);
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -126,6 +134,16 @@ b2Body* b2World::CreateBody(const b2BodyDef* def)
 	m_bodyList = b;
 	++m_bodyCount;
 
+	// Defold mod
+	if (b->IsAwake() && b->IsActive())
+	{
+		b->LinkAwake();
+	}
+	if (b->GetType() == b2_kinematicBody)
+	{
+		AddKinematicBody(b);
+	}
+
 	return b;
 }
 
@@ -205,11 +223,452 @@ void b2World::DestroyBody(b2Body* b)
 		m_bodyList = b->m_next;
 	}
 
+	// Defold mod
+	if (b->m_flags & b2Body::e_awakeListFlag)
+	{
+		RemoveAwakeBody(b);
+	}
+	if (b->GetType() == b2_kinematicBody)
+	{
+		RemoveKinematicBody(b);
+	}
+
 	--m_bodyCount;
 	b->~b2Body();
 	m_blockAllocator.Free(b, sizeof(b2Body));
 }
 
+void b2World::SetParallelFor(b2ParallelFor* parallelFor)
+{
+	for (int32 i = 0; i < m_taskCount - 1; ++i)
+	{
+		m_taskAllocators[i].~b2StackAllocator();
+	}
+	if (m_taskAllocators)
+	{
+		b2Free(m_taskAllocators);
+	}
+	m_taskAllocators = NULL;
+	m_taskCount = 1;
+
+	m_parallelFor = parallelFor;
+	if (parallelFor && parallelFor->GetThreadCount() > 1)
+	{
+		m_taskCount = parallelFor->GetThreadCount();
+		m_taskAllocators = (b2StackAllocator*)b2Alloc((m_taskCount - 1) * sizeof(b2StackAllocator));
+		for (int32 i = 0; i < m_taskCount - 1; ++i)
+		{
+			new (m_taskAllocators + i) b2StackAllocator();
+		}
+	}
+}
+
+void b2World::RemoveAwakeBody(b2Body* b)
+{
+	b2Assert(b->m_flags & b2Body::e_awakeListFlag);
+
+	if (b->m_prevAwake)
+	{
+		b->m_prevAwake->m_nextAwake = b->m_nextAwake;
+	}
+
+	if (b->m_nextAwake)
+	{
+		b->m_nextAwake->m_prevAwake = b->m_prevAwake;
+	}
+
+	if (b == m_awakeBodyList)
+	{
+		m_awakeBodyList = b->m_nextAwake;
+	}
+
+	b->m_prevAwake = NULL;
+	b->m_nextAwake = NULL;
+	b->m_flags &= ~b2Body::e_awakeListFlag;
+}
+
+// Defold mod: Layout of the state written by SaveState. The header is followed by the saved
+// bodies, contacts, proxies, joints and moved proxies, in that order. All sections except the
+// last one are a multiple of 8 bytes, keeping the following section aligned.
+static const int32 b2_stateVersion = 1;
+
+struct b2WorldStateHeader
+{
+	const b2World* world;
+	int32 version;
+	int32 bodyCount;		// all bodies, to detect changes to the world
+	int32 fixtureCount;		// all fixtures, to detect changes to the world
+	int32 savedBodyCount;	// non-static bodies
+	int32 proxyCount;		// proxies of the non-static bodies
+	int32 contactCount;
+	int32 jointCount;
+	int32 moveCount;
+	int32 flags;
+	float32 inv_dt0;
+	int32 stepComplete;
+};
+
+struct b2BodyState
+{
+	const b2Body* body;
+	b2Transform xf;
+	b2Sweep sweep;
+	b2Vec2 linearVelocity;
+	float32 angularVelocity;
+	b2Vec2 force;
+	float32 torque;
+	float32 sleepTime;
+	b2Vec2 prevPosition;
+	float32 prevAngle;
+	int32 awake;
+};
+
+struct b2ContactState
+{
+	const b2Fixture* fixtureA;
+	const b2Fixture* fixtureB;
+	int32 indexA;
+	int32 indexB;
+	uint32 flags;
+	int32 toiCount;
+	float32 toi;
+	float32 friction;
+	float32 restitution;
+	b2Manifold manifold;
+};
+
+struct b2ProxyState
+{
+	b2AABB aabb;
+	b2AABB fatAABB;
+};
+
+struct b2JointState
+{
+	float32 impulses[b2_maxJointImpulses];
+};
+
+static int32 b2GetStateSize(int32 bodyCount, int32 contactCount, int32 proxyCount, int32 jointCount, int32 moveCount)
+{
+	return sizeof(b2WorldStateHeader) + bodyCount * sizeof(b2BodyState) + contactCount * sizeof(b2ContactState) +
+		   proxyCount * sizeof(b2ProxyState) + jointCount * sizeof(b2JointState) + moveCount * sizeof(int32);
+}
+
+int32 b2World::GetStateSize() const
+{
+	int32 bodyCount = 0;
+	int32 proxyCount = 0;
+	for (const b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		if (b->m_type == b2_staticBody)
+		{
+			continue;
+		}
+		++bodyCount;
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			proxyCount += f->m_proxyCount;
+		}
+	}
+
+	const b2BroadPhase& broadPhase = m_contactManager.m_broadPhase;
+	const int32* moveBuffer = broadPhase.GetMoveBuffer();
+	int32 moveCount = 0;
+	for (int32 i = 0; i < broadPhase.GetMoveCount(); ++i)
+	{
+		moveCount += moveBuffer[i] != b2BroadPhase::e_nullProxy ? 1 : 0;
+	}
+
+	return b2GetStateSize(bodyCount, m_contactManager.m_contactCount, proxyCount, m_jointCount, moveCount);
+}
+
+void b2World::SaveState(void* buffer) const
+{
+	b2Assert(IsLocked() == false);
+
+	b2WorldStateHeader* header = (b2WorldStateHeader*)buffer;
+	header->world = this;
+	header->version = b2_stateVersion;
+	header->bodyCount = m_bodyCount;
+	header->jointCount = m_jointCount;
+	header->contactCount = m_contactManager.m_contactCount;
+	header->flags = m_flags & e_newFixture;
+	header->inv_dt0 = m_inv_dt0;
+	header->stepComplete = m_stepComplete ? 1 : 0;
+
+	b2BodyState* bodyState = (b2BodyState*)(header + 1);
+	int32 fixtureCount = 0;
+	int32 proxyCount = 0;
+	for (const b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		fixtureCount += b->m_fixtureCount;
+		if (b->m_type == b2_staticBody)
+		{
+			continue;
+		}
+		bodyState->body = b;
+		bodyState->xf = b->m_xf;
+		bodyState->sweep = b->m_sweep;
+		bodyState->linearVelocity = b->m_linearVelocity;
+		bodyState->angularVelocity = b->m_angularVelocity;
+		bodyState->force = b->m_force;
+		bodyState->torque = b->m_torque;
+		bodyState->sleepTime = b->m_sleepTime;
+		bodyState->prevPosition = b->m_prevPosition;
+		bodyState->prevAngle = b->m_prevAngle;
+		bodyState->awake = b->IsAwake() ? 1 : 0;
+		++bodyState;
+
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			proxyCount += f->m_proxyCount;
+		}
+	}
+	header->fixtureCount = fixtureCount;
+	header->savedBodyCount = (int32)(bodyState - (b2BodyState*)(header + 1));
+	header->proxyCount = proxyCount;
+
+	b2ContactState* contactState = (b2ContactState*)bodyState;
+	for (const b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		contactState->fixtureA = c->m_fixtureA;
+		contactState->fixtureB = c->m_fixtureB;
+		contactState->indexA = c->m_indexA;
+		contactState->indexB = c->m_indexB;
+		contactState->flags = c->m_flags & ~b2Contact::e_islandFlag;
+		contactState->toiCount = c->m_toiCount;
+		contactState->toi = c->m_toi;
+		contactState->friction = c->m_friction;
+		contactState->restitution = c->m_restitution;
+		contactState->manifold = c->m_manifold;
+		++contactState;
+	}
+
+	const b2BroadPhase& broadPhase = m_contactManager.m_broadPhase;
+	b2ProxyState* proxyState = (b2ProxyState*)contactState;
+	for (const b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		if (b->m_type == b2_staticBody)
+		{
+			continue;
+		}
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				proxyState->aabb = f->m_proxies[i].aabb;
+				proxyState->fatAABB = broadPhase.GetFatAABB(f->m_proxies[i].proxyId);
+				++proxyState;
+			}
+		}
+	}
+
+	b2JointState* jointState = (b2JointState*)proxyState;
+	for (const b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		int32 count = j->SaveImpulses(jointState->impulses);
+		for (int32 i = count; i < b2_maxJointImpulses; ++i)
+		{
+			jointState->impulses[i] = 0.0f;
+		}
+		++jointState;
+	}
+
+	int32* moveState = (int32*)jointState;
+	const int32* moveBuffer = broadPhase.GetMoveBuffer();
+	int32 moveCount = 0;
+	for (int32 i = 0; i < broadPhase.GetMoveCount(); ++i)
+	{
+		if (moveBuffer[i] != b2BroadPhase::e_nullProxy)
+		{
+			moveState[moveCount++] = moveBuffer[i];
+		}
+	}
+	header->moveCount = moveCount;
+}
+
+bool b2World::RestoreState(const void* buffer, int32 size)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked() || size < (int32)sizeof(b2WorldStateHeader))
+	{
+		return false;
+	}
+
+	const b2WorldStateHeader* header = (const b2WorldStateHeader*)buffer;
+	if (header->world != this || header->version != b2_stateVersion ||
+		header->bodyCount != m_bodyCount || header->jointCount != m_jointCount ||
+		size != b2GetStateSize(header->savedBodyCount, header->contactCount, header->proxyCount, header->jointCount, header->moveCount))
+	{
+		return false;
+	}
+
+	// Check that the world has the same bodies and fixtures before changing anything
+	const b2BodyState* bodyStates = (const b2BodyState*)(header + 1);
+	const b2BodyState* bodyStatesEnd = bodyStates + header->savedBodyCount;
+	const b2BodyState* bodyState = bodyStates;
+	int32 fixtureCount = 0;
+	int32 proxyCount = 0;
+	for (const b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		fixtureCount += b->m_fixtureCount;
+		if (b->m_type == b2_staticBody)
+		{
+			continue;
+		}
+		if (bodyState == bodyStatesEnd || bodyState->body != b)
+		{
+			return false;
+		}
+		++bodyState;
+
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			proxyCount += f->m_proxyCount;
+		}
+	}
+	if (bodyState != bodyStatesEnd || fixtureCount != header->fixtureCount || proxyCount != header->proxyCount)
+	{
+		return false;
+	}
+
+	for (bodyState = bodyStates; bodyState != bodyStatesEnd; ++bodyState)
+	{
+		b2Body* b = (b2Body*)bodyState->body;
+		bool moved = !(b->m_xf.p == bodyState->xf.p) || b->m_xf.q.s != bodyState->xf.q.s || b->m_xf.q.c != bodyState->xf.q.c;
+
+		b->SetAwake(bodyState->awake != 0);
+		b->m_xf = bodyState->xf;
+		b->m_sweep = bodyState->sweep;
+		b->m_linearVelocity = bodyState->linearVelocity;
+		b->m_angularVelocity = bodyState->angularVelocity;
+		b->m_force = bodyState->force;
+		b->m_torque = bodyState->torque;
+		b->m_sleepTime = bodyState->sleepTime;
+		b->m_prevPosition = bodyState->prevPosition;
+		b->m_prevAngle = bodyState->prevAngle;
+
+		// Report the new transform through the awake list, even if the body is asleep
+		if (moved && (b->m_flags & (b2Body::e_awakeListFlag | b2Body::e_activeFlag)) == b2Body::e_activeFlag)
+		{
+			b->LinkAwake();
+		}
+	}
+
+	// Keep the current contacts when they are the same as the saved ones, which is the common case
+	// when re-simulating a few steps. Otherwise replace them all, without calling the contact listener.
+	const b2ContactState* contactStates = (const b2ContactState*)bodyStatesEnd;
+	const b2ContactState* contactStatesEnd = contactStates + header->contactCount;
+	bool sameContacts = m_contactManager.m_contactCount == header->contactCount;
+	const b2ContactState* contactState = contactStates;
+	for (b2Contact* c = m_contactManager.m_contactList; c && sameContacts; c = c->m_next, ++contactState)
+	{
+		sameContacts = c->m_fixtureA == contactState->fixtureA && c->m_fixtureB == contactState->fixtureB &&
+					   c->m_indexA == contactState->indexA && c->m_indexB == contactState->indexB;
+	}
+
+	if (!sameContacts)
+	{
+		b2Contact* c = m_contactManager.m_contactList;
+		while (c)
+		{
+			b2Contact* next = c->m_next;
+			// Not touching, so that the bodies aren't woken up and EndContact isn't called
+			c->m_flags &= ~b2Contact::e_touchingFlag;
+			c->m_manifold.pointCount = 0;
+			m_contactManager.Destroy(c);
+			c = next;
+		}
+
+		// Contacts are added first in the lists, recreate them in reverse to get the saved order
+		for (contactState = contactStatesEnd; contactState != contactStates;)
+		{
+			--contactState;
+			b2Contact* contact = m_contactManager.CreateContact((b2Fixture*)contactState->fixtureA, contactState->indexA,
+																(b2Fixture*)contactState->fixtureB, contactState->indexB);
+			b2Assert(contact != NULL && contact->m_fixtureA == contactState->fixtureA);
+			B2_NOT_USED(contact);
+		}
+	}
+
+	contactState = contactStates;
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next, ++contactState)
+	{
+		c->m_flags = contactState->flags;
+		c->m_toiCount = contactState->toiCount;
+		c->m_toi = contactState->toi;
+		c->m_friction = contactState->friction;
+		c->m_restitution = contactState->restitution;
+		c->m_manifold = contactState->manifold;
+	}
+
+	b2BroadPhase& broadPhase = m_contactManager.m_broadPhase;
+	const b2ProxyState* proxyState = (const b2ProxyState*)contactStatesEnd;
+	for (bodyState = bodyStates; bodyState != bodyStatesEnd; ++bodyState)
+	{
+		for (b2Fixture* f = ((b2Body*)bodyState->body)->m_fixtureList; f; f = f->m_next)
+		{
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				f->m_proxies[i].aabb = proxyState->aabb;
+				broadPhase.SetFatAABB(f->m_proxies[i].proxyId, proxyState->fatAABB);
+				++proxyState;
+			}
+		}
+	}
+
+	const b2JointState* jointState = (const b2JointState*)proxyState;
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		j->RestoreImpulses(jointState->impulses);
+		++jointState;
+	}
+
+	const int32* moveState = (const int32*)jointState;
+	broadPhase.ClearMoveBuffer();
+	for (int32 i = 0; i < header->moveCount; ++i)
+	{
+		broadPhase.TouchProxy(moveState[i]);
+	}
+
+	m_flags = (m_flags & ~e_newFixture) | (header->flags & e_newFixture);
+	m_inv_dt0 = header->inv_dt0;
+	m_stepComplete = header->stepComplete != 0;
+	return true;
+}
+
+void b2World::AddKinematicBody(b2Body* b)
+{
+	b->m_prevKinematic = NULL;
+	b->m_nextKinematic = m_kinematicBodyList;
+	if (m_kinematicBodyList)
+	{
+		m_kinematicBodyList->m_prevKinematic = b;
+	}
+	m_kinematicBodyList = b;
+}
+
+void b2World::RemoveKinematicBody(b2Body* b)
+{
+	if (b->m_prevKinematic)
+	{
+		b->m_prevKinematic->m_nextKinematic = b->m_nextKinematic;
+	}
+
+	if (b->m_nextKinematic)
+	{
+		b->m_nextKinematic->m_prevKinematic = b->m_prevKinematic;
+	}
+
+	if (b == m_kinematicBodyList)
+	{
+		m_kinematicBodyList = b->m_nextKinematic;
+	}
+
+	b->m_prevKinematic = NULL;
+	b->m_nextKinematic = NULL;
+}
+
 b2Joint* b2World::CreateJoint(const b2JointDef* def)
 {
 	b2Assert(IsLocked() == false);
@@ -384,6 +843,62 @@ void b2World::SetAllowSleeping(bool flag)
 }
 
 // Find islands, integrate and solve constraints, solve position constraints
+// Defold mod: An island deferred to be solved concurrently with other islands, see b2World::SetParallelFor
+struct b2DeferredIsland
+{
+	int32 bodyIndex;
+	int32 bodyCount;
+	int32 contactIndex;
+	int32 contactCount;
+	int32 jointIndex;
+	int32 jointCount;
+};
+
+// Defold mod: A range of deferred islands solved by one thread
+struct b2IslandTask
+{
+	b2StackAllocator* allocator;
+	int32 islandIndex;
+	int32 islandCount;
+	b2Profile profile;
+};
+
+struct b2IslandTaskContext
+{
+	const b2TimeStep* step;
+	b2Vec2 gravity;
+	bool allowSleep;
+	const b2DeferredIsland* islands;
+	b2Body** bodies;
+	b2Contact** contacts;
+	b2Joint** joints;
+	b2IslandTask* tasks;
+};
+
+static void b2SolveIslandTask(void* context, int32 index)
+{
+	b2IslandTaskContext* ctx = (b2IslandTaskContext*)context;
+	b2IslandTask* task = ctx->tasks + index;
+	for (int32 i = task->islandIndex; i < task->islandIndex + task->islandCount; ++i)
+	{
+		const b2DeferredIsland* di = ctx->islands + i;
+		// Contacts are reported by the calling thread once all islands are solved
+		b2Island island(di->bodyCount, di->contactCount, di->jointCount, task->allocator, NULL);
+		memcpy(island.m_bodies, ctx->bodies + di->bodyIndex, di->bodyCount * sizeof(b2Body*));
+		memcpy(island.m_contacts, ctx->contacts + di->contactIndex, di->contactCount * sizeof(b2Contact*));
+		memcpy(island.m_joints, ctx->joints + di->jointIndex, di->jointCount * sizeof(b2Joint*));
+		island.m_bodyCount = di->bodyCount;
+		island.m_contactCount = di->contactCount;
+		island.m_jointCount = di->jointCount;
+
+		b2Profile profile;
+		island.Solve(&profile, *ctx->step, ctx->gravity, ctx->allowSleep);
+		task->profile.solveInit += profile.solveInit;
+		task->profile.solveVelocity += profile.solveVelocity;
+		task->profile.solvePosition += profile.solvePosition;
+	}
+}
+
 void b2World::Solve(const b2TimeStep& step)
 {
 	m_profile.solveInit = 0.0f;
@@ -414,6 +929,25 @@ void b2World::Solve(const b2TimeStep& step)
 	// Build and simulate all awake islands.
 	int32 stackSize = m_bodyCount;
 	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+
+	// Defold mod: Islands that can be solved concurrently are deferred until all islands are built.
+	// Static bodies can be part of several islands, so the body entries are bounded by contacts and joints as well.
+	bool parallel = m_taskCount > 1;
+	int32 deferredIslandCount = 0;
+	int32 deferredBodyCount = 0;
+	int32 deferredContactCount = 0;
+	int32 deferredJointCount = 0;
+	b2DeferredIsland* deferredIslands = NULL;
+	b2Body** deferredBodies = NULL;
+	b2Contact** deferredContacts = NULL;
+	b2Joint** deferredJoints = NULL;
+	if (parallel)
+	{
+		deferredIslands = (b2DeferredIsland*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2DeferredIsland));
+		deferredBodies = (b2Body**)m_stackAllocator.Allocate((m_bodyCount + m_contactManager.m_contactCount + m_jointCount) * sizeof(b2Body*));
+		deferredContacts = (b2Contact**)m_stackAllocator.Allocate(m_contactManager.m_contactCount * sizeof(b2Contact*));
+		deferredJoints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+	}
 	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
 	{
 		if (seed->m_flags & b2Body::e_islandFlag)
@@ -528,11 +1062,44 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+		// Defold mod
+		island.StoreContactIndices();
+
+		// Joints read the island indices from static bodies, which might be part of other islands
+		bool deferIsland = parallel;
+		for (int32 i = 0; deferIsland && i < island.m_jointCount; ++i)
+		{
+			b2Joint* j = island.m_joints[i];
+			if (j->m_type == e_gearJoint || j->m_bodyA->m_type == b2_staticBody || j->m_bodyB->m_type == b2_staticBody)
+			{
+				deferIsland = false;
+			}
+		}
+
+		if (deferIsland)
+		{
+			b2DeferredIsland* di = deferredIslands + deferredIslandCount++;
+			di->bodyIndex = deferredBodyCount;
+			di->bodyCount = island.m_bodyCount;
+			di->contactIndex = deferredContactCount;
+			di->contactCount = island.m_contactCount;
+			di->jointIndex = deferredJointCount;
+			di->jointCount = island.m_jointCount;
+			memcpy(deferredBodies + deferredBodyCount, island.m_bodies, island.m_bodyCount * sizeof(b2Body*));
+			memcpy(deferredContacts + deferredContactCount, island.m_contacts, island.m_contactCount * sizeof(b2Contact*));
+			memcpy(deferredJoints + deferredJointCount, island.m_joints, island.m_jointCount * sizeof(b2Joint*));
+			deferredBodyCount += island.m_bodyCount;
+			deferredContactCount += island.m_contactCount;
+			deferredJointCount += island.m_jointCount;
+		}
+		else
+		{
+			b2Profile profile;
+			island.Solve(&profile, step, m_gravity, m_allowSleep);
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
+		}
 
 		// Post solve cleanup.
 		for (int32 i = 0; i < island.m_bodyCount; ++i)
@@ -546,6 +1113,20 @@ void b2World::Solve(const b2TimeStep& step)
 		}
 	}
 
+	// Defold mod
+	if (parallel)
+	{
+		if (deferredIslandCount > 0)
+		{
+			SolveDeferredIslands(step, deferredIslands, deferredIslandCount, deferredBodies, deferredContacts, deferredJoints);
+		}
+
+		m_stackAllocator.Free(deferredJoints);
+		m_stackAllocator.Free(deferredContacts);
+		m_stackAllocator.Free(deferredBodies);
+		m_stackAllocator.Free(deferredIslands);
+	}
+
 	m_stackAllocator.Free(stack);
 
 	{
@@ -574,6 +1155,89 @@ void b2World::Solve(const b2TimeStep& step)
 	}
 }
 
+void b2World::SolveDeferredIslands(const b2TimeStep& step, const b2DeferredIsland* islands, int32 islandCount,
+									b2Body** bodies, b2Contact** contacts, b2Joint** joints)
+{
+	// Split the islands in ranges of roughly the same amount of work, one per thread
+	int32 taskCount = b2Min(m_taskCount, islandCount);
+	int32 totalWork = 0;
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		totalWork += islands[i].bodyCount + islands[i].contactCount;
+	}
+
+	b2IslandTask* tasks = (b2IslandTask*)m_stackAllocator.Allocate(taskCount * sizeof(b2IslandTask));
+	int32 islandIndex = 0;
+	int32 work = 0;
+	for (int32 t = 0; t < taskCount; ++t)
+	{
+		b2IslandTask* task = tasks + t;
+		task->allocator = t == 0 ? &m_stackAllocator : m_taskAllocators + t - 1;
+		task->islandIndex = islandIndex;
+		memset(&task->profile, 0, sizeof(b2Profile));
+
+		// Leave at least one island for each remaining task
+		int32 targetWork = totalWork * (t + 1) / taskCount;
+		int32 maxIndex = islandCount - (taskCount - t - 1);
+		do
+		{
+			work += islands[islandIndex].bodyCount + islands[islandIndex].contactCount;
+			++islandIndex;
+		}
+		while (islandIndex < maxIndex && (work < targetWork || t == taskCount - 1));
+		task->islandCount = islandIndex - task->islandIndex;
+	}
+
+	b2IslandTaskContext ctx;
+	ctx.step = &step;
+	ctx.gravity = m_gravity;
+	ctx.allowSleep = m_allowSleep;
+	ctx.islands = islands;
+	ctx.bodies = bodies;
+	ctx.contacts = contacts;
+	ctx.joints = joints;
+	ctx.tasks = tasks;
+	if (taskCount > 1)
+	{
+		m_parallelFor->Run(b2SolveIslandTask, &ctx, taskCount);
+	}
+	else
+	{
+		b2SolveIslandTask(&ctx, 0);
+	}
+
+	for (int32 t = 0; t < taskCount; ++t)
+	{
+		m_profile.solveInit += tasks[t].profile.solveInit;
+		m_profile.solveVelocity += tasks[t].profile.solveVelocity;
+		m_profile.solvePosition += tasks[t].profile.solvePosition;
+	}
+	m_stackAllocator.Free(tasks);
+
+	// Report the contacts in island order, the impulses were stored in the manifolds by the solver
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	if (listener)
+	{
+		for (int32 i = 0; i < islandCount; ++i)
+		{
+			const b2DeferredIsland* di = islands + i;
+			for (int32 j = 0; j < di->contactCount; ++j)
+			{
+				b2Contact* c = contacts[di->contactIndex + j];
+				const b2Manifold* manifold = c->GetManifold();
+				b2ContactImpulse impulse;
+				impulse.count = manifold->pointCount;
+				for (int32 k = 0; k < manifold->pointCount; ++k)
+				{
+					impulse.normalImpulses[k] = manifold->points[k].normalImpulse;
+					impulse.tangentImpulses[k] = manifold->points[k].tangentImpulse;
+				}
+				listener->PostSolve(c, &impulse);
+			}
+		}
+	}
+}
+
 // Find TOI contacts and solve them.
 void b2World::SolveTOI(const b2TimeStep& step)
 {
@@ -861,6 +1525,7 @@ void b2World::SolveTOI(const b2TimeStep& step)
 		subStep.positionIterations = 20;
 		subStep.velocityIterations = step.velocityIterations;
 		subStep.warmStarting = false;
+		island.StoreContactIndices();
 		island.SolveTOI(subStep, bA->m_islandIndex, bB->m_islandIndex);
 
 		// Reset island flags and synchronize broad-phase proxies.
@@ -1006,6 +1671,13 @@ struct b2WorldRayCastWrapper
 		b2FixtureProxy* proxy = (b2FixtureProxy*)userData;
 		b2Fixture* fixture = proxy->fixture;
 		int32 index = proxy->childIndex;
+
+		// Defold modification. A grid proxy covers a chunk of cells, cast against each cell along the ray
+		if (fixture->GetType() == b2Shape::e_grid)
+		{
+			return RayCastGridChunk(input, fixture, index);
+		}
+
 		b2RayCastOutput output;
 		bool hit = fixture->RayCast(&output, input, index);
 
@@ -1019,6 +1691,38 @@ struct b2WorldRayCastWrapper
 		return input.maxFraction;
 	}
 
+	float32 RayCastGridChunk(const b2RayCastInput& input, b2Fixture* fixture, int32 chunkIndex)
+	{
+		const b2GridShape* grid = (const b2GridShape*)fixture->GetShape();
+		b2Vec2 end = input.p1 + input.maxFraction * (input.p2 - input.p1);
+		b2AABB rayAABB;
+		rayAABB.lowerBound = b2Min(input.p1, end);
+		rayAABB.upperBound = b2Max(input.p1, end);
+		uint32 cells[B2GRIDSHAPE_CHUNK_CELL_COUNT];
+		uint32 cellCount = grid->GetChunkCells(chunkIndex, rayAABB, fixture->GetBody()->GetTransform(), cells);
+
+		b2RayCastInput cellInput = input;
+		for (uint32 i = 0; i < cellCount; ++i)
+		{
+			b2RayCastOutput output;
+			if (fixture->RayCast(&output, cellInput, cells[i]))
+			{
+				float32 fraction = output.fraction;
+				b2Vec2 point = (1.0f - fraction) * input.p1 + fraction * input.p2;
+				float32 value = callback->ReportFixture(fixture, cells[i], point, output.normal, fraction);
+				if (value == 0.0f)
+				{
+					return 0.0f;
+				}
+				if (value > 0.0f)
+				{
+					cellInput.maxFraction = value;
+				}
+			}
+		}
+		return cellInput.maxFraction;
+	}
+
 	const b2BroadPhase* broadPhase;
 	b2RayCastCallback* callback;
 };
@@ -34,6 +34,7 @@ class b2Body;
 class b2Draw;
 class b2Fixture;
 class b2Joint;
+struct b2DeferredIsland;
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -204,6 +205,42 @@ public:
 	/// @warning this should be called outside of a time step.
 	void Dump();
 
+    /* The following functions are added by defold */
+
+    /// Get the list of bodies woken up since they were last removed with RemoveAwakeBody.
+    /// Bodies stay in the list when they fall asleep, so that their final transform can be
+    /// read after the step. Use b2Body::GetNextAwake to get the next body in the list.
+    b2Body* GetAwakeBodyList();
+
+    /// Remove a body from the awake list, it is added again when woken up or activated.
+    void RemoveAwakeBody(b2Body* body);
+
+    /// Get the list of kinematic bodies. The list is kept up to date when bodies are created,
+    /// destroyed or change type. Use b2Body::GetNextKinematic to get the next body in the list.
+    b2Body* GetKinematicBodyList();
+
+    /// Solve independent islands on several threads. Each island is solved by a single thread,
+    /// giving the same result as when solved on the calling thread. Islands with joints attached
+    /// to static bodies are always solved on the calling thread.
+    /// The object is owned by you and must remain in scope. Pass NULL to disable.
+    void SetParallelFor(b2ParallelFor* parallelFor);
+
+    /// Get the size in bytes of a snapshot of the simulation state, see SaveState.
+    int32 GetStateSize() const;
+
+    /// Save the simulation state to a buffer of GetStateSize() bytes. This is the motion and
+    /// sleep state of the bodies, the broad-phase AABBs, the contacts and the joint impulses.
+    /// Shapes, fixtures, joints and body settings are not saved.
+    /// @warning this should be called outside of a time step.
+    void SaveState(void* buffer) const;
+
+    /// Restore a state saved by SaveState, after which stepping the world gives the same result
+    /// as it did after the state was saved. No contact callbacks are called. The world must have
+    /// the same bodies, fixtures and joints as when the state was saved. Returns false, leaving
+    /// the world unchanged, if the state doesn't match the world.
+    /// @warning this should be called outside of a time step.
+    bool RestoreState(const void* buffer, int32 size);
+
 private:
 
 	// m_flags
@@ -220,6 +257,9 @@ private:
 	friend class b2Controller;
 
 	void Solve(const b2TimeStep& step);
+	// Defold mod: Solve islands deferred by Solve on several threads
+	void SolveDeferredIslands(const b2TimeStep& step, const b2DeferredIsland* islands, int32 islandCount,
+							  b2Body** bodies, b2Contact** contacts, b2Joint** joints);
 	void SolveTOI(const b2TimeStep& step);
 
 	void DrawJoint(b2Joint* joint);
@@ -236,6 +276,19 @@ private:
 	b2Body* m_bodyList;
 	b2Joint* m_jointList;
 
+    // Defold mod: Bodies woken up since last removed, see GetAwakeBodyList
+    b2Body* m_awakeBodyList;
+
+    // Defold mod: All kinematic bodies, see GetKinematicBodyList
+    b2Body* m_kinematicBodyList;
+    void AddKinematicBody(b2Body* b);
+    void RemoveKinematicBody(b2Body* b);
+
+    // Defold mod: See SetParallelFor. Task 0 uses m_stackAllocator, the following tasks use m_taskAllocators.
+    b2ParallelFor* m_parallelFor;
+    b2StackAllocator* m_taskAllocators;
+    int32 m_taskCount;
+
 	int32 m_bodyCount;
 	int32 m_jointCount;
 
@@ -347,4 +400,14 @@ inline const b2Profile& b2World::GetProfile() const
 	return m_profile;
 }
 
+inline b2Body* b2World::GetAwakeBodyList()
+{
+    return m_awakeBodyList;
+}
+
+inline b2Body* b2World::GetKinematicBodyList()
+{
+    return m_kinematicBodyList;
+}
+
 #endif
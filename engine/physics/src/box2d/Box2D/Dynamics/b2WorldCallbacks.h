@@ -152,4 +152,20 @@ public:
 									const b2Vec2& normal, float32 fraction) = 0;
 };
 
+/// Defold mod: Runs tasks on several threads, used to solve independent islands concurrently.
+/// See b2World::SetParallelFor
+class b2ParallelFor
+{
+public:
+	typedef void (*TaskFn)(void* context, int32 index);
+
+	virtual ~b2ParallelFor() {}
+
+	/// Max number of tasks that run at the same time.
+	virtual int32 GetThreadCount() = 0;
+
+	/// Call task(context, index) for every index in [0, count) and return once all calls have completed.
+	virtual void Run(TaskFn task, void* context, int32 count) = 0;
+};
+
 #endif
@@ -55,6 +55,15 @@ namespace dmPhysics
         RESULT_UNKNOWN_ERROR = 5,
     };
 
+    /// Broadphase algorithm used by a 3D world.
+    enum BroadphaseType
+    {
+        /// Sweep and prune within the fixed world AABB, limited to NewWorldParams::m_MaxBroadphaseProxies objects
+        BROADPHASE_TYPE_AXIS_SWEEP = 0,
+        /// Dynamic AABB trees, unbounded in world size and object count
+        BROADPHASE_TYPE_DBVT = 1,
+    };
+
     /// 3D context handle.
     typedef struct Context3D* HContext3D;
     /// 3D world handle.
@@ -85,6 +94,12 @@ namespace dmPhysics
     static const float MIN_SCALE = 0.01f;
     static const float MAX_SCALE = 1.0f;
 
+    /// Max number of solver worker threads, see NewContextParams::m_SolverThreadCount
+    static const uint32_t MAX_SOLVER_THREAD_COUNT = 16;
+
+    /// Max number of proxies in an axis sweep broadphase, see NewWorldParams::m_MaxBroadphaseProxies
+    static const uint32_t MAX_BROADPHASE_PROXIES = 1 << 18;
+
     /**
      * HullDesc structure
      */
@@ -239,6 +254,12 @@ namespace dmPhysics
         uint32_t m_RayCastLimit3D;
         /// Maximum number of overlapping triggers
         uint32_t m_TriggerOverlapCapacity;
+        /// Number of velocity iterations of the constraint solver for each step (solver iterations in 3D)
+        uint32_t m_VelocityIterations;
+        /// Number of position iterations of the constraint solver for each step (2D only)
+        uint32_t m_PositionIterations;
+        /// Number of worker threads solving independent islands concurrently, 0 to solve them on the stepping thread (2D only). Must be at most MAX_SOLVER_THREAD_COUNT
+        uint32_t m_SolverThreadCount;
         /// If true, the collision objects will retrieve the position of its game object
         uint8_t m_AllowDynamicTransforms:1;
         uint8_t :7;
@@ -286,6 +307,12 @@ namespace dmPhysics
      */
     dmMessage::HSocket GetSocket2D(HContext2D context);
 
+    /**
+     * Get the number of worker threads solving islands in a 2D context, see NewContextParams::m_SolverThreadCount.
+     * @return number of solver threads
+     */
+    uint32_t GetSolverThreadCount2D(HContext2D context);
+
     /**
      * Parameters to use when creating a world.
      */
@@ -301,6 +328,10 @@ namespace dmPhysics
         GetWorldTransformCallback m_GetWorldTransformCallback;
         /// param set_world_transform Callback for copying the transform from the collision object to the corresponding user data
         SetWorldTransformCallback m_SetWorldTransformCallback;
+        /// Broadphase algorithm (3D only)
+        BroadphaseType m_Broadphase;
+        /// Max number of collision objects in an axis sweep broadphase (3D only). Must be in the range 2 - MAX_BROADPHASE_PROXIES
+        uint32_t m_MaxBroadphaseProxies;
     };
 
     /**
@@ -364,6 +395,12 @@ namespace dmPhysics
         TriggerExitedCallback   m_TriggerExitedCallback;
         /// Trigger exited callback
         void*                   m_TriggerExitedUserData;
+        /// If set, the world is stepped exactly once by m_DT, as one step of a fixed update driven by the caller.
+        /// The transforms before the step are kept, see InterpolateTransforms2D and InterpolateTransforms3D
+        uint8_t                 m_FixedTimeStep:1;
+        /// If set, the debug data is not drawn. Used when the world is stepped more than once per frame, see DrawDebug2D and DrawDebug3D
+        uint8_t                 m_SkipDebugDraw:1;
+        uint8_t                 :6;
     };
 
     /**
@@ -371,16 +408,85 @@ namespace dmPhysics
      *
      * @param world Physics world
      * @param context Function parameter struct
+     * @return number of simulation steps taken
      */
-    void StepWorld3D(HWorld3D world, const StepWorldContext& context);
+    uint32_t StepWorld3D(HWorld3D world, const StepWorldContext& context);
 
     /**
      * Simulate 2D physics
      *
      * @param world Physics world
      * @param context Function parameter struct
+     * @return number of simulation steps taken
+     */
+    uint32_t StepWorld2D(HWorld2D world, const StepWorldContext& context);
+
+    /**
+     * Pass the transforms of the moving dynamic objects to the set world transform callback, interpolated
+     * between the last two steps. Used when the world is stepped once per fixed step, to move the objects
+     * smoothly between the steps.
+     *
+     * @param world Physics world, stepped with StepWorldContext::m_FixedTimeStep set
+     * @param alpha Fraction [0, 1] of the fixed time step elapsed since the last step. The transform before
+     *              the last step is passed at 0 and the one after it at 1.
+     */
+    void InterpolateTransforms3D(HWorld3D world, float alpha);
+
+    /**
+     * Pass the transforms of the moving dynamic objects to the set world transform callback, interpolated
+     * between the last two steps. Used when the world is stepped once per fixed step, to move the objects
+     * smoothly between the steps.
+     *
+     * @param world Physics world, stepped with StepWorldContext::m_FixedTimeStep set
+     * @param alpha Fraction [0, 1] of the fixed time step elapsed since the last step. The transform before
+     *              the last step is passed at 0 and the one after it at 1.
+     */
+    void InterpolateTransforms2D(HWorld2D world, float alpha);
+
+    /**
+     * Save the simulation state of a 3D world, to be restored with RestoreWorldSnapshot3D.
+     * The snapshot holds the motion and activation state of the collision objects and the contact
+     * points used for warm starting, but no shapes or object settings. The buffer is resized to
+     * fit and reused between calls, so saving doesn't allocate once it is large enough.
+     *
+     * @param world Physics world
+     * @param snapshot Buffer receiving the snapshot
+     */
+    void SaveWorldSnapshot3D(HWorld3D world, dmArray<uint8_t>& snapshot);
+
+    /**
+     * Restore a snapshot saved by SaveWorldSnapshot3D. Bullet creates and removes contact
+     * manifolds as the broadphase pairs change, so stepping after the restore repeats the
+     * steps after the save exactly only if the same pairs overlapped at both points.
+     *
+     * @param world Physics world
+     * @param snapshot Snapshot of the same world
+     * @return false if collision objects were created or deleted after the snapshot was saved, the world is then unchanged
+     */
+    bool RestoreWorldSnapshot3D(HWorld3D world, const dmArray<uint8_t>& snapshot);
+
+    /**
+     * Save the simulation state of a 2D world, to be restored with RestoreWorldSnapshot2D.
+     * The snapshot holds the motion and sleep state of the collision objects, the contacts,
+     * the joint impulses and the fixed time step accumulator, but no shapes or object settings.
+     * The buffer is resized to fit and reused between calls, so saving doesn't allocate once
+     * it is large enough.
+     *
+     * @param world Physics world
+     * @param snapshot Buffer receiving the snapshot
+     */
+    void SaveWorldSnapshot2D(HWorld2D world, dmArray<uint8_t>& snapshot);
+
+    /**
+     * Restore a snapshot saved by SaveWorldSnapshot2D. Stepping the world after the restore
+     * gives the same result as stepping it after the save. No contact callbacks are called by
+     * the restore itself and the trigger overlaps are kept.
+     *
+     * @param world Physics world
+     * @param snapshot Snapshot of the same world
+     * @return false if collision objects, shapes or joints were created or deleted after the snapshot was saved, the world is then unchanged
      */
-    void StepWorld2D(HWorld2D world, const StepWorldContext& context);
+    bool RestoreWorldSnapshot2D(HWorld2D world, const dmArray<uint8_t>& snapshot);
 
     /**
      * Enable/disable debug-draw
@@ -396,6 +502,18 @@ namespace dmPhysics
      */
     void SetDrawDebug2D(HWorld2D world, bool draw_debug);
 
+    /**
+     * Draw the debug data of the world, if enabled. Done by StepWorld3D unless StepWorldContext::m_SkipDebugDraw is set.
+     * @param world Physics world
+     */
+    void DrawDebug3D(HWorld3D world);
+
+    /**
+     * Draw the debug data of the world, if enabled. Done by StepWorld2D unless StepWorldContext::m_SkipDebugDraw is set.
+     * @param world Physics world
+     */
+    void DrawDebug2D(HWorld2D world);
+
     /**
      * Create a new 3D sphere shape.
      *
@@ -1078,6 +1196,139 @@ namespace dmPhysics
      */
     void RayCast2D(HWorld2D world, const RayCastRequest& request, dmArray<RayCastResponse>& results);
 
+    /**
+     * Perform a batch of synchronous ray casts, reporting the closest hit of each ray.
+     * Zero-length rays and m_ReturnAllResults are not supported and report no hit.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Array of requests
+     * @param count Number of requests
+     * @param responses Array of count responses, the response at index i belongs to the request at index i
+     */
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses);
+
+    /**
+     * Perform a batch of synchronous ray casts, reporting the closest hit of each ray.
+     * Zero-length rays and m_ReturnAllResults are not supported and report no hit.
+     * The rays are spread across the solver threads when NewContextParams::m_SolverThreadCount is set.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Array of requests
+     * @param count Number of requests
+     * @param responses Array of count responses, the response at index i belongs to the request at index i
+     */
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses);
+
+    /**
+     * Shape used by overlap queries and shape casts.
+     */
+    struct QueryShape
+    {
+        enum Type
+        {
+            TYPE_SPHERE = 0,
+            TYPE_BOX    = 1,
+        };
+
+        QueryShape();
+
+        /// Half extents of the box. The z component is ignored in 2D
+        Vectormath::Aos::Vector3 m_HalfExtents;
+        /// Radius of the sphere, a circle in 2D
+        float m_Radius;
+        /// Shape type
+        Type m_Type;
+    };
+
+    /**
+     * Container of data for overlap queries.
+     */
+    struct OverlapRequest
+    {
+        OverlapRequest();
+
+        /// Shape to test for overlaps
+        QueryShape m_Shape;
+        /// Center of the shape, the shape is axis aligned
+        Vectormath::Aos::Point3 m_Position;
+        /// All collision objects with this user data will be ignored
+        void* m_IgnoredUserData;
+        /// Bit field to filter out collision objects of the corresponding groups
+        uint16_t m_Mask;
+    };
+
+    /**
+     * Container of data for overlap results.
+     */
+    struct OverlapResponse
+    {
+        /// User specified data for the overlapping object
+        void* m_CollisionObjectUserData;
+        /// Group of the overlapping object
+        uint16_t m_CollisionObjectGroup;
+    };
+
+    /**
+     * Find all collision objects overlapping a shape. Triggers are ignored and every object is reported once.
+     *
+     * @param world Physics world in which to perform the query
+     * @param request Struct containing data for the query
+     * @param results Array receiving the overlapping objects
+     * @note The result array may grow during the call
+     */
+    void QueryOverlap3D(HWorld3D world, const OverlapRequest& request, dmArray<OverlapResponse>& results);
+
+    /**
+     * Find all collision objects overlapping a shape. Triggers are ignored and every object is reported once.
+     *
+     * @param world Physics world in which to perform the query
+     * @param request Struct containing data for the query
+     * @param results Array receiving the overlapping objects
+     * @note The result array may grow during the call
+     */
+    void QueryOverlap2D(HWorld2D world, const OverlapRequest& request, dmArray<OverlapResponse>& results);
+
+    /**
+     * Container of data for shape cast queries.
+     */
+    struct ShapeCastRequest
+    {
+        ShapeCastRequest();
+
+        /// Shape to sweep, axis aligned
+        QueryShape m_Shape;
+        /// Start position of the shape center
+        Vectormath::Aos::Point3 m_From;
+        /// End position of the shape center
+        Vectormath::Aos::Point3 m_To;
+        /// All collision objects with this user data will be ignored
+        void* m_IgnoredUserData;
+        /// Bit field to filter out collision objects of the corresponding groups
+        uint16_t m_Mask;
+    };
+
+    /**
+     * Sweep a shape through the world and report the first hit. Triggers are ignored.
+     * m_Fraction of the response is the fraction of the sweep where the shape first touches,
+     * m_Position the contact point and m_Normal the surface normal of the hit object.
+     *
+     * @param world Physics world in which to perform the query
+     * @param request Struct containing data for the query
+     * @param response Response receiving the closest hit, m_Hit is 0 if nothing was hit
+     */
+    void ShapeCast3D(HWorld3D world, const ShapeCastRequest& request, RayCastResponse& response);
+
+    /**
+     * Sweep a shape through the world and report the first hit. Triggers are ignored.
+     * m_Fraction of the response is the fraction of the sweep where the shape first touches,
+     * m_Position the contact point and m_Normal the surface normal of the hit object.
+     *
+     * @param world Physics world in which to perform the query
+     * @param request Struct containing data for the query
+     * @param response Response receiving the closest hit, m_Hit is 0 if nothing was hit
+     */
+    void ShapeCast2D(HWorld2D world, const ShapeCastRequest& request, RayCastResponse& response);
+
     /**
      * Set the gravity for a 2D physics world.
      *
@@ -32,12 +32,15 @@ namespace dmPhysics
     , m_DebugCallbacks()
     , m_Gravity(0.0f, -10.0f)
     , m_Socket(0)
+    , m_JobThread(0)
     , m_Scale(1.0f)
     , m_InvScale(1.0f)
     , m_ContactImpulseLimit(0.0f)
     , m_TriggerEnterLimit(0.0f)
     , m_RayCastLimit(0)
     , m_TriggerOverlapCapacity(0)
+    , m_VelocityIterations(10)
+    , m_PositionIterations(10)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -50,12 +53,18 @@ namespace dmPhysics
     , m_RayCastRequests()
     , m_DebugDraw(&context->m_DebugCallbacks)
     , m_ContactListener(this)
+    , m_IslandParallelFor(context->m_JobThread)
     , m_GetWorldTransformCallback(params.m_GetWorldTransformCallback)
     , m_SetWorldTransformCallback(params.m_SetWorldTransformCallback)
+    , m_InterpolationAlpha(1.0f)
     , m_AllowDynamicTransforms(context->m_AllowDynamicTransforms)
     {
     	m_RayCastRequests.SetCapacity(context->m_RayCastLimit);
         OverlapCacheInit(&m_TriggerOverlaps);
+        if (context->m_JobThread)
+        {
+            m_World.SetParallelFor(&m_IslandParallelFor);
+        }
     }
 
     class ProcessRayCastResultCallback2D : public b2RayCastCallback
@@ -199,6 +208,38 @@ namespace dmPhysics
         m_TempStepWorldContext = context;
     }
 
+    IslandParallelFor::IslandParallelFor(dmJobThread::HContext job_thread)
+    : m_JobThread(job_thread)
+    {
+
+    }
+
+    int32 IslandParallelFor::GetThreadCount()
+    {
+        // The stepping thread takes part in the work
+        return (int32) dmJobThread::GetWorkerCount(m_JobThread) + 1;
+    }
+
+    struct IslandTaskContext
+    {
+        b2ParallelFor::TaskFn   m_Task;
+        void*                   m_Context;
+    };
+
+    static void ProcessIslandTask(void* context, uint32_t index)
+    {
+        IslandTaskContext* task_context = (IslandTaskContext*) context;
+        task_context->m_Task(task_context->m_Context, (int32) index);
+    }
+
+    void IslandParallelFor::Run(TaskFn task, void* context, int32 count)
+    {
+        IslandTaskContext task_context;
+        task_context.m_Task = task;
+        task_context.m_Context = context;
+        dmJobThread::ParallelFor(m_JobThread, ProcessIslandTask, &task_context, (uint32_t) count);
+    }
+
     HContext2D NewContext2D(const NewContextParams& params)
     {
         if (params.m_Scale < MIN_SCALE || params.m_Scale > MAX_SCALE)
@@ -215,7 +256,14 @@ namespace dmPhysics
         context->m_TriggerEnterLimit = params.m_TriggerEnterLimit * params.m_Scale;
         context->m_RayCastLimit = params.m_RayCastLimit2D;
         context->m_TriggerOverlapCapacity = params.m_TriggerOverlapCapacity;
+        context->m_VelocityIterations = (int) params.m_VelocityIterations;
+        context->m_PositionIterations = (int) params.m_PositionIterations;
         context->m_AllowDynamicTransforms = params.m_AllowDynamicTransforms;
+        assert(params.m_SolverThreadCount <= MAX_SOLVER_THREAD_COUNT);
+        if (params.m_SolverThreadCount > 0)
+        {
+            context->m_JobThread = dmJobThread::Create(params.m_SolverThreadCount, "physics2d");
+        }
         dmMessage::Result result = dmMessage::NewSocket(PHYSICS_SOCKET_NAME, &context->m_Socket);
         if (result != dmMessage::RESULT_OK)
         {
@@ -236,6 +284,8 @@ namespace dmPhysics
         }
         if (context->m_Socket != 0)
             dmMessage::DeleteSocket(context->m_Socket);
+        if (context->m_JobThread != 0)
+            dmJobThread::Destroy(context->m_JobThread);
         delete context;
     }
 
@@ -244,6 +294,11 @@ namespace dmPhysics
         return context->m_Socket;
     }
 
+    uint32_t GetSolverThreadCount2D(HContext2D context)
+    {
+        return dmJobThread::GetWorkerCount(context->m_JobThread);
+    }
+
     HWorld2D NewWorld2D(HContext2D context, const NewWorldParams& params)
     {
         if (context->m_Worlds.Full())
@@ -379,9 +434,57 @@ namespace dmPhysics
         }
     }
 
-    void StepWorld2D(HWorld2D world, const StepWorldContext& step_context)
+    // The origin and angle of the body interpolated between the last two steps
+    static void GetInterpolatedTransform(const b2Body* body, float alpha, b2Vec2& position, float& angle)
+    {
+        const b2Vec2& prev_position = body->GetPreviousPosition();
+        float prev_angle = body->GetPreviousAngle();
+        position = prev_position + alpha * (body->GetPosition() - prev_position);
+        angle = prev_angle + alpha * (body->GetAngle() - prev_angle);
+    }
+
+    /// Move the body to the transform of its game object, if the game object has been moved
+    static void UpdateBodyTransform(HWorld2D world, b2Body* body, float last_alpha, float pos_epsilon, float rot_epsilon)
+    {
+        HContext2D context = world->m_Context;
+        // Compare against the transform the game object was given, which is interpolated for dynamic bodies
+        b2Vec2 old_b2_position = body->GetPosition();
+        float old_angle = body->GetAngle();
+        if (last_alpha < 1.0f && body->GetType() == b2_dynamicBody)
+        {
+            GetInterpolatedTransform(body, last_alpha, old_b2_position, old_angle);
+        }
+        Vectormath::Aos::Point3 old_position;
+        FromB2(old_b2_position, old_position, context->m_InvScale);
+        dmTransform::Transform world_transform;
+        (*world->m_GetWorldTransformCallback)(body->GetUserData(), world_transform);
+        Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
+        // Ignore z-component
+        position.setZ(0.0f);
+        Vectormath::Aos::Quat rotation = world_transform.GetRotation();
+        float dp = distSqr(old_position, position);
+        float angle = atan2(2.0f * (rotation.getW() * rotation.getZ() + rotation.getX() * rotation.getY()), 1.0f - 2.0f * (rotation.getY() * rotation.getY() + rotation.getZ() * rotation.getZ()));
+        float da = old_angle - angle;
+
+        if (dp > pos_epsilon || fabsf(da) > rot_epsilon)
+        {
+            b2Vec2 b2_position;
+            ToB2(position, b2_position, context->m_Scale);
+            body->SetTransform(b2_position, angle);
+            body->SetSleepingAllowed(false);
+        }
+        else
+        {
+            body->SetSleepingAllowed(true);
+        }
+    }
+
+    uint32_t StepWorld2D(HWorld2D world, const StepWorldContext& step_context)
     {
         float dt = step_context.m_DT;
+        // Interpolation factor of the transforms passed to the game objects the previous step
+        float last_alpha = world->m_InterpolationAlpha;
+
         HContext2D context = world->m_Context;
         float scale = context->m_Scale;
         // Epsilon defining what transforms are considered noise and not
@@ -392,62 +495,67 @@ namespace dmPhysics
         if (world->m_GetWorldTransformCallback)
         {
             DM_PROFILE(Physics, "UpdateKinematic");
-            for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
+            if (world->m_AllowDynamicTransforms)
             {
-                bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && body->GetType() != b2_staticBody;
-
-                // translate & rotation
-                if (retrieve_gameworld_transform || body->GetType() == b2_kinematicBody)
+                // Sleeping dynamic bodies might also have been moved through their game objects
+                for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
                 {
-                    Vectormath::Aos::Point3 old_position = GetWorldPosition2D(context, body);
-                    dmTransform::Transform world_transform;
-                    (*world->m_GetWorldTransformCallback)(body->GetUserData(), world_transform);
-                    Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
-                    // Ignore z-component
-                    position.setZ(0.0f);
-                    Vectormath::Aos::Quat rotation = world_transform.GetRotation();
-                    float dp = distSqr(old_position, position);
-                    float angle = atan2(2.0f * (rotation.getW() * rotation.getZ() + rotation.getX() * rotation.getY()), 1.0f - 2.0f * (rotation.getY() * rotation.getY() + rotation.getZ() * rotation.getZ()));
-                    float old_angle = body->GetAngle();
-                    float da = old_angle - angle;
-
-                    if (dp > POS_EPSILON || fabsf(da) > ROT_EPSILON)
+                    if (body->GetType() != b2_staticBody)
                     {
-                        b2Vec2 b2_position;
-                        ToB2(position, b2_position, scale);
-                        body->SetTransform(b2_position, angle);
-                        body->SetSleepingAllowed(false);
-                    }
-                    else
-                    {
-                        body->SetSleepingAllowed(true);
+                        UpdateBodyTransform(world, body, last_alpha, POS_EPSILON, ROT_EPSILON);
+                        UpdateScale(world, body);
                     }
                 }
-
-                // Scaling
-                if(retrieve_gameworld_transform)
+            }
+            else
+            {
+                // Box2D keeps the list up to date when bodies change type
+                for (b2Body* body = world->m_World.GetKinematicBodyList(); body; body = body->GetNextKinematic())
                 {
-                    UpdateScale(world, body);
+                    UpdateBodyTransform(world, body, last_alpha, POS_EPSILON, ROT_EPSILON);
                 }
             }
         }
         {
             DM_PROFILE(Physics, "StepSimulation");
             world->m_ContactListener.SetStepWorldContext(&step_context);
-            world->m_World.Step(dt, 10, 10);
+            if (step_context.m_FixedTimeStep)
+            {
+                // Bodies not in the awake list are at rest and already have their previous transform stored
+                for (b2Body* body = world->m_World.GetAwakeBodyList(); body; body = body->GetNextAwake())
+                {
+                    body->StorePreviousTransform();
+                }
+            }
+            world->m_World.Step(dt, context->m_VelocityIterations, context->m_PositionIterations);
+            // The game objects are given the transforms after the step, see InterpolateTransforms2D
+            world->m_InterpolationAlpha = 1.0f;
+
             float inv_scale = world->m_Context->m_InvScale;
             // Update transforms of dynamic bodies
-            if (world->m_SetWorldTransformCallback)
+            // Only bodies woken up since the last update can have moved, the ones that have fallen
+            // asleep are given their final transform and then removed from the awake list
             {
-                for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
+                DM_PROFILE(Physics, "UpdateDynamic");
+                b2Body* body = world->m_World.GetAwakeBodyList();
+                while (body)
                 {
-                    if (body->GetType() == b2_dynamicBody && body->IsActive())
+                    b2Body* next = body->GetNextAwake();
+                    bool dynamic = body->GetType() == b2_dynamicBody && body->IsActive();
+                    bool awake = body->IsAwake();
+                    if (dynamic && world->m_SetWorldTransformCallback)
                     {
                         Vectormath::Aos::Point3 position;
                         FromB2(body->GetPosition(), position, inv_scale);
                         Vectormath::Aos::Quat rotation = Vectormath::Aos::Quat::rotationZ(body->GetAngle());
                         (*world->m_SetWorldTransformCallback)(body->GetUserData(), position, rotation);
                     }
+                    if (!dynamic || !awake)
+                    {
+                        body->StorePreviousTransform();
+                        world->m_World.RemoveAwakeBody(body);
+                    }
+                    body = next;
                 }
             }
         }
@@ -495,7 +603,36 @@ namespace dmPhysics
         }
         UpdateOverlapCache(&world->m_TriggerOverlaps, context, world->m_World.GetContactList(), step_context);
 
-        world->m_World.DrawDebugData();
+        if (!step_context.m_SkipDebugDraw)
+        {
+            world->m_World.DrawDebugData();
+        }
+
+        return 1;
+    }
+
+    void InterpolateTransforms2D(HWorld2D world, float alpha)
+    {
+        DM_PROFILE(Physics, "InterpolateTransforms");
+        // Compared against when the game objects are read back before the next step
+        world->m_InterpolationAlpha = alpha;
+        if (!world->m_SetWorldTransformCallback)
+            return;
+        float inv_scale = world->m_Context->m_InvScale;
+        // Bodies that fell asleep have already been given their final transform and left the awake list
+        for (b2Body* body = world->m_World.GetAwakeBodyList(); body; body = body->GetNextAwake())
+        {
+            if (body->GetType() == b2_dynamicBody && body->IsActive())
+            {
+                b2Vec2 b2_position;
+                float angle;
+                GetInterpolatedTransform(body, alpha, b2_position, angle);
+                Vectormath::Aos::Point3 position;
+                FromB2(b2_position, position, inv_scale);
+                Vectormath::Aos::Quat rotation = Vectormath::Aos::Quat::rotationZ(angle);
+                (*world->m_SetWorldTransformCallback)(body->GetUserData(), position, rotation);
+            }
+        }
     }
 
     void UpdateOverlapCache(OverlapCache* cache, HContext2D context, b2Contact* contact_list, const StepWorldContext& step_context)
@@ -539,6 +676,45 @@ namespace dmPhysics
         OverlapCachePrune(cache, prune_data);
     }
 
+    /// Precedes the Box2D world state in a 2D snapshot, 8 bytes to keep the world state aligned
+    struct WorldSnapshotHeader2D
+    {
+        float    m_InterpolationAlpha;
+        uint32_t m_Pad;
+    };
+
+    void SaveWorldSnapshot2D(HWorld2D world, dmArray<uint8_t>& snapshot)
+    {
+        DM_PROFILE(Physics, "SaveWorldSnapshot");
+        uint32_t size = sizeof(WorldSnapshotHeader2D) + (uint32_t)world->m_World.GetStateSize();
+        if (snapshot.Capacity() < size)
+        {
+            snapshot.SetCapacity(size);
+        }
+        snapshot.SetSize(size);
+
+        WorldSnapshotHeader2D* header = (WorldSnapshotHeader2D*)snapshot.Begin();
+        header->m_Pad = 0;
+        header->m_InterpolationAlpha = world->m_InterpolationAlpha;
+        world->m_World.SaveState(header + 1);
+    }
+
+    bool RestoreWorldSnapshot2D(HWorld2D world, const dmArray<uint8_t>& snapshot)
+    {
+        DM_PROFILE(Physics, "RestoreWorldSnapshot");
+        if (snapshot.Size() < sizeof(WorldSnapshotHeader2D))
+        {
+            return false;
+        }
+        const WorldSnapshotHeader2D* header = (const WorldSnapshotHeader2D*)&snapshot.Front();
+        if (!world->m_World.RestoreState(header + 1, (int32)(snapshot.Size() - sizeof(WorldSnapshotHeader2D))))
+        {
+            return false;
+        }
+        world->m_InterpolationAlpha = header->m_InterpolationAlpha;
+        return true;
+    }
+
     void SetDrawDebug2D(HWorld2D world, bool draw_debug)
     {
         int flags = 0;
@@ -550,6 +726,11 @@ namespace dmPhysics
         world->m_DebugDraw.SetFlags(flags);
     }
 
+    void DrawDebug2D(HWorld2D world)
+    {
+        world->m_World.DrawDebugData();
+    }
+
     HCollisionShape2D NewCircleShape2D(HContext2D context, float radius)
     {
         b2CircleShape* shape = new b2CircleShape();
@@ -1173,6 +1354,325 @@ namespace dmPhysics
         }
     }
 
+    // Number of rays processed by each item of a parallel batch ray cast
+    static const uint32_t RAY_CAST_BATCH_SIZE = 64;
+
+    struct RayCastBatchContext2D
+    {
+        HWorld2D                m_World;
+        const RayCastRequest*   m_Requests;
+        RayCastResponse*        m_Responses;
+        uint32_t                m_Count;
+    };
+
+    static void ProcessRayCastBatch2D(void* context, uint32_t index)
+    {
+        RayCastBatchContext2D* batch = (RayCastBatchContext2D*) context;
+        HWorld2D world = batch->m_World;
+        float scale = world->m_Context->m_Scale;
+        uint32_t begin = index * RAY_CAST_BATCH_SIZE;
+        uint32_t end = dmMath::Min(begin + RAY_CAST_BATCH_SIZE, batch->m_Count);
+
+        ProcessRayCastResultCallback2D query;
+        query.m_Context = world->m_Context;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const RayCastRequest& request = batch->m_Requests[i];
+            query.m_Request = &request;
+            query.m_IgnoredUserData = request.m_IgnoredUserData;
+            query.m_CollisionMask = request.m_Mask;
+            query.m_Response = RayCastResponse();
+
+            b2Vec2 from;
+            ToB2(request.m_From, from, scale);
+            b2Vec2 to;
+            ToB2(request.m_To, to, scale);
+            if ((to - from).LengthSquared() > 0.0f)
+            {
+                world->m_World.RayCast(&query, from, to);
+            }
+            batch->m_Responses[i] = query.m_Response;
+        }
+    }
+
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses)
+    {
+        DM_PROFILE(Physics, "RayCastBatch");
+
+        RayCastBatchContext2D batch;
+        batch.m_World = world;
+        batch.m_Requests = requests;
+        batch.m_Responses = responses;
+        batch.m_Count = count;
+        // The tree walks only read the world, so the rays can be cast concurrently
+        uint32_t item_count = (count + RAY_CAST_BATCH_SIZE - 1) / RAY_CAST_BATCH_SIZE;
+        dmJobThread::ParallelFor(world->m_Context->m_JobThread, ProcessRayCastBatch2D, &batch, item_count);
+    }
+
+    static const b2Shape* ToB2QueryShape(const QueryShape& shape, float scale, b2CircleShape& circle, b2PolygonShape& box)
+    {
+        if (shape.m_Type == QueryShape::TYPE_BOX)
+        {
+            box.SetAsBox(shape.m_HalfExtents.getX() * scale, shape.m_HalfExtents.getY() * scale);
+            return &box;
+        }
+        circle.m_p.SetZero();
+        circle.m_radius = shape.m_Radius * scale;
+        return &circle;
+    }
+
+    /*
+     * Get the child shapes of a broadphase proxy overlapping aabb. A grid proxy covers a chunk of cells,
+     * children must hold B2GRIDSHAPE_CHUNK_CELL_COUNT entries.
+     */
+    static uint32_t GetProxyChildren(const b2BroadPhase* broad_phase, int32 proxy_id, const b2AABB& aabb, b2Fixture** out_fixture, uint32* children)
+    {
+        b2FixtureProxy* proxy = (b2FixtureProxy*) broad_phase->GetUserData(proxy_id);
+        *out_fixture = proxy->fixture;
+        if (proxy->fixture->GetType() == b2Shape::e_grid)
+        {
+            const b2GridShape* grid_shape = (const b2GridShape*) proxy->fixture->GetShape();
+            return grid_shape->GetChunkCells(proxy->childIndex, aabb, proxy->fixture->GetBody()->GetTransform(), children);
+        }
+        children[0] = proxy->childIndex;
+        return 1;
+    }
+
+    /*
+     * Resolve a child shape to a shape usable with b2Distance, grid cells are converted to polygons.
+     * Returns 0 if the child is filtered out of the query.
+     */
+    static const b2Shape* GetQueryCandidate(b2Fixture* fixture, int32 index, void* ignored_user_data, uint16_t mask,
+                                            b2PolygonShape& cell_polygon, int32* out_shape_index)
+    {
+        // Never hit triggers
+        if (fixture->IsSensor() || fixture->GetBody()->GetUserData() == ignored_user_data)
+            return 0;
+        if (!(fixture->GetFilterData(index).categoryBits & mask))
+            return 0;
+
+        b2Shape* shape = fixture->GetShape();
+        if (shape->GetType() == b2Shape::e_grid)
+        {
+            b2GridShape* grid_shape = (b2GridShape*) shape;
+            if (!grid_shape->m_enabled || grid_shape->m_cells[index].m_Index == 0xffffffff)
+                return 0;
+            grid_shape->GetPolygonShapeForCell(index, cell_polygon);
+            *out_shape_index = 0;
+            return &cell_polygon;
+        }
+        *out_shape_index = index;
+        return shape;
+    }
+
+    struct OverlapQuery2D
+    {
+        // Called by b2BroadPhase::Query
+        bool QueryCallback(int32 proxy_id)
+        {
+            b2Fixture* fixture;
+            uint32 children[B2GRIDSHAPE_CHUNK_CELL_COUNT];
+            uint32_t child_count = GetProxyChildren(m_BroadPhase, proxy_id, m_AABB, &fixture, children);
+            for (uint32_t i = 0; i < child_count; ++i)
+            {
+                QueryChild(fixture, children[i]);
+            }
+            return true;
+        }
+
+        void QueryChild(b2Fixture* fixture, int32 index)
+        {
+            b2PolygonShape cell_polygon;
+            int32 shape_index;
+            const b2Shape* shape = GetQueryCandidate(fixture, index, m_IgnoredUserData, m_Mask, cell_polygon, &shape_index);
+            if (shape == 0x0)
+                return;
+
+            // Bodies with several fixtures or grid cells are only reported once
+            void* user_data = fixture->GetBody()->GetUserData();
+            for (uint32_t i = m_FirstResult; i < m_Results->Size(); ++i)
+            {
+                if ((*m_Results)[i].m_CollisionObjectUserData == user_data)
+                    return;
+            }
+
+            if (b2TestOverlap(m_Shape, 0, shape, shape_index, m_Transform, fixture->GetBody()->GetTransform()))
+            {
+                OverlapResponse response;
+                response.m_CollisionObjectUserData = user_data;
+                response.m_CollisionObjectGroup = fixture->GetFilterData(index).categoryBits;
+                if (m_Results->Full())
+                    m_Results->OffsetCapacity(32);
+                m_Results->Push(response);
+            }
+        }
+
+        const b2BroadPhase*         m_BroadPhase;
+        const b2Shape*              m_Shape;
+        b2AABB                      m_AABB;
+        b2Transform                 m_Transform;
+        dmArray<OverlapResponse>*   m_Results;
+        uint32_t                    m_FirstResult;
+        void*                       m_IgnoredUserData;
+        uint16_t                    m_Mask;
+    };
+
+    void QueryOverlap2D(HWorld2D world, const OverlapRequest& request, dmArray<OverlapResponse>& results)
+    {
+        DM_PROFILE(Physics, "QueryOverlap");
+
+        float scale = world->m_Context->m_Scale;
+        b2CircleShape circle;
+        b2PolygonShape box;
+
+        OverlapQuery2D query;
+        query.m_BroadPhase = &world->m_World.GetContactManager().m_broadPhase;
+        query.m_Shape = ToB2QueryShape(request.m_Shape, scale, circle, box);
+        b2Vec2 position;
+        ToB2(request.m_Position, position, scale);
+        query.m_Transform.Set(position, 0.0f);
+        query.m_Results = &results;
+        query.m_FirstResult = results.Size();
+        query.m_IgnoredUserData = request.m_IgnoredUserData;
+        query.m_Mask = request.m_Mask;
+
+        query.m_Shape->ComputeAABB(&query.m_AABB, query.m_Transform, 0);
+        query.m_BroadPhase->Query(&query, query.m_AABB);
+    }
+
+    struct ShapeCastQuery2D
+    {
+        // Called by b2BroadPhase::Query
+        bool QueryCallback(int32 proxy_id)
+        {
+            b2Fixture* fixture;
+            uint32 children[B2GRIDSHAPE_CHUNK_CELL_COUNT];
+            uint32_t child_count = GetProxyChildren(m_BroadPhase, proxy_id, m_AABB, &fixture, children);
+            for (uint32_t i = 0; i < child_count; ++i)
+            {
+                QueryChild(fixture, children[i]);
+            }
+            return true;
+        }
+
+        void QueryChild(b2Fixture* fixture, int32 index)
+        {
+            b2PolygonShape cell_polygon;
+            int32 shape_index;
+            const b2Shape* shape = GetQueryCandidate(fixture, index, m_IgnoredUserData, m_Mask, cell_polygon, &shape_index);
+            if (shape == 0x0)
+                return;
+
+            const b2Body* body = fixture->GetBody();
+            b2TOIInput input;
+            input.proxyA.Set(m_Shape, 0);
+            input.proxyB.Set(shape, shape_index);
+            input.sweepA = m_Sweep;
+            input.sweepB.localCenter.SetZero();
+            input.sweepB.c0 = body->GetPosition();
+            input.sweepB.c = input.sweepB.c0;
+            input.sweepB.a0 = body->GetAngle();
+            input.sweepB.a = input.sweepB.a0;
+            input.sweepB.alpha0 = 0.0f;
+            // Only look for hits closer than the closest so far
+            input.tMax = m_Fraction;
+
+            b2TOIOutput output;
+            b2TimeOfImpact(&output, &input);
+            if (output.state != b2TOIOutput::e_touching && output.state != b2TOIOutput::e_overlapped)
+                return;
+            if (m_Hit && output.t >= m_Fraction)
+                return;
+
+            // The shapes are kept apart by a small margin at the time of impact, which gives a well defined normal
+            b2DistanceInput distance_input;
+            distance_input.proxyA = input.proxyA;
+            distance_input.proxyB = input.proxyB;
+            m_Sweep.GetTransform(&distance_input.transformA, output.t);
+            distance_input.transformB = body->GetTransform();
+            distance_input.useRadii = false;
+            b2SimplexCache cache;
+            cache.count = 0;
+            b2DistanceOutput distance_output;
+            b2Distance(&distance_output, &cache, &distance_input);
+
+            b2Vec2 normal = distance_output.pointA - distance_output.pointB;
+            if (normal.Normalize() < b2_epsilon)
+            {
+                normal = m_Sweep.c0 - m_Sweep.c;
+                normal.Normalize();
+            }
+
+            m_Hit = 1;
+            m_Fraction = output.t;
+            m_Normal = normal;
+            m_Point = distance_output.pointB + input.proxyB.m_radius * normal;
+            m_CollisionObjectUserData = body->GetUserData();
+            m_CollisionObjectGroup = fixture->GetFilterData(index).categoryBits;
+        }
+
+        const b2BroadPhase* m_BroadPhase;
+        const b2Shape*      m_Shape;
+        b2AABB              m_AABB;
+        b2Sweep             m_Sweep;
+        b2Vec2              m_Point;
+        b2Vec2              m_Normal;
+        float32             m_Fraction;
+        void*               m_IgnoredUserData;
+        void*               m_CollisionObjectUserData;
+        uint16_t            m_CollisionObjectGroup;
+        uint16_t            m_Mask;
+        uint16_t            m_Hit : 1;
+    };
+
+    void ShapeCast2D(HWorld2D world, const ShapeCastRequest& request, RayCastResponse& response)
+    {
+        DM_PROFILE(Physics, "ShapeCast");
+
+        response = RayCastResponse();
+
+        float scale = world->m_Context->m_Scale;
+        b2CircleShape circle;
+        b2PolygonShape box;
+
+        ShapeCastQuery2D query;
+        query.m_BroadPhase = &world->m_World.GetContactManager().m_broadPhase;
+        query.m_Shape = ToB2QueryShape(request.m_Shape, scale, circle, box);
+        query.m_Sweep.localCenter.SetZero();
+        ToB2(request.m_From, query.m_Sweep.c0, scale);
+        ToB2(request.m_To, query.m_Sweep.c, scale);
+        query.m_Sweep.a0 = 0.0f;
+        query.m_Sweep.a = 0.0f;
+        query.m_Sweep.alpha0 = 0.0f;
+        query.m_Fraction = 1.0f;
+        query.m_IgnoredUserData = request.m_IgnoredUserData;
+        query.m_CollisionObjectUserData = 0x0;
+        query.m_CollisionObjectGroup = 0;
+        query.m_Mask = request.m_Mask;
+        query.m_Hit = 0;
+
+        b2Transform from;
+        from.Set(query.m_Sweep.c0, 0.0f);
+        b2Transform to;
+        to.Set(query.m_Sweep.c, 0.0f);
+        b2AABB aabb_from;
+        query.m_Shape->ComputeAABB(&aabb_from, from, 0);
+        b2AABB aabb_to;
+        query.m_Shape->ComputeAABB(&aabb_to, to, 0);
+        query.m_AABB.Combine(aabb_from, aabb_to);
+        query.m_BroadPhase->Query(&query, query.m_AABB);
+
+        if (query.m_Hit)
+        {
+            response.m_Hit = 1;
+            response.m_Fraction = query.m_Fraction;
+            FromB2(query.m_Point, response.m_Position, world->m_Context->m_InvScale);
+            FromB2(query.m_Normal, response.m_Normal, 1.0f); // Don't scale normal
+            response.m_CollisionObjectUserData = query.m_CollisionObjectUserData;
+            response.m_CollisionObjectGroup = query.m_CollisionObjectGroup;
+        }
+    }
+
     void SetGravity2D(HWorld2D world, const Vectormath::Aos::Vector3& gravity)
     {
         b2Vec2 gravity_b;
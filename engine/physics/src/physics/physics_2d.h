@@ -15,6 +15,7 @@
 
 #include <dlib/array.h>
 #include <dlib/hashtable.h>
+#include <dlib/job_thread.h>
 
 #include "physics.h"
 #include "physics_private.h"
@@ -37,6 +38,19 @@ namespace dmPhysics
         const StepWorldContext* m_TempStepWorldContext;
     };
 
+    /// Solves the islands of a world on the job threads of the context
+    class IslandParallelFor : public b2ParallelFor
+    {
+    public:
+        IslandParallelFor(dmJobThread::HContext job_thread);
+
+        virtual int32 GetThreadCount();
+        virtual void Run(TaskFn task, void* context, int32 count);
+
+    private:
+        dmJobThread::HContext m_JobThread;
+    };
+
     struct World2D
     {
         World2D(HContext2D context, const NewWorldParams& params);
@@ -47,8 +61,11 @@ namespace dmPhysics
         dmArray<RayCastRequest>     m_RayCastRequests;
         DebugDraw2D                 m_DebugDraw;
         ContactListener             m_ContactListener;
+        IslandParallelFor           m_IslandParallelFor;
         GetWorldTransformCallback   m_GetWorldTransformCallback;
         SetWorldTransformCallback   m_SetWorldTransformCallback;
+        /// Interpolation factor used for the transforms last passed to m_SetWorldTransformCallback
+        float                       m_InterpolationAlpha;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
@@ -61,12 +78,16 @@ namespace dmPhysics
         DebugCallbacks              m_DebugCallbacks;
         b2Vec2                      m_Gravity;
         dmMessage::HSocket          m_Socket;
+        /// Worker threads solving independent islands, 0 if disabled
+        dmJobThread::HContext       m_JobThread;
         float                       m_Scale;
         float                       m_InvScale;
         float                       m_ContactImpulseLimit;
         float                       m_TriggerEnterLimit;
         int                         m_RayCastLimit;
         int                         m_TriggerOverlapCapacity;
+        int                         m_VelocityIterations;
+        int                         m_PositionIterations;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
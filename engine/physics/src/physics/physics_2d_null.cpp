@@ -35,6 +35,11 @@ namespace dmPhysics
         return 0;
     }
 
+    uint32_t GetSolverThreadCount2D(HContext2D context)
+    {
+        return 0;
+    }
+
     HWorld2D NewWorld2D(HContext2D context, const NewWorldParams& params)
     {
         return 0;
@@ -44,14 +49,32 @@ namespace dmPhysics
     {
     }
 
-    void StepWorld2D(HWorld2D world, const StepWorldContext& context)
+    uint32_t StepWorld2D(HWorld2D world, const StepWorldContext& context)
+    {
+        return 0;
+    }
+
+    void InterpolateTransforms2D(HWorld2D world, float alpha)
+    {
+    }
+
+    void SaveWorldSnapshot2D(HWorld2D world, dmArray<uint8_t>& snapshot)
     {
     }
 
+    bool RestoreWorldSnapshot2D(HWorld2D world, const dmArray<uint8_t>& snapshot)
+    {
+        return false;
+    }
+
     void SetDrawDebug2D(HWorld2D world, bool draw_debug)
     {
     }
 
+    void DrawDebug2D(HWorld2D world)
+    {
+    }
+
     HCollisionShape2D NewCircleShape2D(HContext2D context, float radius)
     {
         return 0;
@@ -218,6 +241,23 @@ namespace dmPhysics
     {
     }
 
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            responses[i] = RayCastResponse();
+        }
+    }
+
+    void QueryOverlap2D(HWorld2D world, const OverlapRequest& request, dmArray<OverlapResponse>& results)
+    {
+    }
+
+    void ShapeCast2D(HWorld2D world, const ShapeCastRequest& request, RayCastResponse& response)
+    {
+        response = RayCastResponse();
+    }
+
     void SetGravity2D(HWorld2D world, const Vectormath::Aos::Vector3& gravity)
     {
     }
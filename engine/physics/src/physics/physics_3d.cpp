@@ -102,6 +102,9 @@ namespace dmPhysics
             }
         }
 
+        /// World transform of the body before the last fixed step, see InterpolateTransforms3D
+        btTransform m_PreviousTransform;
+
     protected:
         HContext3D m_Context;
         void* m_UserData;
@@ -120,15 +123,48 @@ namespace dmPhysics
     , m_TriggerEnterLimit(0.0f)
     , m_RayCastLimit(0)
     , m_TriggerOverlapCapacity(0)
+    , m_SolverIterations(10)
     , m_AllowDynamicTransforms(0)
     {
 
     }
 
+    /// Gives access to the bullet fixed step accumulator, and to the moving bodies to interpolate
+    class DynamicsWorld3D : public btDiscreteDynamicsWorld
+    {
+    public:
+        DynamicsWorld3D(btDispatcher* dispatcher, btBroadphaseInterface* pair_cache, btConstraintSolver* solver, btCollisionConfiguration* collision_configuration)
+        : btDiscreteDynamicsWorld(dispatcher, pair_cache, solver, collision_configuration)
+        {
+        }
+
+        void ResetLocalTime()
+        {
+            m_localTime = 0;
+        }
+
+        btScalar GetLocalTime() const
+        {
+            return m_localTime;
+        }
+
+        void SetLocalTime(btScalar local_time)
+        {
+            m_localTime = local_time;
+        }
+
+        btAlignedObjectArray<btRigidBody*>& GetNonStaticRigidBodies()
+        {
+            return m_nonStaticRigidBodies;
+        }
+    };
+
     World3D::World3D(HContext3D context, const NewWorldParams& params)
     : m_TriggerOverlaps(context->m_TriggerOverlapCapacity)
     , m_DebugDraw(&context->m_DebugCallbacks)
     , m_Context(context)
+    , m_MotionStateTime(0.0f)
+    , m_InterpolationAlpha(1.0f)
     , m_AllowDynamicTransforms(context->m_AllowDynamicTransforms)
     {
         m_CollisionConfiguration = new btDefaultCollisionConfiguration();
@@ -140,14 +176,27 @@ namespace dmPhysics
         ToBt(params.m_WorldMin, world_aabb_min, context->m_Scale);
         btVector3 world_aabb_max;
         ToBt(params.m_WorldMax, world_aabb_max, context->m_Scale);
-        int maxProxies = 1024;
-        m_OverlappingPairCache = new btAxisSweep3(world_aabb_min,world_aabb_max,maxProxies);
+        if (params.m_Broadphase == BROADPHASE_TYPE_DBVT)
+        {
+            m_OverlappingPairCache = new btDbvtBroadphase();
+        }
+        else
+        {
+            // btAxisSweep3 stores handles in 16 bits, larger worlds need the 32 bit version
+            uint32_t max_proxies = params.m_MaxBroadphaseProxies;
+            assert(max_proxies >= 2 && max_proxies <= MAX_BROADPHASE_PROXIES);
+            if (max_proxies < 32767)
+                m_OverlappingPairCache = new btAxisSweep3(world_aabb_min, world_aabb_max, (unsigned short)max_proxies);
+            else
+                m_OverlappingPairCache = new bt32BitAxisSweep3(world_aabb_min, world_aabb_max, max_proxies);
+        }
 
         m_Solver = new btSequentialImpulseConstraintSolver;
 
-        m_DynamicsWorld = new btDiscreteDynamicsWorld(m_Dispatcher, m_OverlappingPairCache, m_Solver, m_CollisionConfiguration);
+        m_DynamicsWorld = new DynamicsWorld3D(m_Dispatcher, m_OverlappingPairCache, m_Solver, m_CollisionConfiguration);
         m_DynamicsWorld->setGravity(btVector3(context->m_Gravity.getX(), context->m_Gravity.getY(), context->m_Gravity.getZ()));
         m_DynamicsWorld->setDebugDrawer(&m_DebugDraw);
+        m_DynamicsWorld->getSolverInfo().m_numIterations = context->m_SolverIterations;
 
         m_GetWorldTransform = params.m_GetWorldTransformCallback;
         m_SetWorldTransform = params.m_SetWorldTransformCallback;
@@ -283,6 +332,7 @@ namespace dmPhysics
         context->m_TriggerEnterLimit = params.m_TriggerEnterLimit * params.m_Scale;
         context->m_RayCastLimit = params.m_RayCastLimit3D;
         context->m_TriggerOverlapCapacity = params.m_TriggerOverlapCapacity;
+        context->m_SolverIterations = (int) params.m_VelocityIterations;
         context->m_AllowDynamicTransforms = params.m_AllowDynamicTransforms;
         dmMessage::Result result = dmMessage::NewSocket(PHYSICS_SOCKET_NAME, &context->m_Socket);
         if (result != dmMessage::RESULT_OK)
@@ -332,6 +382,226 @@ namespace dmPhysics
         delete world;
     }
 
+    /// Precedes the collision object and manifold states in a 3D snapshot, 16 bytes to keep them aligned
+    struct WorldSnapshotHeader3D
+    {
+        uint32_t    m_ObjectCount;
+        uint32_t    m_ManifoldCount;
+        btScalar    m_LocalTime;
+        float       m_InterpolationAlpha;
+    };
+
+    struct ObjectSnapshot3D
+    {
+        btTransform         m_WorldTransform;
+        btTransform         m_InterpolationWorldTransform;
+        btVector3           m_InterpolationLinearVelocity;
+        btVector3           m_InterpolationAngularVelocity;
+        btVector3           m_LinearVelocity;
+        btVector3           m_AngularVelocity;
+        btVector3           m_TotalForce;
+        btVector3           m_TotalTorque;
+        btCollisionObject*  m_Object;
+        btScalar            m_DeactivationTime;
+        int                 m_ActivationState;
+    };
+
+    /// Followed by m_PointCount btManifoldPoint
+    ATTRIBUTE_ALIGNED16(struct) ManifoldSnapshot3D
+    {
+        const void*         m_Body0;
+        const void*         m_Body1;
+        int                 m_PointCount;
+    };
+
+    void SaveWorldSnapshot3D(HWorld3D world, dmArray<uint8_t>& snapshot)
+    {
+        DM_PROFILE(Physics, "SaveWorldSnapshot");
+        btDiscreteDynamicsWorld* dynamics_world = world->m_DynamicsWorld;
+        btCollisionObjectArray& objects = dynamics_world->getCollisionObjectArray();
+        uint32_t object_count = (uint32_t)objects.size();
+        uint32_t manifold_count = (uint32_t)world->m_Dispatcher->getNumManifolds();
+        uint32_t point_count = 0;
+        for (uint32_t i = 0; i < manifold_count; ++i)
+        {
+            point_count += (uint32_t)world->m_Dispatcher->getManifoldByIndexInternal(i)->getNumContacts();
+        }
+        uint32_t size = sizeof(WorldSnapshotHeader3D) + object_count * sizeof(ObjectSnapshot3D) + manifold_count * sizeof(ManifoldSnapshot3D) + point_count * sizeof(btManifoldPoint);
+        if (snapshot.Capacity() < size)
+        {
+            snapshot.SetCapacity(size);
+        }
+        snapshot.SetSize(size);
+
+        WorldSnapshotHeader3D* header = (WorldSnapshotHeader3D*)snapshot.Begin();
+        header->m_ObjectCount = object_count;
+        header->m_ManifoldCount = manifold_count;
+        header->m_LocalTime = ((DynamicsWorld3D*)dynamics_world)->GetLocalTime();
+        header->m_InterpolationAlpha = world->m_InterpolationAlpha;
+
+        ObjectSnapshot3D* object_snapshot = (ObjectSnapshot3D*)(header + 1);
+        for (uint32_t i = 0; i < object_count; ++i, ++object_snapshot)
+        {
+            btCollisionObject* object = objects[i];
+            object_snapshot->m_Object = object;
+            object_snapshot->m_WorldTransform = object->getWorldTransform();
+            object_snapshot->m_InterpolationWorldTransform = object->getInterpolationWorldTransform();
+            object_snapshot->m_InterpolationLinearVelocity = object->getInterpolationLinearVelocity();
+            object_snapshot->m_InterpolationAngularVelocity = object->getInterpolationAngularVelocity();
+            object_snapshot->m_DeactivationTime = object->getDeactivationTime();
+            object_snapshot->m_ActivationState = object->getActivationState();
+            btRigidBody* body = btRigidBody::upcast(object);
+            if (body != 0x0)
+            {
+                object_snapshot->m_LinearVelocity = body->getLinearVelocity();
+                object_snapshot->m_AngularVelocity = body->getAngularVelocity();
+                object_snapshot->m_TotalForce = body->getTotalForce();
+                object_snapshot->m_TotalTorque = body->getTotalTorque();
+            }
+            else
+            {
+                object_snapshot->m_LinearVelocity.setZero();
+                object_snapshot->m_AngularVelocity.setZero();
+                object_snapshot->m_TotalForce.setZero();
+                object_snapshot->m_TotalTorque.setZero();
+            }
+        }
+
+        ManifoldSnapshot3D* manifold_snapshot = (ManifoldSnapshot3D*)object_snapshot;
+        for (uint32_t i = 0; i < manifold_count; ++i)
+        {
+            const btPersistentManifold* manifold = world->m_Dispatcher->getManifoldByIndexInternal(i);
+            manifold_snapshot->m_Body0 = manifold->getBody0();
+            manifold_snapshot->m_Body1 = manifold->getBody1();
+            manifold_snapshot->m_PointCount = manifold->getNumContacts();
+            btManifoldPoint* points = (btManifoldPoint*)(manifold_snapshot + 1);
+            for (int p = 0; p < manifold_snapshot->m_PointCount; ++p)
+            {
+                points[p] = manifold->getContactPoint(p);
+            }
+            manifold_snapshot = (ManifoldSnapshot3D*)(points + manifold_snapshot->m_PointCount);
+        }
+    }
+
+    static btPersistentManifold* FindManifold(btCollisionDispatcher* dispatcher, const ManifoldSnapshot3D& snapshot, int index)
+    {
+        int count = dispatcher->getNumManifolds();
+        // Manifolds keep their order unless pairs were added or removed
+        if (index < count)
+        {
+            btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(index);
+            if (manifold->getBody0() == snapshot.m_Body0 && manifold->getBody1() == snapshot.m_Body1)
+            {
+                return manifold;
+            }
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+            if (manifold->getBody0() == snapshot.m_Body0 && manifold->getBody1() == snapshot.m_Body1)
+            {
+                return manifold;
+            }
+        }
+        return 0x0;
+    }
+
+    bool RestoreWorldSnapshot3D(HWorld3D world, const dmArray<uint8_t>& snapshot)
+    {
+        DM_PROFILE(Physics, "RestoreWorldSnapshot");
+        if (snapshot.Size() < sizeof(WorldSnapshotHeader3D))
+        {
+            return false;
+        }
+        const WorldSnapshotHeader3D* header = (const WorldSnapshotHeader3D*)&snapshot.Front();
+        btDiscreteDynamicsWorld* dynamics_world = world->m_DynamicsWorld;
+        btCollisionObjectArray& objects = dynamics_world->getCollisionObjectArray();
+        uint32_t object_count = header->m_ObjectCount;
+        uint32_t min_size = sizeof(WorldSnapshotHeader3D) + object_count * sizeof(ObjectSnapshot3D) + header->m_ManifoldCount * sizeof(ManifoldSnapshot3D);
+        if (snapshot.Size() < min_size || (uint32_t)objects.size() != object_count)
+        {
+            return false;
+        }
+        const ObjectSnapshot3D* object_snapshots = (const ObjectSnapshot3D*)(header + 1);
+        for (uint32_t i = 0; i < object_count; ++i)
+        {
+            if (objects[i] != object_snapshots[i].m_Object)
+            {
+                return false;
+            }
+        }
+        const uint8_t* manifolds_end = (const uint8_t*)(object_snapshots + object_count);
+        for (uint32_t i = 0; i < header->m_ManifoldCount; ++i)
+        {
+            const ManifoldSnapshot3D* manifold_snapshot = (const ManifoldSnapshot3D*)manifolds_end;
+            manifolds_end += sizeof(ManifoldSnapshot3D) + manifold_snapshot->m_PointCount * sizeof(btManifoldPoint);
+            if (manifold_snapshot->m_PointCount > MANIFOLD_CACHE_SIZE || manifolds_end > &snapshot.Front() + snapshot.Size())
+            {
+                return false;
+            }
+        }
+        if (manifolds_end != &snapshot.Front() + snapshot.Size())
+        {
+            return false;
+        }
+
+        ((DynamicsWorld3D*)dynamics_world)->SetLocalTime(header->m_LocalTime);
+        world->m_MotionStateTime = header->m_LocalTime;
+        world->m_InterpolationAlpha = header->m_InterpolationAlpha;
+
+        for (uint32_t i = 0; i < object_count; ++i)
+        {
+            const ObjectSnapshot3D& object_snapshot = object_snapshots[i];
+            btCollisionObject* object = object_snapshot.m_Object;
+            btRigidBody* body = btRigidBody::upcast(object);
+            if (body != 0x0)
+            {
+                // Also updates the world inertia tensor
+                body->setCenterOfMassTransform(object_snapshot.m_WorldTransform);
+            }
+            else
+            {
+                object->setWorldTransform(object_snapshot.m_WorldTransform);
+            }
+            object->setInterpolationWorldTransform(object_snapshot.m_InterpolationWorldTransform);
+            object->setInterpolationLinearVelocity(object_snapshot.m_InterpolationLinearVelocity);
+            object->setInterpolationAngularVelocity(object_snapshot.m_InterpolationAngularVelocity);
+            object->forceActivationState(object_snapshot.m_ActivationState);
+            object->setDeactivationTime(object_snapshot.m_DeactivationTime);
+            if (body != 0x0)
+            {
+                body->setLinearVelocity(object_snapshot.m_LinearVelocity);
+                body->setAngularVelocity(object_snapshot.m_AngularVelocity);
+                // The saved totals are already scaled by the linear and angular factors, which are 0 or 1 per axis
+                body->clearForces();
+                body->applyCentralForce(object_snapshot.m_TotalForce);
+                body->applyTorque(object_snapshot.m_TotalTorque);
+            }
+            dynamics_world->updateSingleAabb(object);
+        }
+
+        // Points of manifolds created after the snapshot are dropped, manifolds removed since can't be recreated
+        btCollisionDispatcher* dispatcher = world->m_Dispatcher;
+        for (int i = 0; i < dispatcher->getNumManifolds(); ++i)
+        {
+            dispatcher->getManifoldByIndexInternal(i)->clearManifold();
+        }
+        const ManifoldSnapshot3D* manifold_snapshot = (const ManifoldSnapshot3D*)(object_snapshots + object_count);
+        for (uint32_t i = 0; i < header->m_ManifoldCount; ++i)
+        {
+            const btManifoldPoint* points = (const btManifoldPoint*)(manifold_snapshot + 1);
+            btPersistentManifold* manifold = FindManifold(dispatcher, *manifold_snapshot, (int)i);
+            for (int p = 0; manifold != 0x0 && p < manifold_snapshot->m_PointCount; ++p)
+            {
+                btManifoldPoint point = points[p];
+                point.m_userPersistentData = 0x0;
+                manifold->addManifoldPoint(point);
+            }
+            manifold_snapshot = (const ManifoldSnapshot3D*)(points + manifold_snapshot->m_PointCount);
+        }
+        return true;
+    }
+
     void SetDrawDebug3D(HWorld3D world, bool draw_debug)
     {
         int debug_mode = 0;
@@ -353,9 +623,52 @@ namespace dmPhysics
         world->m_DebugDraw.setDebugMode(debug_mode);
     }
 
+    void DrawDebug3D(HWorld3D world)
+    {
+        world->m_DynamicsWorld->debugDrawWorld();
+    }
+
     static void UpdateOverlapCache(OverlapCache* cache, HContext3D context, btDispatcher* dispatcher, const StepWorldContext& step_context);
 
-    void StepWorld3D(HWorld3D world, const StepWorldContext& step_context)
+    // The transform of the body interpolated between the last two fixed steps
+    static void GetInterpolatedTransform(btRigidBody* body, float alpha, btTransform& transform)
+    {
+        const btTransform& prev_transform = ((MotionState*)body->getMotionState())->m_PreviousTransform;
+        const btTransform& curr_transform = body->getWorldTransform();
+        btQuaternion prev_rotation = prev_transform.getRotation();
+        btQuaternion curr_rotation = curr_transform.getRotation();
+        // Take the shortest way, the bullet slerp is not stable for quaternions of opposite sign
+        if (prev_rotation.dot(curr_rotation) < 0.0f)
+        {
+            curr_rotation = -curr_rotation;
+        }
+        transform.setOrigin(prev_transform.getOrigin().lerp(curr_transform.getOrigin(), alpha));
+        transform.setRotation(prev_rotation.slerp(curr_rotation, alpha));
+    }
+
+    /// The transform last passed to the game object, which for dynamic bodies is interpolated between the
+    /// last two fixed steps, or extrapolated from the last step by bullet when not using a fixed time step
+    static void GetMotionStateTransform(HWorld3D world, btCollisionObject* collision_object, btTransform& transform)
+    {
+        btRigidBody* body = btRigidBody::upcast(collision_object);
+        if (body != 0x0 && body->getMotionState() != 0x0 && !body->isStaticOrKinematicObject())
+        {
+            if (world->m_InterpolationAlpha < 1.0f)
+            {
+                GetInterpolatedTransform(body, world->m_InterpolationAlpha, transform);
+                return;
+            }
+            if (world->m_MotionStateTime > 0.0f)
+            {
+                btTransformUtil::integrateTransform(body->getInterpolationWorldTransform(), body->getInterpolationLinearVelocity(),
+                                                    body->getInterpolationAngularVelocity(), world->m_MotionStateTime * body->getHitFraction(), transform);
+                return;
+            }
+        }
+        transform = collision_object->getWorldTransform();
+    }
+
+    uint32_t StepWorld3D(HWorld3D world, const StepWorldContext& step_context)
     {
         float dt = step_context.m_DT;
         HContext3D context = world->m_Context;
@@ -378,8 +691,12 @@ namespace dmPhysics
 
                 if (collision_object->getInternalType() == btCollisionObject::CO_GHOST_OBJECT || collision_object->isKinematicObject() || retrieve_gameworld_transform)
                 {
-                    Point3 old_position = GetWorldPosition(context, collision_object);
-                    Quat old_rotation = GetWorldRotation(context, collision_object);
+                    btTransform old_transform;
+                    GetMotionStateTransform(world, collision_object, old_transform);
+                    Point3 old_position;
+                    FromBt(old_transform.getOrigin(), old_position, context->m_InvScale);
+                    btQuaternion old_bt_rotation = old_transform.getRotation();
+                    Quat old_rotation(old_bt_rotation.getX(), old_bt_rotation.getY(), old_bt_rotation.getZ(), old_bt_rotation.getW());
                     dmTransform::Transform world_transform;
                     (*world->m_GetWorldTransform)(collision_object->getUserPointer(), world_transform);
                     Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
@@ -418,11 +735,35 @@ namespace dmPhysics
             }
         }
 
+        uint32_t step_count;
         {
             DM_PROFILE(Physics, "StepSimulation");
             // Step simulation
-            // TODO: Max substeps = 1 for now...
-            world->m_DynamicsWorld->stepSimulation(dt, 1);
+            if (step_context.m_FixedTimeStep)
+            {
+                DynamicsWorld3D* dynamics_world = (DynamicsWorld3D*)world->m_DynamicsWorld;
+                btAlignedObjectArray<btRigidBody*>& bodies = dynamics_world->GetNonStaticRigidBodies();
+                for (int i = 0; i < bodies.size(); ++i)
+                {
+                    btRigidBody* body = bodies[i];
+                    if (body->getMotionState() != 0x0)
+                    {
+                        ((MotionState*)body->getMotionState())->m_PreviousTransform = body->getWorldTransform();
+                    }
+                }
+                // Exactly one step, with the motion states set to the transforms after it.
+                // Without the reset, the time bullet accumulated could round down to no step at all.
+                dynamics_world->ResetLocalTime();
+                step_count = (uint32_t) dynamics_world->stepSimulation(dt, 1, dt);
+            }
+            else
+            {
+                // TODO: Max substeps = 1 for now...
+                world->m_DynamicsWorld->stepSimulation(dt, 1);
+                step_count = 1;
+            }
+            world->m_MotionStateTime = ((DynamicsWorld3D*)world->m_DynamicsWorld)->GetLocalTime();
+            world->m_InterpolationAlpha = 1.0f;
         }
 
         // Handle ray cast requests
@@ -543,7 +884,31 @@ namespace dmPhysics
             }
         }
         UpdateOverlapCache(&world->m_TriggerOverlaps, context, dispatcher, step_context);
-        world->m_DynamicsWorld->debugDrawWorld();
+        if (!step_context.m_SkipDebugDraw)
+        {
+            world->m_DynamicsWorld->debugDrawWorld();
+        }
+
+        return step_count;
+    }
+
+    void InterpolateTransforms3D(HWorld3D world, float alpha)
+    {
+        DM_PROFILE(Physics, "InterpolateTransforms");
+        // Compared against when the game objects are read back before the next step
+        world->m_InterpolationAlpha = alpha;
+        // Sleeping bodies have already been given their final transform by the motion state
+        btAlignedObjectArray<btRigidBody*>& bodies = ((DynamicsWorld3D*)world->m_DynamicsWorld)->GetNonStaticRigidBodies();
+        for (int i = 0; i < bodies.size(); ++i)
+        {
+            btRigidBody* body = bodies[i];
+            if (body->getMotionState() != 0x0 && !body->isKinematicObject() && body->isActive())
+            {
+                btTransform transform;
+                GetInterpolatedTransform(body, alpha, transform);
+                body->getMotionState()->setWorldTransform(transform);
+            }
+        }
     }
 
     void UpdateOverlapCache(OverlapCache* cache, HContext3D context, btDispatcher* dispatcher, const StepWorldContext& step_context)
@@ -734,6 +1099,7 @@ namespace dmPhysics
             rb_info.m_linearDamping = data.m_LinearDamping;
             rb_info.m_angularDamping = data.m_AngularDamping;
             btRigidBody* body = new btRigidBody(rb_info);
+            motion_state->m_PreviousTransform = body->getWorldTransform();
             float angular_factor = 1.0f;
             if (data.m_LockedRotation) {
                 angular_factor = 0.0f;
@@ -1130,6 +1496,156 @@ namespace dmPhysics
         }
     }
 
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses)
+    {
+        DM_PROFILE(Physics, "RayCastBatch");
+
+        // The Bullet broadphase keeps a shared traversal stack for ray tests, so the rays are cast on the calling thread
+        float scale = world->m_Context->m_Scale;
+        float inv_scale = world->m_Context->m_InvScale;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const RayCastRequest& request = requests[i];
+            RayCastResponse& response = responses[i];
+            response = RayCastResponse();
+            if (Vectormath::Aos::lengthSqr(request.m_To - request.m_From) <= 0.0f)
+                continue;
+
+            btVector3 from;
+            ToBt(request.m_From, from, scale);
+            btVector3 to;
+            ToBt(request.m_To, to, scale);
+            RayCastResultClosestCallback3D result_callback(from, to, request.m_Mask, request.m_IgnoredUserData);
+            world->m_DynamicsWorld->rayTest(from, to, result_callback);
+            if (result_callback.hasHit())
+            {
+                ResponseFromRayCastResult(response, inv_scale, result_callback.m_closestHitFraction, result_callback.m_hitPointWorld, result_callback.m_hitNormalWorld, result_callback.m_collisionObject);
+            }
+        }
+    }
+
+    static btConvexShape* NewBtQueryShape(const QueryShape& shape, float scale)
+    {
+        if (shape.m_Type == QueryShape::TYPE_BOX)
+        {
+            btVector3 half_extents;
+            ToBt(shape.m_HalfExtents, half_extents, scale);
+            return new btBoxShape(half_extents);
+        }
+        return new btSphereShape(shape.m_Radius * scale);
+    }
+
+    struct OverlapResultCallback3D : public btCollisionWorld::ContactResultCallback
+    {
+        OverlapResultCallback3D(const btCollisionObject* query_object, uint16_t mask, void* ignored_user_data, dmArray<OverlapResponse>* results)
+        : m_QueryObject(query_object)
+        , m_IgnoredUserData(ignored_user_data)
+        , m_Results(results)
+        , m_FirstResult(results->Size())
+        {
+            // *all* groups for now, bullet will test this against the colliding object's mask
+            m_collisionFilterGroup = ~0;
+            m_collisionFilterMask = mask;
+        }
+
+        virtual btScalar addSingleResult(btManifoldPoint& cp, const btCollisionObject* object_a, int part_id_a, int index_a, const btCollisionObject* object_b, int part_id_b, int index_b)
+        {
+            // Points within the contact breaking threshold are reported as well
+            if (cp.getDistance() > 0.0f)
+                return 0.0f;
+            const btCollisionObject* co = object_a == m_QueryObject ? object_b : object_a;
+            void* user_data = co->getUserPointer();
+            if (user_data == m_IgnoredUserData || !co->hasContactResponse())
+                return 0.0f;
+            for (uint32_t i = m_FirstResult; i < m_Results->Size(); ++i)
+            {
+                if ((*m_Results)[i].m_CollisionObjectUserData == user_data)
+                    return 0.0f;
+            }
+
+            OverlapResponse response;
+            response.m_CollisionObjectUserData = user_data;
+            response.m_CollisionObjectGroup = co->getBroadphaseHandle()->m_collisionFilterGroup;
+            if (m_Results->Full())
+                m_Results->OffsetCapacity(32);
+            m_Results->Push(response);
+            return 0.0f;
+        }
+
+        const btCollisionObject*    m_QueryObject;
+        void*                       m_IgnoredUserData;
+        dmArray<OverlapResponse>*   m_Results;
+        uint32_t                    m_FirstResult;
+    };
+
+    void QueryOverlap3D(HWorld3D world, const OverlapRequest& request, dmArray<OverlapResponse>& results)
+    {
+        DM_PROFILE(Physics, "QueryOverlap");
+
+        float scale = world->m_Context->m_Scale;
+        btConvexShape* shape = NewBtQueryShape(request.m_Shape, scale);
+        btVector3 position;
+        ToBt(request.m_Position, position, scale);
+
+        btCollisionObject query_object;
+        query_object.setCollisionShape(shape);
+        query_object.setWorldTransform(btTransform(btQuaternion::getIdentity(), position));
+
+        OverlapResultCallback3D result_callback(&query_object, request.m_Mask, request.m_IgnoredUserData, &results);
+        world->m_DynamicsWorld->contactTest(&query_object, result_callback);
+
+        delete shape;
+    }
+
+    struct ShapeCastResultCallback3D : public btCollisionWorld::ClosestConvexResultCallback
+    {
+        ShapeCastResultCallback3D(const btVector3& from, const btVector3& to, uint16_t mask, void* ignored_user_data)
+        : btCollisionWorld::ClosestConvexResultCallback(from, to)
+        , m_IgnoredUserData(ignored_user_data)
+        {
+            // *all* groups for now, bullet will test this against the colliding object's mask
+            m_collisionFilterGroup = ~0;
+            m_collisionFilterMask = mask;
+        }
+
+        virtual btScalar addSingleResult(btCollisionWorld::LocalConvexResult& convex_result, bool normal_in_world_space)
+        {
+            if (convex_result.m_hitCollisionObject->getUserPointer() == m_IgnoredUserData)
+                return 1.0f;
+            else if (!convex_result.m_hitCollisionObject->hasContactResponse())
+                return 1.0f;
+            else
+                return btCollisionWorld::ClosestConvexResultCallback::addSingleResult(convex_result, normal_in_world_space);
+        }
+
+        void* m_IgnoredUserData;
+    };
+
+    void ShapeCast3D(HWorld3D world, const ShapeCastRequest& request, RayCastResponse& response)
+    {
+        DM_PROFILE(Physics, "ShapeCast");
+
+        response = RayCastResponse();
+        if (Vectormath::Aos::lengthSqr(request.m_To - request.m_From) <= 0.0f)
+            return;
+
+        float scale = world->m_Context->m_Scale;
+        btConvexShape* shape = NewBtQueryShape(request.m_Shape, scale);
+        btVector3 from;
+        ToBt(request.m_From, from, scale);
+        btVector3 to;
+        ToBt(request.m_To, to, scale);
+
+        ShapeCastResultCallback3D result_callback(from, to, request.m_Mask, request.m_IgnoredUserData);
+        world->m_DynamicsWorld->convexSweepTest(shape, btTransform(btQuaternion::getIdentity(), from), btTransform(btQuaternion::getIdentity(), to), result_callback);
+        if (result_callback.hasHit())
+        {
+            ResponseFromRayCastResult(response, world->m_Context->m_InvScale, result_callback.m_closestHitFraction, result_callback.m_hitPointWorld, result_callback.m_hitNormalWorld, result_callback.m_hitCollisionObject);
+        }
+
+        delete shape;
+    }
+
     void SetGravity3D(HWorld3D world, const Vectormath::Aos::Vector3& gravity)
     {
         HContext3D context = world->m_Context;
@@ -32,11 +32,15 @@ namespace dmPhysics
         HContext3D                              m_Context;
         btDefaultCollisionConfiguration*        m_CollisionConfiguration;
         btCollisionDispatcher*                  m_Dispatcher;
-        btAxisSweep3*                           m_OverlappingPairCache;
+        btBroadphaseInterface*                  m_OverlappingPairCache;
         btSequentialImpulseConstraintSolver*    m_Solver;
         btDiscreteDynamicsWorld*                m_DynamicsWorld;
         GetWorldTransformCallback               m_GetWorldTransform;
         SetWorldTransformCallback               m_SetWorldTransform;
+        /// Time the motion states were extrapolated from the last step by bullet, when not using a fixed time step
+        float                                   m_MotionStateTime;
+        /// Interpolation factor used for the transforms last passed to the game objects, see InterpolateTransforms3D
+        float                                   m_InterpolationAlpha;
         uint8_t                                 m_AllowDynamicTransforms:1;
         uint8_t                                 :7;
     };
@@ -55,6 +59,7 @@ namespace dmPhysics
         float                       m_TriggerEnterLimit;
         int                         m_RayCastLimit;
         int                         m_TriggerOverlapCapacity;
+        int                         m_SolverIterations;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
@@ -44,14 +44,32 @@ namespace dmPhysics
     {
     }
 
-    void StepWorld3D(HWorld3D world, const StepWorldContext& context)
+    uint32_t StepWorld3D(HWorld3D world, const StepWorldContext& context)
     {
+        return 0;
+    }
+
+    void InterpolateTransforms3D(HWorld3D world, float alpha)
+    {
+    }
+
+    void SaveWorldSnapshot3D(HWorld3D world, dmArray<uint8_t>& snapshot)
+    {
+    }
+
+    bool RestoreWorldSnapshot3D(HWorld3D world, const dmArray<uint8_t>& snapshot)
+    {
+        return false;
     }
 
     void SetDrawDebug3D(HWorld3D world, bool draw_debug)
     {
     }
 
+    void DrawDebug3D(HWorld3D world)
+    {
+    }
+
     HCollisionShape3D NewSphereShape3D(HContext3D context, float radius)
     {
         return 0;
@@ -186,6 +204,23 @@ namespace dmPhysics
     {
     }
 
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            responses[i] = RayCastResponse();
+        }
+    }
+
+    void QueryOverlap3D(HWorld3D world, const OverlapRequest& request, dmArray<OverlapResponse>& results)
+    {
+    }
+
+    void ShapeCast3D(HWorld3D world, const ShapeCastRequest& request, RayCastResponse& response)
+    {
+        response = RayCastResponse();
+    }
+
     void SetGravity3D(HWorld3D world, const Vectormath::Aos::Vector3& gravity)
     {
     }
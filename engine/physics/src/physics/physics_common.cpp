@@ -30,6 +30,9 @@ namespace dmPhysics
     , m_RayCastLimit2D(0)
     , m_RayCastLimit3D(0)
     , m_TriggerOverlapCapacity(0)
+    , m_VelocityIterations(10)
+    , m_PositionIterations(10)
+    , m_SolverThreadCount(0)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -42,6 +45,8 @@ namespace dmPhysics
     , m_WorldMax(WORLD_EXTENT, WORLD_EXTENT, WORLD_EXTENT)
     , m_GetWorldTransformCallback(0x0)
     , m_SetWorldTransformCallback(0x0)
+    , m_Broadphase(BROADPHASE_TYPE_AXIS_SWEEP)
+    , m_MaxBroadphaseProxies(1024)
     {
 
     }
@@ -89,6 +94,31 @@ namespace dmPhysics
 
     }
 
+    QueryShape::QueryShape()
+    : m_HalfExtents(0.0f, 0.0f, 0.0f)
+    , m_Radius(0.0f)
+    , m_Type(TYPE_SPHERE)
+    {
+
+    }
+
+    OverlapRequest::OverlapRequest()
+    : m_Position(0.0f, 0.0f, 0.0f)
+    , m_IgnoredUserData((void*)~0) // unlikely user data to ignore
+    , m_Mask(~0)
+    {
+
+    }
+
+    ShapeCastRequest::ShapeCastRequest()
+    : m_From(0.0f, 0.0f, 0.0f)
+    , m_To(0.0f, 0.0f, 0.0f)
+    , m_IgnoredUserData((void*)~0) // unlikely user data to ignore
+    , m_Mask(~0)
+    {
+
+    }
+
     DebugCallbacks::DebugCallbacks()
     : m_DrawLines(0x0)
     , m_DrawTriangles(0x0)
@@ -15,6 +15,8 @@
 
 #include "test_physics.h"
 #include <dlib/math.h>
+#include <dlib/time.h>
+#include <vector>
 
 
 using namespace Vectormath::Aos;
@@ -94,7 +96,9 @@ Test3D::Test3D()
 , m_NewWorldFunc(dmPhysics::NewWorld3D)
 , m_DeleteWorldFunc(dmPhysics::DeleteWorld3D)
 , m_StepWorldFunc(dmPhysics::StepWorld3D)
+, m_InterpolateTransformsFunc(dmPhysics::InterpolateTransforms3D)
 , m_SetDrawDebugFunc(dmPhysics::SetDrawDebug3D)
+, m_DrawDebugFunc(dmPhysics::DrawDebug3D)
 , m_NewBoxShapeFunc(dmPhysics::NewBoxShape3D)
 , m_NewSphereShapeFunc(dmPhysics::NewSphereShape3D)
 , m_NewCapsuleShapeFunc(dmPhysics::NewCapsuleShape3D)
@@ -123,10 +127,15 @@ Test3D::Test3D()
 , m_GetMassFunc(dmPhysics::GetMass3D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast3D)
 , m_RayCastFunc(dmPhysics::RayCast3D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch3D)
+, m_QueryOverlapFunc(dmPhysics::QueryOverlap3D)
+, m_ShapeCastFunc(dmPhysics::ShapeCast3D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks3D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape3D)
 , m_SetGravityFunc(dmPhysics::SetGravity3D)
 , m_GetGravityFunc(dmPhysics::GetGravity3D)
+, m_SaveWorldSnapshotFunc(dmPhysics::SaveWorldSnapshot3D)
+, m_RestoreWorldSnapshotFunc(dmPhysics::RestoreWorldSnapshot3D)
 , m_Vertices(new float[4*3])
 , m_VertexCount(4)
 , m_PolygonRadius(0.001f)
@@ -149,7 +158,9 @@ Test2D::Test2D()
 , m_NewWorldFunc(dmPhysics::NewWorld2D)
 , m_DeleteWorldFunc(dmPhysics::DeleteWorld2D)
 , m_StepWorldFunc(dmPhysics::StepWorld2D)
+, m_InterpolateTransformsFunc(dmPhysics::InterpolateTransforms2D)
 , m_SetDrawDebugFunc(dmPhysics::SetDrawDebug2D)
+, m_DrawDebugFunc(dmPhysics::DrawDebug2D)
 , m_NewBoxShapeFunc(dmPhysics::NewBoxShape2D)
 , m_NewSphereShapeFunc(dmPhysics::NewCircleShape2D)
 , m_NewCapsuleShapeFunc(0x0)
@@ -178,10 +189,15 @@ Test2D::Test2D()
 , m_GetMassFunc(dmPhysics::GetMass2D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast2D)
 , m_RayCastFunc(dmPhysics::RayCast2D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch2D)
+, m_QueryOverlapFunc(dmPhysics::QueryOverlap2D)
+, m_ShapeCastFunc(dmPhysics::ShapeCast2D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks2D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape2D)
 , m_SetGravityFunc(dmPhysics::SetGravity2D)
 , m_GetGravityFunc(dmPhysics::GetGravity2D)
+, m_SaveWorldSnapshotFunc(dmPhysics::SaveWorldSnapshot2D)
+, m_RestoreWorldSnapshotFunc(dmPhysics::RestoreWorldSnapshot2D)
 , m_Vertices(new float[3*2])
 , m_VertexCount(3)
 , m_PolygonRadius(b2_polygonRadius)
@@ -497,6 +513,123 @@ TYPED_TEST(PhysicsTest, ShapeTransform)
     (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(box_shape);
 }
 
+TYPED_TEST(PhysicsTest, FixedTimeStep)
+{
+    float box_half_ext = 0.5f;
+
+    VisualObject box_visual_object;
+    box_visual_object.m_Position = Point3(0.0f, 2.0f, 0.0f);
+    dmPhysics::CollisionObjectData box_data;
+    typename TypeParam::CollisionShapeType box_shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+    box_data.m_UserData = &box_visual_object;
+    typename TypeParam::CollisionObjectType box_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, box_data, &box_shape, 1u);
+
+    // Exactly one step per call, even if the time step doesn't add up exactly in floating point
+    TestFixture::m_StepWorldContext.m_DT = 1.0f / 60.0f;
+    TestFixture::m_StepWorldContext.m_FixedTimeStep = 1;
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(1u, (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext));
+    }
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(box_shape);
+}
+
+TYPED_TEST(PhysicsTest, FixedTimeStepInterpolation)
+{
+    float box_half_ext = 0.5f;
+
+    VisualObject box_visual_object;
+    box_visual_object.m_Position = Point3(0.0f, 2.0f, 0.0f);
+    dmPhysics::CollisionObjectData box_data;
+    typename TypeParam::CollisionShapeType box_shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+    box_data.m_UserData = &box_visual_object;
+    typename TypeParam::CollisionObjectType box_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, box_data, &box_shape, 1u);
+
+    // Render at twice the physics rate, the falling box should move every frame
+    TestFixture::m_StepWorldContext.m_DT = 1.0f / 60.0f;
+    TestFixture::m_StepWorldContext.m_FixedTimeStep = 1;
+
+    uint32_t total_steps = 0;
+    float accumulator = 0.0f;
+    float last_y = box_visual_object.m_Position.getY();
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        accumulator += 0.5f;
+        if (accumulator >= 1.0f)
+        {
+            total_steps += (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+            accumulator -= 1.0f;
+        }
+        (*TestFixture::m_Test.m_InterpolateTransformsFunc)(TestFixture::m_World, accumulator);
+        float y = box_visual_object.m_Position.getY();
+        if (i >= 2)
+        {
+            ASSERT_GT(last_y, y);
+        }
+        last_y = y;
+    }
+    ASSERT_EQ(10u, total_steps);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(box_shape);
+}
+
+TYPED_TEST(PhysicsTest, InterpolateTransforms)
+{
+    // Game object transforms are read back, so interpolated transforms must not be taken as moves
+    (*TestFixture::m_Test.m_DeleteWorldFunc)(TestFixture::m_Context, TestFixture::m_World);
+    (*TestFixture::m_Test.m_DeleteContextFunc)(TestFixture::m_Context);
+    dmPhysics::NewContextParams context_params = dmPhysics::NewContextParams();
+    context_params.m_Scale = PHYSICS_SCALE;
+    context_params.m_AllowDynamicTransforms = 1;
+    TestFixture::m_Context = (*TestFixture::m_Test.m_NewContextFunc)(context_params);
+    dmPhysics::NewWorldParams world_params;
+    world_params.m_GetWorldTransformCallback = GetWorldTransform;
+    world_params.m_SetWorldTransformCallback = SetWorldTransform;
+    TestFixture::m_World = (*TestFixture::m_Test.m_NewWorldFunc)(TestFixture::m_Context, world_params);
+    typename TypeParam::ContextType context = TestFixture::m_Context;
+    typename TypeParam::WorldType world = TestFixture::m_World;
+
+    float box_half_ext = 0.5f;
+    VisualObject box_visual_object;
+    box_visual_object.m_Position = Point3(0.0f, 2.0f, 0.0f);
+    dmPhysics::CollisionObjectData box_data;
+    typename TypeParam::CollisionShapeType box_shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+    box_data.m_UserData = &box_visual_object;
+    typename TypeParam::CollisionObjectType box_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(world, box_data, &box_shape, 1u);
+
+    // Stepped once per fixed step by the caller
+    const float fixed_dt = 1.0f / 60.0f;
+    TestFixture::m_StepWorldContext.m_DT = fixed_dt;
+    TestFixture::m_StepWorldContext.m_FixedTimeStep = 1;
+
+    // Fall for half a second, for the steps to be well above the transform epsilon
+    float y[3];
+    for (uint32_t i = 0; i < 30; ++i)
+    {
+        ASSERT_EQ(1u, (*TestFixture::m_Test.m_StepWorldFunc)(world, TestFixture::m_StepWorldContext));
+        y[0] = y[1];
+        y[1] = y[2];
+        y[2] = box_visual_object.m_Position.getY();
+    }
+    float step_distance = y[1] - y[2];
+    ASSERT_GT(step_distance, 0.0f);
+
+    // Half way between the last two steps
+    (*TestFixture::m_Test.m_InterpolateTransformsFunc)(world, 0.5f);
+    ASSERT_NEAR(0.5f * step_distance, fabsf(box_visual_object.m_Position.getY() - y[2]), 0.01f * step_distance);
+
+    // The box keeps falling from where it was simulated
+    ASSERT_EQ(1u, (*TestFixture::m_Test.m_StepWorldFunc)(world, TestFixture::m_StepWorldContext));
+    float expected_distance = 2.0f * step_distance - (y[0] - y[1]);
+    ASSERT_NEAR(expected_distance, y[2] - box_visual_object.m_Position.getY(), 0.1f * step_distance);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(world, box_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(box_shape);
+}
+
 TYPED_TEST(PhysicsTest, KinematicStaticCollision)
 {
     float ground_height_half_ext = 1.0f;
@@ -1189,6 +1322,244 @@ TYPED_TEST(PhysicsTest, SynchronousRayCasting)
     (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
 }
 
+TYPED_TEST(PhysicsTest, BatchRayCasting)
+{
+    float box_half_ext = 0.5f;
+
+    VisualObject vo_a;
+    vo_a.m_Position.setX(1.0f);
+    VisualObject vo_b;
+    vo_b.m_Position.setX(2.5f);
+    VisualObject vo_c;
+    vo_c.m_Position.setX(4.0f);
+    VisualObject* visual_objects[] = {&vo_a, &vo_b, &vo_c};
+    uint16_t groups[] = {1, 2, 1};
+
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+    typename TypeParam::CollisionObjectType collision_objects[3];
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        dmPhysics::CollisionObjectData data;
+        data.m_Group = groups[i];
+        data.m_Mass = 0.0f;
+        data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+        data.m_UserData = visual_objects[i];
+        collision_objects[i] = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    }
+
+    const uint32_t request_count = 5;
+    dmPhysics::RayCastRequest requests[request_count];
+    // A miss
+    requests[0].m_From = Vectormath::Aos::Point3(-1.0f, 0.0f, 0.0f);
+    requests[0].m_To = Vectormath::Aos::Point3(0.0f, 0.0f, 0.0f);
+    // The closest hit
+    requests[1].m_From = Vectormath::Aos::Point3(-1.0f, 0.0f, 0.0f);
+    requests[1].m_To = Vectormath::Aos::Point3(5.0f, 0.0f, 0.0f);
+    // Filtered by group
+    requests[2].m_From = Vectormath::Aos::Point3(-1.0f, 0.0f, 0.0f);
+    requests[2].m_To = Vectormath::Aos::Point3(5.0f, 0.0f, 0.0f);
+    requests[2].m_Mask = 2;
+    // Ignored object
+    requests[3].m_From = Vectormath::Aos::Point3(5.0f, 0.0f, 0.0f);
+    requests[3].m_To = Vectormath::Aos::Point3(-1.0f, 0.0f, 0.0f);
+    requests[3].m_IgnoredUserData = &vo_c;
+    // Zero length
+    requests[4].m_From = Vectormath::Aos::Point3(1.0f, 0.0f, 0.0f);
+    requests[4].m_To = Vectormath::Aos::Point3(1.0f, 0.0f, 0.0f);
+
+    dmPhysics::RayCastResponse responses[request_count];
+    (*TestFixture::m_Test.m_RayCastBatchFunc)(TestFixture::m_World, requests, request_count, responses);
+
+    ASSERT_FALSE(responses[0].m_Hit);
+    ASSERT_TRUE(responses[1].m_Hit);
+    ASSERT_EQ(&vo_a, responses[1].m_CollisionObjectUserData);
+    ASSERT_TRUE(responses[2].m_Hit);
+    ASSERT_EQ(&vo_b, responses[2].m_CollisionObjectUserData);
+    ASSERT_TRUE(responses[3].m_Hit);
+    ASSERT_EQ(&vo_b, responses[3].m_CollisionObjectUserData);
+    ASSERT_FALSE(responses[4].m_Hit);
+
+    // Same results as the single ray casts
+    dmArray<dmPhysics::RayCastResponse> hits;
+    hits.SetCapacity(1);
+    for (uint32_t i = 0; i < request_count - 1; ++i)
+    {
+        hits.SetSize(0);
+        requests[i].m_ReturnAllResults = 0;
+        (*TestFixture::m_Test.m_RayCastFunc)(TestFixture::m_World, requests[i], hits);
+        ASSERT_EQ(hits.Size(), (uint32_t)responses[i].m_Hit);
+        if (responses[i].m_Hit)
+        {
+            ASSERT_EQ(hits[0].m_Fraction, responses[i].m_Fraction);
+            ASSERT_EQ(hits[0].m_CollisionObjectGroup, responses[i].m_CollisionObjectGroup);
+            ASSERT_EQ(hits[0].m_Position.getX(), responses[i].m_Position.getX());
+            ASSERT_EQ(hits[0].m_Normal.getX(), responses[i].m_Normal.getX());
+        }
+    }
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, collision_objects[i]);
+    }
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
+TYPED_TEST(PhysicsTest, OverlapQuery)
+{
+    float box_half_ext = 0.5f;
+
+    VisualObject vo_a;
+    vo_a.m_Position.setX(1.0f);
+    VisualObject vo_b;
+    vo_b.m_Position.setX(2.5f);
+    VisualObject vo_trigger;
+    vo_trigger.m_Position.setX(-1.0f);
+    VisualObject* visual_objects[] = {&vo_a, &vo_b, &vo_trigger};
+    uint16_t groups[] = {1, 2, 1};
+    dmPhysics::CollisionObjectType types[] = {dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC, dmPhysics::COLLISION_OBJECT_TYPE_STATIC, dmPhysics::COLLISION_OBJECT_TYPE_TRIGGER};
+
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+    typename TypeParam::CollisionObjectType collision_objects[3];
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        dmPhysics::CollisionObjectData data;
+        data.m_Group = groups[i];
+        data.m_Mass = 0.0f;
+        data.m_Type = types[i];
+        data.m_UserData = visual_objects[i];
+        collision_objects[i] = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    }
+
+    dmArray<dmPhysics::OverlapResponse> results;
+    dmPhysics::OverlapRequest request;
+
+    // Between the objects, triggers are never reported
+    request.m_Shape.m_Type = dmPhysics::QueryShape::TYPE_SPHERE;
+    request.m_Shape.m_Radius = 0.25f;
+    request.m_Position = Vectormath::Aos::Point3(0.0f, 0.0f, 0.0f);
+    (*TestFixture::m_Test.m_QueryOverlapFunc)(TestFixture::m_World, request, results);
+    ASSERT_EQ(0u, results.Size());
+
+    request.m_Position = Vectormath::Aos::Point3(-1.0f, 0.0f, 0.0f);
+    (*TestFixture::m_Test.m_QueryOverlapFunc)(TestFixture::m_World, request, results);
+    ASSERT_EQ(0u, results.Size());
+
+    // Overlapping both objects
+    request.m_Shape.m_Type = dmPhysics::QueryShape::TYPE_BOX;
+    request.m_Shape.m_HalfExtents = Vector3(1.0f, 0.25f, 0.25f);
+    request.m_Position = Vectormath::Aos::Point3(1.75f, 0.0f, 0.0f);
+    (*TestFixture::m_Test.m_QueryOverlapFunc)(TestFixture::m_World, request, results);
+    ASSERT_EQ(2u, results.Size());
+    ASSERT_NE(results[0].m_CollisionObjectUserData, results[1].m_CollisionObjectUserData);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        ASSERT_TRUE(results[i].m_CollisionObjectUserData == &vo_a || results[i].m_CollisionObjectUserData == &vo_b);
+        ASSERT_EQ(results[i].m_CollisionObjectUserData == &vo_a ? 1 : 2, results[i].m_CollisionObjectGroup);
+    }
+
+    // Filtered by group
+    results.SetSize(0);
+    request.m_Mask = 2;
+    (*TestFixture::m_Test.m_QueryOverlapFunc)(TestFixture::m_World, request, results);
+    ASSERT_EQ(1u, results.Size());
+    ASSERT_EQ(&vo_b, results[0].m_CollisionObjectUserData);
+
+    // Ignored object
+    results.SetSize(0);
+    request.m_Mask = ~0;
+    request.m_IgnoredUserData = &vo_a;
+    request.m_Shape.m_Type = dmPhysics::QueryShape::TYPE_SPHERE;
+    request.m_Shape.m_Radius = 0.75f;
+    request.m_Position = Vectormath::Aos::Point3(1.0f, 0.0f, 0.0f);
+    (*TestFixture::m_Test.m_QueryOverlapFunc)(TestFixture::m_World, request, results);
+    ASSERT_EQ(0u, results.Size());
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, collision_objects[i]);
+    }
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
+TYPED_TEST(PhysicsTest, ShapeCasting)
+{
+    float box_half_ext = 0.5f;
+
+    VisualObject vo_a;
+    vo_a.m_Position.setX(1.0f);
+    VisualObject vo_b;
+    vo_b.m_Position.setX(2.5f);
+    VisualObject* visual_objects[] = {&vo_a, &vo_b};
+    uint16_t groups[] = {1, 2};
+
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+    typename TypeParam::CollisionObjectType collision_objects[2];
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        dmPhysics::CollisionObjectData data;
+        data.m_Group = groups[i];
+        data.m_Mass = 0.0f;
+        data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+        data.m_UserData = visual_objects[i];
+        collision_objects[i] = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    }
+
+    // Both engines keep the shapes apart by a small collision margin
+    const float tolerance = 0.05f;
+    dmPhysics::RayCastResponse response;
+    dmPhysics::ShapeCastRequest request;
+    request.m_Shape.m_Type = dmPhysics::QueryShape::TYPE_SPHERE;
+    request.m_Shape.m_Radius = 0.25f;
+
+    // Passing above the objects
+    request.m_From = Vectormath::Aos::Point3(-2.0f, 2.0f, 0.0f);
+    request.m_To = Vectormath::Aos::Point3(5.0f, 2.0f, 0.0f);
+    (*TestFixture::m_Test.m_ShapeCastFunc)(TestFixture::m_World, request, response);
+    ASSERT_FALSE(response.m_Hit);
+
+    // The sphere touches the first object when its center is at x = 0.25
+    request.m_From = Vectormath::Aos::Point3(-2.0f, 0.0f, 0.0f);
+    request.m_To = Vectormath::Aos::Point3(5.0f, 0.0f, 0.0f);
+    (*TestFixture::m_Test.m_ShapeCastFunc)(TestFixture::m_World, request, response);
+    ASSERT_TRUE(response.m_Hit);
+    ASSERT_EQ(&vo_a, response.m_CollisionObjectUserData);
+    ASSERT_NEAR(2.25f / 7.0f, response.m_Fraction, tolerance);
+    ASSERT_NEAR(0.5f, response.m_Position.getX(), tolerance);
+    ASSERT_NEAR(-1.0f, response.m_Normal.getX(), tolerance);
+
+    // Filtered by group
+    request.m_Mask = 2;
+    (*TestFixture::m_Test.m_ShapeCastFunc)(TestFixture::m_World, request, response);
+    ASSERT_TRUE(response.m_Hit);
+    ASSERT_EQ(&vo_b, response.m_CollisionObjectUserData);
+    ASSERT_EQ(2, response.m_CollisionObjectGroup);
+    ASSERT_NEAR(3.75f / 7.0f, response.m_Fraction, tolerance);
+
+    // A box dropped onto the first object
+    request.m_Mask = ~0;
+    request.m_Shape.m_Type = dmPhysics::QueryShape::TYPE_BOX;
+    request.m_Shape.m_HalfExtents = Vector3(0.25f, 0.25f, 0.25f);
+    request.m_From = Vectormath::Aos::Point3(1.0f, 3.0f, 0.0f);
+    request.m_To = Vectormath::Aos::Point3(1.0f, -3.0f, 0.0f);
+    (*TestFixture::m_Test.m_ShapeCastFunc)(TestFixture::m_World, request, response);
+    ASSERT_TRUE(response.m_Hit);
+    ASSERT_EQ(&vo_a, response.m_CollisionObjectUserData);
+    ASSERT_NEAR(2.25f / 6.0f, response.m_Fraction, tolerance);
+    ASSERT_NEAR(0.5f, response.m_Position.getY(), tolerance);
+    ASSERT_NEAR(1.0f, response.m_Normal.getY(), tolerance);
+
+    // Ignored object
+    request.m_IgnoredUserData = &vo_a;
+    (*TestFixture::m_Test.m_ShapeCastFunc)(TestFixture::m_World, request, response);
+    ASSERT_FALSE(response.m_Hit);
+
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, collision_objects[i]);
+    }
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
 enum Groups
 {
     GROUP_A = 1 << 0,
@@ -1495,10 +1866,21 @@ TYPED_TEST(PhysicsTest, DrawDebug)
     (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
     ASSERT_TRUE(drew);
 
+    // Drawn separately when stepped more than once per frame
+    drew = false;
+    TestFixture::m_StepWorldContext.m_SkipDebugDraw = 1;
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_FALSE(drew);
+    (*TestFixture::m_Test.m_DrawDebugFunc)(TestFixture::m_World);
+    ASSERT_TRUE(drew);
+    TestFixture::m_StepWorldContext.m_SkipDebugDraw = 0;
+
     drew = false;
     (*TestFixture::m_Test.m_SetDrawDebugFunc)(TestFixture::m_World, false);
     (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
     ASSERT_FALSE(drew);
+    (*TestFixture::m_Test.m_DrawDebugFunc)(TestFixture::m_World);
+    ASSERT_FALSE(drew);
 
 
     (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, co);
@@ -2132,6 +2514,340 @@ TYPED_TEST(PhysicsTest, DisabledFromStart)
     (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
 }
 
+TYPED_TEST(PhysicsTest, WorldSnapshot)
+{
+    const uint32_t box_count = 4;
+    const int step_count = 30;
+    float box_half_ext = 0.5f;
+
+    VisualObject ground_vo;
+    dmPhysics::CollisionObjectData ground_data;
+    typename TypeParam::CollisionShapeType ground_shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(10.0f, 1.0f, 10.0f));
+    ground_data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    ground_data.m_Mass = 0.0f;
+    ground_data.m_UserData = &ground_vo;
+    typename TypeParam::CollisionObjectType ground_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, ground_data, &ground_shape, 1u);
+
+    // A stack of boxes, slightly offset so that it topples when pushed, and a box that is still falling
+    // when the snapshot is saved and lands after it
+    typename TypeParam::CollisionShapeType box_shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+    VisualObject box_vos[box_count];
+    typename TypeParam::CollisionObjectType box_cos[box_count];
+    dmPhysics::CollisionObjectData box_data;
+    for (uint32_t i = 0; i < box_count; ++i)
+    {
+        box_vos[i].m_Position = Point3(i * 0.1f, 1.0f + box_half_ext + i * 1.05f, 0.0f);
+        if (i == box_count - 1)
+        {
+            box_vos[i].m_Position = Point3(5.0f, 7.5f, 0.0f);
+        }
+        box_data.m_UserData = &box_vos[i];
+        box_cos[i] = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, box_data, &box_shape, 1u);
+    }
+
+    for (int i = 0; i < 60; ++i)
+    {
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+
+    dmArray<uint8_t> snapshot;
+    (*TestFixture::m_Test.m_SaveWorldSnapshotFunc)(TestFixture::m_World, snapshot);
+    ASSERT_LT(0u, snapshot.Size());
+    Point3 top_position = (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, box_cos[box_count - 2]);
+    Point3 falling_position = (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, box_cos[box_count - 1]);
+    ASSERT_GT(falling_position.getY(), 2.0f);
+
+    Point3 positions[step_count][box_count];
+    Quat rotations[step_count][box_count];
+    Vector3 velocities[step_count][box_count];
+    for (int run = 0; run < 2; ++run)
+    {
+        for (int i = 0; i < step_count; ++i)
+        {
+            if (i == 5)
+            {
+                (*TestFixture::m_Test.m_ApplyForceFunc)(TestFixture::m_Context, box_cos[box_count - 2], Vector3(100.0f, 0.0f, 0.0f), box_vos[box_count - 2].m_Position);
+            }
+            (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+            for (uint32_t b = 0; b < box_count; ++b)
+            {
+                Point3 position = (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, box_cos[b]);
+                Quat rotation = (*TestFixture::m_Test.m_GetWorldRotationFunc)(TestFixture::m_Context, box_cos[b]);
+                Vector3 velocity = (*TestFixture::m_Test.m_GetLinearVelocityFunc)(TestFixture::m_Context, box_cos[b]);
+                if (run == 0)
+                {
+                    positions[i][b] = position;
+                    rotations[i][b] = rotation;
+                    velocities[i][b] = velocity;
+                }
+                else
+                {
+                    // The steps are repeated exactly
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        ASSERT_EQ(positions[i][b].getElem(c), position.getElem(c));
+                        ASSERT_EQ(velocities[i][b].getElem(c), velocity.getElem(c));
+                    }
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        ASSERT_EQ(rotations[i][b].getElem(c), rotation.getElem(c));
+                    }
+                }
+            }
+        }
+        if (run == 0)
+        {
+            // The top box was pushed off the stack and the falling box landed
+            ASSERT_GT(positions[step_count - 1][box_count - 2].getX(), top_position.getX() + 0.1f);
+            ASSERT_NEAR(1.0f + box_half_ext, positions[step_count - 1][box_count - 1].getY(), 0.1f);
+            ASSERT_TRUE((*TestFixture::m_Test.m_RestoreWorldSnapshotFunc)(TestFixture::m_World, snapshot));
+            Point3 position = (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, box_cos[box_count - 2]);
+            ASSERT_EQ(top_position.getX(), position.getX());
+            position = (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, box_cos[box_count - 1]);
+            ASSERT_EQ(falling_position.getY(), position.getY());
+        }
+    }
+
+    // The snapshot doesn't apply to a world with other objects
+    VisualObject extra_vo;
+    extra_vo.m_Position = Point3(5.0f, 5.0f, 0.0f);
+    box_data.m_UserData = &extra_vo;
+    typename TypeParam::CollisionObjectType extra_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, box_data, &box_shape, 1u);
+    ASSERT_FALSE((*TestFixture::m_Test.m_RestoreWorldSnapshotFunc)(TestFixture::m_World, snapshot));
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, extra_co);
+    ASSERT_TRUE((*TestFixture::m_Test.m_RestoreWorldSnapshotFunc)(TestFixture::m_World, snapshot));
+
+    // The buffer is reused
+    const uint8_t* buffer = snapshot.Begin();
+    (*TestFixture::m_Test.m_SaveWorldSnapshotFunc)(TestFixture::m_World, snapshot);
+    ASSERT_EQ(buffer, snapshot.Begin());
+
+    for (uint32_t i = 0; i < box_count; ++i)
+    {
+        (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_cos[i]);
+    }
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, ground_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(box_shape);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(ground_shape);
+}
+
+static dmPhysics::HWorld3D NewBroadphaseWorld3D(dmPhysics::HContext3D context, dmPhysics::BroadphaseType broadphase, uint32_t max_proxies)
+{
+    dmPhysics::NewWorldParams world_params;
+    world_params.m_GetWorldTransformCallback = GetWorldTransform;
+    world_params.m_SetWorldTransformCallback = SetWorldTransform;
+    world_params.m_Broadphase = broadphase;
+    world_params.m_MaxBroadphaseProxies = max_proxies;
+    return dmPhysics::NewWorld3D(context, world_params);
+}
+
+TEST(Broadphase3D, DbvtOutsideWorldBounds)
+{
+    dmPhysics::NewContextParams context_params;
+    context_params.m_Scale = PHYSICS_SCALE;
+    dmPhysics::HContext3D context = dmPhysics::NewContext3D(context_params);
+    dmPhysics::HWorld3D world = NewBroadphaseWorld3D(context, dmPhysics::BROADPHASE_TYPE_DBVT, 0);
+
+    // The dynamic tree has no fixed bounds, collisions are found far outside the default world AABB
+    Vector3 offset(50000.0f, 0.0f, 50000.0f);
+    VisualObject ground_vo;
+    ground_vo.m_Position = Point3(offset);
+    dmPhysics::HCollisionShape3D ground_shape = dmPhysics::NewBoxShape3D(context, Vector3(10.0f, 1.0f, 10.0f));
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &ground_vo;
+    dmPhysics::HCollisionObject3D ground_co = dmPhysics::NewCollisionObject3D(world, data, &ground_shape, 1u);
+
+    VisualObject box_vo;
+    box_vo.m_Position = Point3(offset + Vector3(0.0f, 3.0f, 0.0f));
+    dmPhysics::HCollisionShape3D box_shape = dmPhysics::NewBoxShape3D(context, Vector3(0.5f, 0.5f, 0.5f));
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_DYNAMIC;
+    data.m_Mass = 1.0f;
+    data.m_UserData = &box_vo;
+    dmPhysics::HCollisionObject3D box_co = dmPhysics::NewCollisionObject3D(world, data, &box_shape, 1u);
+
+    dmPhysics::StepWorldContext step_context;
+    step_context.m_DT = 1.0f / 60.0f;
+    for (int i = 0; i < 200; ++i)
+    {
+        dmPhysics::StepWorld3D(world, step_context);
+    }
+    ASSERT_NEAR(1.5f, box_vo.m_Position.getY(), 0.1f);
+
+    dmPhysics::DeleteCollisionObject3D(world, box_co);
+    dmPhysics::DeleteCollisionObject3D(world, ground_co);
+    dmPhysics::DeleteCollisionShape3D(box_shape);
+    dmPhysics::DeleteCollisionShape3D(ground_shape);
+    dmPhysics::DeleteWorld3D(context, world);
+    dmPhysics::DeleteContext3D(context);
+}
+
+TEST(Broadphase3D, Benchmark)
+{
+    const uint32_t body_count = 10000;
+    const uint32_t step_count = 30;
+    const char* names[] = {"axis sweep", "dbvt"};
+    const dmPhysics::BroadphaseType types[] = {dmPhysics::BROADPHASE_TYPE_AXIS_SWEEP, dmPhysics::BROADPHASE_TYPE_DBVT};
+
+    dmPhysics::NewContextParams context_params;
+    context_params.m_Scale = PHYSICS_SCALE;
+    dmPhysics::HContext3D context = dmPhysics::NewContext3D(context_params);
+    dmPhysics::HCollisionShape3D shape = dmPhysics::NewSphereShape3D(context, 0.5f);
+
+    std::vector<VisualObject> visual_objects(body_count);
+    std::vector<dmPhysics::HCollisionObject3D> collision_objects(body_count);
+    dmPhysics::StepWorldContext step_context;
+    step_context.m_DT = 1.0f / 60.0f;
+
+    for (uint32_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t)
+    {
+        dmPhysics::HWorld3D world = NewBroadphaseWorld3D(context, types[t], body_count);
+
+        // Spread out in a 100x100 grid with every other row shifted to overlap its neighbours
+        dmPhysics::CollisionObjectData data;
+        uint64_t start = dmTime::GetTime();
+        for (uint32_t i = 0; i < body_count; ++i)
+        {
+            uint32_t x = i % 100;
+            uint32_t z = i / 100;
+            visual_objects[i] = VisualObject();
+            visual_objects[i].m_Position = Point3(x * 2.0f + (z & 1) * 0.5f, (z & 1) * 0.75f, (z / 2) * 2.0f);
+            data.m_UserData = &visual_objects[i];
+            collision_objects[i] = dmPhysics::NewCollisionObject3D(world, data, &shape, 1u);
+        }
+        uint64_t insert_elapsed = dmTime::GetTime() - start;
+
+        // Bodies fall and jostle each other, moving every proxy each step
+        start = dmTime::GetTime();
+        for (uint32_t i = 0; i < step_count; ++i)
+        {
+            dmPhysics::StepWorld3D(world, step_context);
+        }
+        uint64_t step_elapsed = dmTime::GetTime() - start;
+        ASSERT_GT(0.0f, visual_objects[0].m_Position.getY());
+
+        start = dmTime::GetTime();
+        for (uint32_t i = 0; i < body_count; ++i)
+        {
+            dmPhysics::DeleteCollisionObject3D(world, collision_objects[i]);
+        }
+        uint64_t remove_elapsed = dmTime::GetTime() - start;
+
+        printf("Bench elapsed (%s, %u bodies): insert %.3f ms, step %.3f ms/step, remove %.3f ms\n",
+            names[t], body_count, insert_elapsed / 1000.0, step_elapsed / (1000.0 * step_count), remove_elapsed / 1000.0);
+
+        dmPhysics::DeleteWorld3D(context, world);
+    }
+
+    dmPhysics::DeleteCollisionShape3D(shape);
+    dmPhysics::DeleteContext3D(context);
+}
+
+template <typename T>
+static void WorldSnapshotBenchmark(const char* name, uint32_t body_count)
+{
+    const uint32_t column_height = 10;
+    const uint32_t iterations = 20;
+    T test;
+
+    dmPhysics::NewContextParams context_params;
+    context_params.m_Scale = PHYSICS_SCALE;
+    typename T::ContextType context = (*test.m_NewContextFunc)(context_params);
+    dmPhysics::NewWorldParams world_params;
+    world_params.m_GetWorldTransformCallback = GetWorldTransform;
+    world_params.m_SetWorldTransformCallback = SetWorldTransform;
+    world_params.m_MaxBroadphaseProxies = body_count + 1;
+    typename T::WorldType world = (*test.m_NewWorldFunc)(context, world_params);
+
+    // Columns of boxes resting on the ground, with contacts between all neighbours
+    uint32_t column_count = body_count / column_height;
+    VisualObject ground_vo;
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &ground_vo;
+    typename T::CollisionShapeType ground_shape = (*test.m_NewBoxShapeFunc)(context, Vector3(column_count * 2.0f, 1.0f, 1.0f));
+    typename T::CollisionObjectType ground_co = (*test.m_NewCollisionObjectFunc)(world, data, &ground_shape, 1u);
+
+    typename T::CollisionShapeType shape = (*test.m_NewBoxShapeFunc)(context, Vector3(0.5f, 0.5f, 0.5f));
+    std::vector<VisualObject> visual_objects(body_count);
+    std::vector<typename T::CollisionObjectType> collision_objects(body_count);
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_DYNAMIC;
+    data.m_Mass = 1.0f;
+    for (uint32_t i = 0; i < body_count; ++i)
+    {
+        visual_objects[i].m_Position = Point3((i / column_height) * 2.0f - column_count, 1.5f + (i % column_height) * 1.0f, 0.0f);
+        data.m_UserData = &visual_objects[i];
+        collision_objects[i] = (*test.m_NewCollisionObjectFunc)(world, data, &shape, 1u);
+    }
+
+    dmPhysics::StepWorldContext step_context;
+    step_context.m_DT = 1.0f / 60.0f;
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        (*test.m_StepWorldFunc)(world, step_context);
+    }
+
+    dmArray<uint8_t> snapshot;
+    (*test.m_SaveWorldSnapshotFunc)(world, snapshot);
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        (*test.m_SaveWorldSnapshotFunc)(world, snapshot);
+    }
+    uint64_t save_elapsed = dmTime::GetTime() - start;
+
+    start = dmTime::GetTime();
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        ASSERT_TRUE((*test.m_RestoreWorldSnapshotFunc)(world, snapshot));
+    }
+    uint64_t restore_elapsed = dmTime::GetTime() - start;
+
+    // Restoring after stepping, as when rolling back
+    uint64_t rollback_elapsed = 0;
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        (*test.m_StepWorldFunc)(world, step_context);
+        start = dmTime::GetTime();
+        ASSERT_TRUE((*test.m_RestoreWorldSnapshotFunc)(world, snapshot));
+        rollback_elapsed += dmTime::GetTime() - start;
+    }
+
+    // Compared to re-creating the collision objects
+    start = dmTime::GetTime();
+    for (uint32_t i = 0; i < body_count; ++i)
+    {
+        (*test.m_DeleteCollisionObjectFunc)(world, collision_objects[i]);
+        data.m_UserData = &visual_objects[i];
+        collision_objects[i] = (*test.m_NewCollisionObjectFunc)(world, data, &shape, 1u);
+    }
+    uint64_t recreate_elapsed = dmTime::GetTime() - start;
+
+    printf("Bench elapsed (%s, %u bodies, %u bytes): save %.3f ms, restore %.3f ms, restore after step %.3f ms, re-create objects %.3f ms\n",
+        name, body_count, snapshot.Size(), save_elapsed / (1000.0 * iterations), restore_elapsed / (1000.0 * iterations),
+        rollback_elapsed / (1000.0 * iterations), recreate_elapsed / 1000.0);
+
+    for (uint32_t i = 0; i < body_count; ++i)
+    {
+        (*test.m_DeleteCollisionObjectFunc)(world, collision_objects[i]);
+    }
+    (*test.m_DeleteCollisionObjectFunc)(world, ground_co);
+    (*test.m_DeleteCollisionShapeFunc)(shape);
+    (*test.m_DeleteCollisionShapeFunc)(ground_shape);
+    (*test.m_DeleteWorldFunc)(context, world);
+    (*test.m_DeleteContextFunc)(context);
+}
+
+TEST(WorldSnapshot, Benchmark)
+{
+    WorldSnapshotBenchmark<Test2D>("2D", 1000);
+    WorldSnapshotBenchmark<Test2D>("2D", 10000);
+    WorldSnapshotBenchmark<Test3D>("3D", 1000);
+    WorldSnapshotBenchmark<Test3D>("3D", 10000);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
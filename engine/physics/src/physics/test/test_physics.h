@@ -86,10 +86,12 @@ struct Funcs
     typedef void (*DeleteContextFunc)(typename T::ContextType context);
     typedef typename T::WorldType (*NewWorldFunc)(typename T::ContextType context, const dmPhysics::NewWorldParams& params);
     typedef void (*DeleteWorldFunc)(typename T::ContextType context, typename T::WorldType world);
-    typedef void (*StepWorldFunc)(typename T::WorldType world, const dmPhysics::StepWorldContext& context);
+    typedef uint32_t (*StepWorldFunc)(typename T::WorldType world, const dmPhysics::StepWorldContext& context);
+    typedef void (*InterpolateTransformsFunc)(typename T::WorldType world, float alpha);
     typedef void (*SetCollisionCallbackFunc)(typename T::WorldType world, dmPhysics::CollisionCallback callback, void* user_data);
     typedef void (*SetContactPointCallbackFunc)(typename T::WorldType world, dmPhysics::ContactPointCallback callback, void* user_data);
     typedef void (*SetDrawDebugFunc)(typename T::WorldType world, bool);
+    typedef void (*DrawDebugFunc)(typename T::WorldType world);
     typedef typename T::CollisionShapeType (*NewBoxShapeFunc)(typename T::ContextType context, const Vectormath::Aos::Vector3& half_extents);
     typedef typename T::CollisionShapeType (*NewSphereShapeFunc)(typename T::ContextType context, float radius);
     typedef typename T::CollisionShapeType (*NewCapsuleShapeFunc)(typename T::ContextType context, float radius, float height);
@@ -118,10 +120,15 @@ struct Funcs
     typedef float (*GetMassFunc)(typename T::CollisionObjectType collision_object);
     typedef void (*RequestRayCastFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest& request);
     typedef void (*RayCastFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest& request, dmArray<dmPhysics::RayCastResponse>& results);
+    typedef void (*RayCastBatchFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest* requests, uint32_t count, dmPhysics::RayCastResponse* responses);
+    typedef void (*QueryOverlapFunc)(typename T::WorldType world, const dmPhysics::OverlapRequest& request, dmArray<dmPhysics::OverlapResponse>& results);
+    typedef void (*ShapeCastFunc)(typename T::WorldType world, const dmPhysics::ShapeCastRequest& request, dmPhysics::RayCastResponse& response);
     typedef void (*SetDebugCallbacks)(typename T::ContextType context, const dmPhysics::DebugCallbacks& callbacks);
     typedef void (*ReplaceShapeFunc)(typename T::ContextType context, typename T::CollisionShapeType old_shape, typename T::CollisionShapeType new_shape);
     typedef void (*SetGravityFunc)(typename T::WorldType world, const Vectormath::Aos::Vector3& gravity);
     typedef Vectormath::Aos::Vector3 (*GetGravityFunc)(typename T::WorldType world);
+    typedef void (*SaveWorldSnapshotFunc)(typename T::WorldType world, dmArray<uint8_t>& snapshot);
+    typedef bool (*RestoreWorldSnapshotFunc)(typename T::WorldType world, const dmArray<uint8_t>& snapshot);
 };
 
 struct Test3D
@@ -139,9 +146,11 @@ struct Test3D
     Funcs<Test3D>::NewWorldFunc                     m_NewWorldFunc;
     Funcs<Test3D>::DeleteWorldFunc                  m_DeleteWorldFunc;
     Funcs<Test3D>::StepWorldFunc                    m_StepWorldFunc;
+    Funcs<Test3D>::InterpolateTransformsFunc        m_InterpolateTransformsFunc;
     Funcs<Test3D>::SetCollisionCallbackFunc         m_SetCollisionCallbackFunc;
     Funcs<Test3D>::SetContactPointCallbackFunc      m_SetContactPointCallbackFunc;
     Funcs<Test3D>::SetDrawDebugFunc                 m_SetDrawDebugFunc;
+    Funcs<Test3D>::DrawDebugFunc                    m_DrawDebugFunc;
     Funcs<Test3D>::NewBoxShapeFunc                  m_NewBoxShapeFunc;
     Funcs<Test3D>::NewSphereShapeFunc               m_NewSphereShapeFunc;
     Funcs<Test3D>::NewCapsuleShapeFunc              m_NewCapsuleShapeFunc;
@@ -170,10 +179,15 @@ struct Test3D
     Funcs<Test3D>::GetMassFunc                      m_GetMassFunc;
     Funcs<Test3D>::RequestRayCastFunc               m_RequestRayCastFunc;
     Funcs<Test3D>::RayCastFunc                      m_RayCastFunc;
+    Funcs<Test3D>::RayCastBatchFunc                 m_RayCastBatchFunc;
+    Funcs<Test3D>::QueryOverlapFunc                 m_QueryOverlapFunc;
+    Funcs<Test3D>::ShapeCastFunc                    m_ShapeCastFunc;
     Funcs<Test3D>::SetDebugCallbacks                m_SetDebugCallbacksFunc;
     Funcs<Test3D>::ReplaceShapeFunc                 m_ReplaceShapeFunc;
     Funcs<Test3D>::SetGravityFunc                   m_SetGravityFunc;
     Funcs<Test3D>::GetGravityFunc                   m_GetGravityFunc;
+    Funcs<Test3D>::SaveWorldSnapshotFunc            m_SaveWorldSnapshotFunc;
+    Funcs<Test3D>::RestoreWorldSnapshotFunc         m_RestoreWorldSnapshotFunc;
 
     float*      m_Vertices;
     uint32_t    m_VertexCount;
@@ -196,7 +210,9 @@ struct Test2D
     Funcs<Test2D>::NewWorldFunc                     m_NewWorldFunc;
     Funcs<Test2D>::DeleteWorldFunc                  m_DeleteWorldFunc;
     Funcs<Test2D>::StepWorldFunc                    m_StepWorldFunc;
+    Funcs<Test2D>::InterpolateTransformsFunc        m_InterpolateTransformsFunc;
     Funcs<Test2D>::SetDrawDebugFunc                 m_SetDrawDebugFunc;
+    Funcs<Test2D>::DrawDebugFunc                    m_DrawDebugFunc;
     Funcs<Test2D>::NewBoxShapeFunc                  m_NewBoxShapeFunc;
     Funcs<Test2D>::NewSphereShapeFunc               m_NewSphereShapeFunc;
     Funcs<Test2D>::NewCapsuleShapeFunc              m_NewCapsuleShapeFunc;
@@ -225,10 +241,15 @@ struct Test2D
     Funcs<Test2D>::GetMassFunc                      m_GetMassFunc;
     Funcs<Test2D>::RequestRayCastFunc               m_RequestRayCastFunc;
     Funcs<Test2D>::RayCastFunc                      m_RayCastFunc;
+    Funcs<Test2D>::RayCastBatchFunc                 m_RayCastBatchFunc;
+    Funcs<Test2D>::QueryOverlapFunc                 m_QueryOverlapFunc;
+    Funcs<Test2D>::ShapeCastFunc                    m_ShapeCastFunc;
     Funcs<Test2D>::SetDebugCallbacks                m_SetDebugCallbacksFunc;
     Funcs<Test2D>::ReplaceShapeFunc                 m_ReplaceShapeFunc;
     Funcs<Test2D>::SetGravityFunc                   m_SetGravityFunc;
     Funcs<Test2D>::GetGravityFunc                   m_GetGravityFunc;
+    Funcs<Test2D>::SaveWorldSnapshotFunc            m_SaveWorldSnapshotFunc;
+    Funcs<Test2D>::RestoreWorldSnapshotFunc         m_RestoreWorldSnapshotFunc;
 
     float*      m_Vertices;
     uint32_t    m_VertexCount;
@@ -22,6 +22,7 @@
 
 #include <vector>
 #include <dlib/math.h>
+#include <dlib/time.h>
 #include <dlib/vmath.h>
 
 using namespace Vectormath::Aos;
@@ -1300,6 +1301,82 @@ TYPED_TEST(PhysicsTest, JointHinge)
 
 }
 
+TYPED_TEST(PhysicsTest, JointSnapshot)
+{
+    const int step_count = 30;
+
+    VisualObject vo_a;
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &vo_a;
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(0.5f, 0.5f, 0.0f));
+    typename TypeParam::CollisionObjectType static_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    // A pendulum of two boxes, swinging on a hinge and a spring
+    VisualObject vo_b;
+    vo_b.m_Position = Point3(2.0f, 0.0f, 0.0f);
+    VisualObject vo_c;
+    vo_c.m_Position = Point3(4.0f, 0.0f, 0.0f);
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_DYNAMIC;
+    data.m_Mass = 1.0f;
+    data.m_UserData = &vo_b;
+    typename TypeParam::CollisionObjectType co_b = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    data.m_UserData = &vo_c;
+    typename TypeParam::CollisionObjectType co_c = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    Vectormath::Aos::Point3 p_zero(0.0f);
+    dmPhysics::ConnectJointParams hinge_params(dmPhysics::JOINT_TYPE_HINGE);
+    hinge_params.m_HingeJointParams.m_EnableMotor = true;
+    hinge_params.m_HingeJointParams.m_MotorSpeed = 1.0f;
+    hinge_params.m_HingeJointParams.m_MaxMotorTorque = 10.0f;
+    dmPhysics::HJoint hinge = dmPhysics::CreateJoint2D(TestFixture::m_World, static_co, p_zero, co_b, Point3(-2.0f, 0.0f, 0.0f), dmPhysics::JOINT_TYPE_HINGE, hinge_params);
+    ASSERT_NE((dmPhysics::HJoint)0x0, hinge);
+    dmPhysics::ConnectJointParams spring_params(dmPhysics::JOINT_TYPE_SPRING);
+    spring_params.m_SpringJointParams.m_Length = 2.0f;
+    spring_params.m_SpringJointParams.m_FrequencyHz = 2.0f;
+    dmPhysics::HJoint spring = dmPhysics::CreateJoint2D(TestFixture::m_World, co_b, p_zero, co_c, p_zero, dmPhysics::JOINT_TYPE_SPRING, spring_params);
+    ASSERT_NE((dmPhysics::HJoint)0x0, spring);
+
+    for (int i = 0; i < 20; ++i)
+    {
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+
+    dmArray<uint8_t> snapshot;
+    dmPhysics::SaveWorldSnapshot2D(TestFixture::m_World, snapshot);
+
+    // The joint impulses used for warm starting are restored, repeating the steps exactly
+    Point3 positions[step_count];
+    for (int run = 0; run < 2; ++run)
+    {
+        for (int i = 0; i < step_count; ++i)
+        {
+            (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+            if (run == 0)
+            {
+                positions[i] = vo_c.m_Position;
+            }
+            else
+            {
+                ASSERT_EQ(positions[i].getX(), vo_c.m_Position.getX());
+                ASSERT_EQ(positions[i].getY(), vo_c.m_Position.getY());
+            }
+        }
+        ASSERT_TRUE(dmPhysics::RestoreWorldSnapshot2D(TestFixture::m_World, snapshot));
+    }
+
+    // The snapshot doesn't apply to a world with other joints
+    dmPhysics::DeleteJoint2D(TestFixture::m_World, spring);
+    ASSERT_FALSE(dmPhysics::RestoreWorldSnapshot2D(TestFixture::m_World, snapshot));
+
+    dmPhysics::DeleteJoint2D(TestFixture::m_World, hinge);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, static_co);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, co_b);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, co_c);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
 TYPED_TEST(PhysicsTest, ScaledGrid)
 {
     /*
@@ -1607,6 +1684,645 @@ TYPED_TEST(PhysicsTest, SetGridShapeEnable)
     dmPhysics::DeleteHullSet2D(hull_set);
 }
 
+TYPED_TEST(PhysicsTest, SleepingBodySync)
+{
+    VisualObject vo_a;
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &vo_a;
+    typename TypeParam::CollisionShapeType ground_shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(10.0f, 0.5f, 0.0f));
+    typename TypeParam::CollisionObjectType static_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &ground_shape, 1u);
+
+    VisualObject vo_b;
+    vo_b.m_Position = Point3(0.0f, 1.0f, 0.0f);
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_DYNAMIC;
+    data.m_Mass = 1.0f;
+    data.m_UserData = &vo_b;
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(0.5f, 0.5f, 0.0f));
+    typename TypeParam::CollisionObjectType dynamic_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    // Kinematic bodies are kept in a separate list, make sure removing one keeps the other in sync
+    VisualObject vo_c;
+    vo_c.m_Position = Point3(-5.0f, 5.0f, 0.0f);
+    VisualObject vo_d;
+    vo_d.m_Position = Point3(5.0f, 5.0f, 0.0f);
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &vo_c;
+    typename TypeParam::CollisionObjectType kinematic_co_c = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    data.m_UserData = &vo_d;
+    typename TypeParam::CollisionObjectType kinematic_co_d = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, kinematic_co_c);
+
+    b2Body* body = (b2Body*)dynamic_co;
+    for (uint32_t i = 0; i < 300 && body->IsAwake(); ++i)
+    {
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+    ASSERT_FALSE(body->IsAwake());
+
+    // The game object has been given the final transform of the body
+    Point3 rest_position = (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, dynamic_co);
+    ASSERT_NEAR(rest_position.getX(), vo_b.m_Position.getX(), 0.0001f);
+    ASSERT_NEAR(rest_position.getY(), vo_b.m_Position.getY(), 0.0001f);
+
+    // Sleeping bodies are not synchronized
+    vo_b.m_Position = Point3(0.0f, 100.0f, 0.0f);
+    vo_d.m_Position = Point3(5.0f, 6.0f, 0.0f);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_EQ(100.0f, vo_b.m_Position.getY());
+    ASSERT_NEAR(6.0f, (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, kinematic_co_d).getY(), 0.0001f);
+
+    // Until woken up
+    (*TestFixture::m_Test.m_ApplyForceFunc)(TestFixture::m_Context, dynamic_co, Vector3(0.0f, 1.0f, 0.0f), rest_position);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_TRUE(body->IsAwake());
+    ASSERT_NEAR(rest_position.getY(), vo_b.m_Position.getY(), 0.1f);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, kinematic_co_d);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, dynamic_co);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, static_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(ground_shape);
+}
+
+TYPED_TEST(PhysicsTest, KinematicBodyTypeChange)
+{
+    dmPhysics::SetGravity2D(TestFixture::m_World, Vector3(0.0f, 0.0f, 0.0f));
+
+    VisualObject vo;
+    vo.m_Position = Point3(0.0f, 5.0f, 0.0f);
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_DYNAMIC;
+    data.m_Mass = 1.0f;
+    data.m_UserData = &vo;
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(0.5f, 0.5f, 0.0f));
+    typename TypeParam::CollisionObjectType co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+
+    // A body made kinematic at runtime follows its game object
+    b2Body* body = (b2Body*)co;
+    body->SetType(b2_kinematicBody);
+    vo.m_Position = Point3(3.0f, 6.0f, 0.0f);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    Point3 position = (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, co);
+    ASSERT_NEAR(3.0f, position.getX(), 0.0001f);
+    ASSERT_NEAR(6.0f, position.getY(), 0.0001f);
+
+    // And stops following it when made dynamic again
+    body->SetType(b2_dynamicBody);
+    body->SetLinearVelocity(b2Vec2(0.0f, 0.0f));
+    vo.m_Position = Point3(-3.0f, 6.0f, 0.0f);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    position = (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, co);
+    ASSERT_NEAR(3.0f, position.getX(), 0.0001f);
+    ASSERT_NEAR(3.0f, vo.m_Position.getX(), 0.0001f);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
+TYPED_TEST(PhysicsTest, SleepingBodiesBenchmark)
+{
+    const uint32_t body_count = 20000;
+    const uint32_t frame_count = 60;
+    // Bodies kept awake each frame in the mostly sleeping world
+    const uint32_t awake_count = body_count / 100;
+
+    dmPhysics::SetGravity2D(TestFixture::m_World, Vector3(0.0f, 0.0f, 0.0f));
+
+    std::vector<VisualObject> visual_objects(body_count);
+    std::vector<typename TypeParam::CollisionObjectType> collision_objects(body_count);
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(0.5f, 0.5f, 0.0f));
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_DYNAMIC;
+    data.m_Mass = 1.0f;
+    for (uint32_t i = 0; i < body_count; ++i)
+    {
+        visual_objects[i].m_Position = Point3(2.0f * (i % 200), 2.0f * (i / 200), 0.0f);
+        data.m_UserData = &visual_objects[i];
+        collision_objects[i] = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    }
+
+    // All bodies are awake until they have been at rest long enough
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < frame_count / 2; ++i)
+    {
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+    uint64_t awake_elapsed = dmTime::GetTime() - start;
+
+    for (uint32_t i = 0; i < frame_count; ++i)
+    {
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+    ASSERT_FALSE(((b2Body*)collision_objects[0])->IsAwake());
+
+    start = dmTime::GetTime();
+    for (uint32_t i = 0; i < frame_count; ++i)
+    {
+        for (uint32_t j = 0; j < awake_count; ++j)
+        {
+            uint32_t index = (i * awake_count + j) % body_count;
+            ((b2Body*)collision_objects[index])->SetAwake(true);
+        }
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+    uint64_t sleeping_elapsed = dmTime::GetTime() - start;
+
+    printf("Bench elapsed (%u bodies, %u frames): all awake %.3f ms/frame, %u awake %.3f ms/frame\n",
+        body_count, frame_count, awake_elapsed / (1000.0 * (frame_count / 2)), awake_count, sleeping_elapsed / (1000.0 * frame_count));
+
+    for (uint32_t i = 0; i < body_count; ++i)
+    {
+        (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, collision_objects[i]);
+    }
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
+struct IslandStacks
+{
+    std::vector<VisualObject>                   m_VisualObjects;
+    std::vector<dmPhysics::HCollisionObject2D>  m_CollisionObjects;
+    dmPhysics::HCollisionShape2D                m_GroundShape;
+    dmPhysics::HCollisionShape2D                m_BoxShape;
+    dmPhysics::HCollisionObject2D               m_Ground;
+};
+
+// Independent stacks of boxes on a shared static ground, each stack is an island
+static void CreateIslandStacks(dmPhysics::HContext2D context, dmPhysics::HWorld2D world, uint32_t stack_count, uint32_t stack_height, IslandStacks& stacks)
+{
+    stacks.m_VisualObjects.resize(stack_count * stack_height + 1);
+    stacks.m_CollisionObjects.resize(stack_count * stack_height);
+    stacks.m_GroundShape = dmPhysics::NewBoxShape2D(context, Vector3(stack_count * 2.0f, 0.5f, 0.0f));
+    stacks.m_BoxShape = dmPhysics::NewBoxShape2D(context, Vector3(0.5f, 0.5f, 0.0f));
+
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &stacks.m_VisualObjects[stack_count * stack_height];
+    stacks.m_Ground = dmPhysics::NewCollisionObject2D(world, data, &stacks.m_GroundShape, 1u);
+
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_DYNAMIC;
+    data.m_Mass = 1.0f;
+    for (uint32_t i = 0; i < stack_count; ++i)
+    {
+        for (uint32_t j = 0; j < stack_height; ++j)
+        {
+            uint32_t index = i * stack_height + j;
+            // Slightly offset boxes so that the stacks topple
+            stacks.m_VisualObjects[index].m_Position = Point3(4.0f * i + 0.3f * j, 1.0f + 1.05f * j, 0.0f);
+            data.m_UserData = &stacks.m_VisualObjects[index];
+            stacks.m_CollisionObjects[index] = dmPhysics::NewCollisionObject2D(world, data, &stacks.m_BoxShape, 1u);
+        }
+    }
+}
+
+static void DeleteIslandStacks(dmPhysics::HWorld2D world, IslandStacks& stacks)
+{
+    for (uint32_t i = 0; i < stacks.m_CollisionObjects.size(); ++i)
+    {
+        dmPhysics::DeleteCollisionObject2D(world, stacks.m_CollisionObjects[i]);
+    }
+    dmPhysics::DeleteCollisionObject2D(world, stacks.m_Ground);
+    dmPhysics::DeleteCollisionShape2D(stacks.m_BoxShape);
+    dmPhysics::DeleteCollisionShape2D(stacks.m_GroundShape);
+}
+
+// Replace the context and world of the fixture with ones solving islands on worker threads
+static void NewSolverThreadWorld(dmPhysics::HContext2D& context, dmPhysics::HWorld2D& world, uint32_t thread_count)
+{
+    dmPhysics::DeleteWorld2D(context, world);
+    dmPhysics::DeleteContext2D(context);
+
+    dmPhysics::NewContextParams context_params = dmPhysics::NewContextParams();
+    context_params.m_Scale = PHYSICS_SCALE;
+    context_params.m_RayCastLimit2D = 64;
+    context_params.m_TriggerOverlapCapacity = 16;
+    context_params.m_SolverThreadCount = thread_count;
+    context = dmPhysics::NewContext2D(context_params);
+    dmPhysics::NewWorldParams world_params;
+    world_params.m_GetWorldTransformCallback = GetWorldTransform;
+    world_params.m_SetWorldTransformCallback = SetWorldTransform;
+    world = dmPhysics::NewWorld2D(context, world_params);
+}
+
+TYPED_TEST(PhysicsTest, SolverThreads)
+{
+    const uint32_t stack_count = 16;
+    const uint32_t stack_height = 5;
+    const uint32_t step_count = 120;
+
+    IslandStacks stacks;
+    CreateIslandStacks(TestFixture::m_Context, TestFixture::m_World, stack_count, stack_height, stacks);
+    for (uint32_t i = 0; i < step_count; ++i)
+    {
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+    int contact_point_count = TestFixture::m_ContactPointCount;
+    std::vector<VisualObject> expected = stacks.m_VisualObjects;
+    DeleteIslandStacks(TestFixture::m_World, stacks);
+
+    NewSolverThreadWorld(TestFixture::m_Context, TestFixture::m_World, 3);
+    ASSERT_NE((void*)0, TestFixture::m_Context);
+    TestFixture::m_ContactPointCount = 0;
+
+    IslandStacks thread_stacks;
+    CreateIslandStacks(TestFixture::m_Context, TestFixture::m_World, stack_count, stack_height, thread_stacks);
+    for (uint32_t i = 0; i < step_count; ++i)
+    {
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+
+    // Every island is solved by a single thread, so the result is identical
+    ASSERT_EQ(contact_point_count, TestFixture::m_ContactPointCount);
+    for (uint32_t i = 0; i < stack_count * stack_height; ++i)
+    {
+        ASSERT_EQ(expected[i].m_Position.getX(), thread_stacks.m_VisualObjects[i].m_Position.getX());
+        ASSERT_EQ(expected[i].m_Position.getY(), thread_stacks.m_VisualObjects[i].m_Position.getY());
+        ASSERT_EQ(expected[i].m_Rotation.getZ(), thread_stacks.m_VisualObjects[i].m_Rotation.getZ());
+        ASSERT_EQ(expected[i].m_Rotation.getW(), thread_stacks.m_VisualObjects[i].m_Rotation.getW());
+    }
+    // The stacks have toppled
+    ASSERT_GT(4.0f, thread_stacks.m_VisualObjects[stack_height - 1].m_Position.getY());
+    DeleteIslandStacks(TestFixture::m_World, thread_stacks);
+}
+
+TYPED_TEST(PhysicsTest, SolverThreadCount)
+{
+    ASSERT_EQ(0u, dmPhysics::GetSolverThreadCount2D(TestFixture::m_Context));
+
+    NewSolverThreadWorld(TestFixture::m_Context, TestFixture::m_World, dmPhysics::MAX_SOLVER_THREAD_COUNT);
+    ASSERT_NE((void*)0, TestFixture::m_Context);
+    ASSERT_EQ(dmPhysics::MAX_SOLVER_THREAD_COUNT, dmPhysics::GetSolverThreadCount2D(TestFixture::m_Context));
+
+    IslandStacks stacks;
+    CreateIslandStacks(TestFixture::m_Context, TestFixture::m_World, 4, 2, stacks);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    DeleteIslandStacks(TestFixture::m_World, stacks);
+}
+
+TYPED_TEST(PhysicsTest, SolverThreadsBenchmark)
+{
+    const uint32_t stack_count = 256;
+    const uint32_t stack_height = 10;
+    const uint32_t step_count = 120;
+    const uint32_t thread_count = 3;
+
+    IslandStacks stacks;
+    CreateIslandStacks(TestFixture::m_Context, TestFixture::m_World, stack_count, stack_height, stacks);
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < step_count; ++i)
+    {
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+    uint64_t serial_elapsed = dmTime::GetTime() - start;
+    DeleteIslandStacks(TestFixture::m_World, stacks);
+
+    NewSolverThreadWorld(TestFixture::m_Context, TestFixture::m_World, thread_count);
+    CreateIslandStacks(TestFixture::m_Context, TestFixture::m_World, stack_count, stack_height, stacks);
+    start = dmTime::GetTime();
+    for (uint32_t i = 0; i < step_count; ++i)
+    {
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+    uint64_t threaded_elapsed = dmTime::GetTime() - start;
+    DeleteIslandStacks(TestFixture::m_World, stacks);
+
+    printf("Bench elapsed (%u stacks of %u boxes, %u steps): calling thread %.3f ms/step, %u solver threads %.3f ms/step\n",
+        stack_count, stack_height, step_count, serial_elapsed / (1000.0 * step_count), thread_count, threaded_elapsed / (1000.0 * step_count));
+}
+
+TYPED_TEST(PhysicsTest, GridShapeQueries)
+{
+    int32_t rows = 2;
+    int32_t columns = 2;
+    int32_t cell_width = 16;
+    int32_t cell_height = 16;
+
+    VisualObject vo_a;
+    vo_a.m_Position = Point3(1, 0, 0);
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &vo_a;
+    data.m_Group = 0xffff;
+    data.m_Mask = 0xffff;
+
+    const float hull_vertices[] = {  // 1x1 around origo
+                                    -0.5f, -0.5f,
+                                     0.5f, -0.5f,
+                                     0.5f,  0.5f,
+                                    -0.5f,  0.5f };
+
+    const dmPhysics::HullDesc hulls[] = { {0, 4}, {4, 4} };
+    dmPhysics::HHullSet2D hull_set = dmPhysics::NewHullSet2D(TestFixture::m_Context, hull_vertices, 4, hulls, 1);
+    dmPhysics::HCollisionShape2D grid_shape = dmPhysics::NewGridShape2D(TestFixture::m_Context, hull_set, Point3(0,0,0), cell_width, cell_height, rows, columns);
+    typename TypeParam::CollisionObjectType grid_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &grid_shape, 1u);
+
+    for (int32_t row = 0; row < rows; ++row)
+    {
+        for (int32_t col = 0; col < columns; ++col)
+        {
+            dmPhysics::SetGridShapeHull(grid_co, 0, row, col, 0, EMPTY_FLAGS);
+        }
+    }
+
+    // Overlapping all four cells, the grid is reported once
+    dmArray<dmPhysics::OverlapResponse> overlaps;
+    dmPhysics::OverlapRequest overlap_request;
+    overlap_request.m_Shape.m_Type = dmPhysics::QueryShape::TYPE_SPHERE;
+    overlap_request.m_Shape.m_Radius = 2.0f;
+    overlap_request.m_Position = Point3(1, 0, 0);
+    dmPhysics::QueryOverlap2D(TestFixture::m_World, overlap_request, overlaps);
+    ASSERT_EQ(1U, overlaps.Size());
+    ASSERT_EQ(&vo_a, overlaps[0].m_CollisionObjectUserData);
+
+    dmPhysics::RayCastResponse response;
+    dmPhysics::ShapeCastRequest cast_request;
+    cast_request.m_Shape.m_Type = dmPhysics::QueryShape::TYPE_SPHERE;
+    cast_request.m_Shape.m_Radius = 1.0f;
+    cast_request.m_From = Point3(-40, 4, 0);
+    cast_request.m_To = Point3(40, 4, 0);
+    dmPhysics::ShapeCast2D(TestFixture::m_World, cast_request, response);
+    ASSERT_TRUE(response.m_Hit);
+    ASSERT_EQ(&vo_a, response.m_CollisionObjectUserData);
+    ASSERT_NEAR(-15.0f, response.m_Position.getX(), 0.05f);
+    ASSERT_NEAR(-1.0f, response.m_Normal.getX(), 0.001f);
+
+    // Clear all hulls
+    for (int32_t row = 0; row < rows; ++row)
+    {
+        for (int32_t col = 0; col < columns; ++col)
+        {
+            dmPhysics::SetGridShapeHull(grid_co, 0, row, col, dmPhysics::GRIDSHAPE_EMPTY_CELL, EMPTY_FLAGS);
+        }
+    }
+
+    overlaps.SetSize(0);
+    dmPhysics::QueryOverlap2D(TestFixture::m_World, overlap_request, overlaps);
+    ASSERT_EQ(0U, overlaps.Size());
+    dmPhysics::ShapeCast2D(TestFixture::m_World, cast_request, response);
+    ASSERT_FALSE(response.m_Hit);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, grid_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(grid_shape);
+    dmPhysics::DeleteHullSet2D(hull_set);
+}
+
+// Grid cells are grouped in chunks sharing a broadphase proxy, edits must still find new contacts within a chunk
+TYPED_TEST(PhysicsTest, GridShapeChunks)
+{
+    int32_t rows = 20;
+    int32_t columns = 20;
+    int32_t cell_width = 16;
+    int32_t cell_height = 16;
+
+    VisualObject vo_grid;
+    vo_grid.m_Position = Point3(0, 0, 0);
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &vo_grid;
+    data.m_Group = 0xffff;
+    data.m_Mask = 0xffff;
+
+    const float hull_vertices[] = {  // 1x1 around origo
+                                    -0.5f, -0.5f,
+                                     0.5f, -0.5f,
+                                     0.5f,  0.5f,
+                                    -0.5f,  0.5f };
+
+    const dmPhysics::HullDesc hulls[] = { {0, 4} };
+    dmPhysics::HHullSet2D hull_set = dmPhysics::NewHullSet2D(TestFixture::m_Context, hull_vertices, 4, hulls, 1);
+    dmPhysics::HCollisionShape2D grid_shape = dmPhysics::NewGridShape2D(TestFixture::m_Context, hull_set, Point3(0,0,0), cell_width, cell_height, rows, columns);
+    typename TypeParam::CollisionObjectType grid_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &grid_shape, 1u);
+
+    // One set cell in the first and in the last chunk
+    dmPhysics::SetGridShapeHull(grid_co, 0, 0, 0, 0, EMPTY_FLAGS);
+    dmPhysics::SetGridShapeHull(grid_co, 0, 17, 17, 0, EMPTY_FLAGS);
+
+    // Spheres centered in cells (2, 3) and (17, 17)
+    VisualObject vo_a;
+    vo_a.m_Position = Point3(3 * cell_width - 152.0f, 2 * cell_height - 152.0f, 0.0f);
+    VisualObject vo_b;
+    vo_b.m_Position = Point3(17 * cell_width - 152.0f, 17 * cell_height - 152.0f, 0.0f);
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewSphereShapeFunc)(TestFixture::m_Context, 4.0f);
+    data.m_UserData = &vo_a;
+    typename TypeParam::CollisionObjectType co_a = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    data.m_UserData = &vo_b;
+    typename TypeParam::CollisionObjectType co_b = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    // 3x3 chunks of 8x8 cells and the two spheres
+    ASSERT_EQ(11, ((b2Body*)grid_co)->GetWorld()->GetProxyCount());
+
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_EQ(0, vo_a.m_CollisionCount);
+    ASSERT_EQ(1, vo_b.m_CollisionCount);
+
+    // The chunk already covers the cell, the new contact is found without the sphere moving
+    dmPhysics::SetGridShapeHull(grid_co, 0, 2, 3, 0, EMPTY_FLAGS);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_LT(0, vo_a.m_CollisionCount);
+
+    // Cleared cells stop colliding
+    dmPhysics::SetGridShapeHull(grid_co, 0, 2, 3, dmPhysics::GRIDSHAPE_EMPTY_CELL, EMPTY_FLAGS);
+    dmPhysics::SetGridShapeHull(grid_co, 0, 17, 17, dmPhysics::GRIDSHAPE_EMPTY_CELL, EMPTY_FLAGS);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    vo_a.m_CollisionCount = 0;
+    vo_b.m_CollisionCount = 0;
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_EQ(0, vo_a.m_CollisionCount);
+    ASSERT_EQ(0, vo_b.m_CollisionCount);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, co_a);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, co_b);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, grid_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(grid_shape);
+    dmPhysics::DeleteHullSet2D(hull_set);
+}
+
+TYPED_TEST(PhysicsTest, GridShapeEditBenchmark)
+{
+    const int32_t rows = 512;
+    const int32_t columns = 512;
+    const float cell_size = 16.0f;
+    const uint32_t body_count = 256;
+    const uint32_t frame_count = 120;
+    // Cells destroyed each frame
+    const uint32_t edit_count = 64;
+
+    VisualObject vo_grid;
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &vo_grid;
+
+    const float hull_vertices[] = {  // 1x1 around origo
+                                    -0.5f, -0.5f,
+                                     0.5f, -0.5f,
+                                     0.5f,  0.5f,
+                                    -0.5f,  0.5f };
+
+    const dmPhysics::HullDesc hulls[] = { {0, 4} };
+    dmPhysics::HHullSet2D hull_set = dmPhysics::NewHullSet2D(TestFixture::m_Context, hull_vertices, 4, hulls, 1);
+    dmPhysics::HCollisionShape2D grid_shape = dmPhysics::NewGridShape2D(TestFixture::m_Context, hull_set, Point3(0,0,0), cell_size, cell_size, rows, columns);
+
+    // Terrain filling the lower half of the map
+    uint64_t start = dmTime::GetTime();
+    typename TypeParam::CollisionObjectType grid_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &grid_shape, 1u);
+    for (int32_t row = 0; row < rows / 2; ++row)
+    {
+        for (int32_t col = 0; col < columns; ++col)
+        {
+            dmPhysics::SetGridShapeHull(grid_co, 0, row, col, 0, EMPTY_FLAGS);
+        }
+    }
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    uint64_t setup_elapsed = dmTime::GetTime() - start;
+
+    // Bodies resting on the surface
+    std::vector<VisualObject> visual_objects(body_count);
+    std::vector<typename TypeParam::CollisionObjectType> collision_objects(body_count);
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(4.0f, 4.0f, 0.0f));
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_DYNAMIC;
+    data.m_Mass = 1.0f;
+    for (uint32_t i = 0; i < body_count; ++i)
+    {
+        visual_objects[i].m_Position = Point3((i * 2 + 0.5f) * cell_size - columns * cell_size * 0.5f, 4.0f, 0.0f);
+        data.m_UserData = &visual_objects[i];
+        collision_objects[i] = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    }
+
+    // Dig down through the terrain, spread over the whole map
+    uint32_t seed = 1;
+    start = dmTime::GetTime();
+    for (uint32_t i = 0; i < frame_count; ++i)
+    {
+        for (uint32_t j = 0; j < edit_count; ++j)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            int32_t row = rows / 2 - 1 - (int32_t)((seed >> 8) % (rows / 2));
+            int32_t col = (int32_t)((seed >> 20) % columns);
+            dmPhysics::SetGridShapeHull(grid_co, 0, row, col, dmPhysics::GRIDSHAPE_EMPTY_CELL, EMPTY_FLAGS);
+        }
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+    uint64_t edit_elapsed = dmTime::GetTime() - start;
+
+    printf("Bench elapsed (%d x %d cells, %d proxies): setup %.3f ms, %u cell edits and step %.3f ms/frame\n",
+        rows, columns, ((b2Body*)grid_co)->GetWorld()->GetProxyCount(), setup_elapsed / 1000.0, edit_count, edit_elapsed / (1000.0 * frame_count));
+
+    for (uint32_t i = 0; i < body_count; ++i)
+    {
+        (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, collision_objects[i]);
+    }
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, grid_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(grid_shape);
+    dmPhysics::DeleteHullSet2D(hull_set);
+}
+
+struct RayCastScene
+{
+    std::vector<VisualObject>                   m_VisualObjects;
+    std::vector<dmPhysics::HCollisionObject2D>  m_CollisionObjects;
+    std::vector<dmPhysics::RayCastRequest>      m_Requests;
+    dmPhysics::HCollisionShape2D                m_Shape;
+};
+
+// A field of static boxes and rays crossing it in all directions
+static void CreateRayCastScene(dmPhysics::HContext2D context, dmPhysics::HWorld2D world, uint32_t box_count, uint32_t ray_count, RayCastScene& scene)
+{
+    const uint32_t columns = 50;
+    scene.m_VisualObjects.resize(box_count);
+    scene.m_CollisionObjects.resize(box_count);
+    scene.m_Shape = dmPhysics::NewBoxShape2D(context, Vector3(0.5f, 0.5f, 0.0f));
+
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    data.m_Mass = 0.0f;
+    for (uint32_t i = 0; i < box_count; ++i)
+    {
+        scene.m_VisualObjects[i].m_Position = Point3(3.0f * (i % columns), 3.0f * (i / columns), 0.0f);
+        data.m_UserData = &scene.m_VisualObjects[i];
+        scene.m_CollisionObjects[i] = dmPhysics::NewCollisionObject2D(world, data, &scene.m_Shape, 1u);
+    }
+
+    float width = 3.0f * columns;
+    float height = 3.0f * (box_count / columns);
+    scene.m_Requests.resize(ray_count);
+    for (uint32_t i = 0; i < ray_count; ++i)
+    {
+        float angle = i * 2.0f * (float)M_PI / ray_count;
+        Point3 from((i * 7 % 101) * width / 100.0f, (i * 13 % 97) * height / 96.0f, 0.0f);
+        scene.m_Requests[i].m_From = from;
+        scene.m_Requests[i].m_To = from + Vector3(cosf(angle), sinf(angle), 0.0f) * 40.0f;
+    }
+}
+
+static void DeleteRayCastScene(dmPhysics::HWorld2D world, RayCastScene& scene)
+{
+    for (uint32_t i = 0; i < scene.m_CollisionObjects.size(); ++i)
+    {
+        dmPhysics::DeleteCollisionObject2D(world, scene.m_CollisionObjects[i]);
+    }
+    dmPhysics::DeleteCollisionShape2D(scene.m_Shape);
+}
+
+TYPED_TEST(PhysicsTest, RayCastBatchBenchmark)
+{
+    const uint32_t box_count = 2000;
+    const uint32_t ray_count = 10000;
+    const uint32_t thread_count = 3;
+
+    RayCastScene scene;
+    CreateRayCastScene(TestFixture::m_Context, TestFixture::m_World, box_count, ray_count, scene);
+
+    dmArray<dmPhysics::RayCastResponse> hits;
+    hits.SetCapacity(1);
+    uint32_t hit_count = 0;
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < ray_count; ++i)
+    {
+        hits.SetSize(0);
+        scene.m_Requests[i].m_ReturnAllResults = 0;
+        dmPhysics::RayCast2D(TestFixture::m_World, scene.m_Requests[i], hits);
+        hit_count += hits.Size();
+    }
+    uint64_t single_elapsed = dmTime::GetTime() - start;
+
+    std::vector<dmPhysics::RayCastResponse> responses(ray_count);
+    start = dmTime::GetTime();
+    dmPhysics::RayCastBatch2D(TestFixture::m_World, &scene.m_Requests[0], ray_count, &responses[0]);
+    uint64_t batch_elapsed = dmTime::GetTime() - start;
+    DeleteRayCastScene(TestFixture::m_World, scene);
+
+    NewSolverThreadWorld(TestFixture::m_Context, TestFixture::m_World, thread_count);
+    CreateRayCastScene(TestFixture::m_Context, TestFixture::m_World, box_count, ray_count, scene);
+    std::vector<dmPhysics::RayCastResponse> thread_responses(ray_count);
+    start = dmTime::GetTime();
+    dmPhysics::RayCastBatch2D(TestFixture::m_World, &scene.m_Requests[0], ray_count, &thread_responses[0]);
+    uint64_t threaded_elapsed = dmTime::GetTime() - start;
+    DeleteRayCastScene(TestFixture::m_World, scene);
+
+    uint32_t batch_hit_count = 0;
+    for (uint32_t i = 0; i < ray_count; ++i)
+    {
+        batch_hit_count += responses[i].m_Hit;
+        ASSERT_EQ(responses[i].m_Hit, thread_responses[i].m_Hit);
+        ASSERT_EQ(responses[i].m_Fraction, thread_responses[i].m_Fraction);
+    }
+    ASSERT_EQ(hit_count, batch_hit_count);
+    ASSERT_LT(0U, hit_count);
+
+    printf("Bench elapsed (%u rays, %u boxes): single %.3f ms, batch %.3f ms, batch on %u threads %.3f ms\n",
+        ray_count, box_count, single_elapsed / 1000.0, batch_elapsed / 1000.0, thread_count, threaded_elapsed / 1000.0);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -35,6 +35,8 @@ namespace dmLoadQueue
         dmResource::FResourcePreload m_Function;
         dmResource::PreloadHintInfo m_HintInfo;
         void* m_Context;
+        // Set if the resource may be created by the queue, see RESOURCE_TYPE_FLAGS_THREADED_CREATE
+        dmResource::SResourceType* m_CreateType;
     };
 
     struct LoadResult
@@ -42,6 +44,9 @@ namespace dmLoadQueue
         dmResource::Result m_LoadResult;
         dmResource::Result m_PreloadResult;
         void* m_PreloadData;
+        // RESULT_PENDING unless the resource was created by the queue
+        dmResource::Result m_CreateResult;
+        dmResource::SResourceDescriptor m_Resource;
     };
 
     HQueue CreateQueue(dmResource::HFactory factory);
@@ -21,6 +21,8 @@
 #include <dlib/mutex.h>
 #include <dlib/time.h>
 #include <dlib/condition_variable.h>
+#include <dlib/hash.h>
+#include <dlib/profile.h>
 
 namespace dmLoadQueue
 {
@@ -81,6 +83,28 @@ namespace dmLoadQueue
         return &queue->m_Request[queue->m_Loaded % QUEUE_SLOTS];
     }
 
+    static void CreateResource(Queue* queue, Request* request, dmResource::SResourceType* resource_type, LoadResult* result)
+    {
+        DM_PROFILE(Resource, "CreateResource");
+
+        dmResource::SResourceDescriptor* resource = &result->m_Resource;
+        memset(resource, 0, sizeof(*resource));
+        resource->m_NameHash           = dmHashString64(request->m_CanonicalPath);
+        resource->m_ReferenceCount     = 1;
+        resource->m_ResourceType       = (void*) resource_type;
+        resource->m_ResourceSizeOnDisc = request->m_Buffer.Size();
+
+        dmResource::ResourceCreateParams params;
+        params.m_Factory     = queue->m_Factory;
+        params.m_Context     = resource_type->m_Context;
+        params.m_Filename    = request->m_Name;
+        params.m_Buffer      = request->m_Buffer.Begin();
+        params.m_BufferSize  = request->m_Buffer.Size();
+        params.m_PreloadData = result->m_PreloadData;
+        params.m_Resource    = resource;
+        result->m_CreateResult = resource_type->m_CreateFunction(params);
+    }
+
     static void LoadThread(void* arg)
     {
         Queue* queue     = (Queue*)arg;
@@ -137,6 +161,7 @@ namespace dmLoadQueue
                 result.m_LoadResult    = DoLoadResource(queue->m_Factory, current->m_CanonicalPath, current->m_Name, &size, &current->m_Buffer);
                 result.m_PreloadResult = dmResource::RESULT_PENDING;
                 result.m_PreloadData   = 0;
+                result.m_CreateResult  = dmResource::RESULT_PENDING;
 
                 if (result.m_LoadResult == dmResource::RESULT_OK)
                 {
@@ -156,6 +181,14 @@ namespace dmLoadQueue
                     {
                         result.m_PreloadResult = dmResource::RESULT_OK;
                     }
+
+                    // A resource without dependencies can be created right away if the type allows it,
+                    // the preloader then only registers it on the main thread
+                    dmResource::SResourceType* create_type = current->m_PreloadInfo.m_CreateType;
+                    if (create_type && result.m_PreloadResult == dmResource::RESULT_OK && current->m_PreloadInfo.m_HintInfo.m_HintCount == 0)
+                    {
+                        CreateResource(queue, current, create_type, &result);
+                    }
                 }
             }
         }
@@ -95,6 +95,9 @@ struct SResourceFactory
     SResourceType                                m_ResourceTypes[MAX_RESOURCE_TYPES];
     uint32_t                                     m_ResourceTypesCount;
 
+    uint32_t                                     m_PreloaderMaxRequests;
+    uint32_t                                     m_PreloaderMaxPaths;
+
     // Guard for anything that touches anything that could be shared
     // with GetRaw (used for async threaded loading). Liveupdate, HttpClient, m_Buffer
     // m_BuiltinsManifest, m_Manifest
@@ -187,6 +190,8 @@ void SetDefaultNewFactoryParams(struct NewFactoryParams* params)
 {
     params->m_MaxResources = 1024;
     params->m_Flags = RESOURCE_FACTORY_FLAGS_EMPTY;
+    params->m_PreloaderMaxRequests = 4096;
+    params->m_PreloaderMaxPaths = 8192;
 
     params->m_ArchiveManifest.m_Data = 0;
     params->m_ArchiveManifest.m_Size = 0;
@@ -568,6 +573,12 @@ Result NewArchiveIndexWithResource(Manifest* manifest, const uint8_t* hashDigest
     return (result == dmResourceArchive::RESULT_OK) ? RESULT_OK : RESULT_INVAL;
 }
 
+Result NewArchiveIndexWithResources(Manifest* manifest, const uint8_t* hash_digests, uint32_t hash_digest_length, const dmResourceArchive::LiveUpdateResource* resources, uint32_t resource_count, const char* proj_id, dmResourceArchive::HArchiveIndex& out_new_index, dmResourceArchive::Result* out_results)
+{
+    dmResourceArchive::Result result = dmResourceArchive::NewArchiveIndexWithResources(manifest->m_ArchiveIndex, hash_digests, hash_digest_length, resources, resource_count, proj_id, out_new_index, out_results);
+    return (result == dmResourceArchive::RESULT_OK) ? RESULT_OK : RESULT_INVAL;
+}
+
 Result BundleVersionValid(const Manifest* manifest, const char* bundle_ver_path)
 {
     Result result = RESULT_OK;
@@ -765,6 +776,10 @@ HFactory NewFactory(NewFactoryParams* params, const char* uri)
 
         if (r == RESULT_OK)
         {
+            if (params->m_Flags & RESOURCE_FACTORY_FLAGS_ARCHIVE_LOOKUP_TABLE)
+            {
+                dmResourceArchive::SetLookupTableEnabled(factory->m_Manifest->m_ArchiveIndex, true);
+            }
             // Only need factory->m_Manifest->m_DDFData from this point on, make sure we release unneeded message
             dmDDF::FreeMessage(factory->m_Manifest->m_DDF);
             factory->m_Manifest->m_DDF = 0x0;
@@ -796,6 +811,8 @@ HFactory NewFactory(NewFactoryParams* params, const char* uri)
     }
 
     factory->m_ResourceTypesCount = 0;
+    factory->m_PreloaderMaxRequests = params->m_PreloaderMaxRequests;
+    factory->m_PreloaderMaxPaths = params->m_PreloaderMaxPaths;
 
     const uint32_t table_size = dmMath::Max(1u, (3 * params->m_MaxResources) / 4);
     factory->m_Resources = new dmHashTable<uint64_t, SResourceDescriptor>();
@@ -962,12 +979,29 @@ Result RegisterType(HFactory factory,
     resource_type.m_PostCreateFunction = post_create_function;
     resource_type.m_DestroyFunction = destroy_function;
     resource_type.m_RecreateFunction = recreate_function;
+    resource_type.m_Flags = 0;
 
     factory->m_ResourceTypes[factory->m_ResourceTypesCount++] = resource_type;
 
     return RESULT_OK;
 }
 
+void GetPreloaderLimits(HFactory factory, uint32_t* max_requests, uint32_t* max_paths)
+{
+    *max_requests = factory->m_PreloaderMaxRequests;
+    *max_paths = factory->m_PreloaderMaxPaths;
+}
+
+Result SetTypeFlags(HFactory factory, const char* extension, uint32_t flags)
+{
+    SResourceType* resource_type = FindResourceType(factory, extension);
+    if (resource_type == 0)
+        return RESULT_UNKNOWN_RESOURCE_TYPE;
+
+    resource_type->m_Flags = flags;
+    return RESULT_OK;
+}
+
 // Finds the specific entry in a sorted list of entries
 static int FindEntryIndex(const Manifest* manifest, dmhash_t path_hash)
 {
@@ -48,6 +48,21 @@ namespace dmResource
      */
     #define RESOURCE_FACTORY_FLAGS_HTTP_CACHE     (1 << 2)
 
+    /**
+     * Build a hash prefix lookup table for the archive index
+     * @see dmResourceArchive::SetLookupTableEnabled
+     */
+    #define RESOURCE_FACTORY_FLAGS_ARCHIVE_LOOKUP_TABLE (1 << 3)
+
+    /**
+     * The create function of the resource type only does CPU work (e.g. parsing or decoding) and may be
+     * called on the loading thread by the preloader. Work that must be done on the main thread, such as
+     * graphics uploads, belongs in the post create function. Only resources without dependencies are
+     * created on the loading thread, and the create function must not get any other resources.
+     * @see SetTypeFlags
+     */
+    #define RESOURCE_TYPE_FLAGS_THREADED_CREATE   (1 << 0)
+
     /**
      * Result
      */
@@ -349,7 +364,13 @@ namespace dmResource
         EmbeddedResource m_ArchiveData;
         EmbeddedResource m_ArchiveManifest;
 
-        uint32_t m_Reserved[5];
+        /// Maximum number of requests a preloader can grow to. Default is 4096
+        uint32_t m_PreloaderMaxRequests;
+
+        /// Maximum number of unique paths a preloader can store. Default is 8192
+        uint32_t m_PreloaderMaxPaths;
+
+        uint32_t m_Reserved[3];
 
         NewFactoryParams()
         {
@@ -398,6 +419,15 @@ namespace dmResource
                                FResourceDestroy destroy_function,
                                FResourceRecreate recreate_function);
 
+    /**
+     * Set the flags of a registered resource type
+     * @param factory Factory handle
+     * @param extension File extension for resource
+     * @param flags Resource type flags, e.g. RESOURCE_TYPE_FLAGS_THREADED_CREATE
+     * @return RESULT_OK on success
+     */
+    Result SetTypeFlags(HFactory factory, const char* extension, uint32_t flags);
+
     /**
      * Get a resource from factory
      * @param factory Factory handle
@@ -570,6 +600,30 @@ namespace dmResource
      */
     void DeletePreloader(HPreloader preloader);
 
+    /**
+     * Preloader statistics, used to tune the preloader limits
+     */
+    struct PreloaderStats
+    {
+        /// Number of requests currently in the preloader tree
+        uint32_t m_Requests;
+        /// Highest number of requests in the preloader tree at the same time
+        uint32_t m_PeakRequests;
+        /// Number of hints that were thrown away since the request or path limit was reached
+        uint32_t m_DroppedRequests;
+        /// Number of internalized paths
+        uint32_t m_Paths;
+        /// Total time in us the preloader has waited for a free slot in the load queue
+        uint64_t m_StallTime;
+    };
+
+    /**
+     * Get the preloader statistics
+     * @param preloader Preloader
+     * @param stats Output statistics
+     */
+    void GetPreloaderStats(HPreloader preloader, PreloaderStats* stats);
+
     /**
      * Hint the preloader what to load before Create is called on the resource.
      * The resources are not guaranteed to be loaded before Create is called.
@@ -612,6 +666,19 @@ namespace dmResource
      */
     Result NewArchiveIndexWithResource(Manifest* manifest, const uint8_t* hash_digest, uint32_t hash_digest_length, const dmResourceArchive::LiveUpdateResource* resource, const char* proj_id, dmResourceArchive::HArchiveIndex& out_new_index);
 
+    /**
+     * Create new archive index with a batch of resources.
+     * @param manifest Manifest to use
+     * @param hash_digests Hash digests, hash_digest_length bytes per resource
+     * @param hash_digest_length Hash digest length
+     * @param resources LiveUpdate resources to create with
+     * @param resource_count Number of resources
+     * @param out_new_index New archive index
+     * @param out_results Per resource archive result
+     * @return RESULT_OK on success
+     */
+    Result NewArchiveIndexWithResources(Manifest* manifest, const uint8_t* hash_digests, uint32_t hash_digest_length, const dmResourceArchive::LiveUpdateResource* resources, uint32_t resource_count, const char* proj_id, dmResourceArchive::HArchiveIndex& out_new_index, dmResourceArchive::Result* out_results);
+
     /**
      * Determines if the resource could be unique
      * @param name Resource name
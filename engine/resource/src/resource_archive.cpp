@@ -23,9 +23,13 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
+
 #include "resource.h"
 #include "resource_archive_private.h"
+#include <dlib/array.h>
 #include <dlib/dstrings.h>
+#include <dlib/hashtable.h>
 #include <dlib/lz4.h>
 #include <dlib/log.h>
 #include <dlib/crypt.h>
@@ -212,6 +216,7 @@ namespace dmResourceArchive
 
         bundled_archive_container->m_ArchiveIndex = reloaded_index;
         bundled_archive_container->m_IsMemMapped = true;
+        BuildLookupTable(bundled_archive_container);
 
         // reloaded_index is now the union of bundled archive index and liveupdate entries
         // use it as runtime index, and write it to liveupdate.arci.tmp
@@ -390,6 +395,8 @@ namespace dmResourceArchive
 
     void Delete(HArchiveIndexContainer &archive)
     {
+        DeleteLookupTable(archive);
+
         if (archive->m_Entries)
         {
             delete[] archive->m_Entries;
@@ -617,6 +624,12 @@ namespace dmResourceArchive
 
         memcpy((void*)entries_shift_src, (void*)&entry, sizeof(EntryData));
         archive->m_EntryDataCount = C_TO_JAVA(JAVA_TO_C(archive->m_EntryDataCount) + 1);
+
+        // Inserting directly into the container index invalidates the entry indices in the lookup table
+        if (archive == archive_container->m_ArchiveIndex)
+        {
+            BuildLookupTable(archive_container);
+        }
         return RESULT_OK;
     }
 
@@ -650,18 +663,169 @@ namespace dmResourceArchive
         }
     }
 
-    Result NewArchiveIndexWithResource(HArchiveIndexContainer archive_container, const uint8_t* hash_digest, uint32_t hash_digest_len, const dmResourceArchive::LiveUpdateResource* resource, const char* proj_id, HArchiveIndex& out_new_index)
+    struct HashDigestSorter
+    {
+        HashDigestSorter(const uint8_t* hash_digests, uint32_t hash_digest_len) : m_HashDigests(hash_digests), m_HashDigestLen(hash_digest_len) {}
+
+        bool operator()(uint32_t a, uint32_t b) const
+        {
+            return memcmp(m_HashDigests + a * m_HashDigestLen, m_HashDigests + b * m_HashDigestLen, m_HashDigestLen) < 0;
+        }
+
+        const uint8_t* m_HashDigests;
+        uint32_t m_HashDigestLen;
+    };
+
+    static void SetLiveUpdateEntry(EntryData* entry, const LiveUpdateResource* resource, uint32_t offset)
+    {
+        bool is_compressed = (resource->m_Header->m_Flags & ENTRY_FLAG_COMPRESSED);
+        entry->m_ResourceDataOffset = C_TO_JAVA(offset);
+        entry->m_ResourceSize = is_compressed ? resource->m_Header->m_Size : C_TO_JAVA(resource->m_Count);
+        entry->m_ResourceCompressedSize = is_compressed ? C_TO_JAVA(resource->m_Count) : (C_TO_JAVA(0xffffffff));
+        entry->m_Flags = C_TO_JAVA(resource->m_Header->m_Flags | ENTRY_FLAG_LIVEUPDATE_DATA);
+    }
+
+    Result WriteResourcesToArchive(ArchiveIndexContainer* archive, const LiveUpdateResource* resources, const uint32_t* order, uint32_t count, EntryData* out_entries)
+    {
+        FILE* f = archive->m_LiveUpdateFileResourceData;
+        fseek(f, 0, SEEK_END);
+        uint32_t start_offset = (uint32_t)ftell(f);
+        uint32_t offset = start_offset;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const LiveUpdateResource* resource = &resources[order[i]];
+            size_t bytes = fwrite(resource->m_Data, 1, resource->m_Count, f);
+            if (bytes != resource->m_Count)
+            {
+                dmLogError("All bytes not written for resource, bytes written: %zu, resource size: %zu", bytes, resource->m_Count);
+                return RESULT_IO_ERROR;
+            }
+            SetLiveUpdateEntry(&out_entries[i], resource, offset);
+            offset += (uint32_t)bytes;
+        }
+
+        fflush(f); // make sure all writes flushed before mem-mapping below
+
+        // Remap once for the whole batch instead of once per resource
+        if (archive->m_LiveUpdateResourcesMemMapped)
+        {
+            void* temp_map = (void*)archive->m_LiveUpdateResourceData;
+            dmResource::UnmapFile(temp_map, start_offset);
+            temp_map = 0x0;
+            uint32_t map_size = 0;
+            dmResource::Result res = dmResource::MapFile(archive->m_LiveUpdateResourcePath, temp_map, map_size);
+            if (res != dmResource::RESULT_OK)
+            {
+                dmLogError("Failed to map liveupdate respource file, result = %i", res);
+                return RESULT_IO_ERROR;
+            }
+            archive->m_LiveUpdateResourceData = (uint8_t*)temp_map;
+            archive->m_LiveUpdateResourceSize = offset;
+        }
+
+        return RESULT_OK;
+    }
+
+    Result InsertResources(ArchiveIndexContainer* archive_container, const uint8_t* hash_digests, uint32_t hash_digest_len, const LiveUpdateResource* resources, uint32_t resource_count, Result* out_results, ArchiveIndex*& out_new_index)
     {
         out_new_index = 0x0;
 
-        int idx = -1;
-        Result index_result = GetInsertionIndex(archive_container, hash_digest, &idx);
-        if (index_result != RESULT_OK)
+        // Drop resources already in the index, then sort the rest on hash so they can be merged in a single pass
+        dmArray<uint32_t> order;
+        order.SetCapacity(resource_count);
+        for (uint32_t i = 0; i < resource_count; ++i)
         {
-            dmLogError("Could not calculate valid resource insertion index, resource probably already stored in index.");
-            return index_result;
+            if (FindEntry(archive_container, hash_digests + i * hash_digest_len, 0x0) == RESULT_OK)
+            {
+                out_results[i] = RESULT_ALREADY_STORED;
+            }
+            else
+            {
+                out_results[i] = RESULT_OK;
+                order.Push(i);
+            }
+        }
+        std::sort(order.Begin(), order.End(), HashDigestSorter(hash_digests, hash_digest_len));
+
+        // The same resource may be queued more than once within a batch, keep the first one
+        uint32_t insert_count = 0;
+        for (uint32_t i = 0; i < order.Size(); ++i)
+        {
+            if (insert_count > 0 && memcmp(hash_digests + order[i] * hash_digest_len, hash_digests + order[insert_count-1] * hash_digest_len, hash_digest_len) == 0)
+            {
+                out_results[order[i]] = RESULT_ALREADY_STORED;
+                continue;
+            }
+            order[insert_count++] = order[i];
+        }
+        order.SetSize(insert_count);
+
+        if (insert_count == 0)
+        {
+            return RESULT_ALREADY_STORED;
+        }
+
+        dmArray<EntryData> lu_entries;
+        lu_entries.SetCapacity(insert_count);
+        lu_entries.SetSize(insert_count);
+        Result write_result = WriteResourcesToArchive(archive_container, resources, order.Begin(), insert_count, lu_entries.Begin());
+        if (write_result != RESULT_OK)
+        {
+            for (uint32_t i = 0; i < insert_count; ++i)
+            {
+                out_results[order[i]] = write_result;
+            }
+            return write_result;
+        }
+
+        ArchiveIndex* ai = archive_container->m_ArchiveIndex;
+        uint32_t entry_count = JAVA_TO_C(ai->m_EntryDataCount);
+        const uint8_t* hashes = (archive_container->m_IsMemMapped) ? (uint8_t*)((uintptr_t)ai + JAVA_TO_C(ai->m_HashOffset)) : archive_container->m_Hashes;
+        const EntryData* entries = (archive_container->m_IsMemMapped) ? (EntryData*)((uintptr_t)ai + JAVA_TO_C(ai->m_EntryDataOffset)) : archive_container->m_Entries;
+
+        uint32_t new_entry_count = entry_count + insert_count;
+        uint32_t hash_digests_size = new_entry_count * DMRESOURCE_MAX_HASH;
+        uint32_t size_to_alloc = sizeof(ArchiveIndex) + hash_digests_size + new_entry_count * sizeof(EntryData);
+        ArchiveIndex* new_index = (ArchiveIndex*)new uint8_t[size_to_alloc];
+        memcpy(new_index, ai, sizeof(ArchiveIndex)); // copy header data
+        new_index->m_EntryDataCount = C_TO_JAVA(new_entry_count);
+        new_index->m_HashOffset = C_TO_JAVA((uint32_t)sizeof(ArchiveIndex));
+        new_index->m_EntryDataOffset = C_TO_JAVA((uint32_t)(sizeof(ArchiveIndex) + hash_digests_size));
+
+        uint8_t* new_hashes = (uint8_t*)((uintptr_t)new_index + sizeof(ArchiveIndex));
+        EntryData* new_entries = (EntryData*)((uintptr_t)new_hashes + hash_digests_size);
+
+        // Merge the sorted existing entries with the sorted new entries
+        uint32_t i = 0;
+        uint32_t j = 0;
+        for (uint32_t k = 0; k < new_entry_count; ++k)
+        {
+            const uint8_t* new_hash = (j < insert_count) ? hash_digests + order[j] * hash_digest_len : 0x0;
+            bool take_existing = new_hash == 0x0 || (i < entry_count && memcmp(hashes + i * DMRESOURCE_MAX_HASH, new_hash, hash_digest_len) < 0);
+            uint8_t* dst_hash = new_hashes + k * DMRESOURCE_MAX_HASH;
+            if (take_existing)
+            {
+                memcpy(dst_hash, hashes + i * DMRESOURCE_MAX_HASH, DMRESOURCE_MAX_HASH);
+                memcpy(&new_entries[k], &entries[i], sizeof(EntryData));
+                ++i;
+            }
+            else
+            {
+                memset(dst_hash, 0, DMRESOURCE_MAX_HASH);
+                memcpy(dst_hash, new_hash, hash_digest_len);
+                memcpy(&new_entries[k], &lu_entries[j], sizeof(EntryData));
+                ++j;
+            }
         }
 
+        out_new_index = new_index;
+        return RESULT_OK;
+    }
+
+    Result NewArchiveIndexWithResources(HArchiveIndexContainer archive_container, const uint8_t* hash_digests, uint32_t hash_digest_len, const dmResourceArchive::LiveUpdateResource* resources, uint32_t resource_count, const char* proj_id, HArchiveIndex& out_new_index, Result* out_results)
+    {
+        out_new_index = 0x0;
+
         char app_support_path[DMPATH_MAX_PATH];
         char lu_index_path[DMPATH_MAX_PATH];
         char lu_index_tmp_path[DMPATH_MAX_PATH];
@@ -670,50 +834,80 @@ namespace dmResourceArchive
         if (support_path_result != dmSys::RESULT_OK)
         {
             dmLogError("Failed get application support path for \"%s\", result = %i", proj_id, support_path_result);
+            for (uint32_t i = 0; i < resource_count; ++i)
+            {
+                out_results[i] = RESULT_NOT_FOUND;
+            }
             return RESULT_NOT_FOUND;
         }
         dmPath::Concat(app_support_path, "liveupdate.arci", lu_index_path, DMPATH_MAX_PATH);
         CreateFilesIfNotExists(archive_container, lu_index_path);
 
-        // Make deep-copy. Operate on this and only overwrite when done inserting
+        // Append all resource data and merge the new entries into a copy of the index.
+        // The copy is only swapped in once the batch is done
         ArchiveIndex* ai_temp = 0x0;
-        NewArchiveIndexFromCopy(ai_temp, archive_container, 1);
-
-        // Shift buffers and insert index- and resource data
-        Result insert_result = ShiftAndInsert(archive_container, ai_temp, hash_digest, hash_digest_len, idx, resource, 0x0);
-
+        Result insert_result = InsertResources(archive_container, hash_digests, hash_digest_len, resources, resource_count, out_results, ai_temp);
         if (insert_result != RESULT_OK)
         {
-            delete ai_temp;
-            dmLogError("Failed to insert resource, result = %i", insert_result);
             return insert_result;
         }
 
         // Write to temporary index file, filename liveupdate.arci.tmp
         dmStrlCpy(lu_index_tmp_path, lu_index_path, DMPATH_MAX_PATH);
         dmStrlCat(lu_index_tmp_path, ".tmp", DMPATH_MAX_PATH);
+        Result write_result = RESULT_OK;
         FILE* f_lu_index = fopen(lu_index_tmp_path, "wb");
         if (!f_lu_index)
         {
             dmLogError("Failed to create liveupdate index file");
-            return RESULT_IO_ERROR;
+            write_result = RESULT_IO_ERROR;
         }
-        uint32_t entry_count = JAVA_TO_C(ai_temp->m_EntryDataCount);
-        uint32_t total_size = sizeof(ArchiveIndex) + entry_count * DMRESOURCE_MAX_HASH + entry_count * sizeof(EntryData);
-        if (fwrite((void*)ai_temp, 1, total_size, f_lu_index) != total_size)
+        else
         {
+            uint32_t entry_count = JAVA_TO_C(ai_temp->m_EntryDataCount);
+            uint32_t total_size = sizeof(ArchiveIndex) + entry_count * DMRESOURCE_MAX_HASH + entry_count * sizeof(EntryData);
+            if (fwrite((void*)ai_temp, 1, total_size, f_lu_index) != total_size)
+            {
+                dmLogError("Failed to write liveupdate index file");
+                write_result = RESULT_IO_ERROR;
+            }
+            fflush(f_lu_index);
             fclose(f_lu_index);
-            dmLogError("Failed to write liveupdate index file");
-            return RESULT_IO_ERROR;
         }
-        fflush(f_lu_index);
-        fclose(f_lu_index);
+
+        if (write_result != RESULT_OK)
+        {
+            Delete(ai_temp);
+            for (uint32_t i = 0; i < resource_count; ++i)
+            {
+                if (out_results[i] == RESULT_OK)
+                {
+                    out_results[i] = write_result;
+                }
+            }
+            return write_result;
+        }
 
         // set result
         out_new_index = ai_temp;
         return RESULT_OK;
     }
 
+    Result NewArchiveIndexWithResource(HArchiveIndexContainer archive_container, const uint8_t* hash_digest, uint32_t hash_digest_len, const dmResourceArchive::LiveUpdateResource* resource, const char* proj_id, HArchiveIndex& out_new_index)
+    {
+        Result resource_result = RESULT_OK;
+        Result result = NewArchiveIndexWithResources(archive_container, hash_digest, hash_digest_len, resource, 1, proj_id, out_new_index, &resource_result);
+        if (resource_result == RESULT_ALREADY_STORED)
+        {
+            dmLogError("Could not calculate valid resource insertion index, resource probably already stored in index.");
+        }
+        else if (result != RESULT_OK)
+        {
+            dmLogError("Failed to insert resource, result = %i", result);
+        }
+        return result;
+    }
+
     void SetNewArchiveIndex(HArchiveIndexContainer archive_container, HArchiveIndex new_index, bool mem_mapped)
     {
         if (!archive_container->m_IsMemMapped)
@@ -724,17 +918,11 @@ namespace dmResourceArchive
         archive_container->m_ArchiveIndex = new_index;
         // Since we store data sequentially when doing the deep-copy we want to access it in that fashion
         archive_container->m_IsMemMapped = mem_mapped;
+        BuildLookupTable(archive_container);
     }
 
-    Result FindEntry(HArchiveIndexContainer archive, const uint8_t* hash, EntryData* entry)
+    static void GetHashesAndEntries(HArchiveIndexContainer archive, uint8_t*& hashes, EntryData*& entries)
     {
-        uint32_t entry_count = JAVA_TO_C(archive->m_ArchiveIndex->m_EntryDataCount);
-        uint32_t entry_offset = JAVA_TO_C(archive->m_ArchiveIndex->m_EntryDataOffset);
-        uint32_t hash_offset = JAVA_TO_C(archive->m_ArchiveIndex->m_HashOffset);
-        uint32_t hash_len = JAVA_TO_C(archive->m_ArchiveIndex->m_HashLength);
-        uint8_t* hashes = 0;
-        EntryData* entries = 0;
-
         // If archive is loaded from file use the member arrays for hashes and entries, otherwise read with mem offsets.
         if (!archive->m_IsMemMapped)
         {
@@ -743,31 +931,82 @@ namespace dmResourceArchive
         }
         else
         {
-            hashes = (uint8_t*)((uintptr_t)archive->m_ArchiveIndex + hash_offset);
-            entries = (EntryData*)((uintptr_t)archive->m_ArchiveIndex + entry_offset);
+            hashes = (uint8_t*)((uintptr_t)archive->m_ArchiveIndex + JAVA_TO_C(archive->m_ArchiveIndex->m_HashOffset));
+            entries = (EntryData*)((uintptr_t)archive->m_ArchiveIndex + JAVA_TO_C(archive->m_ArchiveIndex->m_EntryDataOffset));
+        }
+    }
+
+    static inline uint64_t GetLookupKey(const uint8_t* hash)
+    {
+        uint64_t key;
+        memcpy(&key, hash, sizeof(key));
+        return key;
+    }
+
+    void DeleteLookupTable(HArchiveIndexContainer archive)
+    {
+        delete archive->m_LookupTable;
+        archive->m_LookupTable = 0x0;
+    }
+
+    void BuildLookupTable(HArchiveIndexContainer archive)
+    {
+        DeleteLookupTable(archive);
+        if (!archive->m_UseLookupTable)
+        {
+            return;
+        }
+
+        uint32_t entry_count = JAVA_TO_C(archive->m_ArchiveIndex->m_EntryDataCount);
+        uint32_t hash_len = JAVA_TO_C(archive->m_ArchiveIndex->m_HashLength);
+        if (entry_count == 0 || hash_len < sizeof(uint64_t))
+        {
+            return;
+        }
+
+        uint8_t* hashes = 0;
+        EntryData* entries = 0;
+        GetHashesAndEntries(archive, hashes, entries);
+
+        ArchiveLookupTable* table = new ArchiveLookupTable;
+        table->SetCapacity((3 * entry_count) / 2 + 1, entry_count);
+        for (uint32_t i = 0; i < entry_count; ++i)
+        {
+            uint64_t key = GetLookupKey(hashes + DMRESOURCE_MAX_HASH * i);
+            uint32_t* index = table->Get(key);
+            if (index)
+            {
+                // Digests sharing the same prefix are resolved with a binary search
+                *index = LOOKUP_TABLE_AMBIGUOUS;
+            }
+            else
+            {
+                table->Put(key, i);
+            }
         }
+        archive->m_LookupTable = table;
+    }
 
+    void SetLookupTableEnabled(HArchiveIndexContainer archive, bool enabled)
+    {
+        archive->m_UseLookupTable = enabled;
+        BuildLookupTable(archive);
+    }
+
+    static int FindEntryIndex(const uint8_t* hashes, uint32_t entry_count, const uint8_t* hash, uint32_t hash_len)
+    {
         // Search for hash with binary search (entries are sorted on hash)
         int first = 0;
         int last = (int)entry_count-1;
         while (first <= last)
         {
             int mid = first + (last - first) / 2;
-            uint8_t* h = (hashes + DMRESOURCE_MAX_HASH * mid);
+            const uint8_t* h = (hashes + DMRESOURCE_MAX_HASH * mid);
 
             int cmp = memcmp(hash, h, hash_len);
             if (cmp == 0)
             {
-                if (entry != NULL)
-                {
-                    EntryData* e = &entries[mid];
-                    entry->m_ResourceDataOffset = JAVA_TO_C(e->m_ResourceDataOffset);
-                    entry->m_ResourceSize = JAVA_TO_C(e->m_ResourceSize);
-                    entry->m_ResourceCompressedSize = JAVA_TO_C(e->m_ResourceCompressedSize);
-                    entry->m_Flags = JAVA_TO_C(e->m_Flags);
-                }
-
-                return RESULT_OK;
+                return mid;
             }
             else if (cmp > 0)
             {
@@ -778,8 +1017,46 @@ namespace dmResourceArchive
                 last = mid-1;
             }
         }
+        return -1;
+    }
+
+    Result FindEntry(HArchiveIndexContainer archive, const uint8_t* hash, EntryData* entry)
+    {
+        uint32_t entry_count = JAVA_TO_C(archive->m_ArchiveIndex->m_EntryDataCount);
+        uint32_t hash_len = JAVA_TO_C(archive->m_ArchiveIndex->m_HashLength);
+        uint8_t* hashes = 0;
+        EntryData* entries = 0;
+        GetHashesAndEntries(archive, hashes, entries);
+
+        int index = -1;
+        uint32_t* lookup = archive->m_LookupTable ? archive->m_LookupTable->Get(GetLookupKey(hash)) : 0x0;
+        if (lookup && *lookup != LOOKUP_TABLE_AMBIGUOUS)
+        {
+            if (memcmp(hash, hashes + DMRESOURCE_MAX_HASH * *lookup, hash_len) == 0)
+            {
+                index = (int)*lookup;
+            }
+        }
+        else if (!archive->m_LookupTable || lookup)
+        {
+            index = FindEntryIndex(hashes, entry_count, hash, hash_len);
+        }
+
+        if (index < 0)
+        {
+            return RESULT_NOT_FOUND;
+        }
 
-        return RESULT_NOT_FOUND;
+        if (entry != NULL)
+        {
+            EntryData* e = &entries[index];
+            entry->m_ResourceDataOffset = JAVA_TO_C(e->m_ResourceDataOffset);
+            entry->m_ResourceSize = JAVA_TO_C(e->m_ResourceSize);
+            entry->m_ResourceCompressedSize = JAVA_TO_C(e->m_ResourceCompressedSize);
+            entry->m_Flags = JAVA_TO_C(e->m_Flags);
+        }
+
+        return RESULT_OK;
     }
 
     Result Read(HArchiveIndexContainer archive, EntryData* entry_data, void* buffer)
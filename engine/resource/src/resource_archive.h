@@ -125,6 +125,15 @@ namespace dmResourceArchive
      */
     Result FindEntry(HArchiveIndexContainer archive, const uint8_t* hash, EntryData* entry);
 
+    /**
+     * Enable or disable the hash prefix lookup table used by FindEntry. Disabled by default.
+     * The table costs memory and is rebuilt in O(N) every time the archive index changes,
+     * e.g. when liveupdate resources are stored, in exchange for faster lookups in large archives.
+     * @param archive archive index handle
+     * @param enabled true to build the lookup table, false to delete it and use binary search
+     */
+    void SetLookupTableEnabled(HArchiveIndexContainer archive, bool enabled);
+
     /**
      * Read resource
      * @param archive archive index handle
@@ -159,6 +168,22 @@ namespace dmResourceArchive
      */
     Result NewArchiveIndexWithResource(HArchiveIndexContainer archive, const uint8_t* hash_digest, uint32_t hash_digest_len, const dmResourceArchive::LiveUpdateResource* resource, const char* proj_id, HArchiveIndex& out_new_index);
 
+    /**
+     * Make a new archive index containing all given LiveUpdate resources. The resource data is appended to the
+     * liveupdate archive in one go and the new entries are merged into a copy of the existing archive index in a single pass.
+     * Resources already present in the archive index (or duplicated within the batch) are skipped and reported as RESULT_ALREADY_STORED
+     * @param archive archive container
+     * @param hash_digests hash digests of the resources, hash_digest_len bytes per resource
+     * @param hash_digest_len size in bytes of a single hash digest
+     * @param resources LiveUpdate resources to insert
+     * @param resource_count number of resources
+     * @param proj_id project id SHA
+     * @param out_new_index reference to HArchiveIndex that will cointain the new archive index (on success)
+     * @param out_results per resource result, resource_count entries
+     * @return RESULT_OK if at least one resource was inserted
+     */
+    Result NewArchiveIndexWithResources(HArchiveIndexContainer archive, const uint8_t* hash_digests, uint32_t hash_digest_len, const dmResourceArchive::LiveUpdateResource* resources, uint32_t resource_count, const char* proj_id, HArchiveIndex& out_new_index, Result* out_results);
+
     /**
      * Set new archive index in archive container. Replace existing archive index if set
      * @param archive archive container
@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include "resource_archive.h"
+#include <dlib/hashtable.h>
 #include <dlib/path.h>
 
 #define MD5_SIZE (16)
@@ -47,6 +48,11 @@ namespace dmResourceArchive
         uint8_t  m_ArchiveIndexMD5[MD5_SIZE];
     };
 
+    /// Maps the first 8 bytes of a hash digest to its entry index in the archive index.
+    /// Digests sharing the same 8 byte prefix map to LOOKUP_TABLE_AMBIGUOUS and are looked up with a binary search
+    typedef dmHashTable64<uint32_t> ArchiveLookupTable;
+    const static uint32_t LOOKUP_TABLE_AMBIGUOUS = 0xffffffff;
+
     struct ArchiveIndexContainer
     {
         ArchiveIndexContainer()
@@ -70,6 +76,11 @@ namespace dmResourceArchive
         uint8_t* m_LiveUpdateResourceData; // mem-mapped liveupdate.arcd
         uint32_t m_LiveUpdateResourceSize;
         FILE* m_LiveUpdateFileResourceData; // liveupdate.arcd file handle
+
+        /// Covers all entries in m_ArchiveIndex (bundled and liveupdate), rebuilt whenever the archive index changes.
+        /// Only built if m_UseLookupTable is set, see SetLookupTableEnabled
+        ArchiveLookupTable* m_LookupTable;
+        bool m_UseLookupTable;
     };
 
 	struct LiveUpdateEntries {
@@ -94,6 +105,10 @@ namespace dmResourceArchive
 
 	Result WriteResourceToArchive(ArchiveIndexContainer*& archive, const uint8_t* buf, uint32_t buf_len, uint32_t& bytes_written, uint32_t& offset);
 
+    Result WriteResourcesToArchive(ArchiveIndexContainer* archive, const LiveUpdateResource* resources, const uint32_t* order, uint32_t count, EntryData* out_entries);
+
+    Result InsertResources(ArchiveIndexContainer* archive_container, const uint8_t* hash_digests, uint32_t hash_digest_len, const LiveUpdateResource* resources, uint32_t resource_count, Result* out_results, ArchiveIndex*& out_new_index);
+
 	void NewArchiveIndexFromCopy(ArchiveIndex*& dst, ArchiveIndexContainer* src, uint32_t extra_entries_alloc);
 
     Result GetInsertionIndex(HArchiveIndexContainer archive, const uint8_t* hash_digest, int* index);
@@ -108,5 +123,9 @@ namespace dmResourceArchive
 
     void Delete(ArchiveIndex* archive);
 
+    void BuildLookupTable(ArchiveIndexContainer* archive);
+
+    void DeleteLookupTable(ArchiveIndexContainer* archive);
+
 }
 #endif // RESOURCE_ARCHIVE_PRIVATE_H
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include <dlib/uri.h>
 #include <dlib/time.h>
 #include <dlib/spinlock.h>
+#include <dlib/math.h>
 
 #include "block_allocator.h"
 #include "resource.h"
@@ -71,6 +72,10 @@ namespace dmResource
     // to each request item. The path cache is also syncronized with the same spinlock as the new preloader hints array.
     // The path cache is not touched by the UpdatePreloader code, we keep the internalized pointers in the item.
 
+    // Requests are allocated in blocks and path strings in pages as the preloader grows, so pointers to requests
+    // and internalized paths stay valid. The limits are set with NewFactoryParams::m_PreloaderMaxRequests and
+    // NewFactoryParams::m_PreloaderMaxPaths.
+
     // If max number of preload items is reached or the path cache is full new items added to the preloader will
     // be thrown away and can potentially cause synced loading of those resources.
 
@@ -83,7 +88,7 @@ namespace dmResource
         dmhash_t m_CanonicalPathHash;
     };
 
-    typedef int16_t TRequestIndex;
+    typedef int32_t TRequestIndex;
 
     struct PreloadRequest
     {
@@ -92,7 +97,7 @@ namespace dmResource
         TRequestIndex m_Parent;
         TRequestIndex m_FirstChild;
         TRequestIndex m_NextSibling;
-        uint16_t m_PendingChildCount;
+        uint32_t m_PendingChildCount;
 
         // Set once resources have started loading, they have a load request
         dmLoadQueue::HRequest m_LoadRequest;
@@ -124,18 +129,12 @@ namespace dmResource
     // the required size is something the sum of all children on each level down along
     // the largest branch.
 
-    typedef dmHashTable<dmhash_t, uint32_t> TPathHashTable;
+    typedef dmHashTable<dmhash_t, const char*> TPathHashTable;
     typedef dmHashTable<dmhash_t, bool> TPathInProgressTable;
 
-    static const uint32_t MAX_PRELOADER_REQUESTS         = 1024;
-    static const uint32_t PATH_IN_PROGRESS_TABLE_SIZE    = MAX_PRELOADER_REQUESTS / 3;
-    static const uint32_t PATH_IN_PROGRESS_CAPACITY      = MAX_PRELOADER_REQUESTS;
-    static const uint32_t PATH_IN_PROGRESS_HASHDATA_SIZE = (PATH_IN_PROGRESS_TABLE_SIZE * sizeof(uint32_t)) + (PATH_IN_PROGRESS_CAPACITY * sizeof(TPathInProgressTable::Entry));
-    static const uint32_t PATH_AVERAGE_LENGTH            = 40;
-    static const uint32_t MAX_PRELOADER_PATHS            = 1536;
-    static const uint32_t PATH_BUFFER_TABLE_SIZE         = 509;
-    static const uint32_t PATH_BUFFER_TABLE_CAPACITY     = MAX_PRELOADER_PATHS;
-    static const uint32_t PATH_BUFFER_HASHDATA_SIZE      = (PATH_BUFFER_TABLE_SIZE * sizeof(uint32_t)) + (PATH_BUFFER_TABLE_CAPACITY * sizeof(TPathHashTable::Entry));
+    static const uint32_t REQUEST_BLOCK_SIZE     = 256;
+    static const uint32_t PATH_PAGE_SIZE         = 16 * 1024;
+    static const uint32_t PATH_TABLE_MIN_SIZE    = 512;
 
     struct PendingHint
     {
@@ -145,35 +144,34 @@ namespace dmResource
 
     struct ResourcePreloader
     {
-        ResourcePreloader()
-            : m_InProgress(&m_PathInProgressData, PATH_IN_PROGRESS_TABLE_SIZE, PATH_IN_PROGRESS_CAPACITY)
-        {
-        }
         struct SyncedData
         {
             SyncedData()
-                : m_PathLookup(m_LookupData, PATH_BUFFER_TABLE_SIZE, PATH_BUFFER_TABLE_CAPACITY)
-                , m_PathDataUsed(0)
+                : m_PathPageUsed(0)
+                , m_MaxPaths(0)
+                , m_DroppedPaths(0)
             {
             }
             dmArray<PendingHint> m_NewHints;
             TPathHashTable m_PathLookup;
-            uint8_t m_LookupData[PATH_BUFFER_HASHDATA_SIZE];
-            char m_PathData[MAX_PRELOADER_PATHS * PATH_AVERAGE_LENGTH];
-            uint32_t m_PathDataUsed;
+            dmArray<char*> m_PathPages;
+            uint32_t m_PathPageUsed;
+            uint32_t m_MaxPaths;
+            // Number of paths that could not be internalized since the path limit was reached
+            uint32_t m_DroppedPaths;
         } m_SyncedData;
 
         dmSpinlock::lock_t m_SyncedDataSpinlock;
 
-        PreloadRequest m_Request[MAX_PRELOADER_REQUESTS];
+        // Blocks of REQUEST_BLOCK_SIZE requests, see GetRequest
+        dmArray<PreloadRequest*> m_RequestBlocks;
+        uint32_t m_MaxRequests;
 
         // list of free nodes
-        TRequestIndex m_Freelist[MAX_PRELOADER_REQUESTS];
-        uint32_t m_FreelistSize;
+        dmArray<TRequestIndex> m_Freelist;
         dmLoadQueue::HQueue m_LoadQueue;
         HFactory m_Factory;
         TPathInProgressTable m_InProgress;
-        uint8_t m_PathInProgressData[PATH_IN_PROGRESS_HASHDATA_SIZE];
 
         // used instead of dynamic allocs as far as it lasts.
         dmBlockAllocator::HContext m_BlockAllocator;
@@ -188,27 +186,82 @@ namespace dmResource
         TRequestIndex m_PersistResourceCount;
 
         dmArray<void*> m_PersistedResources;
+
+        // Instrumentation, see GetPreloaderStats
+        uint32_t m_PeakRequests;
+        uint32_t m_DroppedRequests;
+        uint64_t m_LoadQueueFullTime;
+        uint64_t m_StallTime;
     };
 
+    static inline PreloadRequest* GetRequest(ResourcePreloader* preloader, TRequestIndex index)
+    {
+        return &preloader->m_RequestBlocks[index / REQUEST_BLOCK_SIZE][index % REQUEST_BLOCK_SIZE];
+    }
+
+    static uint32_t GetRequestCount(ResourcePreloader* preloader)
+    {
+        return preloader->m_RequestBlocks.Size() * REQUEST_BLOCK_SIZE;
+    }
+
+    // Adds a new block of free requests, returns false if the max number of requests is reached
+    static bool GrowRequests(ResourcePreloader* preloader)
+    {
+        uint32_t count = GetRequestCount(preloader);
+        if (count >= preloader->m_MaxRequests)
+        {
+            return false;
+        }
+
+        if (preloader->m_RequestBlocks.Full())
+        {
+            preloader->m_RequestBlocks.OffsetCapacity(8);
+        }
+        preloader->m_RequestBlocks.Push(new PreloadRequest[REQUEST_BLOCK_SIZE]);
+
+        // Free list is popped from the back, hand out the lower indices first.
+        // The root is always allocated so index zero is never added to the free list
+        uint32_t new_count = count + REQUEST_BLOCK_SIZE;
+        preloader->m_Freelist.OffsetCapacity(REQUEST_BLOCK_SIZE);
+        for (uint32_t i = new_count - 1; i >= count && i > 0; --i)
+        {
+            preloader->m_Freelist.Push((TRequestIndex) i);
+        }
+
+        preloader->m_InProgress.SetCapacity(dmMath::Max(1u, new_count / 3), new_count);
+        return true;
+    }
+
     const char* InternalizePath(ResourcePreloader::SyncedData* preloader_synced_data, dmhash_t path_hash, const char* path, uint32_t path_len)
     {
-        uint32_t* path_lookup = preloader_synced_data->m_PathLookup.Get(path_hash);
+        const char** path_lookup = preloader_synced_data->m_PathLookup.Get(path_hash);
         if (path_lookup != 0x0)
         {
-            return &preloader_synced_data->m_PathData[*path_lookup];
+            return *path_lookup;
         }
         if (preloader_synced_data->m_PathLookup.Full())
         {
-            return 0x0;
+            uint32_t capacity = preloader_synced_data->m_PathLookup.Capacity();
+            if (capacity >= preloader_synced_data->m_MaxPaths)
+            {
+                return 0x0;
+            }
+            capacity = dmMath::Min(capacity * 2, preloader_synced_data->m_MaxPaths);
+            preloader_synced_data->m_PathLookup.SetCapacity(dmMath::Max(1u, capacity / 3), capacity);
         }
-        if (preloader_synced_data->m_PathDataUsed + path_len + 1 > sizeof(preloader_synced_data->m_PathData))
+        if (preloader_synced_data->m_PathPages.Empty() || preloader_synced_data->m_PathPageUsed + path_len + 1 > PATH_PAGE_SIZE)
         {
-            return 0x0;
+            if (preloader_synced_data->m_PathPages.Full())
+            {
+                preloader_synced_data->m_PathPages.OffsetCapacity(8);
+            }
+            preloader_synced_data->m_PathPages.Push((char*) malloc(PATH_PAGE_SIZE));
+            preloader_synced_data->m_PathPageUsed = 0;
         }
-        char* result = &preloader_synced_data->m_PathData[preloader_synced_data->m_PathDataUsed];
+        char* result = preloader_synced_data->m_PathPages.Back() + preloader_synced_data->m_PathPageUsed;
         dmStrlCpy(result, path, path_len + 1);
-        preloader_synced_data->m_PathLookup.Put(path_hash, preloader_synced_data->m_PathDataUsed);
-        preloader_synced_data->m_PathDataUsed += path_len + 1;
+        preloader_synced_data->m_PathLookup.Put(path_hash, result);
+        preloader_synced_data->m_PathPageUsed += path_len + 1;
         return result;
     }
 
@@ -265,12 +318,14 @@ namespace dmResource
             out_path_descriptor.m_InternalizedName = InternalizePath(&preloader->m_SyncedData, out_path_descriptor.m_NameHash, name, name_len);
             if (out_path_descriptor.m_InternalizedName == 0x0)
             {
+                ++preloader->m_SyncedData.m_DroppedPaths;
                 dmSpinlock::Unlock(&preloader->m_SyncedDataSpinlock);
                 return RESULT_OUT_OF_MEMORY;
             }
             out_path_descriptor.m_InternalizedCanonicalPath = InternalizePath(&preloader->m_SyncedData, out_path_descriptor.m_CanonicalPathHash, canonical_path, canonical_path_len);
             if (out_path_descriptor.m_InternalizedCanonicalPath == 0x0)
             {
+                ++preloader->m_SyncedData.m_DroppedPaths;
                 dmSpinlock::Unlock(&preloader->m_SyncedDataSpinlock);
                 return RESULT_OUT_OF_MEMORY;
             }
@@ -302,44 +357,50 @@ namespace dmResource
 
     static void PreloaderTreeInsert(ResourcePreloader* preloader, TRequestIndex index, TRequestIndex parent)
     {
-        PreloadRequest* reqs      = &preloader->m_Request[0];
-        reqs[index].m_NextSibling = reqs[parent].m_FirstChild;
-        reqs[index].m_Parent      = parent;
-        reqs[parent].m_FirstChild = index;
-        reqs[parent].m_PendingChildCount += 1;
+        PreloadRequest* req        = GetRequest(preloader, index);
+        PreloadRequest* parent_req = GetRequest(preloader, parent);
+        req->m_NextSibling         = parent_req->m_FirstChild;
+        req->m_Parent              = parent;
+        parent_req->m_FirstChild   = index;
+        parent_req->m_PendingChildCount += 1;
     }
 
     static void RemoveFromParentPendingCount(ResourcePreloader* preloader, PreloadRequest* req)
     {
         if (req->m_Parent != -1)
         {
-            assert(preloader->m_Request[req->m_Parent].m_PendingChildCount > 0);
-            preloader->m_Request[req->m_Parent].m_PendingChildCount -= 1;
+            assert(GetRequest(preloader, req->m_Parent)->m_PendingChildCount > 0);
+            GetRequest(preloader, req->m_Parent)->m_PendingChildCount -= 1;
         }
     }
 
     static Result PreloadPathDescriptor(HPreloader preloader, TRequestIndex parent, const PathDescriptor& path_descriptor)
     {
         // Quick deduplication, check if the child is already listed under the current parent
-        TRequestIndex child = preloader->m_Request[parent].m_FirstChild;
+        TRequestIndex child = GetRequest(preloader, parent)->m_FirstChild;
         while (child != -1)
         {
-            if (preloader->m_Request[child].m_PathDescriptor.m_NameHash == path_descriptor.m_NameHash)
+            if (GetRequest(preloader, child)->m_PathDescriptor.m_NameHash == path_descriptor.m_NameHash)
             {
                 return RESULT_ALREADY_REGISTERED;
             }
-            child = preloader->m_Request[child].m_NextSibling;
+            child = GetRequest(preloader, child)->m_NextSibling;
         }
 
-        if (!preloader->m_FreelistSize)
+        if (preloader->m_Freelist.Empty() && !GrowRequests(preloader))
         {
             // Preload queue is exhausted; this is not fatal, it just means the resource will be loaded
             // inside the main thread which may cause stuttering
+            ++preloader->m_DroppedRequests;
             return RESULT_OUT_OF_MEMORY;
         }
 
-        TRequestIndex new_req = preloader->m_Freelist[--preloader->m_FreelistSize];
-        PreloadRequest* req   = &preloader->m_Request[new_req];
+        TRequestIndex new_req = preloader->m_Freelist.Back();
+        preloader->m_Freelist.Pop();
+        PreloadRequest* req   = GetRequest(preloader, new_req);
+
+        uint32_t in_use = GetRequestCount(preloader) - preloader->m_Freelist.Size();
+        preloader->m_PeakRequests = dmMath::Max(preloader->m_PeakRequests, in_use);
         memset(req, 0, sizeof(PreloadRequest));
         req->m_PathDescriptor    = path_descriptor;
         req->m_FirstChild        = -1;
@@ -353,15 +414,15 @@ namespace dmResource
         TRequestIndex go_up = parent;
         while (go_up != -1)
         {
-            if (preloader->m_Request[go_up].m_PathDescriptor.m_CanonicalPathHash == path_descriptor.m_CanonicalPathHash)
+            if (GetRequest(preloader, go_up)->m_PathDescriptor.m_CanonicalPathHash == path_descriptor.m_CanonicalPathHash)
             {
                 req->m_LoadResult = RESULT_RESOURCE_LOOP_ERROR;
                 assert(parent != -1);
-                assert(preloader->m_Request[parent].m_PendingChildCount > 0);
-                preloader->m_Request[parent].m_PendingChildCount -= 1;
+                assert(GetRequest(preloader, parent)->m_PendingChildCount > 0);
+                GetRequest(preloader, parent)->m_PendingChildCount -= 1;
                 break;
             }
-            go_up = preloader->m_Request[go_up].m_Parent;
+            go_up = GetRequest(preloader, go_up)->m_Parent;
         }
         return RESULT_OK;
     }
@@ -404,12 +465,12 @@ namespace dmResource
     // Only supports removing the first child, which is all the preloader uses anyway.
     static void PreloaderRemoveLeaf(ResourcePreloader* preloader, TRequestIndex index)
     {
-        assert(preloader->m_FreelistSize < MAX_PRELOADER_REQUESTS);
+        assert(preloader->m_Freelist.Size() < GetRequestCount(preloader));
 
-        PreloadRequest* me = &preloader->m_Request[index];
+        PreloadRequest* me = GetRequest(preloader, index);
         assert(me->m_FirstChild == -1);
         assert(me->m_PendingChildCount == 0);
-        PreloadRequest* parent = &preloader->m_Request[me->m_Parent];
+        PreloadRequest* parent = GetRequest(preloader, me->m_Parent);
         assert(parent->m_FirstChild == index);
 
         if (me->m_Resource)
@@ -431,7 +492,7 @@ namespace dmResource
             RemoveFromParentPendingCount(preloader, me);
         }
 
-        preloader->m_Freelist[preloader->m_FreelistSize++] = index;
+        preloader->m_Freelist.Push(index);
     }
 
     static void RemoveChildren(ResourcePreloader* preloader, PreloadRequest* req)
@@ -446,13 +507,20 @@ namespace dmResource
     HPreloader NewPreloader(HFactory factory, const dmArray<const char*>& names)
     {
         ResourcePreloader* preloader = new ResourcePreloader();
-        // root is always allocated so we don't add index zero in the free list
-        for (uint32_t i = 0; i < MAX_PRELOADER_REQUESTS - 1; i++)
-        {
-            preloader->m_Freelist[i] = MAX_PRELOADER_REQUESTS - i - 1;
-        }
 
-        preloader->m_FreelistSize = MAX_PRELOADER_REQUESTS - 1;
+        uint32_t max_paths;
+        GetPreloaderLimits(factory, &preloader->m_MaxRequests, &max_paths);
+        preloader->m_MaxRequests = dmMath::Max(preloader->m_MaxRequests, 1u);
+        preloader->m_SyncedData.m_MaxPaths = dmMath::Max(max_paths, 2u);
+        uint32_t path_capacity = dmMath::Min(preloader->m_SyncedData.m_MaxPaths, PATH_TABLE_MIN_SIZE);
+        preloader->m_SyncedData.m_PathLookup.SetCapacity(dmMath::Max(1u, path_capacity / 3), path_capacity);
+
+        preloader->m_PeakRequests      = 1;
+        preloader->m_DroppedRequests   = 0;
+        preloader->m_LoadQueueFullTime = 0;
+        preloader->m_StallTime         = 0;
+
+        GrowRequests(preloader);
 
         preloader->m_Factory         = factory;
         preloader->m_LoadQueue       = dmLoadQueue::CreateQueue(factory);
@@ -462,7 +530,7 @@ namespace dmResource
         preloader->m_PersistedResources.SetCapacity(names.Size());
 
         // Insert root.
-        PreloadRequest* root = &preloader->m_Request[0];
+        PreloadRequest* root = GetRequest(preloader, 0);
         memset(root, 0x00, sizeof(PreloadRequest));
 
         root->m_LoadResult        = MakePathDescriptor(preloader, names[0], root->m_PathDescriptor);
@@ -472,7 +540,7 @@ namespace dmResource
         preloader->m_PersistResourceCount++;
 
         // Post create setup
-        preloader->m_PostCreateCallbacks.SetCapacity(MAX_PRELOADER_REQUESTS / 8);
+        preloader->m_PostCreateCallbacks.SetCapacity(REQUEST_BLOCK_SIZE / 2);
         preloader->m_LoadQueueFull           = false;
         preloader->m_CreateComplete          = false;
         preloader->m_PostCreateCallbackIndex = 0;
@@ -506,54 +574,11 @@ namespace dmResource
         return NewPreloader(factory, names);
     }
 
-    // CreateResource operation ends either with
-    //   1) Having created the resource and free:d all buffers => RESULT_OK + m_Resource
-    //   2) Having failed, (or created and destroyed), leaving => RESULT_SOME_ERROR + everything free:d
-    //
-    // If buffer is null it means to use the items internal buffer
-    static void CreateResource(HPreloader preloader, PreloadRequest* req, void* buffer, uint32_t buffer_size)
+    // Registers a resource that has been through the create step, either in CreateResource
+    // or on the load thread for types flagged with RESOURCE_TYPE_FLAGS_THREADED_CREATE
+    static void FinishCreateResource(HPreloader preloader, PreloadRequest* req, SResourceDescriptor& tmp_resource)
     {
-        assert(req->m_LoadResult == RESULT_PENDING);
-        assert(req->m_PendingChildCount == 0);
-
-        assert(req->m_PathDescriptor.m_ResourceType);
-
-        SResourceDescriptor tmp_resource;
-        memset(&tmp_resource, 0, sizeof(tmp_resource));
-
-        SResourceType* resource_type = req->m_PathDescriptor.m_ResourceType;
-
-        // We must call CreateFunction if Preload function has been called, so always do this even when an error has occured
-        tmp_resource.m_NameHash       = req->m_PathDescriptor.m_CanonicalPathHash;
-        tmp_resource.m_ReferenceCount = 1;
-        tmp_resource.m_ResourceType   = (void*)resource_type;
-
-        ResourceCreateParams params;
-        params.m_Factory     = preloader->m_Factory;
-        params.m_Context     = resource_type->m_Context;
-        params.m_PreloadData = req->m_PreloadData;
-        params.m_Resource    = &tmp_resource;
-        params.m_Filename    = req->m_PathDescriptor.m_InternalizedName;
-
-        if (!buffer)
-        {
-            assert(req->m_Buffer);
-            tmp_resource.m_ResourceSizeOnDisc = req->m_BufferSize;
-            params.m_Buffer                   = req->m_Buffer;
-            params.m_BufferSize               = req->m_BufferSize;
-            req->m_LoadResult                 = resource_type->m_CreateFunction(params);
-
-            dmBlockAllocator::Free(preloader->m_BlockAllocator, req->m_Buffer, req->m_BufferSize);
-
-            req->m_Buffer = 0;
-        }
-        else
-        {
-            tmp_resource.m_ResourceSizeOnDisc = buffer_size;
-            params.m_Buffer                   = buffer;
-            params.m_BufferSize               = buffer_size;
-            req->m_LoadResult                 = resource_type->m_CreateFunction(params);
-        }
+        SResourceType* resource_type = (SResourceType*)tmp_resource.m_ResourceType;
 
         if (req->m_LoadResult == RESULT_OK)
         {
@@ -561,7 +586,7 @@ namespace dmResource
             {
                 if (preloader->m_PostCreateCallbacks.Full())
                 {
-                    preloader->m_PostCreateCallbacks.OffsetCapacity(MAX_PRELOADER_REQUESTS / 8);
+                    preloader->m_PostCreateCallbacks.OffsetCapacity(REQUEST_BLOCK_SIZE / 2);
                 }
                 preloader->m_PostCreateCallbacks.SetSize(preloader->m_PostCreateCallbacks.Size() + 1);
                 ResourcePostCreateParamsInternal& ip = preloader->m_PostCreateCallbacks.Back();
@@ -664,6 +689,58 @@ namespace dmResource
         }
     }
 
+    // CreateResource operation ends either with
+    //   1) Having created the resource and free:d all buffers => RESULT_OK + m_Resource
+    //   2) Having failed, (or created and destroyed), leaving => RESULT_SOME_ERROR + everything free:d
+    //
+    // If buffer is null it means to use the items internal buffer
+    static void CreateResource(HPreloader preloader, PreloadRequest* req, void* buffer, uint32_t buffer_size)
+    {
+        assert(req->m_LoadResult == RESULT_PENDING);
+        assert(req->m_PendingChildCount == 0);
+
+        assert(req->m_PathDescriptor.m_ResourceType);
+
+        SResourceDescriptor tmp_resource;
+        memset(&tmp_resource, 0, sizeof(tmp_resource));
+
+        SResourceType* resource_type = req->m_PathDescriptor.m_ResourceType;
+
+        // We must call CreateFunction if Preload function has been called, so always do this even when an error has occured
+        tmp_resource.m_NameHash       = req->m_PathDescriptor.m_CanonicalPathHash;
+        tmp_resource.m_ReferenceCount = 1;
+        tmp_resource.m_ResourceType   = (void*)resource_type;
+
+        ResourceCreateParams params;
+        params.m_Factory     = preloader->m_Factory;
+        params.m_Context     = resource_type->m_Context;
+        params.m_PreloadData = req->m_PreloadData;
+        params.m_Resource    = &tmp_resource;
+        params.m_Filename    = req->m_PathDescriptor.m_InternalizedName;
+
+        if (!buffer)
+        {
+            assert(req->m_Buffer);
+            tmp_resource.m_ResourceSizeOnDisc = req->m_BufferSize;
+            params.m_Buffer                   = req->m_Buffer;
+            params.m_BufferSize               = req->m_BufferSize;
+            req->m_LoadResult                 = resource_type->m_CreateFunction(params);
+
+            dmBlockAllocator::Free(preloader->m_BlockAllocator, req->m_Buffer, req->m_BufferSize);
+
+            req->m_Buffer = 0;
+        }
+        else
+        {
+            tmp_resource.m_ResourceSizeOnDisc = buffer_size;
+            params.m_Buffer                   = buffer;
+            params.m_BufferSize               = buffer_size;
+            req->m_LoadResult                 = resource_type->m_CreateFunction(params);
+        }
+
+        FinishCreateResource(preloader, req, tmp_resource);
+    }
+
     // Try to create the resource of the parent if all the child requests has been
     // resolved. We continue up the parent chain until we find a parent where all
     // children are not resolved and we break
@@ -675,7 +752,7 @@ namespace dmResource
         {
             return false;
         }
-        PreloadRequest* parent_req = &preloader->m_Request[parent];
+        PreloadRequest* parent_req = GetRequest(preloader, parent);
         if (parent_req->m_PendingChildCount > 0)
         {
             return false;
@@ -722,8 +799,18 @@ namespace dmResource
         {
             if (req->m_LoadResult == RESULT_PENDING)
             {
-                // Create the resource using the loading buffer directly.
-                CreateResource(preloader, req, buffer, buffer_size);
+                if (load_result.m_CreateResult != RESULT_PENDING)
+                {
+                    // Already created by the load queue, only the registration is left
+                    req->m_LoadResult = load_result.m_CreateResult;
+                    load_result.m_Resource.m_NameHash = req->m_PathDescriptor.m_CanonicalPathHash;
+                    FinishCreateResource(preloader, req, load_result.m_Resource);
+                }
+                else
+                {
+                    // Create the resource using the loading buffer directly.
+                    CreateResource(preloader, req, buffer, buffer_size);
+                }
                 created_resource = true;
             }
             UnmarkPathInProgress(preloader, &req->m_PathDescriptor);
@@ -753,7 +840,7 @@ namespace dmResource
         DM_PROFILE(Resource, "PreloaderUpdateOneItem");
         while (index >= 0)
         {
-            PreloadRequest* req = &preloader->m_Request[index];
+            PreloadRequest* req = GetRequest(preloader, index);
             switch (req->m_LoadResult)
             {
                 case RESULT_PENDING:
@@ -807,7 +894,11 @@ namespace dmResource
             {
                 return false;
             }
-            preloader->m_LoadQueueFull = false;
+            if (preloader->m_LoadQueueFull)
+            {
+                preloader->m_LoadQueueFull = false;
+                preloader->m_StallTime += dmTime::GetTime() - preloader->m_LoadQueueFullTime;
+            }
 
             if (FinishLoad(preloader, req, res, buffer, buffer_size))
             {
@@ -859,6 +950,8 @@ namespace dmResource
         info.m_HintInfo.m_Parent    = index;
         info.m_Function             = req->m_PathDescriptor.m_ResourceType->m_PreloadFunction;
         info.m_Context              = req->m_PathDescriptor.m_ResourceType->m_Context;
+        info.m_HintInfo.m_HintCount = 0;
+        info.m_CreateType           = (req->m_PathDescriptor.m_ResourceType->m_Flags & RESOURCE_TYPE_FLAGS_THREADED_CREATE) ? req->m_PathDescriptor.m_ResourceType : 0;
 
         // If we can't add the request to the load queue it is because the queue is full
         // We will try again once we completed loading of an item via dmLoadQueue::EndLoad
@@ -868,7 +961,8 @@ namespace dmResource
             return true;
         }
 
-        preloader->m_LoadQueueFull = true;
+        preloader->m_LoadQueueFull     = true;
+        preloader->m_LoadQueueFullTime = dmTime::GetTime();
         return false;
     }
 
@@ -919,7 +1013,7 @@ namespace dmResource
 
         do
         {
-            Result root_result        = preloader->m_Request[0].m_LoadResult;
+            Result root_result        = GetRequest(preloader, 0)->m_LoadResult;
             Result post_create_result = RESULT_OK;
             if (preloader->m_PostCreateCallbackIndex < preloader->m_PostCreateCallbacks.Size())
             {
@@ -932,7 +1026,7 @@ namespace dmResource
                         // Just waiting for the post-create functions to complete
                         // If main result is RESULT_OK pick up any errors from
                         // post create function
-                        preloader->m_Request[0].m_LoadResult = post_create_result;
+                        GetRequest(preloader, 0)->m_LoadResult = post_create_result;
                     }
                     continue;
                 }
@@ -958,7 +1052,7 @@ namespace dmResource
                     {
                         if (!complete_callback(complete_callback_params))
                         {
-                            preloader->m_Request[0].m_LoadResult = RESULT_NOT_LOADED;
+                            GetRequest(preloader, 0)->m_LoadResult = RESULT_NOT_LOADED;
                         }
                         empty_runs = 0;
                         // We need to continue to do all post create functions
@@ -1021,8 +1115,16 @@ namespace dmResource
             dmLogWarning("Waiting for preloader to complete.");
         }
 
+        PreloaderStats stats;
+        GetPreloaderStats(preloader, &stats);
+        if (stats.m_DroppedRequests > 0)
+        {
+            dmLogWarning("The preloader dropped %u hints and loaded them on the main thread (peak %u requests, %u paths), tweak \"resource.preloader_max_requests\" and \"resource.preloader_max_paths\" in the config file.",
+                         stats.m_DroppedRequests, stats.m_PeakRequests, stats.m_Paths);
+        }
+
         // Release root and persisted resources
-        preloader->m_PersistedResources.Push(preloader->m_Request[0].m_Resource);
+        preloader->m_PersistedResources.Push(GetRequest(preloader, 0)->m_Resource);
         for (uint32_t i = 0; i < preloader->m_PersistedResources.Size(); ++i)
         {
             void* resource = preloader->m_PersistedResources[i];
@@ -1031,14 +1133,38 @@ namespace dmResource
             Release(preloader->m_Factory, resource);
         }
 
-        assert(preloader->m_FreelistSize == (MAX_PRELOADER_REQUESTS - 1));
+        assert(preloader->m_Freelist.Size() == (GetRequestCount(preloader) - 1));
         dmLoadQueue::DeleteQueue(preloader->m_LoadQueue);
 
+        for (uint32_t i = 0; i < preloader->m_RequestBlocks.Size(); ++i)
+        {
+            delete[] preloader->m_RequestBlocks[i];
+        }
+        for (uint32_t i = 0; i < preloader->m_SyncedData.m_PathPages.Size(); ++i)
+        {
+            free(preloader->m_SyncedData.m_PathPages[i]);
+        }
+
         dmBlockAllocator::DeleteContext(preloader->m_BlockAllocator);
 
         delete preloader;
     }
 
+    void GetPreloaderStats(HPreloader preloader, PreloaderStats* stats)
+    {
+        stats->m_Requests        = GetRequestCount(preloader) - preloader->m_Freelist.Size();
+        stats->m_PeakRequests    = preloader->m_PeakRequests;
+        stats->m_DroppedRequests = preloader->m_DroppedRequests;
+        stats->m_StallTime       = preloader->m_StallTime;
+        if (preloader->m_LoadQueueFull)
+        {
+            stats->m_StallTime += dmTime::GetTime() - preloader->m_LoadQueueFullTime;
+        }
+        DM_SPINLOCK_SCOPED_LOCK(preloader->m_SyncedDataSpinlock)
+        stats->m_Paths = preloader->m_SyncedData.m_PathLookup.Size();
+        stats->m_DroppedRequests += preloader->m_SyncedData.m_DroppedPaths;
+    }
+
     bool PreloadHint(HPreloadHintInfo info, const char* name)
     {
         if (!info || !name)
@@ -1063,6 +1189,7 @@ namespace dmResource
         PendingHint& hint     = preloader->m_SyncedData.m_NewHints.Back();
         hint.m_PathDescriptor = path_descriptor;
         hint.m_Parent         = info->m_Parent;
+        info->m_HintCount++;
 
         return true;
     }
@@ -44,6 +44,7 @@ namespace dmResource
         FResourcePostCreate m_PostCreateFunction;
         FResourceDestroy    m_DestroyFunction;
         FResourceRecreate   m_RecreateFunction;
+        uint32_t            m_Flags;
     };
 
     typedef dmArray<char> LoadBufferType;
@@ -62,6 +63,8 @@ namespace dmResource
     uint32_t GetCanonicalPathFromBase(const char* base_dir, const char* relative_dir, char* buf);
 
     SResourceType* FindResourceType(SResourceFactory* factory, const char* extension);
+    void GetPreloaderLimits(HFactory factory, uint32_t* max_requests, uint32_t* max_paths);
+
     uint32_t GetRefCount(HFactory factory, void* resource);
     uint32_t GetRefCount(HFactory factory, dmhash_t identifier);
 
@@ -93,6 +96,8 @@ namespace dmResource
     {
         HPreloader m_Preloader;
         int32_t m_Parent;
+        // Number of hints added by the preload function
+        uint32_t m_HintCount;
     };
 }
 
@@ -19,6 +19,8 @@
 #include <dlib/time.h>
 #include <dlib/message.h>
 #include <dlib/thread.h>
+#include <dlib/atomic.h>
+#include <dlib/math.h>
 #include <ddf/ddf.h>
 #include "resource_ddf.h"
 #include "../resource.h"
@@ -1323,6 +1325,249 @@ TEST_P(GetResourceTest, OverflowTestRecursive)
 }
 
 
+struct ThreadedCreateContext
+{
+    dmThread::Thread m_MainThread;
+    uint32_t         m_LeafCount;
+    uint32_t         m_CreateTime;
+    int32_atomic_t   m_OffMainThreadCount;
+};
+
+static dmResource::Result ThreadedCreateLeafCreate(const dmResource::ResourceCreateParams& params)
+{
+    ThreadedCreateContext* context = (ThreadedCreateContext*) params.m_Context;
+    if (dmThread::GetCurrentThread() != context->m_MainThread)
+    {
+        dmAtomicIncrement32(&context->m_OffMainThreadCount);
+    }
+
+    // Simulate decoding work
+    uint64_t start = dmTime::GetTime();
+    while (dmTime::GetTime() - start < context->m_CreateTime)
+    {
+    }
+
+    int* value = new int;
+    *value = (int) params.m_BufferSize;
+    params.m_Resource->m_Resource = value;
+    return dmResource::RESULT_OK;
+}
+
+static dmResource::Result ThreadedCreateLeafDestroy(const dmResource::ResourceDestroyParams& params)
+{
+    delete (int*) params.m_Resource->m_Resource;
+    return dmResource::RESULT_OK;
+}
+
+static dmResource::Result ThreadedCreateRootPreload(const dmResource::ResourcePreloadParams& params)
+{
+    ThreadedCreateContext* context = (ThreadedCreateContext*) params.m_Context;
+    for (uint32_t i = 0; i < context->m_LeafCount; ++i)
+    {
+        char name[64];
+        dmSnPrintf(name, sizeof(name), "/__threadedcreate%u__.tcleaf", i);
+        dmResource::PreloadHint(params.m_HintInfo, name);
+    }
+    return dmResource::RESULT_OK;
+}
+
+static dmResource::Result ThreadedCreateRootCreate(const dmResource::ResourceCreateParams& params)
+{
+    ThreadedCreateContext* context = (ThreadedCreateContext*) params.m_Context;
+    std::vector<int*>* leaves = new std::vector<int*>();
+    for (uint32_t i = 0; i < context->m_LeafCount; ++i)
+    {
+        char name[64];
+        dmSnPrintf(name, sizeof(name), "/__threadedcreate%u__.tcleaf", i);
+        int* leaf = 0;
+        dmResource::Result r = dmResource::Get(params.m_Factory, name, (void**) &leaf);
+        if (r != dmResource::RESULT_OK)
+        {
+            for (uint32_t j = 0; j < leaves->size(); ++j)
+                dmResource::Release(params.m_Factory, (*leaves)[j]);
+            delete leaves;
+            return r;
+        }
+        leaves->push_back(leaf);
+    }
+    params.m_Resource->m_Resource = leaves;
+    return dmResource::RESULT_OK;
+}
+
+static dmResource::Result ThreadedCreateRootDestroy(const dmResource::ResourceDestroyParams& params)
+{
+    std::vector<int*>* leaves = (std::vector<int*>*) params.m_Resource->m_Resource;
+    for (uint32_t i = 0; i < leaves->size(); ++i)
+        dmResource::Release(params.m_Factory, (*leaves)[i]);
+    delete leaves;
+    return dmResource::RESULT_OK;
+}
+
+static void WriteThreadedCreateFiles(uint32_t leaf_count)
+{
+    FILE* f = fopen("./__threadedcreate__.tcroot", "wb");
+    ASSERT_NE((FILE*) 0, f);
+    fprintf(f, "root");
+    fclose(f);
+    for (uint32_t i = 0; i < leaf_count; ++i)
+    {
+        char file_name[64];
+        dmSnPrintf(file_name, sizeof(file_name), "./__threadedcreate%u__.tcleaf", i);
+        f = fopen(file_name, "wb");
+        ASSERT_NE((FILE*) 0, f);
+        fprintf(f, "leaf%u", i);
+        fclose(f);
+    }
+}
+
+static void RemoveThreadedCreateFiles(uint32_t leaf_count)
+{
+    unlink("./__threadedcreate__.tcroot");
+    for (uint32_t i = 0; i < leaf_count; ++i)
+    {
+        char file_name[64];
+        dmSnPrintf(file_name, sizeof(file_name), "./__threadedcreate%u__.tcleaf", i);
+        unlink(file_name);
+    }
+}
+
+// Preloads a root resource with many leaves with an expensive create function and
+// returns the longest time spent in a single UpdatePreloader call
+static void PreloadThreadedCreate(ThreadedCreateContext* context, uint32_t type_flags, uint64_t* max_frame_time, uint64_t* total_time)
+{
+    dmResource::NewFactoryParams params;
+    params.m_MaxResources = context->m_LeafCount + 1;
+    dmResource::HFactory factory = dmResource::NewFactory(&params, ".");
+    ASSERT_NE((void*) 0, factory);
+
+    dmResource::Result e;
+    e = dmResource::RegisterType(factory, "tcroot", context, &ThreadedCreateRootPreload, &ThreadedCreateRootCreate, 0, &ThreadedCreateRootDestroy, 0);
+    ASSERT_EQ(dmResource::RESULT_OK, e);
+    e = dmResource::RegisterType(factory, "tcleaf", context, 0, &ThreadedCreateLeafCreate, 0, &ThreadedCreateLeafDestroy, 0);
+    ASSERT_EQ(dmResource::RESULT_OK, e);
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::SetTypeFlags(factory, "tcleaf", type_flags));
+
+    dmResource::HPreloader pr = dmResource::NewPreloader(factory, "/__threadedcreate__.tcroot");
+
+    *max_frame_time = 0;
+    uint64_t start = dmTime::GetTime();
+    dmResource::Result r;
+    do
+    {
+        uint64_t frame_start = dmTime::GetTime();
+        r = dmResource::UpdatePreloader(pr, 0, 0, 1000);
+        uint64_t frame_time = dmTime::GetTime() - frame_start;
+        *max_frame_time = dmMath::Max(*max_frame_time, frame_time);
+    } while (r == dmResource::RESULT_PENDING);
+    *total_time = dmTime::GetTime() - start;
+    ASSERT_EQ(dmResource::RESULT_OK, r);
+
+    dmResource::SResourceDescriptor descriptor;
+    e = dmResource::GetDescriptor(factory, "/__threadedcreate0__.tcleaf", &descriptor);
+    ASSERT_EQ(dmResource::RESULT_OK, e);
+    ASSERT_EQ(1u, descriptor.m_ReferenceCount);
+
+    dmResource::DeletePreloader(pr);
+    dmResource::DeleteFactory(factory);
+}
+
+TEST(ThreadedCreateTest, PreloadHitch)
+{
+    ThreadedCreateContext context;
+    context.m_MainThread         = dmThread::GetCurrentThread();
+    context.m_LeafCount          = 64;
+    context.m_CreateTime         = 2000;
+    context.m_OffMainThreadCount = 0;
+
+    WriteThreadedCreateFiles(context.m_LeafCount);
+
+    uint64_t main_max_frame, main_total;
+    PreloadThreadedCreate(&context, 0, &main_max_frame, &main_total);
+    ASSERT_EQ(0, context.m_OffMainThreadCount);
+
+    uint64_t threaded_max_frame, threaded_total;
+    PreloadThreadedCreate(&context, RESOURCE_TYPE_FLAGS_THREADED_CREATE, &threaded_max_frame, &threaded_total);
+#if !defined(__EMSCRIPTEN__)
+    ASSERT_EQ((int32_t) context.m_LeafCount, context.m_OffMainThreadCount);
+#endif
+
+    printf("Bench elapsed (%u leaves, %u us create): main thread create max frame %.3f ms total %.3f ms, threaded create max frame %.3f ms total %.3f ms\n",
+        context.m_LeafCount, context.m_CreateTime,
+        main_max_frame / 1000.0f, main_total / 1000.0f,
+        threaded_max_frame / 1000.0f, threaded_total / 1000.0f);
+
+    RemoveThreadedCreateFiles(context.m_LeafCount);
+}
+
+TEST(PreloaderLimitsTest, GrowAndDrop)
+{
+    ThreadedCreateContext context;
+    context.m_MainThread         = dmThread::GetCurrentThread();
+    context.m_LeafCount          = 600;
+    context.m_CreateTime         = 0;
+    context.m_OffMainThreadCount = 0;
+
+    WriteThreadedCreateFiles(context.m_LeafCount);
+
+    // The first limits fit the whole tree, the second only the first block of requests
+    // and the third only the paths of some of the leaves
+    const uint32_t max_requests[] = { 4096, 256, 4096 };
+    const uint32_t max_paths[] = { 8192, 8192, 256 };
+    for (uint32_t i = 0; i < sizeof(max_requests) / sizeof(max_requests[0]); ++i)
+    {
+        dmResource::NewFactoryParams params;
+        params.m_MaxResources = context.m_LeafCount + 1;
+        params.m_PreloaderMaxRequests = max_requests[i];
+        params.m_PreloaderMaxPaths = max_paths[i];
+        dmResource::HFactory factory = dmResource::NewFactory(&params, ".");
+        ASSERT_NE((void*) 0, factory);
+
+        dmResource::Result e;
+        e = dmResource::RegisterType(factory, "tcroot", &context, &ThreadedCreateRootPreload, &ThreadedCreateRootCreate, 0, &ThreadedCreateRootDestroy, 0);
+        ASSERT_EQ(dmResource::RESULT_OK, e);
+        e = dmResource::RegisterType(factory, "tcleaf", &context, 0, &ThreadedCreateLeafCreate, 0, &ThreadedCreateLeafDestroy, 0);
+        ASSERT_EQ(dmResource::RESULT_OK, e);
+
+        dmResource::HPreloader pr = dmResource::NewPreloader(factory, "/__threadedcreate__.tcroot");
+        dmResource::Result r;
+        do
+        {
+            r = dmResource::UpdatePreloader(pr, 0, 0, 10000);
+        } while (r == dmResource::RESULT_PENDING);
+        // Dropped hints are loaded synchronously when the root is created
+        ASSERT_EQ(dmResource::RESULT_OK, r);
+
+        dmResource::PreloaderStats stats;
+        dmResource::GetPreloaderStats(pr, &stats);
+        ASSERT_EQ(1u, stats.m_Requests);
+        ASSERT_GE(max_paths[i], stats.m_Paths);
+        if (max_paths[i] <= context.m_LeafCount)
+        {
+            // Hints whose paths don't fit are dropped before taking a request
+            ASSERT_LT(0u, stats.m_DroppedRequests);
+            ASSERT_EQ(context.m_LeafCount + 1, stats.m_PeakRequests + stats.m_DroppedRequests);
+        }
+        else if (max_requests[i] > context.m_LeafCount)
+        {
+            ASSERT_EQ(context.m_LeafCount + 1, stats.m_PeakRequests);
+            ASSERT_EQ(0u, stats.m_DroppedRequests);
+        }
+        else
+        {
+            ASSERT_EQ(max_requests[i], stats.m_PeakRequests);
+            ASSERT_EQ(context.m_LeafCount + 1 - max_requests[i], stats.m_DroppedRequests);
+        }
+        printf("Preloader stats (max %u requests, %u paths): peak %u, dropped %u, paths %u, stall %.3f ms\n", max_requests[i], max_paths[i],
+            stats.m_PeakRequests, stats.m_DroppedRequests, stats.m_Paths, stats.m_StallTime / 1000.0f);
+
+        dmResource::DeletePreloader(pr);
+        dmResource::DeleteFactory(factory);
+    }
+
+    RemoveThreadedCreateFiles(context.m_LeafCount);
+}
+
+
 TEST_F(ResourceTest, ManifestLoadDdfFail)
 {
     dmResource::Manifest* manifest = new dmResource::Manifest();
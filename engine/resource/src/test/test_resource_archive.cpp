@@ -11,6 +11,8 @@
 // specific language governing permissions and limitations under the License.
 
 #include <stdint.h>
+#include <stdlib.h>
+#include <dlib/time.h>
 #include "../resource.h"
 #include "../resource_private.h"
 #include "../resource_archive.h"
@@ -245,6 +247,294 @@ TEST(dmResourceArchive, ShiftInsertResource)
     FreeMutableIndexData((void*&)arci_copy);
 }
 
+TEST(dmResourceArchive, InsertResources)
+{
+    const char* resource_filename = "test_resource_liveupdate.arcd";
+    FILE* resource_file = fopen(resource_filename, "wb");
+    bool success = resource_file != 0x0;
+    ASSERT_EQ(success, true);
+
+    dmResourceArchive::LiveUpdateResourceHeader header;
+    dmResourceArchive::LiveUpdateResource resources[5];
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        resources[i].m_Header = &header;
+        resources[i].m_Data = (uint8_t*)content[i];
+        resources[i].m_Count = strlen(content[i]);
+    }
+    header.m_Flags = 0;
+    header.m_Size = 0;
+
+    // Unsorted batch, with one hash already in the archive and one duplicate within the batch
+    uint8_t hashes[5][20];
+    memcpy(hashes[0], sorted_last_hash, 20);
+    memcpy(hashes[1], sorted_first_hash, 20);
+    memcpy(hashes[2], content_hash[3], 20);
+    memcpy(hashes[3], sorted_middle_hash, 20);
+    memcpy(hashes[4], sorted_first_hash, 20);
+
+    dmResourceArchive::HArchiveIndexContainer archive = 0;
+    dmResourceArchive::Result result = dmResourceArchive::WrapArchiveBuffer((void*) RESOURCES_ARCI, RESOURCES_ARCD, resource_filename, 0x0, resource_file, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+    ASSERT_EQ(7U, dmResourceArchive::GetEntryCount(archive));
+
+    dmResourceArchive::Result results[5];
+    dmResourceArchive::ArchiveIndex* new_index = 0;
+    result = dmResourceArchive::InsertResources(archive, &hashes[0][0], 20, resources, 5, results, new_index);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, results[0]);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, results[1]);
+    ASSERT_EQ(dmResourceArchive::RESULT_ALREADY_STORED, results[2]);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, results[3]);
+    ASSERT_EQ(dmResourceArchive::RESULT_ALREADY_STORED, results[4]);
+
+    // The existing index is untouched until the new one is set
+    ASSERT_EQ(7U, dmResourceArchive::GetEntryCount(archive));
+    dmResourceArchive::SetNewArchiveIndex(archive, new_index, true);
+    ASSERT_EQ(10U, dmResourceArchive::GetEntryCount(archive));
+    ASSERT_EQ((uint32_t)(sizeof(dmResourceArchive::ArchiveIndex) + 10 * DMRESOURCE_MAX_HASH), dmResourceArchive::GetEntryDataOffset(archive));
+
+    dmResourceArchive::EntryData entry;
+    for (uint32_t i = 0; i < 7; ++i)
+    {
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, dmResourceArchive::FindEntry(archive, content_hash[i], 0x0));
+    }
+    const uint32_t inserted[] = { 0, 1, 3 };
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        result = dmResourceArchive::FindEntry(archive, hashes[inserted[i]], &entry);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        ASSERT_EQ(resources[inserted[i]].m_Count, entry.m_ResourceSize);
+        ASSERT_TRUE((entry.m_Flags & dmResourceArchive::ENTRY_FLAG_LIVEUPDATE_DATA) != 0);
+    }
+
+    // Only hashes in the archive index are reported as stored
+    results[0] = dmResourceArchive::RESULT_UNKNOWN;
+    result = dmResourceArchive::InsertResources(archive, &hashes[0][0], 20, resources, 1, results, new_index);
+    ASSERT_EQ(dmResourceArchive::RESULT_ALREADY_STORED, result);
+    ASSERT_EQ(dmResourceArchive::RESULT_ALREADY_STORED, results[0]);
+    ASSERT_EQ((dmResourceArchive::ArchiveIndex*)0, new_index);
+
+    dmResourceArchive::Delete(archive->m_ArchiveIndex);
+    dmResourceArchive::Delete(archive);
+}
+
+static void CreateRandomHashes(uint8_t* hashes, uint32_t count, uint32_t hash_len)
+{
+    for (uint32_t i = 0; i < count * hash_len; ++i)
+    {
+        hashes[i] = (uint8_t)(rand() & 0xff);
+    }
+}
+
+TEST(dmResourceArchive, InsertResourcesBenchmark)
+{
+    const uint32_t resource_count = 5000;
+    const char* resource_filename = "test_resource_liveupdate.arcd";
+
+    dmResourceArchive::LiveUpdateResourceHeader header;
+    header.m_Flags = 0;
+    header.m_Size = 0;
+    dmResourceArchive::LiveUpdateResource* resources = new dmResourceArchive::LiveUpdateResource[resource_count];
+    for (uint32_t i = 0; i < resource_count; ++i)
+    {
+        resources[i].m_Header = &header;
+        resources[i].m_Data = (uint8_t*)content[i % 7];
+        resources[i].m_Count = strlen(content[i % 7]);
+    }
+    uint8_t* hashes = new uint8_t[resource_count * 20];
+    srand(1234);
+    CreateRandomHashes(hashes, resource_count, 20);
+
+    // One resource at a time, copying and shifting the index for each resource
+    dmResourceArchive::HArchiveIndexContainer archive = 0;
+    FILE* resource_file = fopen(resource_filename, "wb");
+    ASSERT_TRUE(resource_file != 0x0);
+    dmResourceArchive::Result result = dmResourceArchive::WrapArchiveBuffer((void*) RESOURCES_ARCI, RESOURCES_ARCD, resource_filename, 0x0, resource_file, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < resource_count; ++i)
+    {
+        int index = -1;
+        dmResourceArchive::GetInsertionIndex(archive, hashes + i * 20, &index);
+        dmResourceArchive::ArchiveIndex* ai_temp = 0x0;
+        dmResourceArchive::NewArchiveIndexFromCopy(ai_temp, archive, 1);
+        result = dmResourceArchive::ShiftAndInsert(archive, ai_temp, hashes + i * 20, 20, index, &resources[i], 0x0);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        dmResourceArchive::ArchiveIndex* prev_index = (i > 0) ? archive->m_ArchiveIndex : 0x0;
+        dmResourceArchive::SetNewArchiveIndex(archive, ai_temp, true);
+        dmResourceArchive::Delete(prev_index);
+    }
+    uint64_t single_elapsed = dmTime::GetTime() - start;
+    ASSERT_EQ(7U + resource_count, dmResourceArchive::GetEntryCount(archive));
+    dmResourceArchive::Delete(archive->m_ArchiveIndex);
+    dmResourceArchive::Delete(archive);
+
+    // All resources in one batch
+    resource_file = fopen(resource_filename, "wb");
+    ASSERT_TRUE(resource_file != 0x0);
+    result = dmResourceArchive::WrapArchiveBuffer((void*) RESOURCES_ARCI, RESOURCES_ARCD, resource_filename, 0x0, resource_file, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+    dmResourceArchive::Result* results = new dmResourceArchive::Result[resource_count];
+    dmResourceArchive::ArchiveIndex* new_index = 0x0;
+    start = dmTime::GetTime();
+    result = dmResourceArchive::InsertResources(archive, hashes, 20, resources, resource_count, results, new_index);
+    uint64_t batch_elapsed = dmTime::GetTime() - start;
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+    dmResourceArchive::SetNewArchiveIndex(archive, new_index, true);
+    ASSERT_EQ(7U + resource_count, dmResourceArchive::GetEntryCount(archive));
+    for (uint32_t i = 0; i < resource_count; ++i)
+    {
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, results[i]);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, dmResourceArchive::FindEntry(archive, hashes + i * 20, 0x0));
+    }
+
+    printf("Bench elapsed (%u resources): single %.3f ms, batch %.3f ms\n", resource_count, single_elapsed / 1000.0, batch_elapsed / 1000.0);
+
+    dmResourceArchive::Delete(archive->m_ArchiveIndex);
+    dmResourceArchive::Delete(archive);
+    delete[] results;
+    delete[] hashes;
+    delete[] resources;
+}
+
+static int CompareArchiveHash(const void* a, const void* b)
+{
+    return memcmp(a, b, DMRESOURCE_MAX_HASH);
+}
+
+// Creates an archive index with entry_count random sorted hashes, the resource offset of each entry is set to its index.
+// Free with dmResourceArchive::Delete(ArchiveIndex*)
+static dmResourceArchive::ArchiveIndex* CreateRandomArchiveIndex(uint32_t entry_count)
+{
+    uint32_t hashes_size = entry_count * DMRESOURCE_MAX_HASH;
+    uint32_t size = sizeof(dmResourceArchive::ArchiveIndex) + hashes_size + entry_count * sizeof(dmResourceArchive::EntryData);
+    dmResourceArchive::ArchiveIndex* archive_index = (dmResourceArchive::ArchiveIndex*)new uint8_t[size];
+    memset(archive_index, 0, size);
+    archive_index->m_Version = C_TO_JAVA(dmResourceArchive::VERSION);
+    archive_index->m_EntryDataCount = C_TO_JAVA(entry_count);
+    archive_index->m_HashOffset = C_TO_JAVA((uint32_t)sizeof(dmResourceArchive::ArchiveIndex));
+    archive_index->m_EntryDataOffset = C_TO_JAVA((uint32_t)sizeof(dmResourceArchive::ArchiveIndex) + hashes_size);
+    archive_index->m_HashLength = C_TO_JAVA(20U);
+
+    uint8_t* hashes = (uint8_t*)((uintptr_t)archive_index + sizeof(dmResourceArchive::ArchiveIndex));
+    dmResourceArchive::EntryData* entries = (dmResourceArchive::EntryData*)((uintptr_t)hashes + hashes_size);
+    for (uint32_t i = 0; i < entry_count; ++i)
+    {
+        CreateRandomHashes(hashes + i * DMRESOURCE_MAX_HASH, 1, 20);
+    }
+    qsort(hashes, entry_count, DMRESOURCE_MAX_HASH, CompareArchiveHash);
+    for (uint32_t i = 0; i < entry_count; ++i)
+    {
+        entries[i].m_ResourceDataOffset = C_TO_JAVA(i);
+    }
+    return archive_index;
+}
+
+static void VerifyFindEntry(dmResourceArchive::HArchiveIndexContainer archive, const uint8_t* hashes, uint32_t entry_count)
+{
+    dmResourceArchive::EntryData entry;
+    for (uint32_t i = 0; i < entry_count; ++i)
+    {
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, dmResourceArchive::FindEntry(archive, hashes + i * DMRESOURCE_MAX_HASH, &entry));
+        ASSERT_EQ(i, entry.m_ResourceDataOffset);
+    }
+
+    // Same prefix as an existing digest but different tail
+    uint8_t missing_hash[20];
+    memcpy(missing_hash, hashes, 20);
+    missing_hash[19] ^= 0xff;
+    ASSERT_EQ(dmResourceArchive::RESULT_NOT_FOUND, dmResourceArchive::FindEntry(archive, missing_hash, &entry));
+    missing_hash[0] ^= 0xff;
+    ASSERT_EQ(dmResourceArchive::RESULT_NOT_FOUND, dmResourceArchive::FindEntry(archive, missing_hash, &entry));
+}
+
+TEST(dmResourceArchive, LookupTable)
+{
+    const uint32_t entry_count = 4096;
+    srand(4321);
+    dmResourceArchive::ArchiveIndex* archive_index = CreateRandomArchiveIndex(entry_count);
+    uint8_t* hashes = (uint8_t*)((uintptr_t)archive_index + sizeof(dmResourceArchive::ArchiveIndex));
+
+    // Let two neighbouring digests share the same 8 byte prefix
+    memcpy(hashes + 101 * DMRESOURCE_MAX_HASH, hashes + 100 * DMRESOURCE_MAX_HASH, 8);
+    memset(hashes + 101 * DMRESOURCE_MAX_HASH + 8, 0xff, 12);
+    ASSERT_LT(memcmp(hashes + 100 * DMRESOURCE_MAX_HASH, hashes + 101 * DMRESOURCE_MAX_HASH, 20), 0);
+    ASSERT_LT(memcmp(hashes + 101 * DMRESOURCE_MAX_HASH, hashes + 102 * DMRESOURCE_MAX_HASH, 20), 0);
+
+    dmResourceArchive::HArchiveIndexContainer archive = 0;
+    dmResourceArchive::Result result = dmResourceArchive::WrapArchiveBuffer((void*) archive_index, RESOURCES_ARCD, 0x0, 0x0, 0x0, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+    // The lookup table is opt-in
+    ASSERT_EQ((dmResourceArchive::ArchiveLookupTable*)0, archive->m_LookupTable);
+    VerifyFindEntry(archive, hashes, entry_count);
+
+    dmResourceArchive::SetLookupTableEnabled(archive, true);
+    ASSERT_NE((dmResourceArchive::ArchiveLookupTable*)0, archive->m_LookupTable);
+    ASSERT_EQ(dmResourceArchive::LOOKUP_TABLE_AMBIGUOUS, *archive->m_LookupTable->Get(*(uint64_t*)(hashes + 100 * DMRESOURCE_MAX_HASH)));
+
+    VerifyFindEntry(archive, hashes, entry_count);
+
+    // Index changes don't rebuild the table once it is disabled
+    dmResourceArchive::SetLookupTableEnabled(archive, false);
+    ASSERT_EQ((dmResourceArchive::ArchiveLookupTable*)0, archive->m_LookupTable);
+    dmResourceArchive::BuildLookupTable(archive);
+    ASSERT_EQ((dmResourceArchive::ArchiveLookupTable*)0, archive->m_LookupTable);
+    VerifyFindEntry(archive, hashes, entry_count);
+
+    dmResourceArchive::Delete(archive);
+    dmResourceArchive::Delete(archive_index);
+}
+
+TEST(dmResourceArchive, FindEntryBenchmark)
+{
+    const uint32_t entry_count = 65536;
+    const uint32_t lookup_count = 1000000;
+    srand(1234);
+    dmResourceArchive::ArchiveIndex* archive_index = CreateRandomArchiveIndex(entry_count);
+    const uint8_t* hashes = (uint8_t*)((uintptr_t)archive_index + sizeof(dmResourceArchive::ArchiveIndex));
+
+    uint32_t* lookups = new uint32_t[lookup_count];
+    for (uint32_t i = 0; i < lookup_count; ++i)
+    {
+        lookups[i] = (uint32_t)rand() % entry_count;
+    }
+
+    dmResourceArchive::HArchiveIndexContainer archive = 0;
+    dmResourceArchive::Result result = dmResourceArchive::WrapArchiveBuffer((void*) archive_index, RESOURCES_ARCD, 0x0, 0x0, 0x0, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+    dmResourceArchive::SetLookupTableEnabled(archive, true);
+
+    uint32_t found = 0;
+    dmResourceArchive::EntryData entry;
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < lookup_count; ++i)
+    {
+        found += dmResourceArchive::FindEntry(archive, hashes + lookups[i] * DMRESOURCE_MAX_HASH, &entry) == dmResourceArchive::RESULT_OK;
+    }
+    uint64_t table_elapsed = dmTime::GetTime() - start;
+    ASSERT_EQ(lookup_count, found);
+
+    dmResourceArchive::SetLookupTableEnabled(archive, false);
+    found = 0;
+    start = dmTime::GetTime();
+    for (uint32_t i = 0; i < lookup_count; ++i)
+    {
+        found += dmResourceArchive::FindEntry(archive, hashes + lookups[i] * DMRESOURCE_MAX_HASH, &entry) == dmResourceArchive::RESULT_OK;
+    }
+    uint64_t search_elapsed = dmTime::GetTime() - start;
+    ASSERT_EQ(lookup_count, found);
+
+    printf("Bench elapsed (%u lookups, %u entries): lookup table %.3f ms, binary search %.3f ms\n", lookup_count, entry_count, table_elapsed / 1000.0, search_elapsed / 1000.0);
+
+    dmResourceArchive::Delete(archive);
+    dmResourceArchive::Delete(archive_index);
+    delete[] lookups;
+}
+
 TEST(dmResourceArchive, NewArchiveIndexFromCopy)
 {
     uint32_t single_entry_offset = DMRESOURCE_MAX_HASH;
@@ -435,6 +435,69 @@ namespace dmRig
         return slerp(frac, Quat(data[i+0], data[i+1], data[i+2], data[i+3]), Quat(data[i+0+4], data[i+1+4], data[i+2+4], data[i+3+4]));
     }
 
+    static inline Vector3 DecodeVec3(const uint16_t* data, const float* range)
+    {
+        // range is min x, y, z followed by quantization step x, y, z
+        return Vector3(range[0] + data[0] * range[3], range[1] + data[1] * range[4], range[2] + data[2] * range[5]);
+    }
+
+    static inline Quat DecodeQuat(const uint16_t* data)
+    {
+        const float s = 1.0f / 32767.0f;
+        return normalize(Quat((int16_t)data[0] * s, (int16_t)data[1] * s, (int16_t)data[2] * s, (int16_t)data[3] * s));
+    }
+
+    static void ApplyCompressedTracks(const dmRigDDF::CompressedAnimationTracks* tracks, uint32_t sample, float fraction, dmArray<dmTransform::Transform>& pose, const dmArray<uint32_t>& track_idx_to_pose, float blend_weight)
+    {
+        uint32_t frame_count = tracks->m_FrameCount;
+        uint32_t stride = tracks->m_FrameStride;
+        const uint16_t* frame0 = 0x0;
+        const uint16_t* frame1 = 0x0;
+        if (frame_count > 0 && stride > 0)
+        {
+            uint32_t last = frame_count - 1;
+            frame0 = ((const uint16_t*)tracks->m_Frames.m_Data) + dmMath::Min(sample, last) * stride;
+            frame1 = ((const uint16_t*)tracks->m_Frames.m_Data) + dmMath::Min(sample + 1, last) * stride;
+        }
+
+        uint32_t channel_count = tracks->m_Channels.m_Count;
+        for (uint32_t ci = 0; ci < channel_count; ++ci)
+        {
+            const dmRigDDF::CompressedAnimationChannel* channel = &tracks->m_Channels[ci];
+            uint32_t bone_index = channel->m_BoneIndex;
+            if (bone_index >= track_idx_to_pose.Size()) {
+                continue;
+            }
+            if (!channel->m_Constant && frame0 == 0x0) {
+                continue;
+            }
+            dmTransform::Transform& transform = pose[track_idx_to_pose[bone_index]];
+            const float* values = channel->m_Values.m_Data;
+            uint32_t offset = channel->m_FrameOffset;
+            switch (channel->m_Type)
+            {
+            case dmRigDDF::COMPRESSED_CHANNEL_POSITION:
+                {
+                    Vector3 v = channel->m_Constant ? Vector3(values[0], values[1], values[2]) : lerp(fraction, DecodeVec3(frame0 + offset, values), DecodeVec3(frame1 + offset, values));
+                    transform.SetTranslation(lerp(blend_weight, transform.GetTranslation(), v));
+                }
+                break;
+            case dmRigDDF::COMPRESSED_CHANNEL_ROTATION:
+                {
+                    Quat q = channel->m_Constant ? Quat(values[0], values[1], values[2], values[3]) : slerp(fraction, DecodeQuat(frame0 + offset), DecodeQuat(frame1 + offset));
+                    transform.SetRotation(slerp(blend_weight, transform.GetRotation(), q));
+                }
+                break;
+            case dmRigDDF::COMPRESSED_CHANNEL_SCALE:
+                {
+                    Vector3 v = channel->m_Constant ? Vector3(values[0], values[1], values[2]) : lerp(fraction, DecodeVec3(frame0 + offset, values), DecodeVec3(frame1 + offset, values));
+                    transform.SetScale(lerp(blend_weight, transform.GetScale(), v));
+                }
+                break;
+            }
+        }
+    }
+
     static float CursorToTime(float cursor, float duration, bool backwards, bool once_pingpong)
     {
         float t = cursor;
@@ -524,6 +587,11 @@ namespace dmRig
         uint32_t rounded_sample = (uint32_t)(fraction + 0.5f);
         fraction -= sample;
         // Sample animation tracks
+        if (animation->m_CompressedTracks.m_Channels.m_Count > 0)
+        {
+            ApplyCompressedTracks(&animation->m_CompressedTracks, sample, fraction, pose, track_idx_to_pose, blend_weight);
+        }
+
         uint32_t track_count = animation->m_Tracks.m_Count;
         for (uint32_t ti = 0; ti < track_count; ++ti)
         {
@@ -60,6 +60,19 @@ static void DeleteRigAnimation(dmRigDDF::RigAnimation& anim)
         }
     }
 
+    for (uint32_t c = 0; c < anim.m_CompressedTracks.m_Channels.m_Count; ++c) {
+        dmRigDDF::CompressedAnimationChannel& channel = anim.m_CompressedTracks.m_Channels.m_Data[c];
+        if (channel.m_Values.m_Count) {
+            delete [] channel.m_Values.m_Data;
+        }
+    }
+    if (anim.m_CompressedTracks.m_Channels.m_Count) {
+        delete [] anim.m_CompressedTracks.m_Channels.m_Data;
+    }
+    if (anim.m_CompressedTracks.m_Frames.m_Count) {
+        delete [] anim.m_CompressedTracks.m_Frames.m_Data;
+    }
+
     if (anim.m_Tracks.m_Count) {
         delete [] anim.m_Tracks.m_Data;
     }
@@ -567,6 +580,9 @@ void SetUpSimpleRig(dmArray<dmRig::RigBone>& bind_pose, dmRigDDF::Skeleton* skel
         dmRigDDF::RigAnimation& anim8 = animation_set->m_Animations.m_Data[8];
         dmRigDDF::RigAnimation& anim9 = animation_set->m_Animations.m_Data[9];
         dmRigDDF::RigAnimation& anim10 = animation_set->m_Animations.m_Data[10];
+        for (uint32_t i = 0; i < animation_count; ++i) {
+            memset(&animation_set->m_Animations.m_Data[i].m_CompressedTracks, 0, sizeof(dmRigDDF::CompressedAnimationTracks));
+        }
         anim0.m_Id = dmHashString64("valid");
         anim0.m_Duration            = 3.0f;
         anim0.m_SampleRate          = 1.0f;
@@ -1000,6 +1016,116 @@ void SetUpSimpleRig(dmArray<dmRig::RigBone>& bind_pose, dmRigDDF::Skeleton* skel
         dmRig::FillBoneListArrays(*mesh_set, *animation_set, *skeleton, track_idx_to_pose, pose_idx_to_influence);
 }
 
+static uint32_t AddCompressedChannel(dmArray<dmRigDDF::CompressedAnimationChannel>& channels, uint32_t bone_index, dmRigDDF::CompressedChannelType type, const float* data, uint32_t count, uint32_t components, uint32_t frame_offset)
+{
+    if (count == 0) {
+        return frame_offset;
+    }
+    dmRigDDF::CompressedAnimationChannel channel;
+    memset(&channel, 0, sizeof(channel));
+    channel.m_BoneIndex = bone_index;
+    channel.m_Type = type;
+
+    uint32_t frame_count = count / components;
+    channel.m_Constant = true;
+    for (uint32_t i = 1; i < frame_count && channel.m_Constant; ++i) {
+        for (uint32_t c = 0; c < components; ++c) {
+            if (fabsf(data[i*components + c] - data[c]) > RIG_EPSILON_FLOAT) {
+                channel.m_Constant = false;
+                break;
+            }
+        }
+    }
+
+    if (channel.m_Constant) {
+        channel.m_Values.m_Data = new float[components];
+        channel.m_Values.m_Count = components;
+        memcpy(channel.m_Values.m_Data, data, components * sizeof(float));
+    } else if (type != dmRigDDF::COMPRESSED_CHANNEL_ROTATION) {
+        channel.m_Values.m_Data = new float[components * 2];
+        channel.m_Values.m_Count = components * 2;
+        for (uint32_t c = 0; c < components; ++c) {
+            float min = data[c];
+            float max = data[c];
+            for (uint32_t i = 1; i < frame_count; ++i) {
+                min = dmMath::Min(min, data[i*components + c]);
+                max = dmMath::Max(max, data[i*components + c]);
+            }
+            channel.m_Values.m_Data[c] = min;
+            channel.m_Values.m_Data[components + c] = (max - min) / 65535.0f;
+        }
+    }
+
+    if (!channel.m_Constant) {
+        channel.m_FrameOffset = frame_offset;
+        frame_offset += components;
+    }
+    if (channels.Full()) {
+        channels.OffsetCapacity(8);
+    }
+    channels.Push(channel);
+    return frame_offset;
+}
+
+// Test version of RigUtil.compressAnimation in bob, quantizes the bone tracks of src into dst.
+// The bob output itself is verified against the same sampling rules in AnimationSetBuilderTest.
+static void CompressAnimationTracks(const dmRigDDF::RigAnimation& src, dmRigDDF::RigAnimation& dst)
+{
+    dmArray<dmRigDDF::CompressedAnimationChannel> channels;
+    dmArray<const float*> sources;
+    uint32_t stride = 0;
+    uint32_t frame_count = 0;
+    for (uint32_t t = 0; t < src.m_Tracks.m_Count; ++t) {
+        const dmRigDDF::AnimationTrack& track = src.m_Tracks[t];
+        const float* data[] = {track.m_Positions.m_Data, track.m_Rotations.m_Data, track.m_Scale.m_Data};
+        const uint32_t counts[] = {track.m_Positions.m_Count, track.m_Rotations.m_Count, track.m_Scale.m_Count};
+        const uint32_t components[] = {3, 4, 3};
+        const dmRigDDF::CompressedChannelType types[] = {dmRigDDF::COMPRESSED_CHANNEL_POSITION, dmRigDDF::COMPRESSED_CHANNEL_ROTATION, dmRigDDF::COMPRESSED_CHANNEL_SCALE};
+        for (uint32_t i = 0; i < 3; ++i) {
+            uint32_t prev_size = channels.Size();
+            stride = AddCompressedChannel(channels, track.m_BoneIndex, types[i], data[i], counts[i], components[i], stride);
+            if (channels.Size() != prev_size) {
+                if (sources.Full()) {
+                    sources.OffsetCapacity(8);
+                }
+                sources.Push(data[i]);
+                frame_count = dmMath::Max(frame_count, counts[i] / components[i]);
+            }
+        }
+    }
+
+    dmRigDDF::CompressedAnimationTracks& compressed = dst.m_CompressedTracks;
+    memset(&compressed, 0, sizeof(compressed));
+    compressed.m_FrameCount = frame_count;
+    compressed.m_FrameStride = stride;
+    compressed.m_Channels.m_Data = new dmRigDDF::CompressedAnimationChannel[channels.Size()];
+    compressed.m_Channels.m_Count = channels.Size();
+    memcpy(compressed.m_Channels.m_Data, channels.Begin(), channels.Size() * sizeof(dmRigDDF::CompressedAnimationChannel));
+
+    uint16_t* frames = new uint16_t[frame_count * stride];
+    compressed.m_Frames.m_Data = (uint8_t*)frames;
+    compressed.m_Frames.m_Count = frame_count * stride * sizeof(uint16_t);
+    for (uint32_t c = 0; c < channels.Size(); ++c) {
+        const dmRigDDF::CompressedAnimationChannel& channel = channels[c];
+        if (channel.m_Constant) {
+            continue;
+        }
+        uint32_t components = channel.m_Type == dmRigDDF::COMPRESSED_CHANNEL_ROTATION ? 4 : 3;
+        for (uint32_t f = 0; f < frame_count; ++f) {
+            for (uint32_t i = 0; i < components; ++i) {
+                float v = sources[c][f*components + i];
+                uint16_t* out = &frames[f*stride + channel.m_FrameOffset + i];
+                if (channel.m_Type == dmRigDDF::COMPRESSED_CHANNEL_ROTATION) {
+                    *out = (uint16_t)(int16_t)dmMath::Clamp((int32_t)floorf(v * 32767.0f + 0.5f), -32767, 32767);
+                } else {
+                    float step = channel.m_Values[components + i];
+                    *out = step == 0.0f ? 0 : (uint16_t)dmMath::Clamp((int32_t)floorf((v - channel.m_Values[i]) / step + 0.5f), 0, 65535);
+                }
+            }
+        }
+    }
+}
+
 class RigContextTest : public jc_test_base_class
 {
 public:
@@ -1594,6 +1720,93 @@ TEST_F(RigInstanceTest, BlendRotation)
     ASSERT_VEC4(rot_2, pose[0].GetRotation());
 }
 
+// Compare a compressed (quantized, interleaved) animation against the
+// float tracks it was created from, within a tolerance.
+TEST_F(RigInstanceTest, CompressedAnimationAccuracy)
+{
+    const uint32_t samples = 32; // 1s at 30fps, +1 for t == duration, +1 duplicated last frame
+    dmRigDDF::AnimationSet* animation_set = new dmRigDDF::AnimationSet();
+    animation_set->m_Animations.m_Data = new dmRigDDF::RigAnimation[2];
+    animation_set->m_Animations.m_Count = 2;
+    animation_set->m_BoneList.m_Count = 0;
+    dmRigDDF::RigAnimation& anim = animation_set->m_Animations.m_Data[0];
+    dmRigDDF::RigAnimation& compressed_anim = animation_set->m_Animations.m_Data[1];
+    memset(&anim, 0, sizeof(anim));
+    memset(&compressed_anim, 0, sizeof(compressed_anim));
+    anim.m_Id = dmHashString64("float");
+    anim.m_Duration = 1.0f;
+    anim.m_SampleRate = 30.0f;
+    compressed_anim.m_Id = dmHashString64("compressed");
+    compressed_anim.m_Duration = 1.0f;
+    compressed_anim.m_SampleRate = 30.0f;
+
+    anim.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[2];
+    anim.m_Tracks.m_Count = 2;
+    for (uint32_t t = 0; t < 2; ++t) {
+        dmRigDDF::AnimationTrack& track = anim.m_Tracks[t];
+        track.m_BoneIndex = t;
+        track.m_Positions.m_Data = new float[samples*3];
+        track.m_Positions.m_Count = samples*3;
+        track.m_Rotations.m_Data = new float[samples*4];
+        track.m_Rotations.m_Count = samples*4;
+        track.m_Scale.m_Data = new float[samples*3];
+        track.m_Scale.m_Count = samples*3;
+        for (uint32_t i = 0; i < samples; ++i) {
+            float a = dmMath::Min(i, samples - 2) / 30.0f * 2.0f * (float)M_PI;
+            // Bone 0 has a constant scale, bone 1 a constant position
+            Vector3 position = t == 0 ? Vector3(100.0f * sinf(a), 50.0f * cosf(a), 0.0f) : Vector3(1.0f, 0.0f, 0.0f);
+            Vector3 scale = t == 0 ? Vector3(1.0f) : Vector3(1.0f + 0.5f * sinf(a), 1.0f, 1.0f);
+            Quat rotation = Quat::rotationZ(a * (t + 1));
+            memcpy(&track.m_Positions.m_Data[i*3], &position, sizeof(float)*3);
+            memcpy(&track.m_Rotations.m_Data[i*4], &rotation, sizeof(float)*4);
+            memcpy(&track.m_Scale.m_Data[i*3], &scale, sizeof(float)*3);
+        }
+    }
+    CompressAnimationTracks(anim, compressed_anim);
+
+    // Two constant channels, the rest are stored per frame at 16 bits per component
+    ASSERT_EQ(6u, compressed_anim.m_CompressedTracks.m_Channels.m_Count);
+    ASSERT_EQ(3u + 4u + 4u + 3u, compressed_anim.m_CompressedTracks.m_FrameStride);
+    uint32_t float_size = 2 * samples * (3 + 4 + 3) * sizeof(float);
+    ASSERT_LT(compressed_anim.m_CompressedTracks.m_Frames.m_Count, float_size / 2);
+
+    dmRig::HRigInstance instance = 0x0;
+    dmRig::InstanceCreateParams create_params = {0};
+    create_params.m_Context            = m_Context;
+    create_params.m_Instance           = &instance;
+    create_params.m_BindPose           = &m_BindPose;
+    create_params.m_Skeleton           = m_Skeleton;
+    create_params.m_MeshSet            = m_MeshSet;
+    create_params.m_AnimationSet       = animation_set;
+    create_params.m_TrackIdxToPose     = &m_TrackIdxToPose;
+    create_params.m_PoseIdxToInfluence = &m_PoseIdxToInfluence;
+    create_params.m_MeshId             = dmHashString64((const char*)"test");
+    create_params.m_DefaultAnimation   = dmHashString64((const char*)"");
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::InstanceCreate(create_params));
+
+    dmArray<dmTransform::Transform>& pose = *dmRig::GetPose(instance);
+    for (uint32_t i = 0; i < 64; ++i) {
+        float offset = i / 64.0f;
+        ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(instance, dmHashString64("float"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, offset, 1.0f));
+        ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 0.0f));
+        dmTransform::Transform expected[] = {pose[0], pose[1]};
+
+        ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(instance, dmHashString64("compressed"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, offset, 1.0f));
+        ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 0.0f));
+        for (uint32_t b = 0; b < 2; ++b) {
+            ASSERT_NEAR(0.0f, length(expected[b].GetTranslation() - pose[b].GetTranslation()), 0.01f);
+            ASSERT_NEAR(0.0f, length(expected[b].GetScale() - pose[b].GetScale()), 0.001f);
+            ASSERT_NEAR(1.0f, fabsf(dot(expected[b].GetRotation(), pose[b].GetRotation())), 0.0001f);
+        }
+    }
+
+    dmRig::InstanceDestroyParams destroy_params = {0};
+    destroy_params.m_Context = m_Context;
+    destroy_params.m_Instance = instance;
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::InstanceDestroy(destroy_params));
+    DeleteRigData(0x0, 0x0, animation_set);
+}
+
 TEST_F(RigInstanceTest, GetVertexCount)
 {
     ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
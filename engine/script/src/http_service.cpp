@@ -10,11 +10,13 @@
 // CONDITIONS OF ANY KIND, either express or implied. See the License for the
 // specific language governing permissions and limitations under the License.
 
+#include <assert.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <dlib/array.h>
 #include <dlib/dstrings.h>
+#include <dlib/hash.h>
 #include <dlib/thread.h>
 #include <dlib/time.h>
 #include <dlib/message.h>
@@ -32,12 +34,14 @@ namespace dmHttpService
 {
     #define HTTP_SOCKET_NAME "@http"
 
+    // Posted by a worker to the load balancer when it is done with a request
+    static const dmhash_t WORKER_IDLE_HASH = dmHashString64("__http_worker_idle");
+
     // The stack size was increased from 0x10000 to 0x20000 due to
     // a crash happening on older Android devices (< 4.3).
     // (Reason: Our HTTP service threads call getaddrinfo() which
     //  resulted in a writes outside the stack space inside libc.)
     const uint32_t THREAD_STACK_SIZE = 0x20000;
-    const uint32_t THREAD_COUNT = 4;
     const uint32_t DEFAULT_RESPONSE_BUFFER_SIZE = 64 * 1024;
     const uint32_t DEFAULT_HEADER_BUFFER_SIZE = 16 * 1024;
 
@@ -56,10 +60,27 @@ namespace dmHttpService
         dmArray<char>         m_Response;
         dmArray<char>         m_Headers;
         const HttpService*    m_Service;
+        uint32_t              m_Index;
+        // Host (scheme://host:port) of the last request dispatched to the worker
+        // and whether the worker is handling a request. Only accessed from the load balancer thread
+        uint32_t              m_LastHost;
+        bool                  m_Busy;
         bool                  m_CacheFlusher;
         volatile bool         m_Run;
     };
 
+    // Request waiting in the load balancer for an idle worker
+    struct QueuedRequest
+    {
+        dmMessage::URL        m_Sender;
+        dmMessage::URL        m_Receiver;
+        dmhash_t              m_Id;
+        uintptr_t             m_UserData;
+        void*                 m_Data;
+        uint32_t              m_DataSize;
+        uint32_t              m_Host;
+    };
+
     struct HttpService
     {
         HttpService()
@@ -67,14 +88,15 @@ namespace dmHttpService
             m_Balancer = 0;
             m_Socket = 0;
             m_HttpCache = 0;
-            m_LoadBalanceCount = 0;
+            m_QueueHead = 0;
             m_Run = false;
         }
         dmArray<Worker*>          m_Workers;
+        dmArray<QueuedRequest>    m_Queue;
+        uint32_t                  m_QueueHead;
         dmThread::Thread          m_Balancer;
         dmMessage::HSocket        m_Socket;
         dmHttpCache::HCache       m_HttpCache;
-        int                       m_LoadBalanceCount;
         volatile bool             m_Run;
     };
 
@@ -271,6 +293,11 @@ namespace dmHttpService
                 HandleRequest(worker, &message->m_Sender, request);
                 free((void*) request->m_Headers);
                 free((void*) request->m_Request);
+
+                dmMessage::URL url;
+                dmMessage::ResetURL(url);
+                url.m_Socket = worker->m_Service->m_Socket;
+                dmMessage::Post(0, &url, WORKER_IDLE_HASH, 0, 0, &worker->m_Index, sizeof(worker->m_Index), 0);
             }
             else if (message->m_Descriptor == (uintptr_t) dmHttpDDF::StopHttp::m_DDFDescriptor)
             {
@@ -298,14 +325,100 @@ namespace dmHttpService
         }
     }
 
+    static uint32_t HashHost(const dmHttpDDF::HttpRequest* request)
+    {
+        // NOTE: The url is still stored as an offset at this point, see HandleRequest
+        const char* url = (const char*) ((uintptr_t) request + (uintptr_t) request->m_Url);
+        const char* host = strstr(url, "://");
+        host = host ? host + 3 : url;
+        uint32_t len = (uint32_t) strcspn(host, "/?#");
+        return dmHashBuffer32(url, (uint32_t) (host - url) + len);
+    }
+
+    // Pick an idle worker, preferably one that already talks to the same host
+    // so that its connection can be reused
+    static Worker* SelectWorker(HttpService* service, uint32_t host)
+    {
+        Worker* best = 0;
+        uint32_t count = service->m_Workers.Size();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Worker* worker = service->m_Workers[i];
+            if (worker->m_Busy) {
+                continue;
+            }
+            if (worker->m_LastHost == host) {
+                return worker;
+            }
+            if (best == 0) {
+                best = worker;
+            }
+        }
+        return best;
+    }
+
+    // Hand queued requests, in order, to idle workers. A request is only posted to
+    // a worker once it is idle so that a slow request never holds up the ones queued
+    // after it while other workers are available.
+    static void DispatchQueue(HttpService* service)
+    {
+        dmArray<QueuedRequest>& queue = service->m_Queue;
+        while (service->m_QueueHead < queue.Size())
+        {
+            QueuedRequest& q = queue[service->m_QueueHead];
+            Worker* worker = SelectWorker(service, q.m_Host);
+            if (!worker) {
+                break;
+            }
+            worker->m_Busy = true;
+            worker->m_LastHost = q.m_Host;
+
+            dmMessage::URL r = q.m_Receiver;
+            r.m_Socket = worker->m_Socket;
+            dmMessage::Post(&q.m_Sender, &r, q.m_Id, q.m_UserData, (uintptr_t) dmHttpDDF::HttpRequest::m_DDFDescriptor, q.m_Data, q.m_DataSize, 0);
+            free(q.m_Data);
+            service->m_QueueHead++;
+        }
+
+        // Compact the queue once the dispatched requests make up the better part of it
+        uint32_t head = service->m_QueueHead;
+        if (head > 0 && head * 2 >= queue.Size()) {
+            uint32_t left = queue.Size() - head;
+            memmove(queue.Begin(), queue.Begin() + head, left * sizeof(QueuedRequest));
+            queue.SetSize(left);
+            service->m_QueueHead = 0;
+        }
+    }
+
     void LoadBalance(dmMessage::Message *message, void* user_ptr)
     {
         HttpService* service = (HttpService*) user_ptr;
         if (message->m_Descriptor == (uintptr_t) dmHttpDDF::StopHttp::m_DDFDescriptor) {
             service->m_Run = false;
+        } else if (message->m_Descriptor == 0 && message->m_Id == WORKER_IDLE_HASH) {
+            uint32_t index = *(uint32_t*) &message->m_Data[0];
+            service->m_Workers[index]->m_Busy = false;
+            DispatchQueue(service);
+        } else if (message->m_Descriptor == (uintptr_t) dmHttpDDF::HttpRequest::m_DDFDescriptor) {
+            dmArray<QueuedRequest>& queue = service->m_Queue;
+            if (queue.Full()) {
+                queue.OffsetCapacity(dmMath::Max(16U, queue.Capacity()));
+            }
+            QueuedRequest q;
+            q.m_Sender = message->m_Sender;
+            q.m_Receiver = message->m_Receiver;
+            q.m_Id = message->m_Id;
+            q.m_UserData = message->m_UserData;
+            q.m_Data = malloc(message->m_DataSize);
+            memcpy(q.m_Data, &message->m_Data[0], message->m_DataSize);
+            q.m_DataSize = message->m_DataSize;
+            q.m_Host = HashHost((const dmHttpDDF::HttpRequest*) &message->m_Data[0]);
+            queue.Push(q);
+            DispatchQueue(service);
         } else {
+            // Let the worker report unknown messages
             dmMessage::URL r = message->m_Receiver;
-            r.m_Socket = service->m_Workers[service->m_LoadBalanceCount % THREAD_COUNT]->m_Socket;
+            r.m_Socket = service->m_Workers[0]->m_Socket;
             dmMessage::Post(&message->m_Sender,
                             &r,
                             message->m_Id,
@@ -313,7 +426,6 @@ namespace dmHttpService
                             message->m_Descriptor,
                             message->m_Data,
                             message->m_DataSize, 0);
-            service->m_LoadBalanceCount++;
         }
     }
 
@@ -341,7 +453,7 @@ namespace dmHttpService
         }
     }
 
-    HHttpService New()
+    HHttpService New(const Params* params)
     {
         HttpService* service = new HttpService;
 
@@ -364,10 +476,13 @@ namespace dmHttpService
             dmLogWarning("Unable to locate application support path for \"%s\": (%d)", "defold", sys_result);
         }
 
+        assert(params->m_ThreadCount >= 1 && params->m_ThreadCount <= MAX_THREAD_COUNT);
+        uint32_t thread_count = params->m_ThreadCount;
+
         service->m_Run = true;
         dmMessage::NewSocket(HTTP_SOCKET_NAME, &service->m_Socket);
-        service->m_Workers.SetCapacity(THREAD_COUNT);
-        for (uint32_t i = 0; i < THREAD_COUNT; ++i)
+        service->m_Workers.SetCapacity(thread_count);
+        for (uint32_t i = 0; i < thread_count; ++i)
         {
             Worker* worker = new Worker();
             char tmp[128];
@@ -378,6 +493,9 @@ namespace dmHttpService
             worker->m_Request = 0;
             worker->m_Status = 0;
             worker->m_Service = service;
+            worker->m_Index = i;
+            worker->m_LastHost = 0;
+            worker->m_Busy = false;
             worker->m_CacheFlusher = i == 0;
             worker->m_Run = true;
             service->m_Workers.Push(worker);
@@ -402,12 +520,17 @@ namespace dmHttpService
         return http_service->m_Socket;
     }
 
+    uint32_t GetWorkerCount(HHttpService http_service)
+    {
+        return http_service->m_Workers.Size();
+    }
+
     void Delete(HHttpService http_service)
     {
         dmMessage::URL url;
         url.m_Socket = http_service->m_Socket;
         dmMessage::Post(0, &url, 0, 0, (uintptr_t) dmHttpDDF::StopHttp::m_DDFDescriptor, 0, 0, 0);
-        for (uint32_t i = 0; i < THREAD_COUNT; ++i)
+        for (uint32_t i = 0; i < http_service->m_Workers.Size(); ++i)
         {
             dmHttpService::Worker* worker = http_service->m_Workers[i];
             url.m_Socket = worker->m_Socket;
@@ -424,6 +547,13 @@ namespace dmHttpService
         }
         dmThread::Join(http_service->m_Balancer);
         dmMessage::DeleteSocket(http_service->m_Socket);
+        for (uint32_t i = http_service->m_QueueHead; i < http_service->m_Queue.Size(); ++i)
+        {
+            dmHttpDDF::HttpRequest* request = (dmHttpDDF::HttpRequest*) http_service->m_Queue[i].m_Data;
+            free((void*) request->m_Headers);
+            free((void*) request->m_Request);
+            free(request);
+        }
         dmHttpCache::Close(http_service->m_HttpCache);
         delete http_service;
     }
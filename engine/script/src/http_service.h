@@ -13,12 +13,44 @@
 #ifndef DM_HTTP_SERVICE
 #define DM_HTTP_SERVICE
 
+#include <stdint.h>
+#include <dlib/message.h>
+
 namespace dmHttpService
 {
     typedef struct HttpService* HHttpService;
 
-    HHttpService New();
+    const uint32_t DEFAULT_THREAD_COUNT = 4;
+    const uint32_t MAX_THREAD_COUNT = 32;
+
+    /**
+     * Parameters passed into #New when creating the http service
+     */
+    struct Params
+    {
+        /// Number of worker threads performing requests, 1 to MAX_THREAD_COUNT. Default DEFAULT_THREAD_COUNT
+        uint32_t m_ThreadCount;
+
+        Params()
+        {
+            m_ThreadCount = DEFAULT_THREAD_COUNT;
+        }
+    };
+
+    /**
+     * Create a new http service
+     * @param params parameters
+     * @return http service handle
+     */
+    HHttpService New(const Params* params);
     dmMessage::HSocket GetSocket(HHttpService http_service);
+
+    /**
+     * Get the number of worker threads performing requests
+     * @param http_service http service handle
+     * @return number of worker threads
+     */
+    uint32_t GetWorkerCount(HHttpService http_service);
     void Delete(HHttpService http_service);
 
 }  // namespace dmHttpService
@@ -235,6 +235,12 @@ namespace dmScript
         g_Timeout = timeout;
     }
 
+    // Used for unit test
+    uint32_t GetHttpWorkerCount()
+    {
+        return g_Service ? dmHttpService::GetWorkerCount(g_Service) : 0;
+    }
+
     static void HttpInitialize(HContext context)
     {
         lua_State* L = GetLuaState(context);
@@ -243,7 +249,16 @@ namespace dmScript
         int top = lua_gettop(L);
 
         if (g_Service == 0) {
-            g_Service = dmHttpService::New();
+            dmHttpService::Params params;
+            if (config_file) {
+                int32_t thread_count = dmConfigFile::GetInt(config_file, "network.http_thread_count", dmHttpService::DEFAULT_THREAD_COUNT);
+                params.m_ThreadCount = (uint32_t) dmMath::Clamp(thread_count, 1, (int32_t) dmHttpService::MAX_THREAD_COUNT);
+                if ((uint32_t) thread_count != params.m_ThreadCount)
+                {
+                    dmLogWarning("network.http_thread_count must be in the range 1 - %u and has been clamped to %u.", dmHttpService::MAX_THREAD_COUNT, params.m_ThreadCount);
+                }
+            }
+            g_Service = dmHttpService::New(&params);
             dmScript::RegisterDDFDecoder(dmHttpDDF::HttpResponse::m_DDFDescriptor, &HttpResponseDecoder);
         }
         g_ServiceRefCount++;
@@ -20,6 +20,8 @@ namespace dmScript
     void InitializeHttp(HContext context);
 
     void SetHttpRequestTimeout(uint64_t timeout);
+
+    uint32_t GetHttpWorkerCount();
 }
 
 #endif // DM_SCRIPT_HTTP_H
@@ -14,6 +14,7 @@
 #include "script_timer_private.h"
 
 #include <string.h>
+#include <algorithm>
 #include <dlib/index_pool.h>
 #include <dlib/hashtable.h>
 #include <dlib/profile.h>
@@ -37,14 +38,14 @@ namespace dmScript
      */
 
     /*
-        The timers are stored in a flat array with no holes which we scan sequenctially on each update.
+        The timers are stored in a flat array with no holes.
 
         When a timer is removed the last timer in the list may change location (EraseSwap).
 
-        This is to keep the array sweep fast and handle cases where multiple short lived timers are
-        created followed by one long-lived timer. If we did not re-shuffle and keep holes we would keep
-        scanning the array to the end where the only live timer exists skipping all the holes.
-        How much of an issue this is guesswork at this point.
+        The live timers are also kept in a binary min-heap keyed on the absolute time at which they
+        fire (the accumulated dt of the timer world). UpdateTimers only pops the timers that are due
+        so idle timers cost nothing per update. The timers that are due in an update are triggered in
+        the order they were added, regardless of their fire times.
 
         The timer identity is an index into an indirection layer combined with a generation counter,
         this makes it possible to reuse the index for the indirection layer without risk of using
@@ -64,22 +65,42 @@ namespace dmScript
         uintptr_t       m_Owner;
         uintptr_t       m_UserData;
 
+        // The time (in timer world time) when the timer fires
+        double          m_FireTime;
+
         // Store complete timer handle with generation here to identify stale timer handles
         HTimer          m_Handle;
 
-        // How much time remaining until the timer fires
-        float           m_Remaining;
-
         // The timer delay, we need to keep this for repeating timers
         float           m_Delay;
 
+        // Position in the TimerWorld::m_Heap, INVALID_TIMER_HEAP_INDEX if not scheduled
+        uint32_t        m_HeapIndex;
+
+        // The order the timer was added in, see TimerWorld::m_Sequence
+        uint32_t        m_Sequence;
+
         // Flag if the timer should repeat
         uint32_t        m_Repeat : 1;
         // Flag if the timer is alive
         uint32_t        m_IsAlive : 1;
     };
 
+    struct TimerHeapEntry
+    {
+        double          m_FireTime;
+        uint32_t        m_Sequence;
+        uint16_t        m_LookupIndex;
+    };
+
+    struct TriggeredTimer
+    {
+        HTimer          m_Handle;
+        uint32_t        m_Sequence;
+    };
+
     #define INVALID_TIMER_LOOKUP_INDEX  0xffffu
+    #define INVALID_TIMER_HEAP_INDEX    0xffffffffu
     #define INITIAL_TIMER_CAPACITY      8u
     #define MAX_TIMER_CAPACITY          65000u  // Needs to be less that 65535 since 65535 is reserved for invalid index
     #define TIMER_CAPACITY_GROWTH       16u
@@ -89,6 +110,11 @@ namespace dmScript
         dmArray<Timer>                      m_Timers;
         dmArray<uint16_t>                   m_IndexLookup;
         dmIndexPool<uint16_t>               m_IndexPool;
+        dmArray<TimerHeapEntry>             m_Heap;         // Scheduled timers, ordered on fire time
+        dmArray<TriggeredTimer>             m_Triggered;    // Timers that are due in the current update
+        dmArray<HTimer>                     m_Dead;         // Timers that died during the current update
+        double                              m_Time;         // Accumulated time of all updates
+        uint32_t                            m_Sequence;     // Incremented for each added timer, the order due timers are triggered in
         uint16_t                            m_Version;   // Incremented to avoid collisions each time we push timer indexes back to the m_IndexPool
         uint16_t                            m_InUpdate : 1;
     };
@@ -103,6 +129,140 @@ namespace dmScript
         return (((uint32_t)generation) << 16) | (lookup_index);
     }
 
+    static Timer* GetTimer(HTimerWorld timer_world, HTimer handle)
+    {
+        uint16_t lookup_index = GetLookupIndex(handle);
+        if (lookup_index >= timer_world->m_IndexLookup.Size())
+        {
+            return 0x0;
+        }
+
+        uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
+        if (timer_index >= timer_world->m_Timers.Size())
+        {
+            return 0x0;
+        }
+
+        Timer* timer = &timer_world->m_Timers[timer_index];
+        if (timer->m_Handle != handle)
+        {
+            return 0x0;
+        }
+        return timer;
+    }
+
+    static inline bool HeapLess(const TimerHeapEntry& a, const TimerHeapEntry& b)
+    {
+        return a.m_FireTime < b.m_FireTime || (a.m_FireTime == b.m_FireTime && a.m_Sequence < b.m_Sequence);
+    }
+
+    static inline void HeapSet(HTimerWorld timer_world, uint32_t heap_index, const TimerHeapEntry& entry)
+    {
+        timer_world->m_Heap[heap_index] = entry;
+        timer_world->m_Timers[timer_world->m_IndexLookup[entry.m_LookupIndex]].m_HeapIndex = heap_index;
+    }
+
+    static void HeapSiftUp(HTimerWorld timer_world, uint32_t heap_index)
+    {
+        dmArray<TimerHeapEntry>& heap = timer_world->m_Heap;
+        TimerHeapEntry entry = heap[heap_index];
+        while (heap_index > 0)
+        {
+            uint32_t parent = (heap_index - 1) / 2;
+            if (!HeapLess(entry, heap[parent]))
+            {
+                break;
+            }
+            HeapSet(timer_world, heap_index, heap[parent]);
+            heap_index = parent;
+        }
+        HeapSet(timer_world, heap_index, entry);
+    }
+
+    static void HeapSiftDown(HTimerWorld timer_world, uint32_t heap_index)
+    {
+        dmArray<TimerHeapEntry>& heap = timer_world->m_Heap;
+        uint32_t size = heap.Size();
+        TimerHeapEntry entry = heap[heap_index];
+        while (true)
+        {
+            uint32_t child = heap_index * 2 + 1;
+            if (child >= size)
+            {
+                break;
+            }
+            if (child + 1 < size && HeapLess(heap[child + 1], heap[child]))
+            {
+                ++child;
+            }
+            if (!HeapLess(heap[child], entry))
+            {
+                break;
+            }
+            HeapSet(timer_world, heap_index, heap[child]);
+            heap_index = child;
+        }
+        HeapSet(timer_world, heap_index, entry);
+    }
+
+    static void ScheduleTimer(HTimerWorld timer_world, Timer* timer)
+    {
+        assert(timer->m_HeapIndex == INVALID_TIMER_HEAP_INDEX);
+        TimerHeapEntry entry;
+        entry.m_FireTime = timer->m_FireTime;
+        entry.m_Sequence = timer->m_Sequence;
+        entry.m_LookupIndex = GetLookupIndex(timer->m_Handle);
+
+        // The heap never holds more entries than there are timers, see AllocateTimer
+        timer_world->m_Heap.Push(entry);
+        HeapSiftUp(timer_world, timer_world->m_Heap.Size() - 1);
+    }
+
+    static void UnscheduleTimer(HTimerWorld timer_world, Timer* timer)
+    {
+        uint32_t heap_index = timer->m_HeapIndex;
+        if (heap_index == INVALID_TIMER_HEAP_INDEX)
+        {
+            return;
+        }
+        timer->m_HeapIndex = INVALID_TIMER_HEAP_INDEX;
+
+        dmArray<TimerHeapEntry>& heap = timer_world->m_Heap;
+        TimerHeapEntry last = heap.Back();
+        heap.Pop();
+        if (heap_index < heap.Size())
+        {
+            heap[heap_index] = last;
+            HeapSiftUp(timer_world, heap_index);
+            HeapSiftDown(timer_world, timer_world->m_Timers[timer_world->m_IndexLookup[last.m_LookupIndex]].m_HeapIndex);
+        }
+    }
+
+    static void PushHandle(dmArray<HTimer>& handles, HTimer handle)
+    {
+        if (handles.Full())
+        {
+            handles.OffsetCapacity(dmMath::Max(handles.Capacity(), TIMER_CAPACITY_GROWTH));
+        }
+        handles.Push(handle);
+    }
+
+    static inline bool TriggeredLess(const TriggeredTimer& a, const TriggeredTimer& b)
+    {
+        return a.m_Sequence < b.m_Sequence;
+    }
+
+    // Marks a live timer as dead, it is freed directly or at the end of UpdateTimers
+    static void KillTimer(HTimerWorld timer_world, Timer* timer)
+    {
+        timer->m_IsAlive = 0;
+        UnscheduleTimer(timer_world, timer);
+        if (timer_world->m_InUpdate)
+        {
+            PushHandle(timer_world->m_Dead, timer->m_Handle);
+        }
+    }
+
     static Timer* AllocateTimer(HTimerWorld timer_world, uintptr_t owner)
     {
         assert(timer_world != 0x0);
@@ -130,12 +290,14 @@ namespace dmScript
             uint32_t capacity = timer_world->m_Timers.Capacity();
             capacity = dmMath::Min(capacity + TIMER_CAPACITY_GROWTH, MAX_TIMER_CAPACITY);
             timer_world->m_Timers.SetCapacity(capacity);
+            timer_world->m_Heap.SetCapacity(capacity);
         }
 
         timer_world->m_Timers.SetSize(timer_count + 1);
         Timer& timer = timer_world->m_Timers[timer_count];
         timer.m_Handle = handle;
         timer.m_Owner = owner;
+        timer.m_HeapIndex = INVALID_TIMER_HEAP_INDEX;
 
         uint16_t lookup_index = GetLookupIndex(handle);
 
@@ -160,6 +322,7 @@ namespace dmScript
     {
         assert(timer_world != 0x0);
         assert(timer.m_IsAlive == 0);
+        assert(timer.m_HeapIndex == INVALID_TIMER_HEAP_INDEX);
 
         uint16_t lookup_index = GetLookupIndex(timer.m_Handle);
         uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
@@ -172,10 +335,13 @@ namespace dmScript
     {
         TimerWorld* timer_world = new TimerWorld();
         timer_world->m_Timers.SetCapacity(INITIAL_TIMER_CAPACITY);
+        timer_world->m_Heap.SetCapacity(INITIAL_TIMER_CAPACITY);
         timer_world->m_IndexLookup.SetCapacity(INITIAL_TIMER_CAPACITY);
         timer_world->m_IndexLookup.SetSize(INITIAL_TIMER_CAPACITY);
         memset(&timer_world->m_IndexLookup[0], 0u, INITIAL_TIMER_CAPACITY * sizeof(uint16_t));
         timer_world->m_IndexPool.SetCapacity(INITIAL_TIMER_CAPACITY);
+        timer_world->m_Time = 0.0;
+        timer_world->m_Sequence = 0;
         timer_world->m_Version = 0;
         timer_world->m_InUpdate = 0;
         return timer_world;
@@ -193,34 +359,53 @@ namespace dmScript
         DM_PROFILE(TimerWorld, "Update");
 
         timer_world->m_InUpdate = 1;
+        timer_world->m_Time += dt;
+        const double time = timer_world->m_Time;
 
-        // We only scan timers for trigger if the timer *existed at entry to UpdateTimers*, any timers added
-        // in a trigger callback will always be added at the end of m_Timers and not triggered in this scope.
-        uint32_t size = timer_world->m_Timers.Size();
-        DM_COUNTER("timerc", size);
+        DM_COUNTER("timerc", timer_world->m_Timers.Size());
 
-        for (uint32_t i = 0; i < size; ++i)
+        // We only trigger timers that are due *at entry to UpdateTimers*, any timers added or rescheduled
+        // in a trigger callback will not be triggered in this scope.
+        dmArray<TimerHeapEntry>& heap = timer_world->m_Heap;
+        dmArray<TriggeredTimer>& triggered = timer_world->m_Triggered;
+        triggered.SetSize(0);
+        while (!heap.Empty() && heap[0].m_FireTime <= time)
         {
-            Timer* timer = &timer_world->m_Timers[i];
-            if (timer->m_IsAlive == 0)
+            Timer* timer = &timer_world->m_Timers[timer_world->m_IndexLookup[heap[0].m_LookupIndex]];
+            if (triggered.Full())
             {
-                continue;
+                triggered.OffsetCapacity(dmMath::Max(triggered.Capacity(), TIMER_CAPACITY_GROWTH));
             }
+            TriggeredTimer triggered_timer;
+            triggered_timer.m_Handle = timer->m_Handle;
+            triggered_timer.m_Sequence = timer->m_Sequence;
+            triggered.Push(triggered_timer);
+            UnscheduleTimer(timer_world, timer);
+        }
 
-            timer->m_Remaining -= dt;
-            if (timer->m_Remaining > 0.0f)
+        // Keep the order the timers were added in, as when the callbacks were called in timer array order
+        std::sort(triggered.Begin(), triggered.End(), TriggeredLess);
+
+        uint32_t size = triggered.Size();
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            HTimer handle = triggered[i].m_Handle;
+            Timer* timer = GetTimer(timer_world, handle);
+            // The timer may have been cancelled by a previous callback in this update
+            if (timer == 0x0 || timer->m_IsAlive == 0)
             {
                 continue;
             }
 
-            float elapsed_time = timer->m_Delay - timer->m_Remaining;
+            float remaining = (float)(timer->m_FireTime - time);
+            float elapsed_time = timer->m_Delay - remaining;
 
             TimerEventType eventType = timer->m_Repeat == 0 ? TIMER_EVENT_TRIGGER_WILL_DIE : TIMER_EVENT_TRIGGER_WILL_REPEAT;
 
-            timer->m_Callback(timer_world, eventType, timer->m_Handle, elapsed_time, timer->m_Owner, timer->m_UserData);
+            timer->m_Callback(timer_world, eventType, handle, elapsed_time, timer->m_Owner, timer->m_UserData);
 
             // The array might have been reallocated here! So grab the pointer again...
-            timer = &timer_world->m_Timers[i];
+            timer = GetTimer(timer_world, handle);
 
             if (timer->m_IsAlive == 0)
             {
@@ -229,42 +414,38 @@ namespace dmScript
 
             if (timer->m_Repeat == 0)
             {
-                timer->m_IsAlive = 0;
+                KillTimer(timer_world, timer);
                 continue;
             }
 
             if (timer->m_Delay == 0.0f)
             {
-                timer->m_Remaining = 0.0f;
+                timer->m_FireTime = time;
+                ScheduleTimer(timer_world, timer);
                 continue;
             }
 
-            float wrapped_count = ((-timer->m_Remaining) / timer->m_Delay) + 1.f;
+            float wrapped_count = ((-remaining) / timer->m_Delay) + 1.f;
             float offset_to_next_trigger  = floor(wrapped_count) * timer->m_Delay;
-            timer->m_Remaining += offset_to_next_trigger;
-            assert(timer->m_Remaining >= 0.f);
+            remaining += offset_to_next_trigger;
+            assert(remaining >= 0.f);
+            timer->m_FireTime = time + remaining;
+            ScheduleTimer(timer_world, timer);
         }
 
         timer_world->m_InUpdate = 0;
 
-        size = timer_world->m_Timers.Size();
-        uint32_t original_size = size;
-        uint32_t i = 0;
-        while (i < size)
+        dmArray<HTimer>& dead = timer_world->m_Dead;
+        size = dead.Size();
+        for (uint32_t i = 0; i < size; ++i)
         {
-            Timer& timer = timer_world->m_Timers[i];
-            if (timer.m_IsAlive == 0)
-            {
-                FreeTimer(timer_world, timer);
-                --size;
-            }
-            else
-            {
-                ++i;
-            }
+            Timer* timer = GetTimer(timer_world, dead[i]);
+            assert(timer != 0x0);
+            FreeTimer(timer_world, *timer);
         }
+        dead.SetSize(0);
 
-        if (size != original_size)
+        if (size != 0)
         {
             ++timer_world->m_Version;
         }
@@ -287,11 +468,13 @@ namespace dmScript
         }
 
         timer->m_Delay = delay;
-        timer->m_Remaining = delay;
+        timer->m_FireTime = timer_world->m_Time + delay;
         timer->m_UserData = userdata;
         timer->m_Callback = timer_callback;
         timer->m_Repeat = repeat;
         timer->m_IsAlive = 1;
+        timer->m_Sequence = timer_world->m_Sequence++;
+        ScheduleTimer(timer_world, timer);
 
         return timer->m_Handle;
     }
@@ -299,35 +482,25 @@ namespace dmScript
     bool CancelTimer(HTimerWorld timer_world, HTimer handle)
     {
         assert(timer_world != 0x0);
-        uint16_t lookup_index = GetLookupIndex(handle);
-        if (lookup_index >= timer_world->m_IndexLookup.Size())
-        {
-            return false;
-        }
-
-        uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
-        if (timer_index >= timer_world->m_Timers.Size())
-        {
-            return false;
-        }
-
-        Timer& timer = timer_world->m_Timers[timer_index];
-        if (timer.m_Handle != handle)
+        Timer* timer = GetTimer(timer_world, handle);
+        if (timer == 0x0)
         {
             return false;
         }
 
-        if (timer.m_IsAlive == 0)
+        if (timer->m_IsAlive == 0)
         {
             return false;
         }
 
-        timer.m_IsAlive = 0;
-        timer.m_Callback(timer_world, TIMER_EVENT_CANCELLED, timer.m_Handle, 0.f, timer.m_Owner, timer.m_UserData);
+        KillTimer(timer_world, timer);
+        timer->m_Callback(timer_world, TIMER_EVENT_CANCELLED, timer->m_Handle, 0.f, timer->m_Owner, timer->m_UserData);
 
         if (timer_world->m_InUpdate == 0)
         {
-            FreeTimer(timer_world, timer);
+            // The callback might have added timers and reallocated the array
+            timer = GetTimer(timer_world, handle);
+            FreeTimer(timer_world, *timer);
             ++timer_world->m_Version;
         }
         return true;
@@ -351,7 +524,7 @@ namespace dmScript
 
             if (timer.m_IsAlive == 1)
             {
-                timer.m_IsAlive = 0;
+                KillTimer(timer_world, &timer);
                 ++cancelled_count;
             }
 
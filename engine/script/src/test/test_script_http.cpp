@@ -10,8 +10,12 @@
 // CONDITIONS OF ANY KIND, either express or implied. See the License for the
 // specific language governing permissions and limitations under the License.
 
+#include <stdlib.h>
+
 #include "script.h"
-#include "script_http.h" // to set the timeout
+#include "script_http.h" // to set the timeout and read the worker count
+#include "http_service.h"
+#include "script/http_ddf.h"
 
 #include <dlib/configfile.h>
 #include <dlib/dstrings.h>
@@ -20,6 +24,9 @@
 #include <dlib/time.h>
 #include <dlib/socket.h>
 #include <dlib/dns.h>
+#include <dlib/http_server.h>
+#include <dlib/math.h>
+#include <dlib/message.h>
 #include <dlib/thread.h>
 #include <dlib/sys.h>
 
@@ -370,6 +377,169 @@ TEST_F(ScriptHttpTest, TestDeletedSocket)
     ASSERT_EQ(top, lua_gettop(L));
 }
 
+struct LocalHttpServer
+{
+    dmHttpServer::HServer m_Server;
+    dmThread::Thread      m_Thread;
+    uint16_t              m_Port;
+    uint32_t              m_Delay;
+    volatile bool         m_Run;
+};
+
+static void LocalHttpResponse(void* user_data, const dmHttpServer::Request* request)
+{
+    LocalHttpServer* server = (LocalHttpServer*) user_data;
+    if (server->m_Delay) {
+        dmTime::Sleep(server->m_Delay);
+    }
+    char buf[32];
+    dmSnPrintf(buf, sizeof(buf), "%d", server->m_Port);
+    dmHttpServer::Send(request, buf, strlen(buf));
+}
+
+static void LocalHttpServerLoop(void* arg)
+{
+    LocalHttpServer* server = (LocalHttpServer*) arg;
+    while (server->m_Run) {
+        dmHttpServer::Update(server->m_Server);
+        dmTime::Sleep(1000);
+    }
+}
+
+static void StartLocalHttpServer(LocalHttpServer* server, uint32_t delay)
+{
+    dmHttpServer::NewParams params;
+    params.m_Userdata = server;
+    params.m_HttpResponse = LocalHttpResponse;
+    ASSERT_EQ(dmHttpServer::RESULT_OK, dmHttpServer::New(&params, 0, &server->m_Server));
+    dmSocket::Address address;
+    dmHttpServer::GetName(server->m_Server, &address, &server->m_Port);
+    server->m_Delay = delay;
+    server->m_Run = true;
+    server->m_Thread = dmThread::New(LocalHttpServerLoop, 0x80000, server, "test_http");
+}
+
+static void StopLocalHttpServer(LocalHttpServer* server)
+{
+    server->m_Run = false;
+    dmThread::Join(server->m_Thread);
+    dmHttpServer::Delete(server->m_Server);
+}
+
+static void PostHttpRequest(dmHttpService::HHttpService service, const dmMessage::URL* sender, const char* url)
+{
+    const char* method = "GET";
+    uint32_t method_len = strlen(method);
+    uint32_t url_len = strlen(url);
+    char buf[sizeof(dmHttpDDF::HttpRequest) + 16 + 256];
+    char* string_buf = buf + sizeof(dmHttpDDF::HttpRequest);
+    dmStrlCpy(string_buf, method, method_len + 1);
+    dmStrlCpy(string_buf + method_len + 1, url, url_len + 1);
+
+    dmHttpDDF::HttpRequest* request = (dmHttpDDF::HttpRequest*) buf;
+    memset(request, 0, sizeof(*request));
+    request->m_Method = (const char*) (sizeof(*request));
+    request->m_Url = (const char*) (sizeof(*request) + method_len + 1);
+    request->m_Timeout = 5 * 1000000;
+
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(receiver);
+    receiver.m_Socket = dmHttpService::GetSocket(service);
+    uint32_t post_len = sizeof(dmHttpDDF::HttpRequest) + method_len + 1 + url_len + 1;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(sender, &receiver, dmHttpDDF::HttpRequest::m_DDFHash, 0, (uintptr_t) dmHttpDDF::HttpRequest::m_DDFDescriptor, buf, post_len, 0));
+}
+
+struct HttpServiceResponses
+{
+    dmArray<int> m_Ports;
+    int          m_Failed;
+};
+
+static void HttpServiceResponseCallback(dmMessage::Message* message, void* user_ptr)
+{
+    HttpServiceResponses* responses = (HttpServiceResponses*) user_ptr;
+    dmHttpDDF::HttpResponse* response = (dmHttpDDF::HttpResponse*) &message->m_Data[0];
+    char buf[32] = {0};
+    memcpy(buf, (const void*) response->m_Response, dmMath::Min((uint32_t) response->m_ResponseLength, (uint32_t) sizeof(buf) - 1));
+    if (response->m_Status != 200) {
+        responses->m_Failed++;
+    }
+    if (responses->m_Ports.Full()) {
+        responses->m_Ports.OffsetCapacity(16);
+    }
+    responses->m_Ports.Push(atoi(buf));
+}
+
+// A slow request must not hold up requests to other hosts queued behind it on the same worker
+TEST(dmHttpService, LeastLoadedDispatch)
+{
+    LocalHttpServer slow_server;
+    LocalHttpServer fast_server;
+    StartLocalHttpServer(&slow_server, 1000 * 1000);
+    StartLocalHttpServer(&fast_server, 0);
+
+    dmHttpService::Params params;
+    params.m_ThreadCount = 2;
+    dmHttpService::HHttpService service = dmHttpService::New(&params);
+
+    dmMessage::URL sender;
+    dmMessage::ResetURL(sender);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("http_service_test", &sender.m_Socket));
+
+    const uint32_t fast_count = 8;
+    char url[256];
+    dmSnPrintf(url, sizeof(url), "http://127.0.0.1:%d/slow", slow_server.m_Port);
+    PostHttpRequest(service, &sender, url);
+    dmSnPrintf(url, sizeof(url), "http://127.0.0.1:%d/fast", fast_server.m_Port);
+    for (uint32_t i = 0; i < fast_count; ++i) {
+        PostHttpRequest(service, &sender, url);
+    }
+
+    HttpServiceResponses responses;
+    responses.m_Failed = 0;
+    uint64_t start = dmTime::GetTime();
+    while (responses.m_Ports.Size() < fast_count + 1 && dmTime::GetTime() - start < 10 * 1000000) {
+        dmMessage::Dispatch(sender.m_Socket, HttpServiceResponseCallback, &responses);
+        dmTime::Sleep(1000);
+    }
+
+    ASSERT_EQ(fast_count + 1, responses.m_Ports.Size());
+    ASSERT_EQ(0, responses.m_Failed);
+    for (uint32_t i = 0; i < fast_count; ++i) {
+        ASSERT_EQ((int) fast_server.m_Port, responses.m_Ports[i]);
+    }
+    ASSERT_EQ((int) slow_server.m_Port, responses.m_Ports[fast_count]);
+
+    dmMessage::DeleteSocket(sender.m_Socket);
+    dmHttpService::Delete(service);
+    StopLocalHttpServer(&fast_server);
+    StopLocalHttpServer(&slow_server);
+}
+
+TEST(ScriptHttp, ThreadCountConfig)
+{
+    // Out of range values are clamped when the config is read, a negative value must not wrap to a huge count
+    const char* configs[] = {
+        "[network]\nhttp_thread_count = -1\n",
+        "[network]\nhttp_thread_count = 1000\n",
+        "[network]\nhttp_thread_count = 2\n",
+    };
+    const uint32_t expected_counts[] = {1, dmHttpService::MAX_THREAD_COUNT, 2};
+    for (uint32_t i = 0; i < sizeof(configs) / sizeof(configs[0]); ++i)
+    {
+        dmConfigFile::HConfig config_file;
+        ASSERT_EQ(dmConfigFile::RESULT_OK, dmConfigFile::LoadFromBuffer(configs[i], strlen(configs[i]), 0, 0, &config_file));
+        dmScript::HContext context = dmScript::NewContext(config_file, 0, true);
+        dmScript::Initialize(context);
+
+        ASSERT_EQ(expected_counts[i], dmScript::GetHttpWorkerCount());
+
+        dmScript::Finalize(context);
+        dmScript::DeleteContext(context);
+        dmConfigFile::Delete(config_file);
+    }
+}
+
 int main(int argc, char **argv)
 {
     dmSocket::Initialize();
@@ -15,6 +15,8 @@
 #include "../script.h"
 #include "../script_timer_private.h"
 
+#include <dlib/time.h>
+
 
 struct TimerTestCallback
 {
@@ -719,6 +721,103 @@ TEST_F(ScriptTimerTest, TestKillTimers)
     dmScript::DeleteTimerWorld(timer_world);
 }
 
+TEST_F(ScriptTimerTest, TestTriggerOrder)
+{
+    dmScript::HTimerWorld timer_world = dmScript::NewTimerWorld();
+
+    static uint32_t order[8];
+    static uint32_t order_count = 0;
+    order_count = 0;
+
+    struct Callback {
+        static void cb(dmScript::HTimerWorld timer_world, dmScript::TimerEventType event_type, dmScript::HTimer timer_handle, float time_elapsed, uintptr_t owner, uintptr_t userdata)
+        {
+            if (event_type == dmScript::TIMER_EVENT_CANCELLED)
+            {
+                return;
+            }
+            ASSERT_GT(8u, order_count);
+            order[order_count++] = (uint32_t)userdata;
+        }
+    };
+
+    // Timers that are due in the same update trigger in the order they were added
+    dmScript::AddTimer(timer_world, 3.f, false, Callback::cb, 0x10, 0);
+    dmScript::AddTimer(timer_world, 1.f, false, Callback::cb, 0x10, 1);
+    dmScript::HTimer cancelled = dmScript::AddTimer(timer_world, 1.f, false, Callback::cb, 0x10, 2);
+    dmScript::AddTimer(timer_world, 2.f, false, Callback::cb, 0x10, 3);
+    dmScript::AddTimer(timer_world, 1.f, false, Callback::cb, 0x10, 4);
+
+    ASSERT_TRUE(dmScript::CancelTimer(timer_world, cancelled));
+
+    dmScript::UpdateTimers(timer_world, 5.f);
+    ASSERT_EQ(4u, order_count);
+    ASSERT_EQ(0u, order[0]);
+    ASSERT_EQ(1u, order[1]);
+    ASSERT_EQ(3u, order[2]);
+    ASSERT_EQ(4u, order[3]);
+
+    ASSERT_EQ(0u, GetAliveTimers(timer_world));
+
+    // A repeating timer keeps its place when it is rescheduled
+    order_count = 0;
+    dmScript::HTimer repeating = dmScript::AddTimer(timer_world, 1.f, true, Callback::cb, 0x10, 5);
+    dmScript::UpdateTimers(timer_world, 1.f);
+    ASSERT_EQ(1u, order_count);
+    dmScript::AddTimer(timer_world, 0.5f, false, Callback::cb, 0x10, 6);
+    dmScript::UpdateTimers(timer_world, 1.f);
+    ASSERT_EQ(3u, order_count);
+    ASSERT_EQ(5u, order[1]);
+    ASSERT_EQ(6u, order[2]);
+
+    ASSERT_TRUE(dmScript::CancelTimer(timer_world, repeating));
+
+    dmScript::DeleteTimerWorld(timer_world);
+}
+
+TEST_F(ScriptTimerTest, TestIdleTimersPerformance)
+{
+    // A timer world holds at most 65000 timers, so the 100k idle timers are split between two worlds
+    const uint32_t world_count = 2;
+    const uint32_t timers_per_world = 50000;
+    const uint32_t update_count = 1000;
+
+    dmScript::HTimerWorld timer_worlds[world_count];
+    for (uint32_t w = 0; w < world_count; ++w)
+    {
+        timer_worlds[w] = dmScript::NewTimerWorld();
+        for (uint32_t i = 0; i < timers_per_world; ++i)
+        {
+            dmScript::HTimer handle = dmScript::AddTimer(timer_worlds[w], 1000.f + i, false, TestCallback, i % 64, 0x0);
+            ASSERT_NE(dmScript::INVALID_TIMER_HANDLE, handle);
+        }
+    }
+
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < update_count; ++i)
+    {
+        for (uint32_t w = 0; w < world_count; ++w)
+        {
+            dmScript::UpdateTimers(timer_worlds[w], 1.0f / 60.0f);
+        }
+    }
+    uint64_t end = dmTime::GetTime();
+
+    ASSERT_EQ(0u, TimerTestCallback::callback_count);
+    printf("Bench elapsed: %f ms (%f us per update of %u idle timers)\n", (end - start) / 1000.0f, (end - start) / (float)update_count, world_count * timers_per_world);
+
+    for (uint32_t w = 0; w < world_count; ++w)
+    {
+        ASSERT_EQ(timers_per_world, GetAliveTimers(timer_worlds[w]));
+        for (uint32_t owner = 0; owner < 64; ++owner)
+        {
+            dmScript::KillTimers(timer_worlds[w], owner);
+        }
+        ASSERT_EQ(0u, GetAliveTimers(timer_worlds[w]));
+        dmScript::DeleteTimerWorld(timer_worlds[w]);
+    }
+}
+
 static bool RunString(lua_State* L, const char* script)
 {
     luaL_loadstring(L, script);
@@ -13,6 +13,7 @@
 #define JC_TEST_IMPLEMENTATION
 #include <jc_test/jc_test.h>
 #include <dlib/image.h>
+#include <dlib/time.h>
 #include <dlib/webp.h>
 #include <string.h> // memcmp
 
@@ -482,6 +483,67 @@ TEST_F(TexcTest, TranscodeWebEncodedTextureFormat)
     TranscodeWebEncodedFormat(dmTexc::PF_R4G4B4A4, dmWebP::TEXTURE_ENCODE_FORMAT_RGBA4444);
 }
 
+// Returns the transcode time in microseconds, and the transcoded data which the caller deletes
+static uint64_t TranscodeBenchmark(uint32_t size, dmTexc::PixelFormat pixel_format, dmTexc::CompressionType compression_type, uint8_t** out_data, uint32_t* out_data_size)
+{
+    dmTexc::HTexture texture = CreateDefaultRGBA32(size, size);
+    dmTexc::GenMipMaps(texture);
+
+    uint64_t start = dmTime::GetTime();
+    bool ok = dmTexc::Transcode(texture, pixel_format, dmTexc::CS_LRGB, dmTexc::CL_NORMAL, compression_type, dmTexc::DT_DEFAULT);
+    uint64_t elapsed = dmTime::GetTime() - start;
+
+    *out_data_size = ok ? dmTexc::GetTotalDataSize(texture) : 0;
+    *out_data = new uint8_t[*out_data_size];
+    dmTexc::GetData(texture, *out_data, *out_data_size);
+    dmTexc::Destroy(texture);
+    return elapsed;
+}
+
+TEST_F(TexcTest, TranscodeBenchmark)
+{
+    struct BenchFormat
+    {
+        const char*                 m_Name;
+        dmTexc::PixelFormat         m_PixelFormat;
+        dmTexc::CompressionType     m_CompressionType;
+    } bench_formats[] =
+    {
+        {"RGBA WebP lossless", dmTexc::PF_R8G8B8A8, dmTexc::CT_WEBP},
+        {"RGBA WebP lossy", dmTexc::PF_R8G8B8A8, dmTexc::CT_WEBP_LOSSY},
+        {"RGB565 WebP lossless", dmTexc::PF_R5G6B5, dmTexc::CT_WEBP},
+        {"ETC1 WebP", dmTexc::PF_RGB_ETC1, dmTexc::CT_WEBP},
+        {"PVRTC 4bpp WebP", dmTexc::PF_RGBA_PVRTC_4BPPV1, dmTexc::CT_WEBP},
+    };
+
+    const uint32_t size = 512;
+    const float megapixels = size * size * (4.0f / 3.0f) / 1000000.0f; // including the mip maps
+    for (uint32_t i = 0; i < sizeof(bench_formats) / sizeof(bench_formats[0]); ++i)
+    {
+        BenchFormat& format = bench_formats[i];
+        uint8_t* serial_data;
+        uint32_t serial_data_size;
+        uint8_t* parallel_data;
+        uint32_t parallel_data_size;
+
+        dmTexc::SetWorkerCount(0);
+        uint64_t serial_time = TranscodeBenchmark(size, format.m_PixelFormat, format.m_CompressionType, &serial_data, &serial_data_size);
+        dmTexc::SetWorkerCount(4);
+        uint64_t parallel_time = TranscodeBenchmark(size, format.m_PixelFormat, format.m_CompressionType, &parallel_data, &parallel_data_size);
+        dmTexc::SetWorkerCount(0);
+
+        // The worker threads must not change the output
+        ASSERT_NE(0u, serial_data_size);
+        ASSERT_EQ(serial_data_size, parallel_data_size);
+        ASSERT_EQ(0, memcmp(serial_data, parallel_data, serial_data_size));
+        delete[] serial_data;
+        delete[] parallel_data;
+
+        printf("Bench elapsed %s: serial %f MPix/s, 4 workers %f MPix/s\n", format.m_Name,
+                megapixels / (serial_time / 1000000.0f), megapixels / (parallel_time / 1000000.0f));
+    }
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -15,6 +15,7 @@
 
 #include <assert.h>
 
+#include <dlib/job_thread.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
 
@@ -23,6 +24,8 @@
 
 namespace dmTexc
 {
+    static dmJobThread::HContext g_JobThread = 0;
+
     static pvrtexture::PixelType ConvertPixelFormat(PixelFormat pixel_format)
     {
         switch (pixel_format)
@@ -315,6 +318,17 @@ namespace dmTexc
         return true;
     }
 
+    void SetWorkerCount(uint32_t count)
+    {
+        dmJobThread::Destroy(g_JobThread);
+        g_JobThread = count > 0 ? dmJobThread::Create(count, "texc") : 0;
+    }
+
+    dmJobThread::HContext GetJobThread()
+    {
+        return g_JobThread;
+    }
+
 #define DM_TEXC_TRAMPOLINE1(ret, name, t1) \
     ret TEXC_##name(t1 a1)\
     {\
@@ -370,6 +384,7 @@ namespace dmTexc
     DM_TEXC_TRAMPOLINE1(bool, GenMipMaps, HTexture);
     DM_TEXC_TRAMPOLINE2(bool, Flip, HTexture, FlipAxis);
     DM_TEXC_TRAMPOLINE6(bool, Transcode, HTexture, PixelFormat, ColorSpace, CompressionLevel, CompressionType, DitherType);
+    DM_TEXC_TRAMPOLINE1(void, SetWorkerCount, uint32_t);
     DM_TEXC_TRAMPOLINE8(HBuffer, CompressWebPBuffer, uint32_t, uint32_t, uint32_t, void*, uint32_t, PixelFormat, CompressionLevel, CompressionType);
     DM_TEXC_TRAMPOLINE1(uint32_t, GetTotalBufferDataSize, HBuffer);
     DM_TEXC_TRAMPOLINE3(uint32_t, GetBufferData, HBuffer, void*, uint32_t);
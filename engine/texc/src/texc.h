@@ -184,6 +184,14 @@ namespace dmTexc
      */
     DM_TEXC_PROTO(bool, Transcode, HTexture texture, PixelFormat pixelFormat, ColorSpace color_space, CompressionLevel compressionLevel, CompressionType compression_type, DitherType dither_type);
 
+    /**
+     * Set the number of worker threads used to compress the mip maps of a texture.
+     * With 0 workers (default) all compression is done on the calling thread. The output
+     * is identical regardless of the worker count.
+     * Not thread safe, call it before any texture is transcoded.
+     */
+    DM_TEXC_PROTO(void, SetWorkerCount, uint32_t count);
+
     // Compresses an image buffer
     DM_TEXC_PROTO(HBuffer, CompressWebPBuffer, uint32_t width, uint32_t height, uint32_t bpp, void* data, uint32_t size, PixelFormat pixelFormat, CompressionLevel compressionLevel, CompressionType compression_type);
 
@@ -14,6 +14,7 @@
 #define DM_TEXC_PRIVATE_H
 
 #include <dlib/array.h>
+#include <dlib/job_thread.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <PVRTexture.h>
@@ -41,6 +42,9 @@ namespace dmTexc
     };
 
 
+    // Worker threads used to compress the mip maps of a texture, 0 if compressing on the calling thread
+    dmJobThread::HContext GetJobThread();
+
     bool CompressWebP(HTexture texture, PixelFormat pixel_format, ColorSpace color_space, CompressionLevel compression_level, CompressionType compression_type);
     HBuffer CompressWebPBuffer(uint32_t width, uint32_t height, uint32_t bpp, void* data, uint32_t size, PixelFormat pixel_format, CompressionLevel compression_level, CompressionType compression_type);
 
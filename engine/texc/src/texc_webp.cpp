@@ -12,6 +12,7 @@
 
 
 #include <assert.h>
+#include <dlib/job_thread.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
 #include <webp/encode.h>
@@ -257,6 +258,41 @@ namespace dmTexc
     }
 
 
+    struct CompressedMipMap
+    {
+        TextureData m_Data;
+        bool        m_Ok;
+    };
+
+    struct CompressMipMapsJob
+    {
+        pvrtexture::CPVRTexture* m_Texture;
+        const WebPConfig*        m_Config;
+        uint32_t                 m_BitsPerPixel;
+        PixelFormat              m_PixelFormat;
+        CompressionLevel         m_CompressionLevel;
+        CompressionType          m_CompressionType;
+        dmArray<CompressedMipMap> m_Mips;
+    };
+
+    static void CompressMipMap(void* context, uint32_t mip_map)
+    {
+        CompressMipMapsJob* job = (CompressMipMapsJob*) context;
+        pvrtexture::CPVRTexture* pt = job->m_Texture;
+
+        // CompressWebPInternal adjusts the config for some formats, so each mip map gets its own copy
+        WebPConfig config = *job->m_Config;
+        uint32_t outsize = 0;
+        CompressedMipMap& mip = job->m_Mips[mip_map];
+        mip.m_Ok = CompressWebPInternal(&config, pt->getWidth(mip_map), pt->getHeight(mip_map), job->m_BitsPerPixel, (uint8_t*) pt->getDataPtr(mip_map), pt->getDataSize(mip_map),
+                                        &mip.m_Data.m_Data, &outsize, job->m_PixelFormat, job->m_CompressionLevel, job->m_CompressionType);
+        mip.m_Data.m_ByteSize = mip.m_Ok ? outsize : 0;
+        if(!mip.m_Ok)
+        {
+            mip.m_Data.m_Data = 0;
+        }
+    }
+
     bool CompressWebP(HTexture texture, PixelFormat pixel_format, ColorSpace color_space, CompressionLevel compression_level, CompressionType compression_type)
     {
         Texture* t = (Texture*) texture;
@@ -310,41 +346,40 @@ namespace dmTexc
             }
         }
 
-        for(; mip_map < mip_maps; ++mip_map)
+        // Mip maps from the first one below the size threshold are stored uncompressed
+        uint32_t compress_count = 0;
+        while(compress_count < mip_maps && (pt->getWidth(compress_count) * pt->getHeight(compress_count)) > COMPRESSION_ENABLED_PIXELCOUNT_THRESHOLD)
         {
-            uint32_t mip_width = pt->getWidth(mip_map);
-            uint32_t mip_height = pt->getHeight(mip_map);
+            ++compress_count;
+        }
 
-            // check compression size threshold
-            if((mip_width * mip_height) <= COMPRESSION_ENABLED_PIXELCOUNT_THRESHOLD)
+        // The mip maps are compressed independently on the worker threads, which gives the same output as compressing them one by one
+        CompressMipMapsJob job;
+        job.m_Texture = pt;
+        job.m_Config = &config;
+        job.m_BitsPerPixel = bits_per_pixel;
+        job.m_PixelFormat = pixel_format;
+        job.m_CompressionLevel = compression_level;
+        job.m_CompressionType = compression_type;
+        job.m_Mips.SetCapacity(compress_count);
+        job.m_Mips.SetSize(compress_count);
+        memset(job.m_Mips.Begin(), 0, sizeof(CompressedMipMap) * compress_count);
+        dmJobThread::ParallelFor(GetJobThread(), CompressMipMap, &job, compress_count);
+
+        // Keep the chain up to the first mip map that failed to compress, the rest are stored uncompressed
+        for(; mip_map < compress_count; ++mip_map)
+        {
+            CompressedMipMap& mip = job.m_Mips[mip_map];
+            if(!mip.m_Ok)
             {
-                mip_map = mip_maps;
-                break;
-            }
-
-            uint32_t datasize = pt->getDataSize(mip_map);
-            uint8_t* data = (uint8_t*) pt->getDataPtr(mip_map);
-            uint32_t outsize;
-            TextureData ctd;
-            if (!CompressWebPInternal(&config, mip_width, mip_height, bits_per_pixel, data, datasize, &ctd.m_Data, &outsize, pixel_format, compression_level, compression_type)) {
                 dmLogError("Failed to compress mip %d", mip_map);
-                mip_map = mip_maps;
                 break;
             }
-            ctd.m_ByteSize = outsize;
-            t->m_CompressedMips.Push(ctd);
+            t->m_CompressedMips.Push(mip.m_Data);
         }
-
-        // if we haven't got a complete mip-map chain, something went' wrong so free all used memory
-        if(mip_map != mip_maps)
+        for(; mip_map < compress_count; ++mip_map)
         {
-            dmLogError("WebPEncode compression failed at mip index(%d)", mip_map);
-            for(size_t i = 0; i < t->m_CompressedMips.Size(); ++i)
-            {
-                delete[] &t->m_CompressedMips[i].m_Data;
-            }
-            t->m_CompressedMips.SetSize(0);
-            return false;
+            delete[] job.m_Mips[mip_map].m_Data.m_Data;
         }
 
         // compression success, free source picture